@@ -460,6 +460,273 @@ void AudioDataConverters::deinterleaveSamples (const float* source, float** dest
 }
 
 
+//==============================================================================
+#if (JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON) && ! JUCE_BIG_ENDIAN
+namespace AudioDataVectorHelpers
+{
+    // Scalar access to a little-endian packed integer sample, as a left-aligned 32-bit value
+    template <int bytesPerSample> struct PackedInt;
+
+    template <>
+    struct PackedInt<2>
+    {
+        static inline int32 load (const char* p) noexcept            { return (int32) ((uint32) readUnaligned<uint16> (p) << 16); }
+        static inline void store (char* p, int32 value) noexcept     { writeUnaligned<uint16> (p, (uint16) (value >> 16)); }
+    };
+
+    template <>
+    struct PackedInt<3>
+    {
+        static inline int32 load (const char* p) noexcept            { return (int32) (((uint32) ByteOrder::littleEndian24Bit (p)) << 8); }
+        static inline void store (char* p, int32 value) noexcept     { ByteOrder::littleEndian24BitToChars (value >> 8, p); }
+    };
+
+    template <>
+    struct PackedInt<4>
+    {
+        static inline int32 load (const char* p) noexcept            { return readUnaligned<int32> (p); }
+        static inline void store (char* p, int32 value) noexcept     { writeUnaligned<int32> (p, value); }
+    };
+
+    // These must give exactly the same results as Float32::getAsInt32LE() and Float32::setAsInt32LE()
+    static inline int32 floatToInt32 (float value) noexcept     { return (int32) roundToInt (jlimit (-1.0, 1.0, (double) value) * (double) 0x7fffffff); }
+    static inline float int32ToFloat (int32 value) noexcept     { return (float) (value * (1.0 / (1.0 + 0x7fffffff))); }
+
+   #if JUCE_USE_SSE_INTRINSICS
+    struct VectorOps
+    {
+        using IntType   = __m128i;
+        using FloatType = __m128;
+
+        static forcedinline IntType loadInt32 (const void* p) noexcept             { return _mm_loadu_si128 (reinterpret_cast<const __m128i*> (p)); }
+        static forcedinline void storeInt32 (void* p, IntType v) noexcept          { _mm_storeu_si128 (reinterpret_cast<__m128i*> (p), v); }
+        static forcedinline FloatType loadFloat (const void* p) noexcept           { return _mm_loadu_ps (static_cast<const float*> (p)); }
+        static forcedinline void storeFloat (void* p, FloatType v) noexcept        { _mm_storeu_ps (static_cast<float*> (p), v); }
+        static forcedinline IntType setInt32 (int32 a, int32 b, int32 c, int32 d) noexcept  { return _mm_setr_epi32 (a, b, c, d); }
+        static forcedinline FloatType setFloat (float a, float b, float c, float d) noexcept { return _mm_setr_ps (a, b, c, d); }
+        template <int lane> static forcedinline int32 getInt32 (IntType v) noexcept         { return _mm_cvtsi128_si32 (_mm_shuffle_epi32 (v, lane)); }
+        template <int lane> static forcedinline float getFloat (FloatType v) noexcept        { return _mm_cvtss_f32 (_mm_shuffle_ps (v, v, lane)); }
+
+        static forcedinline IntType loadInt16 (const void* p) noexcept
+        {
+            return _mm_unpacklo_epi16 (_mm_setzero_si128(), _mm_loadl_epi64 (reinterpret_cast<const __m128i*> (p)));
+        }
+
+        static forcedinline void storeInt16 (void* p, IntType v) noexcept
+        {
+            auto shifted = _mm_srai_epi32 (v, 16);
+            _mm_storel_epi64 (reinterpret_cast<__m128i*> (p), _mm_packs_epi32 (shifted, shifted));
+        }
+
+        static forcedinline FloatType intToFloat (IntType v) noexcept
+        {
+            return _mm_mul_ps (_mm_cvtepi32_ps (v), _mm_set1_ps (1.0f / 2147483648.0f));
+        }
+
+        static forcedinline __m128i convertPair (__m128d d) noexcept
+        {
+            d = _mm_and_pd (d, _mm_cmpord_pd (d, d)); // NaN -> 0, as the scalar path does
+            d = _mm_min_pd (_mm_max_pd (d, _mm_set1_pd (-1.0)), _mm_set1_pd (1.0));
+            return _mm_cvtpd_epi32 (_mm_mul_pd (d, _mm_set1_pd ((double) 0x7fffffff)));
+        }
+
+        static forcedinline IntType floatToInt (FloatType v) noexcept
+        {
+            return _mm_unpacklo_epi64 (convertPair (_mm_cvtps_pd (v)),
+                                       convertPair (_mm_cvtps_pd (_mm_movehl_ps (v, v))));
+        }
+    };
+   #else
+    struct VectorOps
+    {
+        using IntType   = int32x4_t;
+        using FloatType = float32x4_t;
+
+        static forcedinline IntType loadInt32 (const void* p) noexcept             { return vld1q_s32 (static_cast<const int32_t*> (p)); }
+        static forcedinline void storeInt32 (void* p, IntType v) noexcept          { vst1q_s32 (static_cast<int32_t*> (p), v); }
+        static forcedinline FloatType loadFloat (const void* p) noexcept           { return vld1q_f32 (static_cast<const float*> (p)); }
+        static forcedinline void storeFloat (void* p, FloatType v) noexcept        { vst1q_f32 (static_cast<float*> (p), v); }
+        static forcedinline IntType setInt32 (int32 a, int32 b, int32 c, int32 d) noexcept  { return vsetq_lane_s32 (d, vsetq_lane_s32 (c, vsetq_lane_s32 (b, vdupq_n_s32 (a), 1), 2), 3); }
+        static forcedinline FloatType setFloat (float a, float b, float c, float d) noexcept { return vsetq_lane_f32 (d, vsetq_lane_f32 (c, vsetq_lane_f32 (b, vdupq_n_f32 (a), 1), 2), 3); }
+        template <int lane> static forcedinline int32 getInt32 (IntType v) noexcept         { return vgetq_lane_s32 (v, lane); }
+        template <int lane> static forcedinline float getFloat (FloatType v) noexcept        { return vgetq_lane_f32 (v, lane); }
+        static forcedinline IntType loadInt16 (const void* p) noexcept             { return vshll_n_s16 (vld1_s16 (static_cast<const int16_t*> (p)), 16); }
+        static forcedinline void storeInt16 (void* p, IntType v) noexcept          { vst1_s16 (static_cast<int16_t*> (p), vshrn_n_s32 (v, 16)); }
+        static forcedinline FloatType intToFloat (IntType v) noexcept              { return vmulq_n_f32 (vcvtq_f32_s32 (v), 1.0f / 2147483648.0f); }
+
+       #if JUCE_64BIT
+        static forcedinline int32x2_t convertPair (float64x2_t d) noexcept
+        {
+            d = vreinterpretq_f64_u64 (vandq_u64 (vreinterpretq_u64_f64 (d), vceqq_f64 (d, d))); // NaN -> 0, as the scalar path does
+            d = vminq_f64 (vmaxq_f64 (d, vdupq_n_f64 (-1.0)), vdupq_n_f64 (1.0));
+            return vmovn_s64 (vcvtnq_s64_f64 (vmulq_n_f64 (d, (double) 0x7fffffff)));
+        }
+
+        static forcedinline IntType floatToInt (FloatType v) noexcept
+        {
+            return vcombine_s32 (convertPair (vcvt_f64_f32 (vget_low_f32 (v))),
+                                 convertPair (vcvt_high_f64_f32 (v)));
+        }
+       #else
+        // 32-bit ARM has no double-precision vectors, and single precision can't round the
+        // full 32-bit range identically to the scalar path
+        static forcedinline IntType floatToInt (FloatType v) noexcept
+        {
+            float in[4];
+            int32_t out[4];
+            vst1q_f32 (in, v);
+
+            for (int i = 0; i < 4; ++i)
+                out[i] = floatToInt32 (in[i]);
+
+            return vld1q_s32 (out);
+        }
+       #endif
+    };
+   #endif
+
+    // Reads four samples into left-aligned 32-bit lanes
+    template <int bytesPerSample>
+    static forcedinline VectorOps::IntType loadInts (const char* src, int stride) noexcept
+    {
+        if (stride == bytesPerSample && bytesPerSample == 4)  return VectorOps::loadInt32 (src);
+        if (stride == bytesPerSample && bytesPerSample == 2)  return VectorOps::loadInt16 (src);
+
+        return VectorOps::setInt32 (PackedInt<bytesPerSample>::load (src),
+                                    PackedInt<bytesPerSample>::load (src + stride),
+                                    PackedInt<bytesPerSample>::load (src + stride * 2),
+                                    PackedInt<bytesPerSample>::load (src + stride * 3));
+    }
+
+    template <int bytesPerSample>
+    static forcedinline void storeInts (char* dest, int stride, VectorOps::IntType v) noexcept
+    {
+        if (stride == bytesPerSample && bytesPerSample == 4)  { VectorOps::storeInt32 (dest, v); return; }
+        if (stride == bytesPerSample && bytesPerSample == 2)  { VectorOps::storeInt16 (dest, v); return; }
+
+        PackedInt<bytesPerSample>::store (dest,              VectorOps::getInt32<0> (v));
+        PackedInt<bytesPerSample>::store (dest + stride,     VectorOps::getInt32<1> (v));
+        PackedInt<bytesPerSample>::store (dest + stride * 2, VectorOps::getInt32<2> (v));
+        PackedInt<bytesPerSample>::store (dest + stride * 3, VectorOps::getInt32<3> (v));
+    }
+
+    static forcedinline VectorOps::FloatType loadFloats (const char* src, int stride) noexcept
+    {
+        if (stride == (int) sizeof (float))
+            return VectorOps::loadFloat (src);
+
+        return VectorOps::setFloat (readUnaligned<float> (src),
+                                    readUnaligned<float> (src + stride),
+                                    readUnaligned<float> (src + stride * 2),
+                                    readUnaligned<float> (src + stride * 3));
+    }
+
+    static forcedinline void storeFloats (char* dest, int stride, VectorOps::FloatType v) noexcept
+    {
+        if (stride == (int) sizeof (float))
+        {
+            VectorOps::storeFloat (dest, v);
+            return;
+        }
+
+        writeUnaligned<float> (dest,              VectorOps::getFloat<0> (v));
+        writeUnaligned<float> (dest + stride,     VectorOps::getFloat<1> (v));
+        writeUnaligned<float> (dest + stride * 2, VectorOps::getFloat<2> (v));
+        writeUnaligned<float> (dest + stride * 3, VectorOps::getFloat<3> (v));
+    }
+
+    //==============================================================================
+    // Each block of four samples is read completely before it is written, so in-place
+    // conversions behave like the scalar loop in Pointer::convertSamples()
+    template <int bytesPerSample>
+    static void convertIntToFloat (const char* src, int srcStride, char* dest, int destStride, int num) noexcept
+    {
+        for (; num >= 4; num -= 4, src += srcStride * 4, dest += destStride * 4)
+            storeFloats (dest, destStride, VectorOps::intToFloat (loadInts<bytesPerSample> (src, srcStride)));
+
+        for (; num > 0; --num, src += srcStride, dest += destStride)
+            writeUnaligned<float> (dest, int32ToFloat (PackedInt<bytesPerSample>::load (src)));
+    }
+
+    template <int bytesPerSample>
+    static void convertFloatToInt (const char* src, int srcStride, char* dest, int destStride, int num) noexcept
+    {
+        for (; num >= 4; num -= 4, src += srcStride * 4, dest += destStride * 4)
+            storeInts<bytesPerSample> (dest, destStride, VectorOps::floatToInt (loadFloats (src, srcStride)));
+
+        for (; num > 0; --num, src += srcStride, dest += destStride)
+            PackedInt<bytesPerSample>::store (dest, floatToInt32 (readUnaligned<float> (src)));
+    }
+
+    template <int sourceBytesPerSample, int destBytesPerSample>
+    static void convertIntToInt (const char* src, int srcStride, char* dest, int destStride, int num) noexcept
+    {
+        for (; num >= 4; num -= 4, src += srcStride * 4, dest += destStride * 4)
+            storeInts<destBytesPerSample> (dest, destStride, loadInts<sourceBytesPerSample> (src, srcStride));
+
+        for (; num > 0; --num, src += srcStride, dest += destStride)
+            PackedInt<destBytesPerSample>::store (dest, PackedInt<sourceBytesPerSample>::load (src));
+    }
+}
+
+void AudioData::VectorisedConversions::convert (Type type, int sourceBytesPerSample, const void* source, int sourceStride,
+                                                int destBytesPerSample, void* dest, int destStride, int numSamples) noexcept
+{
+    using namespace AudioDataVectorHelpers;
+
+    auto src = static_cast<const char*> (source);
+    auto dst = static_cast<char*> (dest);
+
+    switch (type)
+    {
+        case intToFloat:
+            switch (sourceBytesPerSample)
+            {
+                case 2:  convertIntToFloat<2> (src, sourceStride, dst, destStride, numSamples); break;
+                case 3:  convertIntToFloat<3> (src, sourceStride, dst, destStride, numSamples); break;
+                case 4:  convertIntToFloat<4> (src, sourceStride, dst, destStride, numSamples); break;
+                default: jassertfalse; break;
+            }
+            break;
+
+        case floatToInt:
+            switch (destBytesPerSample)
+            {
+                case 2:  convertFloatToInt<2> (src, sourceStride, dst, destStride, numSamples); break;
+                case 3:  convertFloatToInt<3> (src, sourceStride, dst, destStride, numSamples); break;
+                case 4:  convertFloatToInt<4> (src, sourceStride, dst, destStride, numSamples); break;
+                default: jassertfalse; break;
+            }
+            break;
+
+        case intToInt32:
+            switch (sourceBytesPerSample)
+            {
+                case 2:  convertIntToInt<2, 4> (src, sourceStride, dst, destStride, numSamples); break;
+                case 3:  convertIntToInt<3, 4> (src, sourceStride, dst, destStride, numSamples); break;
+                case 4:  convertIntToInt<4, 4> (src, sourceStride, dst, destStride, numSamples); break;
+                default: jassertfalse; break;
+            }
+            break;
+
+        case int32ToInt:
+            switch (destBytesPerSample)
+            {
+                case 2:  convertIntToInt<4, 2> (src, sourceStride, dst, destStride, numSamples); break;
+                case 3:  convertIntToInt<4, 3> (src, sourceStride, dst, destStride, numSamples); break;
+                case 4:  convertIntToInt<4, 4> (src, sourceStride, dst, destStride, numSamples); break;
+                default: jassertfalse; break;
+            }
+            break;
+
+        case none:
+        default:
+            jassertfalse;
+            break;
+    }
+}
+#endif
+
 //==============================================================================
 //==============================================================================
 #if JUCE_UNIT_TESTS
@@ -571,6 +838,65 @@ public:
         }
     };
 
+    // Checks an interleaved block conversion against a sample-by-sample copy, byte for byte
+    template <class SourceFormat, class DestFormat>
+    struct InterleavedTest
+    {
+        using SourcePointer = AudioData::Pointer<SourceFormat, AudioData::LittleEndian, AudioData::Interleaved, AudioData::Const>;
+        using DestPointer   = AudioData::Pointer<DestFormat, AudioData::NativeEndian, AudioData::Interleaved, AudioData::NonConst>;
+
+        static void test (UnitTest& unitTest, Random& r)
+        {
+            for (auto numSourceChannels : { 1, 2, 3, 8, 64 })
+                for (auto numDestChannels : { 1, numSourceChannels })
+                    for (auto numSamples : { 0, 1, 3, 4, 7, 33, 1000 })
+                        test (unitTest, r, numSourceChannels, numDestChannels, numSamples);
+        }
+
+        static void test (UnitTest& unitTest, Random& r, int numSourceChannels, int numDestChannels, int numSamples)
+        {
+            const auto sourceSize = (size_t) (numSourceChannels * numSamples * SourcePointer::getBytesPerSample());
+            const auto destSize   = (size_t) (numDestChannels * numSamples * DestPointer::getBytesPerSample());
+
+            HeapBlock<char> source (sourceSize + 1), converted (destSize + 1), expected (destSize + 1);
+            r.fillBitsRandomly (source.get(), sourceSize);
+            r.fillBitsRandomly (converted.get(), destSize);
+            memcpy (expected.get(), converted.get(), destSize);
+
+            if (SourcePointer::isFloatingPoint())
+            {
+                const float specialValues[] = { 0.0f, 1.0f, -1.0f, 0.5f, -0.5f, 1.5f, -1.5f, 1.0e-10f };
+                auto* floats = reinterpret_cast<float*> (source.get());
+
+                for (int i = 0; i < numSourceChannels * numSamples; ++i)
+                    floats[i] = r.nextBool() ? specialValues[r.nextInt (numElementsInArray (specialValues))]
+                                             : r.nextFloat() * 2.4f - 1.2f;
+            }
+
+            const auto sourceChannel = r.nextInt (numSourceChannels);
+            const auto destChannel = numDestChannels > 1 ? sourceChannel : 0;
+
+            AudioData::ConverterInstance<SourcePointer, DestPointer> conv (numSourceChannels, numDestChannels);
+            conv.convertSamples (converted, destChannel, source, sourceChannel, numSamples);
+
+            SourcePointer s (addBytesToPointer (source.get(), sourceChannel * SourcePointer::getBytesPerSample()), numSourceChannels);
+            DestPointer d (addBytesToPointer (expected.get(), destChannel * DestPointer::getBytesPerSample()), numDestChannels);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                if (d.isFloatingPoint())
+                    d.setAsFloat (s.getAsFloat());
+                else
+                    d.setAsInt32 (s.getAsInt32());
+
+                ++s;
+                ++d;
+            }
+
+            unitTest.expect (memcmp (converted.get(), expected.get(), destSize) == 0);
+        }
+    };
+
     void runTest() override
     {
         auto r = getRandom();
@@ -584,6 +910,22 @@ public:
         Test1 <AudioData::Int32>::test (*this, r);
         beginTest ("Round-trip conversion: Float32");
         Test1 <AudioData::Float32>::test (*this, r);
+
+        beginTest ("Interleaved conversion: integer to float");
+        InterleavedTest <AudioData::Int16, AudioData::Float32>::test (*this, r);
+        InterleavedTest <AudioData::Int24, AudioData::Float32>::test (*this, r);
+        InterleavedTest <AudioData::Int32, AudioData::Float32>::test (*this, r);
+
+        beginTest ("Interleaved conversion: float to integer");
+        InterleavedTest <AudioData::Float32, AudioData::Int16>::test (*this, r);
+        InterleavedTest <AudioData::Float32, AudioData::Int24>::test (*this, r);
+        InterleavedTest <AudioData::Float32, AudioData::Int32>::test (*this, r);
+
+        beginTest ("Interleaved conversion: integer to integer");
+        InterleavedTest <AudioData::Int16, AudioData::Int32>::test (*this, r);
+        InterleavedTest <AudioData::Int24, AudioData::Int32>::test (*this, r);
+        InterleavedTest <AudioData::Int32, AudioData::Int16>::test (*this, r);
+        InterleavedTest <AudioData::Int32, AudioData::Int24>::test (*this, r);
     }
 };
 
@@ -320,6 +320,38 @@ public:
         static inline void* toVoidPtr (VoidType* v) noexcept { return const_cast<void*> (v); }
         enum { isConst = 1 };
     };
+
+    //==============================================================================
+   #if (JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON) && ! JUCE_BIG_ENDIAN
+    /*  SIMD block converters that Pointer::convertSamples() uses when one side is little-endian
+        Int16, Int24 or Int32 and the other is little-endian Float32 or Int32. The conversion type
+        is chosen at compile time from the two Pointer types; the strides are in bytes.
+    */
+    struct JUCE_API VectorisedConversions
+    {
+        enum Type { none, intToFloat, floatToInt, intToInt32, int32ToInt };
+
+        template <class Format>
+        static constexpr bool isPackedInt() noexcept
+        {
+            return std::is_same<Format, Int16>::value || std::is_same<Format, Int24>::value || std::is_same<Format, Int32>::value;
+        }
+
+        template <class SourceFormat, class SourceEndianness, class DestFormat, class DestEndianness>
+        static constexpr Type getType() noexcept
+        {
+            return ! (std::is_base_of<LittleEndian, SourceEndianness>::value && std::is_base_of<LittleEndian, DestEndianness>::value) ? none
+                    : (isPackedInt<SourceFormat>() && std::is_same<DestFormat, Float32>::value)                                       ? intToFloat
+                    : (std::is_same<SourceFormat, Float32>::value && isPackedInt<DestFormat>())                                       ? floatToInt
+                    : (isPackedInt<SourceFormat>() && std::is_same<DestFormat, Int32>::value)                                         ? intToInt32
+                    : (std::is_same<SourceFormat, Int32>::value && isPackedInt<DestFormat>())                                         ? int32ToInt
+                    : none;
+        }
+
+        static void convert (Type, int sourceBytesPerSample, const void* source, int sourceStride,
+                             int destBytesPerSample, void* dest, int destStride, int numSamples) noexcept;
+    };
+   #endif
   #endif
 
     //==============================================================================
@@ -465,6 +497,11 @@ public:
 
             if (source.getRawData() != getRawData() || source.getNumBytesBetweenSamples() >= getNumBytesBetweenSamples())
             {
+               #if (JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON) && ! JUCE_BIG_ENDIAN
+                if (convertSamplesVectorised (source, numSamples))
+                    return;
+               #endif
+
                 while (--numSamples >= 0)
                 {
                     Endianness::copyFrom (dest.data, source);
@@ -571,6 +608,24 @@ public:
 
         inline void advance() noexcept                          { this->advanceData (data); }
 
+       #if (JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON) && ! JUCE_BIG_ENDIAN
+        template <class SourceFormat, class SourceEndianness, class SourceInterleaving, class SourceConstness>
+        bool convertSamplesVectorised (const Pointer<SourceFormat, SourceEndianness, SourceInterleaving, SourceConstness>& source, int numSamples) const noexcept
+        {
+            constexpr auto type = VectorisedConversions::getType<SourceFormat, SourceEndianness, SampleFormat, Endianness>();
+
+            if (type == VectorisedConversions::none)
+                return false;
+
+            VectorisedConversions::convert (type, (int) SourceFormat::bytesPerSample, source.getRawData(), source.getNumBytesBetweenSamples(),
+                                            (int) SampleFormat::bytesPerSample, data.data, getNumBytesBetweenSamples(), numSamples);
+            return true;
+        }
+
+        template <class OtherPointerType>
+        bool convertSamplesVectorised (const OtherPointerType&, int) const noexcept  { return false; }
+       #endif
+
         Pointer operator++ (int); // private to force you to use the more efficient pre-increment!
         Pointer operator-- (int);
     };
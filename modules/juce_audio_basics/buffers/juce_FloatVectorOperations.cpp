@@ -485,6 +485,286 @@ namespace FloatVectorHelpers
         }
     };
    #endif
+
+    //==============================================================================
+   #if JUCE_USE_AVX_INTRINSICS
+    // These are compiled for AVX and FMA regardless of the project's architecture flags, and are
+    // only called once the CPU has been checked for both instruction sets.
+    #if JUCE_GCC || JUCE_CLANG
+     #define JUCE_AVX_FMA_TARGET  __attribute__ ((target ("avx,fma")))
+    #else
+     #define JUCE_AVX_FMA_TARGET
+    #endif
+
+    // (The tests switch this off to check the AVX results against the SSE ones)
+    static std::atomic<bool>& getAVXEnabledFlag() noexcept
+    {
+        static std::atomic<bool> enabled { SystemStats::hasAVX() && SystemStats::hasFMA3() };
+        return enabled;
+    }
+
+    static bool isAVXWorthUsing (int num) noexcept
+    {
+        return num >= 16 && getAVXEnabledFlag().load (std::memory_order_relaxed);
+    }
+
+    struct AVXOps32
+    {
+        using Type = float;
+        using ParallelType = __m256;
+        enum { numParallel = 8 };
+
+        static forcedinline JUCE_AVX_FMA_TARGET ParallelType load1 (Type v) noexcept                        { return _mm256_set1_ps (v); }
+        static forcedinline JUCE_AVX_FMA_TARGET ParallelType loadU (const Type* v) noexcept                 { return _mm256_loadu_ps (v); }
+        static forcedinline JUCE_AVX_FMA_TARGET void storeU (Type* dest, ParallelType a) noexcept           { _mm256_storeu_ps (dest, a); }
+        static forcedinline JUCE_AVX_FMA_TARGET ParallelType max (ParallelType a, ParallelType b) noexcept  { return _mm256_max_ps (a, b); }
+        static forcedinline JUCE_AVX_FMA_TARGET ParallelType min (ParallelType a, ParallelType b) noexcept  { return _mm256_min_ps (a, b); }
+
+        // a * b + c, and c - a * b
+        static forcedinline JUCE_AVX_FMA_TARGET ParallelType mulAdd (ParallelType a, ParallelType b, ParallelType c) noexcept  { return _mm256_fmadd_ps (a, b, c); }
+        static forcedinline JUCE_AVX_FMA_TARGET ParallelType mulSub (ParallelType a, ParallelType b, ParallelType c) noexcept  { return _mm256_fnmadd_ps (a, b, c); }
+
+        static forcedinline JUCE_AVX_FMA_TARGET Type max (ParallelType a) noexcept { Type v[numParallel]; storeU (v, a); return jmax (jmax (v[0], v[1], v[2], v[3]), jmax (v[4], v[5], v[6], v[7])); }
+        static forcedinline JUCE_AVX_FMA_TARGET Type min (ParallelType a) noexcept { Type v[numParallel]; storeU (v, a); return jmin (jmin (v[0], v[1], v[2], v[3]), jmin (v[4], v[5], v[6], v[7])); }
+    };
+
+    struct AVXOps64
+    {
+        using Type = double;
+        using ParallelType = __m256d;
+        enum { numParallel = 4 };
+
+        static forcedinline JUCE_AVX_FMA_TARGET ParallelType load1 (Type v) noexcept                        { return _mm256_set1_pd (v); }
+        static forcedinline JUCE_AVX_FMA_TARGET ParallelType loadU (const Type* v) noexcept                 { return _mm256_loadu_pd (v); }
+        static forcedinline JUCE_AVX_FMA_TARGET void storeU (Type* dest, ParallelType a) noexcept           { _mm256_storeu_pd (dest, a); }
+        static forcedinline JUCE_AVX_FMA_TARGET ParallelType max (ParallelType a, ParallelType b) noexcept  { return _mm256_max_pd (a, b); }
+        static forcedinline JUCE_AVX_FMA_TARGET ParallelType min (ParallelType a, ParallelType b) noexcept  { return _mm256_min_pd (a, b); }
+
+        static forcedinline JUCE_AVX_FMA_TARGET ParallelType mulAdd (ParallelType a, ParallelType b, ParallelType c) noexcept  { return _mm256_fmadd_pd (a, b, c); }
+        static forcedinline JUCE_AVX_FMA_TARGET ParallelType mulSub (ParallelType a, ParallelType b, ParallelType c) noexcept  { return _mm256_fnmadd_pd (a, b, c); }
+
+        static forcedinline JUCE_AVX_FMA_TARGET Type max (ParallelType a) noexcept { Type v[numParallel]; storeU (v, a); return jmax (v[0], v[1], v[2], v[3]); }
+        static forcedinline JUCE_AVX_FMA_TARGET Type min (ParallelType a) noexcept { Type v[numParallel]; storeU (v, a); return jmin (v[0], v[1], v[2], v[3]); }
+    };
+
+    template <typename Type> struct AVXModeType;
+    template <> struct AVXModeType<float>  { using Mode = AVXOps32; };
+    template <> struct AVXModeType<double> { using Mode = AVXOps64; };
+
+    // Unaligned loads and stores cost nothing extra on AVX hardware when the data happens to be
+    // aligned, so unlike the SSE versions these don't need to check the pointers.
+    template <typename Type>
+    struct AVX
+    {
+        using Mode = typename AVXModeType<Type>::Mode;
+        using ParallelType = typename Mode::ParallelType;
+        enum { numParallel = Mode::numParallel };
+
+        // GCC only inserts a vzeroupper at -O2 and above, and leaving the upper halves of the
+        // registers dirty makes any SSE code that runs afterwards much slower.
+        struct UpperStateClearer
+        {
+            JUCE_AVX_FMA_TARGET ~UpperStateClearer() noexcept  { _mm256_zeroupper(); }
+        };
+
+        JUCE_AVX_FMA_TARGET static void addWithMultiply (Type* dest, const Type* src, Type multiplier, int num) noexcept
+        {
+            const UpperStateClearer upperStateClearer;
+            const auto mult = Mode::load1 (multiplier);
+            int i = 0;
+
+            for (; i <= num - numParallel; i += numParallel)
+                Mode::storeU (dest + i, Mode::mulAdd (Mode::loadU (src + i), mult, Mode::loadU (dest + i)));
+
+            for (; i < num; ++i)
+                dest[i] += src[i] * multiplier;
+        }
+
+        JUCE_AVX_FMA_TARGET static void addWithMultiply (Type* dest, const Type* src1, const Type* src2, int num) noexcept
+        {
+            const UpperStateClearer upperStateClearer;
+            int i = 0;
+
+            for (; i <= num - numParallel; i += numParallel)
+                Mode::storeU (dest + i, Mode::mulAdd (Mode::loadU (src1 + i), Mode::loadU (src2 + i), Mode::loadU (dest + i)));
+
+            for (; i < num; ++i)
+                dest[i] += src1[i] * src2[i];
+        }
+
+        JUCE_AVX_FMA_TARGET static void subtractWithMultiply (Type* dest, const Type* src, Type multiplier, int num) noexcept
+        {
+            const UpperStateClearer upperStateClearer;
+            const auto mult = Mode::load1 (multiplier);
+            int i = 0;
+
+            for (; i <= num - numParallel; i += numParallel)
+                Mode::storeU (dest + i, Mode::mulSub (Mode::loadU (src + i), mult, Mode::loadU (dest + i)));
+
+            for (; i < num; ++i)
+                dest[i] -= src[i] * multiplier;
+        }
+
+        JUCE_AVX_FMA_TARGET static void subtractWithMultiply (Type* dest, const Type* src1, const Type* src2, int num) noexcept
+        {
+            const UpperStateClearer upperStateClearer;
+            int i = 0;
+
+            for (; i <= num - numParallel; i += numParallel)
+                Mode::storeU (dest + i, Mode::mulSub (Mode::loadU (src1 + i), Mode::loadU (src2 + i), Mode::loadU (dest + i)));
+
+            for (; i < num; ++i)
+                dest[i] -= src1[i] * src2[i];
+        }
+
+        JUCE_AVX_FMA_TARGET static void min (Type* dest, const Type* src, Type comp, int num) noexcept
+        {
+            const UpperStateClearer upperStateClearer;
+            const auto cmp = Mode::load1 (comp);
+            int i = 0;
+
+            for (; i <= num - numParallel; i += numParallel)
+                Mode::storeU (dest + i, Mode::min (Mode::loadU (src + i), cmp));
+
+            for (; i < num; ++i)
+                dest[i] = jmin (src[i], comp);
+        }
+
+        JUCE_AVX_FMA_TARGET static void min (Type* dest, const Type* src1, const Type* src2, int num) noexcept
+        {
+            const UpperStateClearer upperStateClearer;
+            int i = 0;
+
+            for (; i <= num - numParallel; i += numParallel)
+                Mode::storeU (dest + i, Mode::min (Mode::loadU (src1 + i), Mode::loadU (src2 + i)));
+
+            for (; i < num; ++i)
+                dest[i] = jmin (src1[i], src2[i]);
+        }
+
+        JUCE_AVX_FMA_TARGET static void max (Type* dest, const Type* src, Type comp, int num) noexcept
+        {
+            const UpperStateClearer upperStateClearer;
+            const auto cmp = Mode::load1 (comp);
+            int i = 0;
+
+            for (; i <= num - numParallel; i += numParallel)
+                Mode::storeU (dest + i, Mode::max (Mode::loadU (src + i), cmp));
+
+            for (; i < num; ++i)
+                dest[i] = jmax (src[i], comp);
+        }
+
+        JUCE_AVX_FMA_TARGET static void max (Type* dest, const Type* src1, const Type* src2, int num) noexcept
+        {
+            const UpperStateClearer upperStateClearer;
+            int i = 0;
+
+            for (; i <= num - numParallel; i += numParallel)
+                Mode::storeU (dest + i, Mode::max (Mode::loadU (src1 + i), Mode::loadU (src2 + i)));
+
+            for (; i < num; ++i)
+                dest[i] = jmax (src1[i], src2[i]);
+        }
+
+        JUCE_AVX_FMA_TARGET static void clip (Type* dest, const Type* src, Type low, Type high, int num) noexcept
+        {
+            const UpperStateClearer upperStateClearer;
+            const auto lo = Mode::load1 (low);
+            const auto hi = Mode::load1 (high);
+            int i = 0;
+
+            for (; i <= num - numParallel; i += numParallel)
+                Mode::storeU (dest + i, Mode::max (Mode::min (Mode::loadU (src + i), hi), lo));
+
+            for (; i < num; ++i)
+                dest[i] = jmax (jmin (src[i], high), low);
+        }
+
+        // Two accumulators per result, to hide the latency of the min/max instructions
+        JUCE_AVX_FMA_TARGET static Type findMinOrMax (const Type* src, int num, const bool isMinimum) noexcept
+        {
+            const UpperStateClearer upperStateClearer;
+            auto val1 = Mode::loadU (src);
+            auto val2 = Mode::loadU (src + numParallel);
+            int i = 2 * numParallel;
+
+            if (isMinimum)
+            {
+                for (; i <= num - 2 * numParallel; i += 2 * numParallel)
+                {
+                    val1 = Mode::min (val1, Mode::loadU (src + i));
+                    val2 = Mode::min (val2, Mode::loadU (src + i + numParallel));
+                }
+            }
+            else
+            {
+                for (; i <= num - 2 * numParallel; i += 2 * numParallel)
+                {
+                    val1 = Mode::max (val1, Mode::loadU (src + i));
+                    val2 = Mode::max (val2, Mode::loadU (src + i + numParallel));
+                }
+            }
+
+            auto result = isMinimum ? Mode::min (Mode::min (val1, val2))
+                                    : Mode::max (Mode::max (val1, val2));
+
+            for (; i < num; ++i)
+                result = isMinimum ? jmin (result, src[i])
+                                   : jmax (result, src[i]);
+
+            return result;
+        }
+
+        JUCE_AVX_FMA_TARGET static Range<Type> findMinAndMax (const Type* src, int num) noexcept
+        {
+            const UpperStateClearer upperStateClearer;
+            auto mn1 = Mode::loadU (src), mx1 = mn1;
+            auto mn2 = Mode::loadU (src + numParallel), mx2 = mn2;
+            int i = 2 * numParallel;
+
+            for (; i <= num - 2 * numParallel; i += 2 * numParallel)
+            {
+                const auto v1 = Mode::loadU (src + i);
+                const auto v2 = Mode::loadU (src + i + numParallel);
+                mn1 = Mode::min (mn1, v1);
+                mx1 = Mode::max (mx1, v1);
+                mn2 = Mode::min (mn2, v2);
+                mx2 = Mode::max (mx2, v2);
+            }
+
+            Range<Type> result (Mode::min (Mode::min (mn1, mn2)),
+                                Mode::max (Mode::max (mx1, mx2)));
+
+            for (; i < num; ++i)
+                result = result.getUnionWith (src[i]);
+
+            return result;
+        }
+
+        JUCE_AVX_FMA_TARGET static void convertFixedToFloat (float* dest, const int* src, float multiplier, int num) noexcept
+        {
+            const UpperStateClearer upperStateClearer;
+            const auto mult = _mm256_set1_ps (multiplier);
+            int i = 0;
+
+            for (; i <= num - 8; i += 8)
+                _mm256_storeu_ps (dest + i, _mm256_mul_ps (mult, _mm256_cvtepi32_ps (_mm256_loadu_si256 (reinterpret_cast<const __m256i*> (src + i)))));
+
+            for (; i < num; ++i)
+                dest[i] = (float) src[i] * multiplier;
+        }
+    };
+
+    #define JUCE_USE_AVX_IF_AVAILABLE(functionName, ...) \
+        if (FloatVectorHelpers::isAVXWorthUsing (num)) \
+        { \
+            FloatVectorHelpers::AVX<std::remove_pointer_t<decltype (dest)>>::functionName (__VA_ARGS__); \
+            return; \
+        }
+   #else
+    #define JUCE_USE_AVX_IF_AVAILABLE(functionName, ...)
+   #endif
 }
 
 //==============================================================================
@@ -684,6 +964,8 @@ void JUCE_CALLTYPE FloatVectorOperations::addWithMultiply (float* dest, const fl
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsma (src, 1, &multiplier, dest, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_USE_AVX_IF_AVAILABLE (addWithMultiply, dest, src, multiplier, num)
+
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] += src[i] * multiplier, Mode::add (d, Mode::mul (mult, s)),
                                   JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST,
                                   const Mode::ParallelType mult = Mode::load1 (multiplier);)
@@ -695,6 +977,8 @@ void JUCE_CALLTYPE FloatVectorOperations::addWithMultiply (double* dest, const d
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsmaD (src, 1, &multiplier, dest, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_USE_AVX_IF_AVAILABLE (addWithMultiply, dest, src, multiplier, num)
+
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] += src[i] * multiplier, Mode::add (d, Mode::mul (mult, s)),
                                   JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST,
                                   const Mode::ParallelType mult = Mode::load1 (multiplier);)
@@ -706,6 +990,8 @@ void JUCE_CALLTYPE FloatVectorOperations::addWithMultiply (float* dest, const fl
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vma ((float*) src1, 1, (float*) src2, 1, dest, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_USE_AVX_IF_AVAILABLE (addWithMultiply, dest, src1, src2, num)
+
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST_DEST (dest[i] += src1[i] * src2[i], Mode::add (d, Mode::mul (s1, s2)),
                                              JUCE_LOAD_SRC1_SRC2_DEST,
                                              JUCE_INCREMENT_SRC1_SRC2_DEST, )
@@ -717,6 +1003,8 @@ void JUCE_CALLTYPE FloatVectorOperations::addWithMultiply (double* dest, const d
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vmaD ((double*) src1, 1, (double*) src2, 1, dest, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_USE_AVX_IF_AVAILABLE (addWithMultiply, dest, src1, src2, num)
+
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST_DEST (dest[i] += src1[i] * src2[i], Mode::add (d, Mode::mul (s1, s2)),
                                              JUCE_LOAD_SRC1_SRC2_DEST,
                                              JUCE_INCREMENT_SRC1_SRC2_DEST, )
@@ -725,6 +1013,8 @@ void JUCE_CALLTYPE FloatVectorOperations::addWithMultiply (double* dest, const d
 
 void JUCE_CALLTYPE FloatVectorOperations::subtractWithMultiply (float* dest, const float* src, float multiplier, int num) noexcept
 {
+    JUCE_USE_AVX_IF_AVAILABLE (subtractWithMultiply, dest, src, multiplier, num)
+
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] -= src[i] * multiplier, Mode::sub (d, Mode::mul (mult, s)),
                                   JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST,
                                   const Mode::ParallelType mult = Mode::load1 (multiplier);)
@@ -732,6 +1022,8 @@ void JUCE_CALLTYPE FloatVectorOperations::subtractWithMultiply (float* dest, con
 
 void JUCE_CALLTYPE FloatVectorOperations::subtractWithMultiply (double* dest, const double* src, double multiplier, int num) noexcept
 {
+    JUCE_USE_AVX_IF_AVAILABLE (subtractWithMultiply, dest, src, multiplier, num)
+
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] -= src[i] * multiplier, Mode::sub (d, Mode::mul (mult, s)),
                                   JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST,
                                   const Mode::ParallelType mult = Mode::load1 (multiplier);)
@@ -739,6 +1031,8 @@ void JUCE_CALLTYPE FloatVectorOperations::subtractWithMultiply (double* dest, co
 
 void JUCE_CALLTYPE FloatVectorOperations::subtractWithMultiply (float* dest, const float* src1, const float* src2, int num) noexcept
 {
+    JUCE_USE_AVX_IF_AVAILABLE (subtractWithMultiply, dest, src1, src2, num)
+
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST_DEST (dest[i] -= src1[i] * src2[i], Mode::sub (d, Mode::mul (s1, s2)),
                                              JUCE_LOAD_SRC1_SRC2_DEST,
                                              JUCE_INCREMENT_SRC1_SRC2_DEST, )
@@ -746,6 +1040,8 @@ void JUCE_CALLTYPE FloatVectorOperations::subtractWithMultiply (float* dest, con
 
 void JUCE_CALLTYPE FloatVectorOperations::subtractWithMultiply (double* dest, const double* src1, const double* src2, int num) noexcept
 {
+    JUCE_USE_AVX_IF_AVAILABLE (subtractWithMultiply, dest, src1, src2, num)
+
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST_DEST (dest[i] -= src1[i] * src2[i], Mode::sub (d, Mode::mul (s1, s2)),
                                              JUCE_LOAD_SRC1_SRC2_DEST,
                                              JUCE_INCREMENT_SRC1_SRC2_DEST, )
@@ -877,6 +1173,8 @@ void JUCE_CALLTYPE FloatVectorOperations::convertFixedToFloat (float* dest, cons
                                   vmulq_n_f32 (vcvtq_f32_s32 (vld1q_s32 (src)), multiplier),
                                   JUCE_LOAD_NONE, JUCE_INCREMENT_SRC_DEST, )
    #else
+    JUCE_USE_AVX_IF_AVAILABLE (convertFixedToFloat, dest, src, multiplier, num)
+
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = (float) src[i] * multiplier,
                                   Mode::mul (mult, _mm_cvtepi32_ps (_mm_loadu_si128 (reinterpret_cast<const __m128i*> (src)))),
                                   JUCE_LOAD_NONE, JUCE_INCREMENT_SRC_DEST,
@@ -886,6 +1184,8 @@ void JUCE_CALLTYPE FloatVectorOperations::convertFixedToFloat (float* dest, cons
 
 void JUCE_CALLTYPE FloatVectorOperations::min (float* dest, const float* src, float comp, int num) noexcept
 {
+    JUCE_USE_AVX_IF_AVAILABLE (min, dest, src, comp, num)
+
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = jmin (src[i], comp), Mode::min (s, cmp),
                                   JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST,
                                   const Mode::ParallelType cmp = Mode::load1 (comp);)
@@ -893,6 +1193,8 @@ void JUCE_CALLTYPE FloatVectorOperations::min (float* dest, const float* src, fl
 
 void JUCE_CALLTYPE FloatVectorOperations::min (double* dest, const double* src, double comp, int num) noexcept
 {
+    JUCE_USE_AVX_IF_AVAILABLE (min, dest, src, comp, num)
+
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = jmin (src[i], comp), Mode::min (s, cmp),
                                   JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST,
                                   const Mode::ParallelType cmp = Mode::load1 (comp);)
@@ -903,6 +1205,8 @@ void JUCE_CALLTYPE FloatVectorOperations::min (float* dest, const float* src1, c
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vmin ((float*) src1, 1, (float*) src2, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_USE_AVX_IF_AVAILABLE (min, dest, src1, src2, num)
+
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = jmin (src1[i], src2[i]), Mode::min (s1, s2), JUCE_LOAD_SRC1_SRC2, JUCE_INCREMENT_SRC1_SRC2_DEST, )
    #endif
 }
@@ -912,12 +1216,16 @@ void JUCE_CALLTYPE FloatVectorOperations::min (double* dest, const double* src1,
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vminD ((double*) src1, 1, (double*) src2, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_USE_AVX_IF_AVAILABLE (min, dest, src1, src2, num)
+
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = jmin (src1[i], src2[i]), Mode::min (s1, s2), JUCE_LOAD_SRC1_SRC2, JUCE_INCREMENT_SRC1_SRC2_DEST, )
    #endif
 }
 
 void JUCE_CALLTYPE FloatVectorOperations::max (float* dest, const float* src, float comp, int num) noexcept
 {
+    JUCE_USE_AVX_IF_AVAILABLE (max, dest, src, comp, num)
+
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = jmax (src[i], comp), Mode::max (s, cmp),
                                   JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST,
                                   const Mode::ParallelType cmp = Mode::load1 (comp);)
@@ -925,6 +1233,8 @@ void JUCE_CALLTYPE FloatVectorOperations::max (float* dest, const float* src, fl
 
 void JUCE_CALLTYPE FloatVectorOperations::max (double* dest, const double* src, double comp, int num) noexcept
 {
+    JUCE_USE_AVX_IF_AVAILABLE (max, dest, src, comp, num)
+
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = jmax (src[i], comp), Mode::max (s, cmp),
                                   JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST,
                                   const Mode::ParallelType cmp = Mode::load1 (comp);)
@@ -935,6 +1245,8 @@ void JUCE_CALLTYPE FloatVectorOperations::max (float* dest, const float* src1, c
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vmax ((float*) src1, 1, (float*) src2, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_USE_AVX_IF_AVAILABLE (max, dest, src1, src2, num)
+
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = jmax (src1[i], src2[i]), Mode::max (s1, s2), JUCE_LOAD_SRC1_SRC2, JUCE_INCREMENT_SRC1_SRC2_DEST, )
    #endif
 }
@@ -944,6 +1256,8 @@ void JUCE_CALLTYPE FloatVectorOperations::max (double* dest, const double* src1,
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vmaxD ((double*) src1, 1, (double*) src2, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_USE_AVX_IF_AVAILABLE (max, dest, src1, src2, num)
+
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = jmax (src1[i], src2[i]), Mode::max (s1, s2), JUCE_LOAD_SRC1_SRC2, JUCE_INCREMENT_SRC1_SRC2_DEST, )
    #endif
 }
@@ -955,6 +1269,8 @@ void JUCE_CALLTYPE FloatVectorOperations::clip (float* dest, const float* src, f
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vclip ((float*) src, 1, &low, &high, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_USE_AVX_IF_AVAILABLE (clip, dest, src, low, high, num)
+
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = jmax (jmin (src[i], high), low), Mode::max (Mode::min (s, hi), lo),
                                   JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST,
                                   const Mode::ParallelType lo = Mode::load1 (low); const Mode::ParallelType hi = Mode::load1 (high);)
@@ -968,6 +1284,8 @@ void JUCE_CALLTYPE FloatVectorOperations::clip (double* dest, const double* src,
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vclipD ((double*) src, 1, &low, &high, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_USE_AVX_IF_AVAILABLE (clip, dest, src, low, high, num)
+
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = jmax (jmin (src[i], high), low), Mode::max (Mode::min (s, hi), lo),
                                   JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST,
                                   const Mode::ParallelType lo = Mode::load1 (low); const Mode::ParallelType hi = Mode::load1 (high);)
@@ -976,6 +1294,11 @@ void JUCE_CALLTYPE FloatVectorOperations::clip (double* dest, const double* src,
 
 Range<float> JUCE_CALLTYPE FloatVectorOperations::findMinAndMax (const float* src, int num) noexcept
 {
+   #if JUCE_USE_AVX_INTRINSICS
+    if (FloatVectorHelpers::isAVXWorthUsing (num))
+        return FloatVectorHelpers::AVX<float>::findMinAndMax (src, num);
+   #endif
+
    #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
     return FloatVectorHelpers::MinMax<FloatVectorHelpers::BasicOps32>::findMinAndMax (src, num);
    #else
@@ -985,6 +1308,11 @@ Range<float> JUCE_CALLTYPE FloatVectorOperations::findMinAndMax (const float* sr
 
 Range<double> JUCE_CALLTYPE FloatVectorOperations::findMinAndMax (const double* src, int num) noexcept
 {
+   #if JUCE_USE_AVX_INTRINSICS
+    if (FloatVectorHelpers::isAVXWorthUsing (num))
+        return FloatVectorHelpers::AVX<double>::findMinAndMax (src, num);
+   #endif
+
    #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
     return FloatVectorHelpers::MinMax<FloatVectorHelpers::BasicOps64>::findMinAndMax (src, num);
    #else
@@ -994,6 +1322,11 @@ Range<double> JUCE_CALLTYPE FloatVectorOperations::findMinAndMax (const double*
 
 float JUCE_CALLTYPE FloatVectorOperations::findMinimum (const float* src, int num) noexcept
 {
+   #if JUCE_USE_AVX_INTRINSICS
+    if (FloatVectorHelpers::isAVXWorthUsing (num))
+        return FloatVectorHelpers::AVX<float>::findMinOrMax (src, num, true);
+   #endif
+
    #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
     return FloatVectorHelpers::MinMax<FloatVectorHelpers::BasicOps32>::findMinOrMax (src, num, true);
    #else
@@ -1003,6 +1336,11 @@ float JUCE_CALLTYPE FloatVectorOperations::findMinimum (const float* src, int nu
 
 double JUCE_CALLTYPE FloatVectorOperations::findMinimum (const double* src, int num) noexcept
 {
+   #if JUCE_USE_AVX_INTRINSICS
+    if (FloatVectorHelpers::isAVXWorthUsing (num))
+        return FloatVectorHelpers::AVX<double>::findMinOrMax (src, num, true);
+   #endif
+
    #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
     return FloatVectorHelpers::MinMax<FloatVectorHelpers::BasicOps64>::findMinOrMax (src, num, true);
    #else
@@ -1012,6 +1350,11 @@ double JUCE_CALLTYPE FloatVectorOperations::findMinimum (const double* src, int
 
 float JUCE_CALLTYPE FloatVectorOperations::findMaximum (const float* src, int num) noexcept
 {
+   #if JUCE_USE_AVX_INTRINSICS
+    if (FloatVectorHelpers::isAVXWorthUsing (num))
+        return FloatVectorHelpers::AVX<float>::findMinOrMax (src, num, false);
+   #endif
+
    #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
     return FloatVectorHelpers::MinMax<FloatVectorHelpers::BasicOps32>::findMinOrMax (src, num, false);
    #else
@@ -1021,6 +1364,11 @@ float JUCE_CALLTYPE FloatVectorOperations::findMaximum (const float* src, int nu
 
 double JUCE_CALLTYPE FloatVectorOperations::findMaximum (const double* src, int num) noexcept
 {
+   #if JUCE_USE_AVX_INTRINSICS
+    if (FloatVectorHelpers::isAVXWorthUsing (num))
+        return FloatVectorHelpers::AVX<double>::findMinOrMax (src, num, false);
+   #endif
+
    #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
     return FloatVectorHelpers::MinMax<FloatVectorHelpers::BasicOps64>::findMinOrMax (src, num, false);
    #else
@@ -1233,6 +1581,37 @@ public:
             FloatVectorOperations::fill (data2, (ValueType) 3, num);
             FloatVectorOperations::addWithMultiply (data1, data1, data2, num);
             u.expect (areAllValuesEqual (data1, num, (ValueType) 8));
+
+            FloatVectorOperations::subtractWithMultiply (data1, data2, (ValueType) 2, num);
+            u.expect (areAllValuesEqual (data1, num, (ValueType) 2));
+
+            FloatVectorOperations::subtractWithMultiply (data1, data2, data2, num);
+            u.expect (areAllValuesEqual (data1, num, (ValueType) -7));
+
+            FloatVectorOperations::max (data1, data1, (ValueType) -6, num);
+            u.expect (areAllValuesEqual (data1, num, (ValueType) -6));
+
+            FloatVectorOperations::min (data2, data2, (ValueType) -5, num);
+            u.expect (areAllValuesEqual (data2, num, (ValueType) -5));
+
+            FloatVectorOperations::max (data2, data1, data2, num);
+            u.expect (areAllValuesEqual (data2, num, (ValueType) -5));
+
+            FloatVectorOperations::min (data2, data1, data2, num);
+            u.expect (areAllValuesEqual (data2, num, (ValueType) -6));
+
+            fillRandomly (random, data1, num);
+            FloatVectorOperations::clip (data2, data1, (ValueType) 250, (ValueType) 750, num);
+            u.expect (isClipped (data2, data1, num, (ValueType) 250, (ValueType) 750));
+        }
+
+        static bool isClipped (const ValueType* clipped, const ValueType* original, int num, ValueType low, ValueType high)
+        {
+            for (int i = 0; i < num; ++i)
+                if (clipped[i] != jlimit (low, high, original[i]))
+                    return false;
+
+            return true;
         }
 
         static void doConversionTest (UnitTest& u, float* data1, float* data2, int* const int1, int num)
@@ -1286,6 +1665,111 @@ public:
         }
     };
 
+   #if JUCE_USE_AVX_INTRINSICS
+    // Runs the same operations with and without the AVX kernels, on random unaligned buffers
+    template <typename ValueType>
+    struct AVXComparison
+    {
+        using Buffer = std::vector<ValueType>;
+
+        AVXComparison (UnitTest& ut, Random& r)  : u (ut), random (r)
+        {
+            num = 16 + random.nextInt (random.nextBool() ? 1000 : 64);
+            offset = random.nextInt (8);
+
+            for (auto* b : { &src1, &src2, &dest })
+            {
+                b->resize ((size_t) (num + offset));
+
+                for (auto& v : *b)
+                    v = (ValueType) (random.nextDouble() * 2000.0 - 1000.0);
+            }
+
+            for (int i = 0; i < num + offset; ++i)
+                ints.push_back (random.nextInt());
+        }
+
+        // The fused multiply-adds only round once, so may differ in the last bits of the largest
+        // intermediate term, whose size is given by maxTermSize. The other operations must match exactly.
+        template <typename Operation>
+        void compareBuffers (Operation&& op, double maxTermSize = 0)
+        {
+            Buffer withAVX (dest), withoutAVX (dest);
+
+            op (withAVX.data() + offset);
+            setAVXEnabled (false);
+            op (withoutAVX.data() + offset);
+            setAVXEnabled (true);
+
+            auto tolerance = maxTermSize * std::numeric_limits<ValueType>::epsilon() * 2;
+
+            for (int i = offset; i < num + offset; ++i)
+            {
+                auto a = withAVX[(size_t) i], b = withoutAVX[(size_t) i];
+
+                if (std::abs ((double) a - (double) b) > tolerance)
+                {
+                    u.expect (false, "AVX result differs at index " + String (i - offset));
+                    return;
+                }
+            }
+        }
+
+        template <typename Operation>
+        void compareResults (Operation&& op)
+        {
+            auto withAVX = op();
+            setAVXEnabled (false);
+            auto withoutAVX = op();
+            setAVXEnabled (true);
+
+            u.expect (withAVX == withoutAVX);
+        }
+
+        void run()
+        {
+            auto* s1 = src1.data() + offset;
+            auto* s2 = src2.data() + offset;
+            auto* d  = dest.data() + offset;
+            auto n = num;
+
+            compareBuffers ([=] (ValueType* r) { FloatVectorOperations::addWithMultiply (r, s1, (ValueType) 0.3, n); }, 1300.0);
+            compareBuffers ([=] (ValueType* r) { FloatVectorOperations::addWithMultiply (r, s1, s2, n); }, 1001000.0);
+            compareBuffers ([=] (ValueType* r) { FloatVectorOperations::subtractWithMultiply (r, s1, (ValueType) 0.3, n); }, 1300.0);
+            compareBuffers ([=] (ValueType* r) { FloatVectorOperations::subtractWithMultiply (r, s1, s2, n); }, 1001000.0);
+            compareBuffers ([=] (ValueType* r) { FloatVectorOperations::min (r, s1, (ValueType) 12.5, n); });
+            compareBuffers ([=] (ValueType* r) { FloatVectorOperations::min (r, s1, s2, n); });
+            compareBuffers ([=] (ValueType* r) { FloatVectorOperations::max (r, s1, (ValueType) -12.5, n); });
+            compareBuffers ([=] (ValueType* r) { FloatVectorOperations::max (r, s1, s2, n); });
+            compareBuffers ([=] (ValueType* r) { FloatVectorOperations::clip (r, s1, (ValueType) -250, (ValueType) 750, n); });
+            compareResults ([=] { return FloatVectorOperations::findMinimum (s1, n); });
+            compareResults ([=] { return FloatVectorOperations::findMaximum (s1, n); });
+            compareResults ([=] { return FloatVectorOperations::findMinAndMax (s1, n); });
+            compareConversion (d);
+        }
+
+        void compareConversion (float*)
+        {
+            auto* i = ints.data() + offset;
+            auto n = num;
+            compareBuffers ([=] (float* r) { FloatVectorOperations::convertFixedToFloat (r, i, 1.0f / 0x7fffffff, n); });
+        }
+
+        void compareConversion (double*) {}
+
+        static void setAVXEnabled (bool shouldBeEnabled)
+        {
+            FloatVectorHelpers::getAVXEnabledFlag() = shouldBeEnabled;
+        }
+
+        UnitTest& u;
+        Random& random;
+        Buffer src1, src2, dest;
+        std::vector<int> ints;
+        int num = 0, offset = 0;
+    };
+   #endif
+
     void runTest() override
     {
         beginTest ("FloatVectorOperations");
@@ -1295,6 +1779,26 @@ public:
             TestRunner<float>::runTest (*this, getRandom());
             TestRunner<double>::runTest (*this, getRandom());
         }
+
+       #if JUCE_USE_AVX_INTRINSICS
+        if (SystemStats::hasAVX() && SystemStats::hasFMA3())
+        {
+            beginTest ("The AVX and SSE paths give the same results");
+
+            expect (FloatVectorHelpers::getAVXEnabledFlag().load());
+            auto random = getRandom();
+
+            for (int i = 200; --i >= 0;)
+            {
+                AVXComparison<float> (*this, random).run();
+                AVXComparison<double> (*this, random).run();
+            }
+        }
+        else
+        {
+            logMessage ("This CPU or OS doesn't support AVX and FMA, so the AVX paths can't be tested");
+        }
+       #endif
     }
 };
 
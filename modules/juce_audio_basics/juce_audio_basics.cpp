@@ -39,6 +39,14 @@
  #include <emmintrin.h>
 #endif
 
+#ifndef JUCE_USE_AVX_INTRINSICS
+ #define JUCE_USE_AVX_INTRINSICS (JUCE_USE_SSE_INTRINSICS && (JUCE_GCC || JUCE_CLANG || JUCE_MSVC))
+#endif
+
+#if JUCE_USE_AVX_INTRINSICS
+ #include <immintrin.h>
+#endif
+
 #ifndef JUCE_USE_VDSP_FRAMEWORK
  #define JUCE_USE_VDSP_FRAMEWORK 1
 #endif
@@ -59,6 +67,7 @@
 #include "buffers/juce_AudioProcessLoadMeasurer.cpp"
 #include "utilities/juce_IIRFilter.cpp"
 #include "utilities/juce_LagrangeInterpolator.cpp"
+#include "utilities/juce_PolyphaseResampler.cpp"
 #include "utilities/juce_CatmullRomInterpolator.cpp"
 #include "utilities/juce_SmoothedValue.cpp"
 #include "midi/juce_MidiBuffer.cpp"
@@ -82,6 +91,7 @@
 #include "sources/juce_MemoryAudioSource.cpp"
 #include "sources/juce_MixerAudioSource.cpp"
 #include "sources/juce_ResamplingAudioSource.cpp"
+#include "sources/juce_PolyphaseResamplingAudioSource.cpp"
 #include "sources/juce_ReverbAudioSource.cpp"
 #include "sources/juce_ToneGeneratorAudioSource.cpp"
 #include "synthesisers/juce_Synthesiser.cpp"
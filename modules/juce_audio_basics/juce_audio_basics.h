@@ -88,6 +88,7 @@
 #include "utilities/juce_Decibels.h"
 #include "utilities/juce_IIRFilter.h"
 #include "utilities/juce_LagrangeInterpolator.h"
+#include "utilities/juce_PolyphaseResampler.h"
 #include "utilities/juce_CatmullRomInterpolator.h"
 #include "utilities/juce_SmoothedValue.h"
 #include "utilities/juce_Reverb.h"
@@ -115,6 +116,7 @@
 #include "sources/juce_MemoryAudioSource.h"
 #include "sources/juce_MixerAudioSource.h"
 #include "sources/juce_ResamplingAudioSource.h"
+#include "sources/juce_PolyphaseResamplingAudioSource.h"
 #include "sources/juce_ReverbAudioSource.h"
 #include "sources/juce_ToneGeneratorAudioSource.h"
 #include "synthesisers/juce_Synthesiser.h"
@@ -89,11 +89,15 @@ namespace MidiBufferHelpers
 MidiBuffer::MidiBuffer() noexcept {}
 MidiBuffer::~MidiBuffer() {}
 
-MidiBuffer::MidiBuffer (const MidiBuffer& other) noexcept  : data (other.data) {}
+MidiBuffer::MidiBuffer (const MidiBuffer& other) noexcept
+    : data (other.data), lastEventOffset (other.lastEventOffset)
+{
+}
 
 MidiBuffer& MidiBuffer::operator= (const MidiBuffer& other) noexcept
 {
     data = other.data;
+    lastEventOffset = other.lastEventOffset;
     return *this;
 }
 
@@ -102,8 +106,18 @@ MidiBuffer::MidiBuffer (const MidiMessage& message) noexcept
     addEvent (message, 0);
 }
 
-void MidiBuffer::swapWith (MidiBuffer& other) noexcept      { data.swapWith (other.data); }
-void MidiBuffer::clear() noexcept                           { data.clearQuick(); }
+void MidiBuffer::swapWith (MidiBuffer& other) noexcept
+{
+    data.swapWith (other.data);
+    std::swap (lastEventOffset, other.lastEventOffset);
+}
+
+void MidiBuffer::clear() noexcept
+{
+    data.clearQuick();
+    lastEventOffset = -1;
+}
+
 void MidiBuffer::ensureSize (size_t minimumNumBytes)        { data.ensureStorageAllocated ((int) minimumNumBytes); }
 bool MidiBuffer::isEmpty() const noexcept                   { return data.size() == 0; }
 
@@ -113,6 +127,37 @@ void MidiBuffer::clear (const int startSample, const int numSamples)
     uint8* const end   = MidiBufferHelpers::findEventAfter (start,        data.end(), startSample + numSamples - 1);
 
     data.removeRange ((int) (start - data.begin()), (int) (end - data.begin()));
+    lastEventOffset = -1;
+}
+
+int MidiBuffer::getLastEventOffset() const noexcept
+{
+    auto size = data.size();
+
+    if (size == 0)
+        return -1;
+
+    // The data is public, so the cached position is only trusted if the event
+    // there still ends exactly where the data does.
+    if (lastEventOffset >= 0
+         && lastEventOffset + (int) (sizeof (int32) + sizeof (uint16)) <= size
+         && lastEventOffset + MidiBufferHelpers::getEventTotalSize (data.begin() + lastEventOffset) == size)
+        return lastEventOffset;
+
+    auto* const endData = data.end();
+
+    for (auto* d = data.begin();;)
+    {
+        auto* const nextOne = d + MidiBufferHelpers::getEventTotalSize (d);
+
+        if (nextOne >= endData)
+        {
+            lastEventOffset = (int) (d - data.begin());
+            return lastEventOffset;
+        }
+
+        d = nextOne;
+    }
 }
 
 void MidiBuffer::addEvent (const MidiMessage& m, const int sampleNumber)
@@ -127,9 +172,15 @@ void MidiBuffer::addEvent (const void* const newData, const int maxBytes, const
     if (numBytes > 0)
     {
         const size_t newItemSize = (size_t) numBytes + sizeof (int32) + sizeof (uint16);
-        const int offset = (int) (MidiBufferHelpers::findEventAfter (data.begin(), data.end(), sampleNumber) - data.begin());
+        const int lastOffset = getLastEventOffset();
+        const bool isAppending = lastOffset < 0 || MidiBufferHelpers::getEventTime (data.begin() + lastOffset) <= sampleNumber;
+
+        // events that arrive in time order can go straight on the end, without searching for their position
+        const int offset = isAppending ? data.size()
+                                       : (int) (MidiBufferHelpers::findEventAfter (data.begin(), data.end(), sampleNumber) - data.begin());
 
         data.insertMultiple (offset, 0, (int) newItemSize);
+        lastEventOffset = isAppending ? offset : lastOffset + (int) newItemSize;
 
         uint8* const d = data.begin() + offset;
         writeUnaligned<int32>  (d, sampleNumber);
@@ -143,17 +194,69 @@ void MidiBuffer::addEvents (const MidiBuffer& otherBuffer,
                             const int numSamples,
                             const int sampleDeltaToAdd)
 {
-    Iterator i (otherBuffer);
-    i.setNextSamplePosition (startSample);
+    jassert (&otherBuffer != this); // can't add a buffer's events to itself!
+
+    auto* const sourceStart = MidiBufferHelpers::findEventAfter (otherBuffer.data.begin(), otherBuffer.data.end(), startSample - 1);
+    auto* const sourceEnd = numSamples < 0 ? otherBuffer.data.end()
+                                           : MidiBufferHelpers::findEventAfter (sourceStart, otherBuffer.data.end(), startSample + numSamples - 1);
 
-    const uint8* eventData;
-    int eventSize, position;
+    const int numNewBytes = (int) (sourceEnd - sourceStart);
 
-    while (i.getNextEvent (eventData, eventSize, position)
-            && (position < startSample + numSamples || numSamples < 0))
+    if (numNewBytes <= 0)
+        return;
+
+    const int oldSize = data.size();
+    const int lastOffset = getLastEventOffset();
+
+    if (lastOffset < 0 || MidiBufferHelpers::getEventTime (data.begin() + lastOffset)
+                            <= MidiBufferHelpers::getEventTime (sourceStart) + sampleDeltaToAdd)
     {
-        addEvent (eventData, eventSize, position + sampleDeltaToAdd);
+        // All the new events come after the existing ones, so they can just be appended
+        data.insertMultiple (oldSize, 0, numNewBytes);
+        memcpy (data.begin() + oldSize, sourceStart, (size_t) numNewBytes);
+
+        for (auto* d = data.begin() + oldSize; d < data.end(); d += MidiBufferHelpers::getEventTotalSize (d))
+        {
+            writeUnaligned<int32> (d, MidiBufferHelpers::getEventTime (d) + sampleDeltaToAdd);
+            lastEventOffset = (int) (d - data.begin());
+        }
+
+        return;
+    }
+
+    // Otherwise, the existing events are moved up out of the way, and the two sets of events
+    // are merged back into the space in front of them. The write position can never overtake
+    // the existing events that are still to be merged, because there's exactly enough room
+    // for the new events in between.
+    data.insertMultiple (0, 0, numNewBytes);
+
+    auto* dest = data.begin();
+    auto* existing = dest + numNewBytes;
+    auto* const existingEnd = data.end();
+    int lastNewEventOffset = 0;
+
+    for (auto* source = sourceStart; source < sourceEnd;)
+    {
+        const int newTime = MidiBufferHelpers::getEventTime (source) + sampleDeltaToAdd;
+
+        // events that are already in the buffer go before any new ones at the same time
+        while (existing < existingEnd && MidiBufferHelpers::getEventTime (existing) <= newTime)
+        {
+            auto size = MidiBufferHelpers::getEventTotalSize (existing);
+            memmove (dest, existing, size);
+            dest += size;
+            existing += size;
+        }
+
+        auto size = MidiBufferHelpers::getEventTotalSize (source);
+        memcpy (dest, source, size);
+        writeUnaligned<int32> (dest, newTime);
+        lastNewEventOffset = (int) (dest - data.begin());
+        dest += size;
+        source += size;
     }
+
+    lastEventOffset = existing < existingEnd ? lastOffset + numNewBytes : lastNewEventOffset;
 }
 
 int MidiBuffer::getNumEvents() const noexcept
@@ -174,20 +277,48 @@ int MidiBuffer::getFirstEventTime() const noexcept
 
 int MidiBuffer::getLastEventTime() const noexcept
 {
-    if (data.size() == 0)
-        return 0;
+    auto lastOffset = getLastEventOffset();
+    return lastOffset >= 0 ? MidiBufferHelpers::getEventTime (data.begin() + lastOffset) : 0;
+}
 
-    const uint8* const endData = data.end();
+//==============================================================================
+MidiBufferIterator MidiBuffer::cbegin() const noexcept
+{
+    return MidiBufferIterator (data.begin());
+}
 
-    for (const uint8* d = data.begin();;)
+MidiBufferIterator MidiBuffer::cend() const noexcept
+{
+    return MidiBufferIterator (data.end());
+}
+
+MidiBufferIterator MidiBuffer::findNextSamplePosition (int samplePosition) const noexcept
+{
+    return std::find_if (cbegin(), cend(), [samplePosition] (const MidiMessageMetadata& metadata) noexcept
     {
-        const uint8* const nextOne = d + MidiBufferHelpers::getEventTotalSize (d);
+        return metadata.samplePosition >= samplePosition;
+    });
+}
 
-        if (nextOne >= endData)
-            return MidiBufferHelpers::getEventTime (d);
+//==============================================================================
+MidiBufferIterator& MidiBufferIterator::operator++() noexcept
+{
+    data += MidiBufferHelpers::getEventTotalSize (data);
+    return *this;
+}
 
-        d = nextOne;
-    }
+MidiBufferIterator MidiBufferIterator::operator++ (int) noexcept
+{
+    auto copy = *this;
+    ++(*this);
+    return copy;
+}
+
+MidiMessageMetadata MidiBufferIterator::operator*() const noexcept
+{
+    return { data + sizeof (int32) + sizeof (uint16),
+             MidiBufferHelpers::getEventDataSize (data),
+             MidiBufferHelpers::getEventTime (data) };
 }
 
 //==============================================================================
@@ -234,4 +365,164 @@ bool MidiBuffer::Iterator::getNextEvent (MidiMessage& result, int& samplePositio
     return true;
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct MidiBufferTest  : public UnitTest
+{
+    MidiBufferTest()
+        : UnitTest ("MidiBuffer", UnitTestCategories::midi)
+    {}
+
+    // A simple model of the buffer: the events in the order that they should come out
+    using Reference = std::vector<std::pair<int, MidiMessage>>;
+
+    static void addToReference (Reference& reference, const MidiMessage& message, int time)
+    {
+        auto pos = std::upper_bound (reference.begin(), reference.end(), time,
+                                     [] (int t, const std::pair<int, MidiMessage>& e) { return t < e.first; });
+        reference.insert (pos, { time, message });
+    }
+
+    void expectMatches (const MidiBuffer& buffer, const Reference& reference)
+    {
+        size_t index = 0;
+
+        for (const auto metadata : buffer)
+        {
+            if (index >= reference.size())
+                break;
+
+            auto& expected = reference[index++];
+            expectEquals (metadata.samplePosition, expected.first);
+            expectEquals (metadata.numBytes, expected.second.getRawDataSize());
+            expect (memcmp (metadata.data, expected.second.getRawData(), (size_t) metadata.numBytes) == 0);
+        }
+
+        expectEquals ((int) index, (int) reference.size());
+        expectEquals (buffer.getNumEvents(), (int) reference.size());
+        expectEquals (buffer.getLastEventTime(), reference.empty() ? 0 : reference.back().first);
+    }
+
+    static MidiMessage createRandomMessage (Random& r)
+    {
+        switch (r.nextInt (3))
+        {
+            case 0:   return MidiMessage::noteOn (1 + r.nextInt (16), r.nextInt (128), (uint8) r.nextInt (128));
+            case 1:   return MidiMessage::pitchWheel (1 + r.nextInt (16), r.nextInt (0x4000));
+            default:  return MidiMessage::channelPressureChange (1 + r.nextInt (16), r.nextInt (128));
+        }
+    }
+
+    void runTest() override
+    {
+        auto r = getRandom();
+
+        beginTest ("Events are kept in order");
+        {
+            MidiBuffer buffer;
+            Reference reference;
+
+            for (int i = 0; i < 500; ++i)
+            {
+                // mostly in order, with the occasional event that has to be inserted earlier
+                auto time = r.nextInt (8) == 0 ? r.nextInt (i + 1) : i;
+                auto message = createRandomMessage (r);
+
+                buffer.addEvent (message, time);
+                addToReference (reference, message, time);
+            }
+
+            expectMatches (buffer, reference);
+
+            auto copy = buffer;
+            copy.addEvent (MidiMessage::noteOff (1, 10), 1000);
+            addToReference (reference, MidiMessage::noteOff (1, 10), 1000);
+            expectMatches (copy, reference);
+        }
+
+        beginTest ("Adding events from another buffer");
+        {
+            for (int iteration = 0; iteration < 50; ++iteration)
+            {
+                MidiBuffer buffer, other;
+                Reference reference, otherReference;
+
+                for (int i = 0; i < 100; ++i)
+                {
+                    auto message = createRandomMessage (r);
+                    auto time = r.nextInt (200);
+                    buffer.addEvent (message, time);
+                    addToReference (reference, message, time);
+
+                    message = createRandomMessage (r);
+                    time = r.nextInt (200);
+                    other.addEvent (message, time);
+                    addToReference (otherReference, message, time);
+                }
+
+                auto startSample = r.nextInt (200);
+                auto numSamples = r.nextInt (10) == 0 ? -1 : r.nextInt (200);
+                auto delta = r.nextInt (2) == 0 ? r.nextInt (400) - 200 : 250;
+
+                for (auto& e : otherReference)
+                    if (e.first >= startSample && (numSamples < 0 || e.first < startSample + numSamples))
+                        addToReference (reference, e.second, e.first + delta);
+
+                buffer.addEvents (other, startSample, numSamples, delta);
+                expectMatches (buffer, reference);
+            }
+        }
+
+        beginTest ("Iterating from a sample position");
+        {
+            MidiBuffer buffer;
+
+            for (int i = 0; i < 10; ++i)
+                buffer.addEvent (MidiMessage::noteOn (1, 60, 1.0f), i * 10);
+
+            expectEquals ((*buffer.findNextSamplePosition (25)).samplePosition, 30);
+            expect (buffer.findNextSamplePosition (91) == buffer.end());
+            expectEquals ((int) std::distance (buffer.findNextSamplePosition (40), buffer.end()), 6);
+
+           #if JUCE_GCC
+            #pragma GCC diagnostic push
+            #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+           #elif JUCE_CLANG
+            #pragma clang diagnostic push
+            #pragma clang diagnostic ignored "-Wdeprecated-declarations"
+           #elif JUCE_MSVC
+            #pragma warning (push, 0)
+            #pragma warning (disable: 4996)
+           #endif
+
+            MidiBuffer::Iterator iterator (buffer);
+            iterator.setNextSamplePosition (40);
+            MidiMessage message;
+            int position;
+
+            for (auto it = buffer.findNextSamplePosition (40); it != buffer.end(); ++it)
+            {
+                expect (iterator.getNextEvent (message, position));
+                expectEquals ((*it).samplePosition, position);
+            }
+
+            expect (! iterator.getNextEvent (message, position));
+
+           #if JUCE_GCC
+            #pragma GCC diagnostic pop
+           #elif JUCE_CLANG
+            #pragma clang diagnostic pop
+           #elif JUCE_MSVC
+            #pragma warning (pop)
+           #endif
+        }
+    }
+};
+
+static MidiBufferTest midiBufferTest;
+
+#endif
+
 } // namespace juce
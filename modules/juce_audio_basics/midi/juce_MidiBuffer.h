@@ -23,6 +23,85 @@
 namespace juce
 {
 
+//==============================================================================
+/**
+    A view of a midi event which is held in a MidiBuffer.
+
+    The data pointer refers directly to the buffer's internal storage, so it's only
+    valid until the buffer is modified.
+
+    @see MidiBuffer, MidiBufferIterator
+
+    @tags{Audio}
+*/
+struct JUCE_API  MidiMessageMetadata  final
+{
+    MidiMessageMetadata() noexcept = default;
+
+    MidiMessageMetadata (const uint8* dataIn, int numBytesIn, int positionIn) noexcept
+        : data (dataIn), numBytes (numBytesIn), samplePosition (positionIn)
+    {
+    }
+
+    /** Creates a MidiMessage for this event, whose timestamp is set to the sample position. */
+    MidiMessage getMessage() const                          { return MidiMessage (data, numBytes, samplePosition); }
+
+    /** A pointer to the raw midi data of the event. */
+    const uint8* data = nullptr;
+
+    /** The number of bytes of midi data in the event. */
+    int numBytes = 0;
+
+    /** The sample position of the event. */
+    int samplePosition = 0;
+};
+
+//==============================================================================
+/**
+    An iterator which moves through the events in a MidiBuffer, without copying them.
+
+    Note that altering the buffer while an iterator is using it will produce
+    undefined behaviour.
+
+    @see MidiBuffer
+
+    @tags{Audio}
+*/
+class JUCE_API  MidiBufferIterator
+{
+public:
+    //==============================================================================
+    using difference_type   = std::ptrdiff_t;
+    using value_type        = MidiMessageMetadata;
+    using reference         = MidiMessageMetadata;
+    using pointer           = void;
+    using iterator_category = std::forward_iterator_tag;
+
+    /** Creates an iterator which doesn't refer to any buffer. */
+    MidiBufferIterator() noexcept = default;
+
+    /** Creates an iterator which refers to the event starting at the given address.
+        You'll probably want to use MidiBuffer::begin() and MidiBuffer::end() instead.
+    */
+    explicit MidiBufferIterator (const uint8* dataIn) noexcept  : data (dataIn) {}
+
+    //==============================================================================
+    /** Moves the iterator on to the next event. */
+    MidiBufferIterator& operator++() noexcept;
+
+    /** Moves the iterator on to the next event, returning its previous position. */
+    MidiBufferIterator operator++ (int) noexcept;
+
+    /** Returns a view of the event that the iterator is currently pointing at. */
+    MidiMessageMetadata operator*() const noexcept;
+
+    bool operator== (const MidiBufferIterator& other) const noexcept    { return data == other.data; }
+    bool operator!= (const MidiBufferIterator& other) const noexcept    { return data != other.data; }
+
+private:
+    const uint8* data = nullptr;
+};
+
 //==============================================================================
 /**
     Holds a sequence of time-stamped midi events.
@@ -70,7 +149,7 @@ public:
     void clear (int start, int numSamples);
 
     /** Returns true if the buffer is empty.
-        To actually retrieve the events, use a MidiBuffer::Iterator object
+        To actually retrieve the events, iterate over the buffer with begin() and end().
     */
     bool isEmpty() const noexcept;
 
@@ -90,8 +169,10 @@ public:
 
         If an event is added whose sample position is the same as one or more events
         already in the buffer, the new event will be placed after the existing ones.
+        Adding an event at or after the last event in the buffer is a constant-time
+        operation, so it's quickest to add events in time order.
 
-        To retrieve events, use a MidiBuffer::Iterator object
+        To retrieve events, iterate over the buffer with begin() and end().
     */
     void addEvent (const MidiMessage& midiMessage, int sampleNumber);
 
@@ -109,7 +190,7 @@ public:
         it'll actually only store 3 bytes. If the midi data is invalid, it might not
         add an event at all.
 
-        To retrieve events, use a MidiBuffer::Iterator object
+        To retrieve events, iterate over the buffer with begin() and end().
     */
     void addEvent (const void* rawMidiData,
                    int maxBytesOfMidiData,
@@ -117,6 +198,10 @@ public:
 
     /** Adds some events from another buffer to this one.
 
+        The new events are merged with the existing ones in a single pass, so this takes
+        time proportional to the total size of both buffers, and it won't allocate if
+        enough space has been reserved with ensureSize().
+
         @param otherBuffer          the buffer containing the events you want to add
         @param startSample          the lowest sample number in the source buffer for which
                                     events should be added. Any source events whose timestamp is
@@ -158,10 +243,39 @@ public:
     */
     void ensureSize (size_t minimumNumBytes);
 
+    //==============================================================================
+    /** Returns an iterator pointing at the first event in the buffer.
+
+        This lets you use a range-based for loop to look at the events without copying them:
+        @code
+        for (const auto metadata : midiBuffer)
+            doSomething (metadata.getMessage(), metadata.samplePosition);
+        @endcode
+    */
+    MidiBufferIterator cbegin() const noexcept;
+
+    /** Returns an iterator pointing just past the last event in the buffer. */
+    MidiBufferIterator cend() const noexcept;
+
+    /** Returns an iterator pointing at the first event in the buffer. */
+    MidiBufferIterator begin() const noexcept                   { return cbegin(); }
+
+    /** Returns an iterator pointing just past the last event in the buffer. */
+    MidiBufferIterator end() const noexcept                     { return cend(); }
+
+    /** Returns an iterator pointing at the first event whose sample position is greater
+        than or equal to the given position, or end() if there isn't one.
+    */
+    MidiBufferIterator findNextSamplePosition (int samplePosition) const noexcept;
+
     //==============================================================================
     /**
         Used to iterate through the events in a MidiBuffer.
 
+        This class is deprecated - iterate over the buffer with a range-based for
+        loop (or begin() and end()) instead, and use findNextSamplePosition() to start
+        part-way through it.
+
         Note that altering the buffer while an iterator is using it will produce
         undefined behaviour.
 
@@ -172,7 +286,7 @@ public:
     public:
         //==============================================================================
         /** Creates an Iterator for this MidiBuffer. */
-        Iterator (const MidiBuffer&) noexcept;
+        JUCE_DEPRECATED (Iterator (const MidiBuffer&) noexcept);
 
         /** Creates a copy of an iterator. */
         Iterator (const Iterator&) = default;
@@ -231,6 +345,11 @@ public:
     Array<uint8> data;
 
 private:
+    // the offset of the last event, so that events can be appended without searching for the end
+    mutable int lastEventOffset = -1;
+
+    int getLastEventOffset() const noexcept;
+
     JUCE_LEAK_DETECTOR (MidiBuffer)
 };
 
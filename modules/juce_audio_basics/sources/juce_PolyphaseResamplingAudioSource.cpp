@@ -0,0 +1,326 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+PolyphaseResamplingAudioSource::PolyphaseResamplingAudioSource (PositionableAudioSource* const inputSource,
+                                                                const bool deleteInputWhenDeleted,
+                                                                const int channels,
+                                                                PolyphaseResampler::Quality quality)
+    : input (inputSource, deleteInputWhenDeleted),
+      resampler (channels, quality),
+      numChannels (channels)
+{
+    jassert (input != nullptr);
+    destBuffers.calloc (numChannels);
+}
+
+PolyphaseResamplingAudioSource::~PolyphaseResamplingAudioSource() {}
+
+constexpr double PolyphaseResamplingAudioSource::maxResamplingRatio;
+
+void PolyphaseResamplingAudioSource::setResamplingRatio (const double samplesInPerOutputSample)
+{
+    jassert (samplesInPerOutputSample > 0);
+
+    // Anything higher would need more input per block than prepareToPlay() allowed for
+    jassert (samplesInPerOutputSample <= maxResamplingRatio);
+
+    const SpinLock::ScopedLockType sl (ratioLock);
+    ratio = jlimit (1.0e-6, maxResamplingRatio, samplesInPerOutputSample);
+}
+
+int PolyphaseResamplingAudioSource::getLatencyInInputSamples() const noexcept
+{
+    return resampler.getLatencyInInputSamples();
+}
+
+void PolyphaseResamplingAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
+    const SpinLock::ScopedLockType sl (ratioLock);
+
+    auto scaledBlockSize = roundToInt (samplesPerBlockExpected * ratio);
+    input->prepareToPlay (scaledBlockSize, sampleRate * ratio);
+
+    const ScopedLock cl (callbackLock);
+    maxBlockSize = jmax (1, samplesPerBlockExpected);
+
+    // This is enough for a block at the highest ratio, including the first block after
+    // a reset, which also has to fill the look-ahead of the longest kernel.
+    const auto maxInputPerBlock = (int) std::ceil ((maxBlockSize + 1) * maxResamplingRatio)
+                                    + resampler.getMaxLatencyInInputSamples() + 2;
+
+    inputBuffer.setSize (numChannels, maxInputPerBlock);
+    resampler.prepare (maxInputPerBlock);
+    lastRatio = ratio;
+}
+
+void PolyphaseResamplingAudioSource::flushBuffers()
+{
+    const ScopedLock sl (callbackLock);
+    resampler.reset();
+}
+
+void PolyphaseResamplingAudioSource::releaseResources()
+{
+    input->releaseResources();
+
+    const ScopedLock sl (callbackLock);
+    inputBuffer.setSize (numChannels, 0);
+    maxBlockSize = 0;
+}
+
+void PolyphaseResamplingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
+{
+    const ScopedLock sl (callbackLock);
+
+    // prepareToPlay() must be called first, as that's where the buffers are allocated
+    if (maxBlockSize == 0)
+    {
+        jassertfalse;
+        info.clearActiveBufferRegion();
+        return;
+    }
+
+    double localRatio;
+
+    {
+        const SpinLock::ScopedLockType ratioSl (ratioLock);
+        localRatio = ratio;
+    }
+
+    const auto startRatio = lastRatio;
+    lastRatio = localRatio;
+
+    // Blocks that are bigger than prepareToPlay() was told about are done in
+    // pieces, with the ratio ramp shared out between them.
+    for (int done = 0; done < info.numSamples;)
+    {
+        const auto num = jmin (maxBlockSize, info.numSamples - done);
+
+        resampleBlock (*info.buffer, info.startSample + done, num,
+                       startRatio + (localRatio - startRatio) * done / info.numSamples,
+                       startRatio + (localRatio - startRatio) * (done + num) / info.numSamples);
+        done += num;
+    }
+
+    for (int channel = numChannels; channel < info.buffer->getNumChannels(); ++channel)
+        info.buffer->clear (channel, info.startSample, info.numSamples);
+
+    nextPlayPos += info.numSamples;
+}
+
+void PolyphaseResamplingAudioSource::resampleBlock (AudioBuffer<float>& dest, int startSample, int numSamples,
+                                                    double startRatio, double endRatio)
+{
+    auto numNeeded = resampler.getNumInputSamplesNeeded (startRatio, endRatio, numSamples);
+
+    if (numNeeded > 0)
+    {
+        // This can't happen unless the ratio has somehow got above maxResamplingRatio
+        jassert (numNeeded <= inputBuffer.getNumSamples());
+        numNeeded = jmin (numNeeded, inputBuffer.getNumSamples());
+
+        AudioSourceChannelInfo readInfo (&inputBuffer, 0, numNeeded);
+        input->getNextAudioBlock (readInfo);
+
+        resampler.pushSamples (inputBuffer.getArrayOfReadPointers(), numNeeded);
+    }
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        destBuffers[channel] = channel < dest.getNumChannels() ? dest.getWritePointer (channel, startSample)
+                                                               : nullptr;
+
+    const auto numDone = resampler.process (destBuffers, numSamples, startRatio, endRatio);
+    jassert (numDone == numSamples);
+
+    for (int channel = 0; channel < jmin (numChannels, dest.getNumChannels()); ++channel)
+        dest.clear (channel, startSample + numDone, numSamples - numDone);
+}
+
+//==============================================================================
+void PolyphaseResamplingAudioSource::setNextReadPosition (int64 newPosition)
+{
+    const ScopedLock sl (callbackLock);
+
+    double localRatio;
+
+    {
+        const SpinLock::ScopedLockType ratioSl (ratioLock);
+        localRatio = ratio;
+    }
+
+    nextPlayPos = newPosition;
+    input->setNextReadPosition ((int64) std::llround (newPosition * localRatio));
+    resampler.reset();
+    lastRatio = localRatio;
+}
+
+int64 PolyphaseResamplingAudioSource::getNextReadPosition() const
+{
+    return nextPlayPos;
+}
+
+int64 PolyphaseResamplingAudioSource::getTotalLength() const
+{
+    const SpinLock::ScopedLockType sl (ratioLock);
+    return (int64) (input->getTotalLength() / ratio);
+}
+
+bool PolyphaseResamplingAudioSource::isLooping() const
+{
+    return input->isLooping();
+}
+
+void PolyphaseResamplingAudioSource::setLooping (bool shouldLoop)
+{
+    input->setLooping (shouldLoop);
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class PolyphaseResamplingAudioSourceTests  : public UnitTest
+{
+public:
+    PolyphaseResamplingAudioSourceTests()  : UnitTest ("PolyphaseResamplingAudioSource", UnitTestCategories::audio) {}
+
+    void runTest() override
+    {
+        beginTest ("The output follows the input at a constant ratio");
+        {
+            for (auto ratio : { 0.5, 44100.0 / 48000.0, 1.0, 1.5, 3.0 })
+            {
+                SineSource sine;
+                PolyphaseResamplingAudioSource source (&sine, false);
+                source.setResamplingRatio (ratio);
+                source.prepareToPlay (256, 44100.0);
+                source.setNextReadPosition (1000);
+
+                expectLessThan (getMaxError (source, 1000, ratio, 256, 16), 1.0e-4, "ratio " + String (ratio));
+            }
+        }
+
+        beginTest ("Blocks bigger than the prepared size are split up");
+        {
+            SineSource sine;
+            PolyphaseResamplingAudioSource source (&sine, false);
+            source.setResamplingRatio (1.5);
+            source.prepareToPlay (64, 44100.0);
+
+            expectLessThan (getMaxError (source, 0, 1.5, 1000, 4), 1.0e-4);
+            expect (sine.bufferPointers.size() == 1);
+        }
+
+        beginTest ("Raising the ratio doesn't reallocate anything");
+        {
+            SineSource sine;
+            PolyphaseResamplingAudioSource source (&sine, false);
+            source.prepareToPlay (512, 44100.0);
+
+            AudioBuffer<float> output (2, 512);
+
+            for (auto ratio = 0.25; ratio < PolyphaseResamplingAudioSource::maxResamplingRatio * 1.2; ratio *= 1.2)
+            {
+                source.setResamplingRatio (jmin (ratio, PolyphaseResamplingAudioSource::maxResamplingRatio));
+                source.getNextAudioBlock (AudioSourceChannelInfo (output));
+            }
+
+            source.setNextReadPosition (0);
+            source.getNextAudioBlock (AudioSourceChannelInfo (output));
+
+            expect (sine.bufferPointers.size() == 1);
+            expectGreaterThan (sine.largestRead, 512 * 15);
+        }
+    }
+
+private:
+    // Plays a different sine on each channel, and keeps track of the buffers it's given
+    struct SineSource  : public PositionableAudioSource
+    {
+        static float getSample (int channel, double position)
+        {
+            return (float) std::sin ((channel == 0 ? 0.05 : 0.11) * position);
+        }
+
+        void prepareToPlay (int, double) override {}
+        void releaseResources() override {}
+
+        void getNextAudioBlock (const AudioSourceChannelInfo& info) override
+        {
+            bufferPointers.addIfNotAlreadyThere (info.buffer->getReadPointer (0));
+            largestRead = jmax (largestRead, info.numSamples);
+
+            for (int ch = 0; ch < info.buffer->getNumChannels(); ++ch)
+                for (int i = 0; i < info.numSamples; ++i)
+                    info.buffer->setSample (ch, info.startSample + i, getSample (ch, (double) (position + i)));
+
+            position += info.numSamples;
+        }
+
+        void setNextReadPosition (int64 newPosition) override    { position = newPosition; }
+        int64 getNextReadPosition() const override              { return position; }
+        int64 getTotalLength() const override                   { return std::numeric_limits<int>::max(); }
+        bool isLooping() const override                         { return false; }
+
+        int64 position = 0;
+        Array<const float*> bufferPointers;
+        int largestRead = 0;
+    };
+
+    // Compares the output with the ideal values at the input positions that it should
+    // land on, skipping the start, where the kernel overlaps the silence before the input.
+    static double getMaxError (PolyphaseResamplingAudioSource& source, int64 startPosition,
+                               double ratio, int blockSize, int numBlocks)
+    {
+        AudioBuffer<float> output (2, blockSize);
+        const auto firstInput = (double) std::llround ((double) startPosition * ratio);
+        double maxError = 0;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            source.getNextAudioBlock (AudioSourceChannelInfo (output));
+
+            // (the kernel's length depends on the ratio, so this is only known once it's playing)
+            const auto numToSkip = 2 * source.getLatencyInInputSamples();
+
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const auto inputOffset = (block * blockSize + i) * ratio;
+
+                if (inputOffset > numToSkip)
+                    for (int ch = 0; ch < 2; ++ch)
+                        maxError = jmax (maxError, (double) std::abs (output.getSample (ch, i) - SineSource::getSample (ch, firstInput + inputOffset)));
+            }
+        }
+
+        return maxError;
+    }
+};
+
+static PolyphaseResamplingAudioSourceTests polyphaseResamplingAudioSourceTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A PositionableAudioSource that resamples another PositionableAudioSource
+    using a PolyphaseResampler.
+
+    This does the same job as ResamplingAudioSource, but with a windowed-sinc
+    filter instead of an IIR filter and interpolator, so it's far cleaner, and
+    all the channels are processed together. The ratio can be changed while
+    playing, and it's ramped smoothly across each block.
+
+    Positions and lengths are all given in output samples, and are mapped onto
+    the input source using the current ratio.
+
+    The source reads getLatencyInInputSamples() samples ahead of the position
+    that it's playing, so that its output stays aligned with the input, i.e.
+    when you seek to a position, the first sample you get back is centred on the
+    corresponding input sample.
+
+    The ratio can't be set higher than maxResamplingRatio. All the memory that's
+    needed to play blocks of the size given to prepareToPlay() at that ratio is
+    allocated there, so getNextAudioBlock() never allocates. Any bigger blocks
+    are processed in several pieces.
+
+    @see PolyphaseResampler, ResamplingAudioSource
+
+    @tags{Audio}
+*/
+class JUCE_API  PolyphaseResamplingAudioSource  : public PositionableAudioSource
+{
+public:
+    //==============================================================================
+    /** Creates a PolyphaseResamplingAudioSource for a given input source.
+
+        @param inputSource              the input source to read from
+        @param deleteInputWhenDeleted   if true, the input source will be deleted when
+                                        this object is deleted
+        @param numChannels              the number of channels to process
+        @param quality                  the resampler's quality preset
+    */
+    PolyphaseResamplingAudioSource (PositionableAudioSource* inputSource,
+                                    bool deleteInputWhenDeleted,
+                                    int numChannels = 2,
+                                    PolyphaseResampler::Quality quality = PolyphaseResampler::Quality::high);
+
+    /** Destructor. */
+    ~PolyphaseResamplingAudioSource() override;
+
+    /** The highest resampling ratio that can be used, which is also the point
+        beyond which the resampler stops lowering its cutoff.
+    */
+    static constexpr double maxResamplingRatio = 16.0;
+
+    /** Changes the resampling ratio.
+
+        (This value can be changed at any time, even while the source is running).
+
+        @param samplesInPerOutputSample     if set to 1.0, the input is passed through; higher
+                                            values will speed it up; lower values will slow it
+                                            down. The ratio must be greater than 0, and
+                                            will be clipped to maxResamplingRatio
+    */
+    void setResamplingRatio (double samplesInPerOutputSample);
+
+    /** Returns the current resampling ratio.
+
+        This is the value that was set by setResamplingRatio().
+    */
+    double getResamplingRatio() const noexcept                  { return ratio; }
+
+    /** Returns the number of input samples that the source is currently reading
+        ahead of its output.
+    */
+    int getLatencyInInputSamples() const noexcept;
+
+    /** Clears any buffers and filters that the resampler is using. */
+    void flushBuffers();
+
+    //==============================================================================
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock (const AudioSourceChannelInfo&) override;
+
+    void setNextReadPosition (int64 newPosition) override;
+    int64 getNextReadPosition() const override;
+    int64 getTotalLength() const override;
+    bool isLooping() const override;
+    void setLooping (bool shouldLoop) override;
+
+private:
+    //==============================================================================
+    OptionalScopedPointer<PositionableAudioSource> input;
+    PolyphaseResampler resampler;
+    AudioBuffer<float> inputBuffer;
+    HeapBlock<float*> destBuffers;
+    double ratio = 1.0, lastRatio = 1.0;
+    int64 nextPlayPos = 0;
+    int maxBlockSize = 0;
+    const int numChannels;
+    SpinLock ratioLock;
+    CriticalSection callbackLock;
+
+    void resampleBlock (AudioBuffer<float>&, int startSample, int numSamples, double startRatio, double endRatio);
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PolyphaseResamplingAudioSource)
+};
+
+} // namespace juce
@@ -27,7 +27,10 @@ namespace juce
 /**
     A type of AudioSource that takes an input source and changes its sample rate.
 
-    @see AudioSource, LagrangeInterpolator, CatmullRomInterpolator
+    This uses a simple IIR filter and interpolator, so it's cheap but not very
+    clean. For better quality, use a PolyphaseResamplingAudioSource.
+
+    @see AudioSource, LagrangeInterpolator, CatmullRomInterpolator, PolyphaseResamplingAudioSource
 
     @tags{Audio}
 */
@@ -72,11 +72,27 @@ void SynthesiserVoice::renderNextBlock (AudioBuffer<double>& outputBuffer,
     subBuffer.makeCopyOf (tempBuffer, true);
 }
 
+void SynthesiserVoice::renderNextBlockForGroup (SynthesiserVoice* const* voicesToRender, int numVoices,
+                                                AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+{
+    for (int i = 0; i < numVoices; ++i)
+        voicesToRender[i]->renderNextBlock (outputBuffer, startSample, numSamples);
+}
+
+void SynthesiserVoice::renderNextBlockForGroup (SynthesiserVoice* const* voicesToRender, int numVoices,
+                                                AudioBuffer<double>& outputBuffer, int startSample, int numSamples)
+{
+    for (int i = 0; i < numVoices; ++i)
+        voicesToRender[i]->renderNextBlock (outputBuffer, startSample, numSamples);
+}
+
 //==============================================================================
 Synthesiser::Synthesiser()
 {
     for (int i = 0; i < numElementsInArray (lastPitchWheelValues); ++i)
         lastPitchWheelValues[i] = 0x2000;
+
+    queuedMidi.malloc (queuedMidiFifo.getTotalSize());
 }
 
 Synthesiser::~Synthesiser()
@@ -100,6 +116,11 @@ SynthesiserVoice* Synthesiser::addVoice (SynthesiserVoice* const newVoice)
 {
     const ScopedLock sl (lock);
     newVoice->setCurrentPlaybackSampleRate (sampleRate);
+
+    // make sure that grouping the voices won't need to allocate while rendering
+    activeVoices.ensureStorageAllocated (voices.size() + 1);
+    voiceGroup.ensureStorageAllocated (voices.size() + 1);
+
     return voices.add (newVoice);
 }
 
@@ -132,6 +153,70 @@ void Synthesiser::setNoteStealingEnabled (const bool shouldSteal)
     shouldStealNotes = shouldSteal;
 }
 
+void Synthesiser::setVoiceGroupRenderingEnabled (const bool shouldRenderVoicesInGroups)
+{
+    const ScopedLock sl (lock);
+    renderVoicesInGroups = shouldRenderVoicesInGroups;
+}
+
+//==============================================================================
+bool Synthesiser::addMidiMessageToQueue (const MidiMessage& message)
+{
+    auto size = message.getRawDataSize();
+
+    // only short messages can be queued!
+    jassert (size > 0 && size <= 3);
+
+    if (size <= 0 || size > 3)
+        return false;
+
+    auto* data = message.getRawData();
+    auto packed = (uint32) size << 24;
+
+    for (int i = 0; i < size; ++i)
+        packed |= (uint32) data[i] << (8 * i);
+
+    // The write lock only stops different threads from adding messages at the same
+    // time - the audio thread never needs to take it.
+    const SpinLock::ScopedLockType sl (queuedMidiWriteLock);
+
+    int start1, size1, start2, size2;
+    queuedMidiFifo.prepareToWrite (1, start1, size1, start2, size2);
+
+    if (size1 + size2 == 0)
+        return false;
+
+    queuedMidi[size1 > 0 ? start1 : start2] = packed;
+    queuedMidiFifo.finishedWrite (1);
+    return true;
+}
+
+void Synthesiser::handleQueuedMidiMessages()
+{
+    auto numReady = queuedMidiFifo.getNumReady();
+
+    if (numReady == 0)
+        return;
+
+    int start1, size1, start2, size2;
+    queuedMidiFifo.prepareToRead (numReady, start1, size1, start2, size2);
+
+    auto handleQueuedMessages = [this] (int start, int num)
+    {
+        for (int i = start; i < start + num; ++i)
+        {
+            auto packed = queuedMidi[i];
+            const uint8 data[] = { (uint8) packed, (uint8) (packed >> 8), (uint8) (packed >> 16) };
+
+            handleMidiEvent (MidiMessage (data, (int) (packed >> 24), 0.0));
+        }
+    };
+
+    handleQueuedMessages (start1, size1);
+    handleQueuedMessages (start2, size2);
+    queuedMidiFifo.finishedRead (size1 + size2);
+}
+
 void Synthesiser::setMinimumRenderingSubdivisionSize (int numSamples, bool shouldBeStrict) noexcept
 {
     jassert (numSamples > 0); // it wouldn't make much sense for this to be less than 1
@@ -163,18 +248,17 @@ void Synthesiser::processNextBlock (AudioBuffer<floatType>& outputAudio,
     jassert (sampleRate != 0);
     const int targetChannels = outputAudio.getNumChannels();
 
-    MidiBuffer::Iterator midiIterator (midiData);
-    midiIterator.setNextSamplePosition (startSample);
+    auto midiIterator = midiData.findNextSamplePosition (startSample);
 
     bool firstEvent = true;
-    int midiEventPos;
-    MidiMessage m;
 
     const ScopedLock sl (lock);
 
-    while (numSamples > 0)
+    handleQueuedMidiMessages();
+
+    for (; numSamples > 0; ++midiIterator)
     {
-        if (! midiIterator.getNextEvent (m, midiEventPos))
+        if (midiIterator == midiData.cend())
         {
             if (targetChannels > 0)
                 renderVoices (outputAudio, startSample, numSamples);
@@ -182,20 +266,22 @@ void Synthesiser::processNextBlock (AudioBuffer<floatType>& outputAudio,
             return;
         }
 
-        const int samplesToNextMidiMessage = midiEventPos - startSample;
+        const auto metadata = *midiIterator;
+        const int samplesToNextMidiMessage = metadata.samplePosition - startSample;
 
         if (samplesToNextMidiMessage >= numSamples)
         {
             if (targetChannels > 0)
                 renderVoices (outputAudio, startSample, numSamples);
 
-            handleMidiEvent (m);
+            handleMidiEvent (metadata.getMessage());
+            ++midiIterator;
             break;
         }
 
         if (samplesToNextMidiMessage < ((firstEvent && ! subBlockSubdivisionIsStrict) ? 1 : minimumSubBlockSize))
         {
-            handleMidiEvent (m);
+            handleMidiEvent (metadata.getMessage());
             continue;
         }
 
@@ -204,13 +290,13 @@ void Synthesiser::processNextBlock (AudioBuffer<floatType>& outputAudio,
         if (targetChannels > 0)
             renderVoices (outputAudio, startSample, samplesToNextMidiMessage);
 
-        handleMidiEvent (m);
+        handleMidiEvent (metadata.getMessage());
         startSample += samplesToNextMidiMessage;
         numSamples  -= samplesToNextMidiMessage;
     }
 
-    while (midiIterator.getNextEvent (m, midiEventPos))
-        handleMidiEvent (m);
+    for (; midiIterator != midiData.cend(); ++midiIterator)
+        handleMidiEvent ((*midiIterator).getMessage());
 }
 
 // explicit template instantiation
@@ -231,16 +317,64 @@ void Synthesiser::renderNextBlock (AudioBuffer<double>& outputAudio, const MidiB
 
 void Synthesiser::renderVoices (AudioBuffer<float>& buffer, int startSample, int numSamples)
 {
+    if (renderVoicesInGroups)
+    {
+        renderVoiceGroups (buffer, startSample, numSamples);
+        return;
+    }
+
     for (auto* voice : voices)
         voice->renderNextBlock (buffer, startSample, numSamples);
 }
 
 void Synthesiser::renderVoices (AudioBuffer<double>& buffer, int startSample, int numSamples)
 {
+    if (renderVoicesInGroups)
+    {
+        renderVoiceGroups (buffer, startSample, numSamples);
+        return;
+    }
+
     for (auto* voice : voices)
         voice->renderNextBlock (buffer, startSample, numSamples);
 }
 
+template <typename floatType>
+void Synthesiser::renderVoiceGroups (AudioBuffer<floatType>& buffer, int startSample, int numSamples)
+{
+    activeVoices.clearQuick();
+
+    for (auto* voice : voices)
+        if (voice->isVoiceActive())
+            activeVoices.add (voice);
+
+    auto* remainingVoices = activeVoices.begin();
+    auto numRemaining = activeVoices.size();
+
+    // pull out all the voices that share the class of the first remaining one, until none are left
+    while (numRemaining > 0)
+    {
+        auto& voiceType = typeid (*remainingVoices[0]);
+        voiceGroup.clearQuick();
+        int numLeft = 0;
+
+        for (int i = 0; i < numRemaining; ++i)
+        {
+            auto* voice = remainingVoices[i];
+
+            if (typeid (*voice) == voiceType)
+                voiceGroup.add (voice);
+            else
+                remainingVoices[numLeft++] = voice;
+        }
+
+        numRemaining = numLeft;
+
+        voiceGroup.getFirst()->renderNextBlockForGroup (voiceGroup.begin(), voiceGroup.size(),
+                                                        buffer, startSample, numSamples);
+    }
+}
+
 void Synthesiser::handleMidiEvent (const MidiMessage& m)
 {
     const int channel = m.getChannel();
@@ -583,4 +717,139 @@ SynthesiserVoice* Synthesiser::findVoiceToSteal (SynthesiserSound* soundToPlay,
     return low;
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class SynthesiserTests  : public UnitTest
+{
+public:
+    SynthesiserTests()
+        : UnitTest ("Synthesiser", UnitTestCategories::audio)
+    {}
+
+    struct TestSound  : public SynthesiserSound
+    {
+        bool appliesToNote (int) override       { return true; }
+        bool appliesToChannel (int) override    { return true; }
+    };
+
+    // Writes a ramp whose slope depends on the note, and stops after a fixed length
+    struct TestVoice  : public SynthesiserVoice
+    {
+        bool canPlaySound (SynthesiserSound*) override      { return true; }
+        void startNote (int note, float, SynthesiserSound*, int) override   { slope = (float) note * 0.001f; position = 0; }
+        void stopNote (float, bool) override                { clearCurrentNote(); }
+        void pitchWheelMoved (int) override                 {}
+        void controllerMoved (int, int) override            {}
+
+        void renderNextBlock (AudioBuffer<float>& buffer, int startSample, int numSamples) override
+        {
+            if (! isVoiceActive())
+                return;
+
+            for (int i = startSample; i < startSample + numSamples; ++i)
+            {
+                buffer.addSample (0, i, slope * (float) position);
+
+                if (++position >= 1000)
+                {
+                    clearCurrentNote();
+                    break;
+                }
+            }
+        }
+
+        float slope = 0;
+        int position = 0;
+    };
+
+    struct GroupedTestVoice  : public TestVoice
+    {
+        GroupedTestVoice (int& numGroups, int& largestGroup)  : groupCount (numGroups), largestGroupSize (largestGroup) {}
+
+        void renderNextBlockForGroup (SynthesiserVoice* const* voicesToRender, int numVoices,
+                                      AudioBuffer<float>& buffer, int startSample, int numSamples) override
+        {
+            ++groupCount;
+            largestGroupSize = jmax (largestGroupSize, numVoices);
+            SynthesiserVoice::renderNextBlockForGroup (voicesToRender, numVoices, buffer, startSample, numSamples);
+        }
+
+        int& groupCount;
+        int& largestGroupSize;
+    };
+
+    static void render (Synthesiser& synth, AudioBuffer<float>& output)
+    {
+        output.clear();
+        MidiBuffer midi;
+
+        for (int i = 0; i < 12; ++i)
+            midi.addEvent (MidiMessage::noteOn (1, 40 + i * 3, 1.0f), i * 50);
+
+        midi.addEvent (MidiMessage::noteOff (1, 43), 700);
+        synth.renderNextBlock (output, midi, 0, output.getNumSamples());
+    }
+
+    void runTest() override
+    {
+        beginTest ("Rendering voices in groups gives the same results");
+        {
+            int numGroups = 0, largestGroup = 0;
+            Synthesiser synth, groupedSynth;
+            synth.addSound (new TestSound());
+            groupedSynth.addSound (new TestSound());
+
+            for (int i = 0; i < 16; ++i)
+            {
+                synth.addVoice (new TestVoice());
+                groupedSynth.addVoice (i % 2 == 0 ? static_cast<SynthesiserVoice*> (new TestVoice())
+                                                  : new GroupedTestVoice (numGroups, largestGroup));
+            }
+
+            synth.setCurrentPlaybackSampleRate (44100.0);
+            groupedSynth.setCurrentPlaybackSampleRate (44100.0);
+            groupedSynth.setVoiceGroupRenderingEnabled (true);
+            expect (groupedSynth.isVoiceGroupRenderingEnabled());
+
+            AudioBuffer<float> expected (1, 2048), actual (1, 2048);
+            render (synth, expected);
+            render (groupedSynth, actual);
+
+            expect (numGroups > 0);
+            expect (largestGroup > 1);
+
+            for (int i = 0; i < expected.getNumSamples(); ++i)
+                expectWithinAbsoluteError (actual.getSample (0, i), expected.getSample (0, i), 1.0e-3f);
+        }
+
+        beginTest ("Queued messages are handled in the next block");
+        {
+            Synthesiser synth;
+            synth.addSound (new TestSound());
+            synth.addVoice (new TestVoice());
+            synth.setCurrentPlaybackSampleRate (44100.0);
+
+            expect (synth.addMidiMessageToQueue (MidiMessage::noteOn (1, 60, 1.0f)));
+            expect (! synth.getVoice (0)->isVoiceActive());
+
+            AudioBuffer<float> buffer (1, 64);
+            buffer.clear();
+            synth.renderNextBlock (buffer, {}, 0, 64);
+
+            expectEquals (synth.getVoice (0)->getCurrentlyPlayingNote(), 60);
+            expect (buffer.getMagnitude (0, 64) > 0.0f);
+
+            expect (synth.addMidiMessageToQueue (MidiMessage::noteOff (1, 60)));
+            synth.renderNextBlock (buffer, {}, 0, 64);
+            expect (! synth.getVoice (0)->isVoiceActive());
+        }
+    }
+};
+
+static SynthesiserTests synthesiserTests;
+
+#endif
+
 } // namespace juce
@@ -192,6 +192,34 @@ public:
                                   int startSample,
                                   int numSamples);
 
+    /** Renders a group of active voices of the same class in a single call.
+
+        This is only used when Synthesiser::setVoiceGroupRenderingEnabled() has been
+        turned on. The synthesiser then gathers its active voices by class, and calls this
+        method on one of them, passing in the whole group (including itself). This lets a
+        voice class avoid the overhead of rendering each voice separately, and process
+        several voices at once, e.g. by packing their state into the lanes of a
+        dsp::SIMDRegister.
+
+        Each voice in the group must be rendered exactly as renderNextBlock() would have
+        done it, including calling clearCurrentNote() on any voices that finish. The
+        default implementation just calls renderNextBlock() on each voice in turn, so
+        grouping only helps voice classes that override this. The juce_dsp module's unit
+        tests include an example that renders its voices in batches of SIMDRegister lanes.
+    */
+    virtual void renderNextBlockForGroup (SynthesiserVoice* const* voicesToRender,
+                                          int numVoices,
+                                          AudioBuffer<float>& outputBuffer,
+                                          int startSample,
+                                          int numSamples);
+
+    /** A double-precision version of renderNextBlockForGroup() */
+    virtual void renderNextBlockForGroup (SynthesiserVoice* const* voicesToRender,
+                                          int numVoices,
+                                          AudioBuffer<double>& outputBuffer,
+                                          int startSample,
+                                          int numSamples);
+
     /** Changes the voice's reference sample rate.
 
         The rate is set so that subclasses know the output rate and can set their pitch
@@ -378,6 +406,37 @@ public:
     */
     bool isNoteStealingEnabled() const noexcept                     { return shouldStealNotes; }
 
+    /** If set to true, the default renderVoices() method will render the active voices in
+        groups of the same class, using SynthesiserVoice::renderNextBlockForGroup().
+
+        This only makes a difference if your voice class overrides renderNextBlockForGroup()
+        to render several voices more efficiently than it could render them one at a time.
+        Inactive voices aren't rendered at all while this is enabled.
+    */
+    void setVoiceGroupRenderingEnabled (bool shouldRenderVoicesInGroups);
+
+    /** Returns true if the voices are being rendered in groups.
+        @see setVoiceGroupRenderingEnabled
+    */
+    bool isVoiceGroupRenderingEnabled() const noexcept              { return renderVoicesInGroups; }
+
+    //==============================================================================
+    /** Queues a midi message to be handled at the start of the next block that is rendered.
+
+        Unlike calling noteOn() or the other event methods directly, this doesn't take the
+        synthesiser's lock, so it's a good way to inject notes from a UI or network thread
+        without holding up the audio thread. Only messages of up to 3 bytes can be queued.
+
+        The messages go into a fixed-size fifo. Threads that call this at the same time are
+        serialised by a SpinLock, but the audio thread never takes that lock: it reads the
+        queued messages while it holds the synthesiser's lock for the block, and handles them
+        just like those in the MidiBuffer, so noteOn() and the other event methods still run
+        under that (re-entrant) lock as usual.
+
+        Returns false if the message couldn't be queued, because the queue was full.
+    */
+    bool addMidiMessageToQueue (const MidiMessage& message);
+
     //==============================================================================
     /** Triggers a note-on event.
 
@@ -631,11 +690,23 @@ private:
     int minimumSubBlockSize = 32;
     bool subBlockSubdivisionIsStrict = false;
     bool shouldStealNotes = true;
+    bool renderVoicesInGroups = false;
     BigInteger sustainPedalsDown;
 
+    Array<SynthesiserVoice*> activeVoices, voiceGroup;
+
+    AbstractFifo queuedMidiFifo { 1024 };
+    HeapBlock<uint32> queuedMidi;
+    SpinLock queuedMidiWriteLock;
+
     template <typename floatType>
     void processNextBlock (AudioBuffer<floatType>&, const MidiBuffer&, int startSample, int numSamples);
 
+    template <typename floatType>
+    void renderVoiceGroups (AudioBuffer<floatType>&, int startSample, int numSamples);
+
+    void handleQueuedMidiMessages();
+
    #if JUCE_CATCH_DEPRECATED_CODE_MISUSE
     // Note the new parameters for these methods.
     virtual int findFreeVoice (const bool) const { return 0; }
@@ -0,0 +1,744 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace PolyphaseResamplerHelpers
+{
+    struct Spec
+    {
+        int numTaps, numPhases;
+        double beta;
+        float rolloff;  // cutoff as a proportion of Nyquist, chosen so that the stop-band starts at Nyquist
+    };
+
+    static Spec getSpec (PolyphaseResampler::Quality quality) noexcept
+    {
+        switch (quality)
+        {
+            case PolyphaseResampler::Quality::low:       return { 16,   64,  6.0, 0.75f };
+            case PolyphaseResampler::Quality::medium:    return { 32,  128,  8.0, 0.84f };
+            case PolyphaseResampler::Quality::veryHigh:  return { 128, 512, 12.0, 0.94f };
+            case PolyphaseResampler::Quality::high:
+            default:                                     return { 64,  256, 10.0, 0.90f };
+        }
+    }
+
+    // The cutoff is lowered in quarter-octave steps, down to a 16:1 ratio
+    enum { stepsPerOctave = 4, maxCutoffStep = 16, windowTableSize = 8192 };
+
+    static double getStretch (int step) noexcept
+    {
+        return std::pow (2.0, step / (double) stepsPerOctave);
+    }
+
+    static int getNumTaps (int baseNumTaps, int step) noexcept
+    {
+        return ((int) std::ceil (baseNumTaps * getStretch (step)) + 7) & ~7;
+    }
+
+    // The number of phases shrinks as the kernel is stretched, so the table
+    // stays roughly the same size whatever the cutoff.
+    static int getNumPhases (int baseNumPhases, int step) noexcept
+    {
+        return jmax (16, roundToInt (baseNumPhases / getStretch (step)));
+    }
+
+    static double besselI0 (double x) noexcept
+    {
+        double sum = 1.0, term = 1.0;
+        const auto halfX = x * 0.5;
+
+        for (int k = 1; k < 64; ++k)
+        {
+            term *= (halfX / k) * (halfX / k);
+            sum += term;
+
+            if (term < sum * 1.0e-12)
+                break;
+        }
+
+        return sum;
+    }
+
+    //==============================================================================
+    // Each phase's block holds its row followed by the difference to the next
+    // row. The row for the final phase isn't needed for itself, so it's built in
+    // the last delta slot, and then turned into the difference in place.
+    static void fillTable (float* coefficients, const float* window, float rolloff,
+                           int step, int numTaps, int numPhases) noexcept
+    {
+        const auto cutoff = rolloff / getStretch (step);
+        const auto halfLength = numTaps / 2;
+        const auto piCutoff = MathConstants<double>::pi * cutoff;
+        const auto stepSin = std::sin (-piCutoff);
+        const auto stepCos = std::cos (-piCutoff);
+
+        auto getRow = [=] (int phase)
+        {
+            return phase < numPhases ? coefficients + phase * 2 * numTaps
+                                     : coefficients + (numPhases * 2 - 1) * numTaps;
+        };
+
+        for (int phase = 0; phase <= numPhases; ++phase)
+        {
+            const auto t0 = phase / (double) numPhases + (halfLength - 1);
+            auto* row = getRow (phase);
+
+            // sin (pi * cutoff * t) for successive taps is generated by rotation,
+            // which avoids a call to std::sin for every coefficient.
+            auto s = std::sin (piCutoff * t0);
+            auto c = std::cos (piCutoff * t0);
+            double sum = 0;
+
+            for (int tap = 0; tap < numTaps; ++tap)
+            {
+                const auto t = t0 - tap;
+                const auto x = piCutoff * t;
+                const auto sinc = std::abs (x) < 1.0e-9 ? 1.0 : s / x;
+
+                const auto windowPos = jmin (1.0, std::abs (t) / halfLength) * windowTableSize;
+                const auto windowIndex = (int) windowPos;
+                const auto windowAlpha = windowPos - windowIndex;
+                const auto w = window[windowIndex] + windowAlpha * (window[windowIndex + 1] - window[windowIndex]);
+
+                const auto value = cutoff * sinc * w;
+                row[tap] = (float) value;
+                sum += value;
+
+                const auto nextS = s * stepCos + c * stepSin;
+                c = c * stepCos - s * stepSin;
+                s = nextS;
+            }
+
+            // Normalising each phase gives every fractional position exactly unity gain at DC
+            FloatVectorOperations::multiply (row, (float) (1.0 / sum), numTaps);
+        }
+
+        for (int phase = 0; phase < numPhases; ++phase)
+        {
+            auto* row = getRow (phase);
+            FloatVectorOperations::subtract (row + numTaps, getRow (phase + 1), row, numTaps);
+        }
+    }
+
+    //==============================================================================
+    // Each phase of the table holds a row of coefficients followed by the difference
+    // between it and the next phase's row, so the kernel for a position between two
+    // phases is row + alpha * delta. The kernel is worked out on the fly, and shared
+    // by both channels when they're done in pairs. The number of taps is always a
+    // multiple of 8.
+   #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+    using Ops = FloatVectorHelpers::BasicOps32;
+
+    static forcedinline float sum (Ops::ParallelType v) noexcept
+    {
+       #if JUCE_USE_SSE_INTRINSICS
+        v = _mm_add_ps (v, _mm_movehl_ps (v, v));
+        return _mm_cvtss_f32 (_mm_add_ss (v, _mm_shuffle_ps (v, v, 1)));
+       #else
+        float s[Ops::numParallel];
+        Ops::storeU (s, v);
+        return (s[0] + s[1]) + (s[2] + s[3]);
+       #endif
+    }
+
+    static void convolve (const float* src, float* dest, const float* row, const float* delta,
+                          float alpha, int numTaps) noexcept
+    {
+        const auto a = Ops::load1 (alpha);
+        auto acc0 = Ops::load1 (0), acc1 = acc0;
+
+        for (int i = 0; i < numTaps; i += 8)
+        {
+            const auto k0 = Ops::add (Ops::loadU (row + i),     Ops::mul (a, Ops::loadU (delta + i)));
+            const auto k1 = Ops::add (Ops::loadU (row + i + 4), Ops::mul (a, Ops::loadU (delta + i + 4)));
+
+            acc0 = Ops::add (acc0, Ops::mul (Ops::loadU (src + i),     k0));
+            acc1 = Ops::add (acc1, Ops::mul (Ops::loadU (src + i + 4), k1));
+        }
+
+        *dest = sum (Ops::add (acc0, acc1));
+    }
+
+    static void convolve (const float* src0, const float* src1, float* dest0, float* dest1,
+                          const float* row, const float* delta, float alpha, int numTaps) noexcept
+    {
+        const auto a = Ops::load1 (alpha);
+        auto acc00 = Ops::load1 (0), acc01 = acc00, acc10 = acc00, acc11 = acc00;
+
+        for (int i = 0; i < numTaps; i += 8)
+        {
+            const auto k0 = Ops::add (Ops::loadU (row + i),     Ops::mul (a, Ops::loadU (delta + i)));
+            const auto k1 = Ops::add (Ops::loadU (row + i + 4), Ops::mul (a, Ops::loadU (delta + i + 4)));
+
+            acc00 = Ops::add (acc00, Ops::mul (Ops::loadU (src0 + i),     k0));
+            acc01 = Ops::add (acc01, Ops::mul (Ops::loadU (src0 + i + 4), k1));
+            acc10 = Ops::add (acc10, Ops::mul (Ops::loadU (src1 + i),     k0));
+            acc11 = Ops::add (acc11, Ops::mul (Ops::loadU (src1 + i + 4), k1));
+        }
+
+        *dest0 = sum (Ops::add (acc00, acc01));
+        *dest1 = sum (Ops::add (acc10, acc11));
+    }
+   #else
+    static void convolve (const float* src, float* dest, const float* row, const float* delta,
+                          float alpha, int numTaps) noexcept
+    {
+        float total = 0;
+
+        for (int i = 0; i < numTaps; ++i)
+            total += src[i] * (row[i] + alpha * delta[i]);
+
+        *dest = total;
+    }
+
+    static void convolve (const float* src0, const float* src1, float* dest0, float* dest1,
+                          const float* row, const float* delta, float alpha, int numTaps) noexcept
+    {
+        convolve (src0, dest0, row, delta, alpha, numTaps);
+        convolve (src1, dest1, row, delta, alpha, numTaps);
+    }
+   #endif
+
+   #if JUCE_USE_AVX_INTRINSICS
+    using AVXOps = FloatVectorHelpers::AVXOps32;
+
+    static forcedinline JUCE_AVX_FMA_TARGET float sumAVX (AVXOps::ParallelType v) noexcept
+    {
+        auto s = _mm_add_ps (_mm256_castps256_ps128 (v), _mm256_extractf128_ps (v, 1));
+        s = _mm_add_ps (s, _mm_movehl_ps (s, s));
+        return _mm_cvtss_f32 (_mm_add_ss (s, _mm_shuffle_ps (s, s, 1)));
+    }
+
+    // Sums the elements of two vectors at once, returning them in the first two lanes
+    static forcedinline JUCE_AVX_FMA_TARGET __m128 sumAVX (AVXOps::ParallelType a, AVXOps::ParallelType b) noexcept
+    {
+        const auto h = _mm256_hadd_ps (a, b);
+        const auto s = _mm_add_ps (_mm256_castps256_ps128 (h), _mm256_extractf128_ps (h, 1));
+        return _mm_hadd_ps (s, s);
+    }
+
+    JUCE_AVX_FMA_TARGET static void convolveAVX (const float* src, float* dest, const float* row, const float* delta,
+                                                 float alpha, int numTaps) noexcept
+    {
+        const FloatVectorHelpers::AVX<float>::UpperStateClearer upperStateClearer;
+        const auto a = AVXOps::load1 (alpha);
+        auto acc0 = AVXOps::load1 (0), acc1 = acc0;
+        int i = 0;
+
+        for (; i + 16 <= numTaps; i += 16)
+        {
+            acc0 = AVXOps::mulAdd (AVXOps::loadU (src + i),     AVXOps::mulAdd (a, AVXOps::loadU (delta + i),     AVXOps::loadU (row + i)),     acc0);
+            acc1 = AVXOps::mulAdd (AVXOps::loadU (src + i + 8), AVXOps::mulAdd (a, AVXOps::loadU (delta + i + 8), AVXOps::loadU (row + i + 8)), acc1);
+        }
+
+        if (i < numTaps)
+            acc0 = AVXOps::mulAdd (AVXOps::loadU (src + i), AVXOps::mulAdd (a, AVXOps::loadU (delta + i), AVXOps::loadU (row + i)), acc0);
+
+        *dest = sumAVX (_mm256_add_ps (acc0, acc1));
+    }
+
+    JUCE_AVX_FMA_TARGET static void convolveAVX (const float* src0, const float* src1, float* dest0, float* dest1,
+                                                 const float* row, const float* delta, float alpha, int numTaps) noexcept
+    {
+        const FloatVectorHelpers::AVX<float>::UpperStateClearer upperStateClearer;
+        const auto a = AVXOps::load1 (alpha);
+        auto acc00 = AVXOps::load1 (0), acc01 = acc00, acc10 = acc00, acc11 = acc00;
+        int i = 0;
+
+        for (; i + 16 <= numTaps; i += 16)
+        {
+            const auto k0 = AVXOps::mulAdd (a, AVXOps::loadU (delta + i),     AVXOps::loadU (row + i));
+            const auto k1 = AVXOps::mulAdd (a, AVXOps::loadU (delta + i + 8), AVXOps::loadU (row + i + 8));
+
+            acc00 = AVXOps::mulAdd (AVXOps::loadU (src0 + i),     k0, acc00);
+            acc01 = AVXOps::mulAdd (AVXOps::loadU (src0 + i + 8), k1, acc01);
+            acc10 = AVXOps::mulAdd (AVXOps::loadU (src1 + i),     k0, acc10);
+            acc11 = AVXOps::mulAdd (AVXOps::loadU (src1 + i + 8), k1, acc11);
+        }
+
+        if (i < numTaps)
+        {
+            const auto k = AVXOps::mulAdd (a, AVXOps::loadU (delta + i), AVXOps::loadU (row + i));
+            acc00 = AVXOps::mulAdd (AVXOps::loadU (src0 + i), k, acc00);
+            acc10 = AVXOps::mulAdd (AVXOps::loadU (src1 + i), k, acc10);
+        }
+
+        const auto sums = sumAVX (_mm256_add_ps (acc00, acc01), _mm256_add_ps (acc10, acc11));
+        *dest0 = _mm_cvtss_f32 (sums);
+        *dest1 = _mm_cvtss_f32 (_mm_shuffle_ps (sums, sums, 1));
+    }
+   #endif
+}
+
+//==============================================================================
+// The tables for every cutoff step are built when the first resampler of a
+// quality is created, and shared by all the resamplers of that quality, so
+// that a change of ratio never has to do more than pick a different table.
+struct PolyphaseResampler::CoefficientTables
+{
+    using StepTables = HeapBlock<float>[PolyphaseResamplerHelpers::maxCutoffStep + 1];
+
+    const StepTables& getTables (Quality quality)
+    {
+        const ScopedLock sl (lock);
+        auto& tables = tablesForQuality[(int) quality];
+
+        if (tables == nullptr)
+            tables = createTables (quality);
+
+        return tables->steps;
+    }
+
+private:
+    struct TablesForQuality
+    {
+        StepTables steps;
+    };
+
+    static std::unique_ptr<TablesForQuality> createTables (Quality quality)
+    {
+        const auto spec = PolyphaseResamplerHelpers::getSpec (quality);
+        const int windowTableSize = PolyphaseResamplerHelpers::windowTableSize;
+
+        // The Kaiser window is tabulated once over [0, 1], so that building the
+        // filter for each cutoff doesn't need to evaluate any Bessel functions.
+        HeapBlock<float> window (windowTableSize + 2);
+        const auto scale = 1.0 / PolyphaseResamplerHelpers::besselI0 (spec.beta);
+
+        for (int i = 0; i <= windowTableSize; ++i)
+        {
+            const auto x = i / (double) windowTableSize;
+            window[i] = (float) (PolyphaseResamplerHelpers::besselI0 (spec.beta * std::sqrt (jmax (0.0, 1.0 - x * x))) * scale);
+        }
+
+        window[windowTableSize + 1] = 0;
+
+        std::unique_ptr<TablesForQuality> tables (new TablesForQuality());
+
+        for (int step = 0; step <= PolyphaseResamplerHelpers::maxCutoffStep; ++step)
+        {
+            const auto numTaps = PolyphaseResamplerHelpers::getNumTaps (spec.numTaps, step);
+            const auto numPhases = PolyphaseResamplerHelpers::getNumPhases (spec.numPhases, step);
+
+            tables->steps[step].malloc ((size_t) (numPhases * 2 * numTaps));
+            PolyphaseResamplerHelpers::fillTable (tables->steps[step], window, spec.rolloff, step, numTaps, numPhases);
+        }
+
+        return tables;
+    }
+
+    CriticalSection lock;
+    std::unique_ptr<TablesForQuality> tablesForQuality[4];
+};
+
+//==============================================================================
+PolyphaseResampler::PolyphaseResampler (int channels, Quality q)
+    : numChannels (channels),
+      quality (q),
+      baseNumTaps (PolyphaseResamplerHelpers::getSpec (q).numTaps),
+      baseNumPhases (PolyphaseResamplerHelpers::getSpec (q).numPhases),
+      maxNumTaps (PolyphaseResamplerHelpers::getNumTaps (baseNumTaps, PolyphaseResamplerHelpers::maxCutoffStep)),
+      stepTables (coefficientTables->getTables (q))
+{
+    jassert (numChannels > 0);
+
+    setCutoffStep (0);
+    prepare (1024);
+}
+
+PolyphaseResampler::~PolyphaseResampler() {}
+
+//==============================================================================
+void PolyphaseResampler::prepare (int maxInputSamplesPerPush)
+{
+    history.setSize (numChannels, jmax (history.getNumSamples(), maxInputSamplesPerPush + 2 * maxNumTaps), true, false, true);
+    reset();
+}
+
+void PolyphaseResampler::reset() noexcept
+{
+    // The history starts with enough silence for the first input sample to sit
+    // in the centre of the longest kernel that might be used.
+    history.clear();
+    numInHistory = maxNumTaps / 2 - 1;
+    position = numInHistory;
+}
+
+//==============================================================================
+int PolyphaseResampler::getNumTapsForStep (int step) const noexcept
+{
+    return PolyphaseResamplerHelpers::getNumTaps (baseNumTaps, step);
+}
+
+int PolyphaseResampler::getNumPhasesForStep (int step) const noexcept
+{
+    return PolyphaseResamplerHelpers::getNumPhases (baseNumPhases, step);
+}
+
+int PolyphaseResampler::getCutoffStepForRatio (double maxRatio) const noexcept
+{
+    // Rounding up keeps the cutoff low enough for the ratio, and a small amount
+    // of hysteresis stops a ratio that wobbles around a step boundary from
+    // repeatedly switching between two filters.
+    const auto exactStep = PolyphaseResamplerHelpers::stepsPerOctave * std::log2 (jmax (1.0, maxRatio));
+    const auto newStep = jlimit (0, (int) PolyphaseResamplerHelpers::maxCutoffStep, (int) std::ceil (exactStep - 1.0e-3));
+
+    if (newStep < cutoffStep && exactStep > cutoffStep - 1.25)
+        return cutoffStep;
+
+    return newStep;
+}
+
+void PolyphaseResampler::setCutoffStep (int newStep) noexcept
+{
+    cutoffStep = newStep;
+    numTaps = getNumTapsForStep (newStep);
+    numPhases = getNumPhasesForStep (newStep);
+    coefficients = stepTables[newStep];
+}
+
+//==============================================================================
+int PolyphaseResampler::getNumInputSamplesNeeded (double startRatio, double endRatio, int numOutputSamples) const noexcept
+{
+    if (numOutputSamples <= 0)
+        return 0;
+
+    // This must step through the positions in exactly the same way as process()
+    const auto rampStep = (endRatio - startRatio) / numOutputSamples;
+    auto pos = position;
+
+    for (int i = 0; i < numOutputSamples - 1; ++i)
+        pos += startRatio + rampStep * i;
+
+    const auto halfLength = getNumTapsForStep (getCutoffStepForRatio (jmax (startRatio, endRatio))) / 2;
+    return jmax (0, (int) pos + halfLength + 1 - numInHistory);
+}
+
+void PolyphaseResampler::pushSamples (const float* const* input, int numSamples)
+{
+    if (numSamples <= 0)
+        return;
+
+    if (numInHistory + numSamples > history.getNumSamples())
+    {
+        // Discard the samples that are now too old to fall under any kernel
+        const auto firstNeeded = jlimit (0, numInHistory, (int) position - maxNumTaps / 2 + 1);
+        const auto numToKeep = numInHistory - firstNeeded;
+
+        if (firstNeeded > 0)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto* data = history.getWritePointer (ch);
+                memmove (data, data + firstNeeded, (size_t) numToKeep * sizeof (float));
+            }
+
+            numInHistory = numToKeep;
+            position -= firstNeeded;
+        }
+
+        if (numInHistory + numSamples > history.getNumSamples())
+            history.setSize (numChannels, numInHistory + numSamples + maxNumTaps, true, false, true);
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        history.copyFrom (ch, numInHistory, input[ch], numSamples);
+
+    numInHistory += numSamples;
+}
+
+int PolyphaseResampler::process (float* const* output, int numOutputSamples, double startRatio, double endRatio) noexcept
+{
+    jassert (startRatio > 0 && endRatio > 0);
+
+    setCutoffStep (getCutoffStepForRatio (jmax (startRatio, endRatio)));
+
+    const auto rampStep = (endRatio - startRatio) / numOutputSamples;
+    const auto halfLength = numTaps / 2;
+    auto* const* historyData = history.getArrayOfReadPointers();
+    float unusedOutput;
+
+   #if JUCE_USE_AVX_INTRINSICS
+    const auto useAVX = FloatVectorHelpers::isAVXWorthUsing (numTaps);
+   #endif
+
+    for (int i = 0; i < numOutputSamples; ++i)
+    {
+        const auto index = (int) position;
+
+        if (index + halfLength >= numInHistory)
+            return i;
+
+        // The kernel for this position is interpolated between the two nearest
+        // phases, and shared by all the channels.
+        const auto phasePosition = (position - index) * numPhases;
+        const auto phase = (int) phasePosition;
+        const auto alpha = (float) (phasePosition - phase);
+        const auto* row = coefficients + phase * 2 * numTaps;
+        const auto* delta = row + numTaps;
+        const auto start = index - halfLength + 1;
+
+        auto getDest = [&] (int ch) { return output[ch] != nullptr ? output[ch] + i : &unusedOutput; };
+        int ch = 0;
+
+        for (; ch + 1 < numChannels; ch += 2)
+        {
+           #if JUCE_USE_AVX_INTRINSICS
+            if (useAVX)
+                PolyphaseResamplerHelpers::convolveAVX (historyData[ch] + start, historyData[ch + 1] + start, getDest (ch), getDest (ch + 1),
+                                                        row, delta, alpha, numTaps);
+            else
+           #endif
+                PolyphaseResamplerHelpers::convolve (historyData[ch] + start, historyData[ch + 1] + start, getDest (ch), getDest (ch + 1),
+                                                     row, delta, alpha, numTaps);
+        }
+
+        if (ch < numChannels)
+        {
+           #if JUCE_USE_AVX_INTRINSICS
+            if (useAVX)
+                PolyphaseResamplerHelpers::convolveAVX (historyData[ch] + start, getDest (ch), row, delta, alpha, numTaps);
+            else
+           #endif
+                PolyphaseResamplerHelpers::convolve (historyData[ch] + start, getDest (ch), row, delta, alpha, numTaps);
+        }
+
+        position += startRatio + rampStep * i;
+    }
+
+    return numOutputSamples;
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class PolyphaseResamplerTests  : public UnitTest
+{
+public:
+    PolyphaseResamplerTests()  : UnitTest ("PolyphaseResampler", UnitTestCategories::audio) {}
+
+    void runTest() override
+    {
+        beginTest ("Input requirements are exact");
+        {
+            for (auto quality : qualities)
+            {
+                HeapBlock<float> in (8192, true), out (256);
+                float* outs[] = { out.get() };
+                const float* ins[] = { in.get() };
+
+                for (auto ratio : { 0.37, 1.0, 1.5, 3.1, 0.9 })
+                {
+                    PolyphaseResampler resampler (1, quality);
+                    std::vector<std::pair<double, double>> ramps;
+
+                    for (int block = 0; block < 8; ++block)
+                    {
+                        const auto endRatio = ratio * (1.0 + 0.02 * block);
+                        const auto needed = resampler.getNumInputSamplesNeeded (ratio, endRatio, 256);
+
+                        if (needed > 0)
+                        {
+                            // Replaying the same blocks into another resampler, but giving
+                            // it one sample less for this block, should leave it short.
+                            PolyphaseResampler starved (1, quality);
+
+                            for (auto& r : ramps)
+                            {
+                                starved.pushSamples (ins, starved.getNumInputSamplesNeeded (r.first, r.second, 256));
+                                starved.process (outs, 256, r.first, r.second);
+                            }
+
+                            starved.pushSamples (ins, needed - 1);
+                            expectLessThan (starved.process (outs, 256, ratio, endRatio), 256);
+                        }
+
+                        resampler.pushSamples (ins, needed);
+                        expectEquals (resampler.process (outs, 256, ratio, endRatio), 256);
+
+                        ramps.push_back ({ ratio, endRatio });
+                        ratio = endRatio;
+                    }
+                }
+            }
+        }
+
+        beginTest ("Sine waves are reproduced at constant ratios");
+        {
+            for (auto quality : qualities)
+                for (auto ratio : { 44100.0 / 48000.0, 48000.0 / 44100.0, 0.5, 2.0, 1.0 })
+                    checkSines (quality, ratio, ratio, getTolerance (quality));
+        }
+
+        beginTest ("Sine waves are reproduced at varying ratios");
+        {
+            for (auto quality : qualities)
+            {
+                checkSines (quality, 0.5, 2.0, getTolerance (quality));
+                checkSines (quality, 1.7, 0.8, getTolerance (quality));
+            }
+        }
+
+        beginTest ("Frequencies above the new Nyquist are removed");
+        {
+            for (auto quality : qualities)
+            {
+                // A tone at 0.8 of the input's Nyquist is outside the band that survives
+                // downsampling by 2, and should be attenuated rather than aliased.
+                const auto level = getOutputLevel (quality, 2.0, 0.8 * MathConstants<double>::pi);
+                expectLessThan (level, getTolerance (quality) * 2.0, "aliasing too loud");
+            }
+        }
+
+        beginTest ("Switching cutoff doesn't affect the filters");
+        {
+            for (auto quality : qualities)
+            {
+                // A resampler that has been through several cutoffs, and one that shares
+                // the same tables, should both match one that has only used a single cutoff.
+                PolyphaseResampler fresh (1, quality), switched (1, quality);
+
+                for (auto ratio : { 5.0, 1.0, 12.0, 3.0 })
+                    render (switched, ratio);
+
+                switched.reset();
+                PolyphaseResampler other (1, quality);
+
+                const auto expected = render (fresh, 2.0);
+                expect (render (switched, 2.0) == expected);
+                expect (render (other, 2.0) == expected);
+            }
+        }
+    }
+
+private:
+    static constexpr PolyphaseResampler::Quality qualities[] = { PolyphaseResampler::Quality::low,
+                                                                 PolyphaseResampler::Quality::medium,
+                                                                 PolyphaseResampler::Quality::high,
+                                                                 PolyphaseResampler::Quality::veryHigh };
+
+    static double getTolerance (PolyphaseResampler::Quality quality)
+    {
+        switch (quality)
+        {
+            case PolyphaseResampler::Quality::low:       return 2.0e-3;
+            case PolyphaseResampler::Quality::medium:    return 2.0e-4;
+            case PolyphaseResampler::Quality::high:      return 5.0e-5;
+            case PolyphaseResampler::Quality::veryHigh:
+            default:                                     return 2.0e-5;
+        }
+    }
+
+    // Resamples a pair of sines in blocks and compares the result against the
+    // ideal values at the positions that the ratio ramp lands on.
+    void checkSines (PolyphaseResampler::Quality quality, double startRatio, double endRatio, double tolerance)
+    {
+        const int numOut = 2048, blockSize = 128;
+        const double omegas[] = { 0.05, 0.11 };
+
+        PolyphaseResampler resampler (2, quality);
+        resampler.prepare (blockSize * 4);
+
+        AudioBuffer<float> input (2, blockSize * 4), output (2, numOut);
+        int64 numPushed = 0;
+        double inputPosition = 0, maxError = 0;
+
+        for (int block = 0; block < numOut / blockSize; ++block)
+        {
+            const auto ratio0 = startRatio + (endRatio - startRatio) * block / (numOut / blockSize);
+            const auto ratio1 = startRatio + (endRatio - startRatio) * (block + 1) / (numOut / blockSize);
+            const auto needed = resampler.getNumInputSamplesNeeded (ratio0, ratio1, blockSize);
+
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < needed; ++i)
+                    input.setSample (ch, i, (float) std::sin (omegas[ch] * (double) (numPushed + i)));
+
+            resampler.pushSamples (input.getArrayOfReadPointers(), needed);
+            numPushed += needed;
+
+            float* outs[] = { output.getWritePointer (0, block * blockSize), output.getWritePointer (1, block * blockSize) };
+            expectEquals (resampler.process (outs, blockSize, ratio0, ratio1), blockSize);
+
+            const auto rampStep = (ratio1 - ratio0) / blockSize;
+
+            for (int i = 0; i < blockSize; ++i)
+            {
+                // Skip the start-up transient, where the kernel overlaps the initial silence
+                if (inputPosition > resampler.getNumTaps())
+                    for (int ch = 0; ch < 2; ++ch)
+                        maxError = jmax (maxError, std::abs (outs[ch][i] - std::sin (omegas[ch] * inputPosition)));
+
+                inputPosition += ratio0 + rampStep * i;
+            }
+        }
+
+        expectLessThan (maxError, tolerance, "ratio " + String (startRatio) + " -> " + String (endRatio));
+    }
+
+    static std::vector<float> render (PolyphaseResampler& resampler, double ratio)
+    {
+        const int numOut = 256;
+        const auto numIn = resampler.getNumInputSamplesNeeded (ratio, ratio, numOut);
+        HeapBlock<float> in (numIn);
+        std::vector<float> out ((size_t) numOut);
+
+        for (int i = 0; i < numIn; ++i)
+            in[i] = (float) std::sin (0.07 * i);
+
+        const float* ins[] = { in.get() };
+        float* outs[] = { out.data() };
+        resampler.pushSamples (ins, numIn);
+        resampler.process (outs, numOut, ratio);
+        return out;
+    }
+
+    static double getOutputLevel (PolyphaseResampler::Quality quality, double ratio, double omega)
+    {
+        const int numIn = 8192;
+        PolyphaseResampler resampler (1, quality);
+        HeapBlock<float> in (numIn), out (numIn);
+
+        for (int i = 0; i < numIn; ++i)
+            in[i] = (float) std::sin (omega * i);
+
+        const float* ins[] = { in.get() };
+        float* outs[] = { out.get() };
+        resampler.pushSamples (ins, numIn);
+        const auto numOut = resampler.process (outs, numIn, ratio);
+
+        const auto skip = resampler.getNumTaps();
+        auto range = FloatVectorOperations::findMinAndMax (out + skip, numOut - 2 * skip);
+        return jmax (std::abs (range.getStart()), std::abs (range.getEnd()));
+    }
+};
+
+constexpr PolyphaseResampler::Quality PolyphaseResamplerTests::qualities[];
+
+static PolyphaseResamplerTests polyphaseResamplerTests;
+
+#endif
+
+} // namespace juce
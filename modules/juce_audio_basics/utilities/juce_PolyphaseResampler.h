@@ -0,0 +1,180 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A multi-channel windowed-sinc resampler.
+
+    The filter is a Kaiser-windowed sinc, stored as a table of polyphase
+    sub-filters which are linearly interpolated for fractional positions that
+    fall between two phases, so any ratio can be used, and the ratio can be
+    changed smoothly from one output sample to the next.
+
+    When downsampling, the cutoff of the filter is lowered to suit the ratio
+    so that the output doesn't alias, and the kernel is stretched by the same
+    amount so that the transition band stays just as steep relative to the new
+    Nyquist frequency. This means the work per output sample grows with the
+    ratio, while the work per input sample stays the same. The cutoff moves in
+    quarter-octave steps, and stops following the ratio beyond 16:1.
+
+    The tables for all the steps are built when the first resampler of each
+    quality is created, and are shared by all the resamplers of that quality,
+    so changing the ratio never has to build a filter on the audio thread. The
+    shared tables take around 0.25, 0.65, 2.3 and 9MB for the four presets, and
+    are freed when the last resampler using them is deleted.
+
+    The coefficients for each output sample are computed once and shared by
+    all the channels, and the convolutions use SIMD where it's available.
+
+    The resampler works on a push/pull basis: you push input samples with
+    pushSamples(), and then pull as many output samples as that input allows
+    with process(). Use getNumInputSamplesNeeded() to find out exactly how
+    much input a given amount of output will require.
+
+    The first output sample is centred on the first input sample, but it can't
+    be produced until the filter has seen the samples that follow it, so the
+    output lags the input by getLatencyInInputSamples() samples. This grows as
+    the kernel is stretched for downsampling.
+
+    @see PolyphaseResamplingAudioSource, LagrangeInterpolator
+
+    @tags{Audio}
+*/
+class JUCE_API  PolyphaseResampler
+{
+public:
+    //==============================================================================
+    /** The available trade-offs between quality and CPU use. */
+    enum class Quality
+    {
+        low,        /**< 16 taps, around 87dB of stop-band attenuation. */
+        medium,     /**< 32 taps, around 92dB of stop-band attenuation. */
+        high,       /**< 64 taps, around 114dB of stop-band attenuation. */
+        veryHigh    /**< 128 taps, around 138dB of stop-band attenuation and a narrower transition band. */
+    };
+
+    //==============================================================================
+    /** Creates a resampler for a given number of channels.
+
+        If there are no other resamplers of the same quality, this will build the
+        shared filter tables, so it shouldn't be called on the audio thread.
+    */
+    PolyphaseResampler (int numChannels, Quality quality = Quality::high);
+
+    /** Destructor. */
+    ~PolyphaseResampler();
+
+    //==============================================================================
+    /** Returns the number of channels that this resampler was created with. */
+    int getNumChannels() const noexcept                 { return numChannels; }
+
+    /** Returns the quality preset that this resampler was created with. */
+    Quality getQuality() const noexcept                 { return quality; }
+
+    /** Returns the current length of the filter kernel. */
+    int getNumTaps() const noexcept                     { return numTaps; }
+
+    /** Returns the number of input samples by which the output currently lags the input. */
+    int getLatencyInInputSamples() const noexcept       { return numTaps / 2; }
+
+    /** Returns the largest latency that the resampler can have, which it reaches
+        when downsampling by 16:1 or more.
+    */
+    int getMaxLatencyInInputSamples() const noexcept    { return maxNumTaps / 2; }
+
+    //==============================================================================
+    /** Pre-allocates enough space to push blocks of up to the given size without
+        needing to allocate.
+    */
+    void prepare (int maxInputSamplesPerPush);
+
+    /** Clears the resampler's history, as if it had just been created. */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Returns the number of input samples that must be pushed before process()
+        can generate the given number of output samples.
+
+        The ratios have the same meaning as in process(), and must match the ones
+        that you then pass to it.
+    */
+    int getNumInputSamplesNeeded (double startRatio, double endRatio, int numOutputSamples) const noexcept;
+
+    /** Appends some input samples.
+
+        The array must contain one pointer for each of the resampler's channels.
+        This will only allocate if more input is waiting than was allowed for by
+        prepare().
+    */
+    void pushSamples (const float* const* input, int numSamples);
+
+    /** Generates some output samples from the input that has been pushed.
+
+        The ratio is the number of input samples to advance for each output sample,
+        so a ratio of 2.0 will halve the sample rate. It is interpolated linearly
+        from startRatio to endRatio across the block.
+
+        The output array must contain one pointer for each of the resampler's
+        channels, but any of them may be nullptr if that channel isn't needed.
+
+        Generation stops early if the resampler runs out of input, and the number of
+        samples that were actually written is returned.
+    */
+    int process (float* const* output, int numOutputSamples, double startRatio, double endRatio) noexcept;
+
+    /** Generates some output samples using a constant ratio.
+        @see process
+    */
+    int process (float* const* output, int numOutputSamples, double ratio) noexcept
+    {
+        return process (output, numOutputSamples, ratio, ratio);
+    }
+
+private:
+    //==============================================================================
+    const int numChannels;
+    const Quality quality;
+    const int baseNumTaps, baseNumPhases, maxNumTaps;
+
+    struct CoefficientTables;
+    SharedResourcePointer<CoefficientTables> coefficientTables;
+    const HeapBlock<float>* const stepTables;
+
+    const float* coefficients = nullptr;
+    int numTaps = 0, numPhases = 0, cutoffStep = -1;
+
+    AudioBuffer<float> history;
+    int numInHistory = 0;
+    double position = 0;
+
+    int getCutoffStepForRatio (double maxRatio) const noexcept;
+    int getNumTapsForStep (int step) const noexcept;
+    int getNumPhasesForStep (int step) const noexcept;
+    void setCutoffStep (int newStep) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PolyphaseResampler)
+};
+
+} // namespace juce
@@ -27,8 +27,124 @@
 namespace juce
 {
 
+//==============================================================================
+/** A set of real-time worker threads which help the audio thread to get through
+    a block of rendering ops in parallel.
+*/
+struct GraphRenderThreadPool
+{
+    /** A block of work which is shared between the audio thread and the workers. */
+    struct Job
+    {
+        virtual ~Job() {}
+
+        /** Keeps performing the ops which are ready to go, and must only return
+            once all of the job's ops have been completed by one thread or another.
+        */
+        virtual void performAvailableOps() noexcept = 0;
+    };
+
+    GraphRenderThreadPool (int numThreadsToUse)
+    {
+        auto numCpus = SystemStats::getNumCpus();
+
+        for (int i = 0; i < numThreadsToUse; ++i)
+        {
+            auto* worker = workers.add (new Worker (*this, i));
+
+            // leave the first core to the audio thread and spread the workers over the others
+            if (numCpus > 1 && numCpus <= 32)
+                worker->setAffinityMask ((uint32) 1 << (1 + i % (numCpus - 1)));
+
+            worker->startThread (Thread::realtimeAudioPriority);
+        }
+    }
+
+    ~GraphRenderThreadPool()
+    {
+        for (auto* worker : workers)
+        {
+            worker->signalThreadShouldExit();
+            worker->wakeUp.signal();
+        }
+
+        workers.clear();
+    }
+
+    int getNumThreads() const noexcept      { return workers.size(); }
+
+    /** Performs a job on the calling thread, with the help of any workers which
+        manage to join in before it has finished.
+    */
+    void run (Job& job) noexcept
+    {
+        currentJob = &job;
+        isAcceptingWorkers = true;
+
+        for (auto* worker : workers)
+            worker->wakeUp.signal();
+
+        job.performAvailableOps();
+
+        // any worker which is still inside the job has nothing left to do, so this won't take long
+        isAcceptingWorkers = false;
+
+        while (numActiveWorkers.load() > 0)
+            Thread::yield();
+
+        currentJob = nullptr;
+    }
+
+private:
+    //==============================================================================
+    struct Worker  : public Thread
+    {
+        Worker (GraphRenderThreadPool& p, int index)
+            : Thread ("Graph render thread " + String (index + 1)), pool (p)
+        {}
+
+        ~Worker() override
+        {
+            stopThread (10000);
+        }
+
+        void run() override
+        {
+            while (! threadShouldExit())
+            {
+                wakeUp.wait (-1);
+
+                if (threadShouldExit())
+                    break;
+
+                // The audio thread stops accepting workers once the job has been finished,
+                // so it's either safe to join, or the worker must leave straight away.
+                ++pool.numActiveWorkers;
+
+                if (pool.isAcceptingWorkers.load())
+                    pool.currentJob.load()->performAvailableOps();
+
+                --pool.numActiveWorkers;
+            }
+        }
+
+        GraphRenderThreadPool& pool;
+        WaitableEvent wakeUp;
+
+        JUCE_DECLARE_NON_COPYABLE (Worker)
+    };
+
+    OwnedArray<Worker> workers;
+    std::atomic<Job*> currentJob { nullptr };
+    std::atomic<bool> isAcceptingWorkers { false };
+    std::atomic<int> numActiveWorkers { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GraphRenderThreadPool)
+};
+
+//==============================================================================
 template <typename FloatType>
-struct GraphRenderSequence
+struct GraphRenderSequence  : private GraphRenderThreadPool::Job
 {
     GraphRenderSequence() {}
 
@@ -38,9 +154,11 @@ struct GraphRenderSequence
         MidiBuffer* midiBuffers;
         AudioPlayHead* audioPlayHead;
         int numSamples;
+        bool measureRenderTimes;
     };
 
-    void perform (AudioBuffer<FloatType>& buffer, MidiBuffer& midiMessages, AudioPlayHead* audioPlayHead)
+    void perform (AudioBuffer<FloatType>& buffer, MidiBuffer& midiMessages, AudioPlayHead* audioPlayHead,
+                  GraphRenderThreadPool* threadPool = nullptr)
     {
         auto numSamples = buffer.getNumSamples();
         auto maxSamples = renderingBuffer.getNumSamples();
@@ -54,11 +172,11 @@ struct GraphRenderSequence
             {
                 AudioBuffer<FloatType> startAudio (buffer.getArrayOfWritePointers(), buffer.getNumChannels(), maxSamples);
                 midiMessages.clear (maxSamples, numSamples);
-                perform (startAudio, midiMessages, audioPlayHead);
+                perform (startAudio, midiMessages, audioPlayHead, threadPool);
             }
 
             AudioBuffer<FloatType> endAudio (buffer.getArrayOfWritePointers(), buffer.getNumChannels(), maxSamples, numSamples - maxSamples);
-            perform (endAudio, tempMIDI, audioPlayHead);
+            perform (endAudio, tempMIDI, audioPlayHead, threadPool);
             return;
         }
 
@@ -69,10 +187,23 @@ struct GraphRenderSequence
         currentMidiOutputBuffer.clear();
 
         {
-            const Context context { renderingBuffer.getArrayOfWritePointers(), midiBuffers.begin(), audioPlayHead, numSamples };
+            const Context context { renderingBuffer.getArrayOfWritePointers(), midiBuffers.begin(),
+                                    audioPlayHead, numSamples, measureRenderTimes };
+
+            auto startTicks = measureRenderTimes ? Time::getHighResolutionTicks() : 0;
 
-            for (auto* op : renderOps)
-                op->perform (context);
+            if (threadPool != nullptr && threadPool->getNumThreads() > 0 && renderOps.size() > 1)
+            {
+                performInParallel (context, *threadPool);
+            }
+            else
+            {
+                for (auto* op : renderOps)
+                    op->perform (context);
+            }
+
+            if (measureRenderTimes)
+                checkForOverrun (Time::getHighResolutionTicks() - startTicks, numSamples);
         }
 
         for (int i = 0; i < buffer.getNumChannels(); ++i)
@@ -85,70 +216,180 @@ struct GraphRenderSequence
 
     void addClearChannelOp (int index)
     {
-        createOp ([=] (const Context& c)    { FloatVectorOperations::clear (c.audioBuffers[index], c.numSamples); });
+        createOp ([=] (const Context& c)    { FloatVectorOperations::clear (c.audioBuffers[index], c.numSamples); })
+            ->accesses = { BufferAccess::audio (index, true) };
     }
 
     void addCopyChannelOp (int srcIndex, int dstIndex)
     {
         createOp ([=] (const Context& c)    { FloatVectorOperations::copy (c.audioBuffers[dstIndex],
                                                                            c.audioBuffers[srcIndex],
-                                                                           c.numSamples); });
+                                                                           c.numSamples); })
+            ->accesses = { BufferAccess::audio (srcIndex, false), BufferAccess::audio (dstIndex, true) };
     }
 
     void addAddChannelOp (int srcIndex, int dstIndex)
     {
         createOp ([=] (const Context& c)    { FloatVectorOperations::add (c.audioBuffers[dstIndex],
                                                                           c.audioBuffers[srcIndex],
-                                                                          c.numSamples); });
+                                                                          c.numSamples); })
+            ->accesses = { BufferAccess::audio (srcIndex, false), BufferAccess::audio (dstIndex, true) };
     }
 
     void addClearMidiBufferOp (int index)
     {
-        createOp ([=] (const Context& c)    { c.midiBuffers[index].clear(); });
+        createOp ([=] (const Context& c)    { c.midiBuffers[index].clear(); })
+            ->accesses = { BufferAccess::midi (index, true) };
     }
 
     void addCopyMidiBufferOp (int srcIndex, int dstIndex)
     {
-        createOp ([=] (const Context& c)    { c.midiBuffers[dstIndex] = c.midiBuffers[srcIndex]; });
+        createOp ([=] (const Context& c)    { c.midiBuffers[dstIndex] = c.midiBuffers[srcIndex]; })
+            ->accesses = { BufferAccess::midi (srcIndex, false), BufferAccess::midi (dstIndex, true) };
     }
 
     void addAddMidiBufferOp (int srcIndex, int dstIndex)
     {
         createOp ([=] (const Context& c)    { c.midiBuffers[dstIndex].addEvents (c.midiBuffers[srcIndex],
-                                                                                 0, c.numSamples, 0); });
+                                                                                 0, c.numSamples, 0); })
+            ->accesses = { BufferAccess::midi (srcIndex, false), BufferAccess::midi (dstIndex, true) };
     }
 
     void addDelayChannelOp (int chan, int delaySize)
     {
-        renderOps.add (new DelayChannelOp (chan, delaySize));
+        renderOps.add (new DelayChannelOp (chan, delaySize))
+            ->accesses = { BufferAccess::audio (chan, true) };
     }
 
     void addProcessOp (const AudioProcessorGraph::Node::Ptr& node,
                        const Array<int>& audioChannelsUsed, int totalNumChans, int midiBuffer)
     {
-        renderOps.add (new ProcessOp (node, audioChannelsUsed, totalNumChans, midiBuffer));
+        auto* op = new ProcessOp (node, audioChannelsUsed, totalNumChans, midiBuffer);
+        renderOps.add (op);
+        processOps.add (op);
+
+        // a process op uses its own silent channel in place of the shared empty buffer
+        for (auto index : audioChannelsUsed)
+            if (index != 0)
+                op->accesses.add (BufferAccess::audio (index, true));
+
+        op->accesses.add (BufferAccess::midi (midiBuffer, true));
+
+        // the I/O processors all share the sequence's input and output buffers
+        if (dynamic_cast<AudioProcessorGraph::AudioGraphIOProcessor*> (node->getProcessor()) != nullptr)
+            op->accesses.add (BufferAccess::graphIO());
+    }
+
+    /** Works out which ops must wait for which others, so that independent ones can
+        be performed in parallel while giving exactly the same results as performing
+        them in order.
+
+        Each op depends on the last op to write to any buffer that it uses, and an op
+        which writes to a buffer also depends on all the ops which have read from it
+        since then. That includes the first audio buffer, the shared empty one, which
+        the copies and delays made for feedback loops can still use.
+    */
+    void createDependencyGraph()
+    {
+        struct BufferState
+        {
+            int lastWriter = -1;
+            Array<int> readersSinceLastWrite;
+        };
+
+        Array<BufferState> audioStates, midiStates;
+        BufferState graphIOState;
+
+        auto getState = [&] (const BufferAccess& access) -> BufferState&
+        {
+            if (access.type == BufferAccess::Type::graphIO)
+                return graphIOState;
+
+            auto& states = access.type == BufferAccess::Type::audio ? audioStates : midiStates;
+
+            if (states.size() <= access.index)
+                states.resize (access.index + 1);
+
+            return states.getReference (access.index);
+        };
+
+        for (int i = 0; i < renderOps.size(); ++i)
+        {
+            auto& op = *renderOps.getUnchecked (i);
+            Array<int> dependencies;
+
+            for (auto& access : op.accesses)
+            {
+                auto& state = getState (access);
+
+                if (state.lastWriter >= 0 && state.lastWriter != i)
+                    dependencies.addIfNotAlreadyThere (state.lastWriter);
+
+                if (access.isWrite)
+                {
+                    for (auto reader : state.readersSinceLastWrite)
+                        if (reader != i)
+                            dependencies.addIfNotAlreadyThere (reader);
+
+                    state.lastWriter = i;
+                    state.readersSinceLastWrite.clearQuick();
+                }
+                else
+                {
+                    state.readersSinceLastWrite.addIfNotAlreadyThere (i);
+                }
+            }
+
+            op.numDependencies = dependencies.size();
+
+            for (auto dependency : dependencies)
+                renderOps.getUnchecked (dependency)->dependentOps.add (i);
+        }
+
+        auto numOps = (size_t) renderOps.size();
+        remainingDependencies.reset (new std::atomic<int>[numOps]);
+        readyOps.reset (new std::atomic<int>[numOps]);
     }
 
     void prepareBuffers (int blockSize)
     {
-        renderingBuffer.setSize (numBuffersNeeded + 1, blockSize);
+        // any storage taken over from a previous sequence is reused if it's big enough
+        renderingBuffer.setSize (numBuffersNeeded + 1, blockSize, false, false, true);
         renderingBuffer.clear();
-        currentAudioOutputBuffer.setSize (numBuffersNeeded + 1, blockSize);
+        currentAudioOutputBuffer.setSize (numBuffersNeeded + 1, blockSize, false, false, true);
         currentAudioOutputBuffer.clear();
 
         currentAudioInputBuffer = nullptr;
         currentMidiInputBuffer = nullptr;
         currentMidiOutputBuffer.clear();
 
-        midiBuffers.clearQuick();
         midiBuffers.resize (numMidiBuffersNeeded);
 
+        for (auto* op : processOps)
+            op->prepareEmptyChannel (blockSize);
+
         const int defaultMIDIBufferSize = 512;
 
+        tempMIDI.clear();
         tempMIDI.ensureSize (defaultMIDIBufferSize);
 
         for (auto&& m : midiBuffers)
+        {
+            m.clear();
             m.ensureSize (defaultMIDIBufferSize);
+        }
+    }
+
+    /** Takes over the buffers of a sequence that is about to be replaced, so that
+        preparing this one only needs to allocate if the graph has grown.
+    */
+    void takeBuffersFrom (GraphRenderSequence& other) noexcept
+    {
+        std::swap (renderingBuffer, other.renderingBuffer);
+        std::swap (currentAudioOutputBuffer, other.currentAudioOutputBuffer);
+        currentMidiOutputBuffer.swapWith (other.currentMidiOutputBuffer);
+        midiBuffers.swapWith (other.midiBuffers);
+        tempMIDI.swapWith (other.tempMIDI);
     }
 
     void releaseBuffers()
@@ -161,8 +402,13 @@ struct GraphRenderSequence
         midiBuffers.clear();
     }
 
+    int getNumRenderingOps() const noexcept     { return renderOps.size(); }
+
     int numBuffersNeeded = 0, numMidiBuffersNeeded = 0;
 
+    bool measureRenderTimes = false;
+    double sampleRate = 0;
+
     AudioBuffer<FloatType> renderingBuffer, currentAudioOutputBuffer;
     AudioBuffer<FloatType>* currentAudioInputBuffer = nullptr;
 
@@ -174,20 +420,58 @@ struct GraphRenderSequence
 
 private:
     //==============================================================================
+    struct BufferAccess
+    {
+        enum class Type { audio, midi, graphIO };
+
+        static BufferAccess audio (int index, bool isWrite) noexcept    { return { Type::audio, index, isWrite }; }
+        static BufferAccess midi  (int index, bool isWrite) noexcept    { return { Type::midi,  index, isWrite }; }
+        static BufferAccess graphIO() noexcept                          { return { Type::graphIO, 0, true }; }
+
+        Type type;
+        int index;
+        bool isWrite;
+    };
+
     struct RenderingOp
     {
         RenderingOp() noexcept {}
         virtual ~RenderingOp() {}
         virtual void perform (const Context&) = 0;
 
+        Array<BufferAccess> accesses;
+        Array<int> dependentOps;
+        int numDependencies = 0;
+
         JUCE_LEAK_DETECTOR (RenderingOp)
     };
 
     OwnedArray<RenderingOp> renderOps;
 
+    struct ProcessOp;
+    Array<ProcessOp*> processOps;
+
+    //==============================================================================
+    // If the whole block took longer than the audio it produced, the blame goes to
+    // whichever node was slowest.
+    void checkForOverrun (int64 elapsedTicks, int numSamples) noexcept
+    {
+        if (sampleRate <= 0 || elapsedTicks <= Time::secondsToHighResolutionTicks (numSamples / sampleRate))
+            return;
+
+        ProcessOp* slowest = nullptr;
+
+        for (auto* op : processOps)
+            if (slowest == nullptr || op->lastRenderTicks > slowest->lastRenderTicks)
+                slowest = op;
+
+        if (slowest != nullptr)
+            slowest->node->addRenderOverrun();
+    }
+
     //==============================================================================
     template <typename LambdaType>
-    void createOp (LambdaType&& fn)
+    RenderingOp* createOp (LambdaType&& fn)
     {
         struct LambdaOp  : public RenderingOp
         {
@@ -197,7 +481,88 @@ private:
             LambdaType function;
         };
 
-        renderOps.add (new LambdaOp (std::move (fn)));
+        return renderOps.add (new LambdaOp (std::move (fn)));
+    }
+
+    //==============================================================================
+    // The state used while the ops are being performed in parallel. Every op is
+    // pushed onto the ready queue exactly once per block, when its last dependency
+    // has completed, so the queue never needs more slots than there are ops.
+    const Context* currentContext = nullptr;
+    std::unique_ptr<std::atomic<int>[]> remainingDependencies, readyOps;
+    std::atomic<int> readyOpsWritePos { 0 }, readyOpsReadPos { 0 }, numOpsCompleted { 0 };
+
+    void performInParallel (const Context& context, GraphRenderThreadPool& threadPool) noexcept
+    {
+        auto numOps = renderOps.size();
+
+        for (int i = 0; i < numOps; ++i)
+        {
+            remainingDependencies[i].store (renderOps.getUnchecked (i)->numDependencies, std::memory_order_relaxed);
+            readyOps[i].store (-1, std::memory_order_relaxed);
+        }
+
+        readyOpsWritePos = 0;
+        readyOpsReadPos = 0;
+        numOpsCompleted = 0;
+        currentContext = &context;
+
+        for (int i = 0; i < numOps; ++i)
+            if (renderOps.getUnchecked (i)->numDependencies == 0)
+                pushReadyOp (i);
+
+        threadPool.run (*this);
+        currentContext = nullptr;
+    }
+
+    void performAvailableOps() noexcept override
+    {
+        auto numOps = renderOps.size();
+
+        while (numOpsCompleted.load (std::memory_order_acquire) < numOps)
+        {
+            auto index = popReadyOp();
+
+            if (index < 0)
+            {
+                Thread::yield();
+                continue;
+            }
+
+            auto& op = *renderOps.getUnchecked (index);
+            op.perform (*currentContext);
+
+            for (auto dependent : op.dependentOps)
+                if (remainingDependencies[dependent].fetch_sub (1, std::memory_order_acq_rel) == 1)
+                    pushReadyOp (dependent);
+
+            numOpsCompleted.fetch_add (1, std::memory_order_release);
+        }
+    }
+
+    void pushReadyOp (int index) noexcept
+    {
+        auto pos = readyOpsWritePos.fetch_add (1);
+        readyOps[pos].store (index, std::memory_order_release);
+    }
+
+    int popReadyOp() noexcept
+    {
+        for (;;)
+        {
+            auto pos = readyOpsReadPos.load();
+
+            if (pos >= readyOpsWritePos.load())
+                return -1;
+
+            auto index = readyOps[pos].load (std::memory_order_acquire);
+
+            if (index < 0)
+                return -1; // claimed by a writer, but not filled in yet
+
+            if (readyOpsReadPos.compare_exchange_weak (pos, pos + 1))
+                return index;
+        }
     }
 
     //==============================================================================
@@ -251,11 +616,42 @@ private:
         }
 
         void perform (const Context& c) override
+        {
+            if (c.measureRenderTimes)
+            {
+                auto startTicks = Time::getHighResolutionTicks();
+                performProcess (c);
+                lastRenderTicks = Time::getHighResolutionTicks() - startTicks;
+                node->addRenderTime (lastRenderTicks);
+            }
+            else
+            {
+                performProcess (c);
+            }
+        }
+
+        /** Processors are allowed to scribble on channels that they only read from. So rather
+            than giving them the shared empty buffer, which other ops might be using at the
+            same time on other threads, each op that needs one gets its own silent channel.
+        */
+        void prepareEmptyChannel (int blockSize)
+        {
+            if (audioChannelsToUse.contains (0))
+                emptyChannel.malloc ((size_t) jmax (1, blockSize));
+        }
+
+        void performProcess (const Context& c)
         {
             processor.setPlayHead (c.audioPlayHead);
 
+            if (emptyChannel != nullptr)
+                FloatVectorOperations::clear (emptyChannel.getData(), c.numSamples);
+
             for (int i = 0; i < totalChans; ++i)
-                audioChannels[i] = c.audioBuffers[audioChannelsToUse.getUnchecked (i)];
+            {
+                auto index = audioChannelsToUse.getUnchecked (i);
+                audioChannels[i] = index != 0 ? c.audioBuffers[index] : emptyChannel.getData();
+            }
 
             AudioBuffer<FloatType> buffer (audioChannels, totalChans, c.numSamples);
 
@@ -314,67 +710,194 @@ private:
 
         Array<int> audioChannelsToUse;
         HeapBlock<FloatType*> audioChannels;
+        HeapBlock<FloatType> emptyChannel;
         AudioBuffer<float> tempBufferFloat, tempBufferDouble;
         const int totalChans, midiBufferToUse;
+        int64 lastRenderTicks = 0;
 
         JUCE_DECLARE_NON_COPYABLE (ProcessOp)
     };
 };
 
 //==============================================================================
+/** The rendering ops for a graph, worked out without reference to the sample type,
+    so that the float and double sequences can both be created from the same plan.
+
+    Each node's step also keeps a note of everything its ops depended on, so that the
+    next time the graph changes, the steps leading up to the first node which the
+    change affects can be re-used, and only the rest of the graph is planned again.
+*/
+struct GraphRenderingPlan
+{
+    using NodeID = AudioProcessorGraph::NodeID;
+
+    struct Op
+    {
+        enum class Type { clearChannel, copyChannel, addChannel, delayChannel, clearMidi, copyMidi, addMidi, process };
+
+        Type type;
+        int arg1, arg2;             // the arguments for the matching GraphRenderSequence::add...Op() method
+        Array<int> audioChannels;   // only used by process ops
+    };
+
+    struct AssignedBuffer
+    {
+        AudioProcessorGraph::NodeAndChannel channel;
+
+        static AssignedBuffer createReadOnlyEmpty() noexcept    { return { { zeroNodeID(), 0 } }; }
+        static AssignedBuffer createFree() noexcept             { return { { freeNodeID(), 0 } }; }
+
+        bool isReadOnlyEmpty() const noexcept                   { return channel.nodeID == zeroNodeID(); }
+        bool isFree() const noexcept                            { return channel.nodeID == freeNodeID(); }
+        bool isAssigned() const noexcept                        { return ! (isReadOnlyEmpty() || isFree()); }
+
+        void setFree() noexcept                                 { channel = { freeNodeID(), 0 }; }
+        void setAssignedToNonExistentNode() noexcept            { channel = { anonNodeID(), 0 }; }
+
+    private:
+        static NodeID anonNodeID() { return NodeID (0x7ffffffd); }
+        static NodeID zeroNodeID() { return NodeID (0x7ffffffe); }
+        static NodeID freeNodeID() { return NodeID (0x7fffffff); }
+    };
+
+    struct Step
+    {
+        void addClearChannelOp (int index)                      { ops.add ({ Op::Type::clearChannel, index, 0, {} }); }
+        void addCopyChannelOp (int srcIndex, int dstIndex)      { ops.add ({ Op::Type::copyChannel, srcIndex, dstIndex, {} }); }
+        void addAddChannelOp (int srcIndex, int dstIndex)       { ops.add ({ Op::Type::addChannel, srcIndex, dstIndex, {} }); }
+        void addDelayChannelOp (int chan, int delaySize)        { ops.add ({ Op::Type::delayChannel, chan, delaySize, {} }); }
+        void addClearMidiBufferOp (int index)                   { ops.add ({ Op::Type::clearMidi, index, 0, {} }); }
+        void addCopyMidiBufferOp (int srcIndex, int dstIndex)   { ops.add ({ Op::Type::copyMidi, srcIndex, dstIndex, {} }); }
+        void addAddMidiBufferOp (int srcIndex, int dstIndex)    { ops.add ({ Op::Type::addMidi, srcIndex, dstIndex, {} }); }
+
+        void addProcessOp (const Array<int>& audioChannelsUsed, int totalNumChans, int midiBuffer)
+        {
+            ops.add ({ Op::Type::process, totalNumChans, midiBuffer, audioChannelsUsed });
+        }
+
+        // This is only valid during the rebuild that planned or re-used the step
+        AudioProcessorGraph::Node* node = nullptr;
+
+        // The things that the step's ops depend on
+        NodeID nodeID;
+        int numIns = 0, numOuts = 0, latency = 0;
+        bool acceptsMidi = false, producesMidi = false;
+        Array<AudioProcessorGraph::Connection> inputs, outputs;
+
+        // The ops, and the state of the builder once they've been added
+        Array<Op> ops;
+        Array<AssignedBuffer> audioBuffers, midiBuffers;
+        int delay = 0, totalLatency = 0;
+    };
+
+    template <typename RenderSequence>
+    void createOps (RenderSequence& sequence) const
+    {
+        for (auto& step : steps)
+        {
+            for (auto& op : step.ops)
+            {
+                switch (op.type)
+                {
+                    case Op::Type::clearChannel:    sequence.addClearChannelOp (op.arg1); break;
+                    case Op::Type::copyChannel:     sequence.addCopyChannelOp (op.arg1, op.arg2); break;
+                    case Op::Type::addChannel:      sequence.addAddChannelOp (op.arg1, op.arg2); break;
+                    case Op::Type::delayChannel:    sequence.addDelayChannelOp (op.arg1, op.arg2); break;
+                    case Op::Type::clearMidi:       sequence.addClearMidiBufferOp (op.arg1); break;
+                    case Op::Type::copyMidi:        sequence.addCopyMidiBufferOp (op.arg1, op.arg2); break;
+                    case Op::Type::addMidi:         sequence.addAddMidiBufferOp (op.arg1, op.arg2); break;
+                    case Op::Type::process:         sequence.addProcessOp (step.node, op.audioChannels, op.arg1, op.arg2); break;
+                    default:                        jassertfalse; break;
+                }
+            }
+        }
+
+        sequence.numBuffersNeeded = numAudioBuffers;
+        sequence.numMidiBuffersNeeded = numMidiBuffers;
+        sequence.createDependencyGraph();
+    }
+
+    Array<Step> steps;
+    int numAudioBuffers = 0, numMidiBuffers = 0, numStepsReused = 0;
+};
+
 //==============================================================================
-template <typename RenderSequence>
 struct RenderSequenceBuilder
 {
-    RenderSequenceBuilder (AudioProcessorGraph& g, RenderSequence& s)
-        : graph (g), sequence (s)
+    using AssignedBuffer = GraphRenderingPlan::AssignedBuffer;
+    using Step = GraphRenderingPlan::Step;
+
+    RenderSequenceBuilder (AudioProcessorGraph& g, GraphRenderingPlan& newPlan, GraphRenderingPlan* previousPlan)
+        : graph (g), plan (newPlan)
     {
+        createConnectionLists();
         createOrderedNodeList();
 
         audioBuffers.add (AssignedBuffer::createReadOnlyEmpty()); // first buffer is read-only zeros
         midiBuffers .add (AssignedBuffer::createReadOnlyEmpty());
 
+        plan.steps.ensureStorageAllocated (orderedNodes.size());
+
         for (int i = 0; i < orderedNodes.size(); ++i)
         {
-            createRenderingOpsForNode (*orderedNodes.getUnchecked(i), i);
+            auto& node = *orderedNodes.getUnchecked (i);
+
+            // The steps before the first node that has been affected by a change come out
+            // exactly the same as last time, so they don't need to be planned again
+            if (previousPlan != nullptr)
+            {
+                if (canReuseStep (previousPlan->steps, i))
+                {
+                    reuseStep (previousPlan->steps.getReference (i), node);
+                    continue;
+                }
+
+                previousPlan = nullptr;
+                restoreBufferAssignments();
+            }
+
+            currentStep = &addStep (node);
+
+            createRenderingOpsForNode (node, i);
             markAnyUnusedBuffersAsFree (audioBuffers, i);
             markAnyUnusedBuffersAsFree (midiBuffers, i);
+
+            currentStep->audioBuffers = audioBuffers;
+            currentStep->midiBuffers = midiBuffers;
+            currentStep->delay = getNodeDelay (node.nodeID);
+            currentStep->totalLatency = totalLatency;
         }
 
+        if (previousPlan != nullptr)
+            restoreBufferAssignments();
+
         graph.setLatencySamples (totalLatency);
 
-        s.numBuffersNeeded = audioBuffers.size();
-        s.numMidiBuffersNeeded = midiBuffers.size();
+        plan.numAudioBuffers = audioBuffers.size();
+        plan.numMidiBuffers = midiBuffers.size();
     }
 
     //==============================================================================
     using NodeID = AudioProcessorGraph::NodeID;
 
     AudioProcessorGraph& graph;
-    RenderSequence& sequence;
+    GraphRenderingPlan& plan;
+    Step* currentStep = nullptr;
 
     Array<AudioProcessorGraph::Node*> orderedNodes;
 
-    struct AssignedBuffer
+    // The graph's connections, indexed by the position of each node in graph.getNodes(),
+    // so that the builder never has to search through all the connections for a node.
+    struct NodeConnections
     {
-        AudioProcessorGraph::NodeAndChannel channel;
-
-        static AssignedBuffer createReadOnlyEmpty() noexcept    { return { { zeroNodeID(), 0 } }; }
-        static AssignedBuffer createFree() noexcept             { return { { freeNodeID(), 0 } }; }
-
-        bool isReadOnlyEmpty() const noexcept                   { return channel.nodeID == zeroNodeID(); }
-        bool isFree() const noexcept                            { return channel.nodeID == freeNodeID(); }
-        bool isAssigned() const noexcept                        { return ! (isReadOnlyEmpty() || isFree()); }
-
-        void setFree() noexcept                                 { channel = { freeNodeID(), 0 }; }
-        void setAssignedToNonExistentNode() noexcept            { channel = { anonNodeID(), 0 }; }
-
-    private:
-        static NodeID anonNodeID() { return NodeID (0x7ffffffd); }
-        static NodeID zeroNodeID() { return NodeID (0x7ffffffe); }
-        static NodeID freeNodeID() { return NodeID (0x7fffffff); }
+        Array<AudioProcessorGraph::Connection> inputs, outputs;
+        BigInteger upstreamNodes;
+        int renderingIndex = -1;
     };
 
+    Array<NodeConnections> nodeConnections;
+    HashMap<uint32, int> nodeIndices;
+
     Array<AssignedBuffer> audioBuffers, midiBuffers;
 
     enum { readOnlyEmptyBufferIndex = 0 };
@@ -397,28 +920,160 @@ struct RenderSequenceBuilder
     {
         int maxLatency = 0;
 
-        for (auto&& c : graph.getConnections())
-            if (c.destination.nodeID == nodeID)
-                maxLatency = jmax (maxLatency, getNodeDelay (c.source.nodeID));
+        for (auto&& c : getConnectionsForNode (nodeID).inputs)
+            maxLatency = jmax (maxLatency, getNodeDelay (c.source.nodeID));
 
         return maxLatency;
     }
 
     //==============================================================================
+    int getNodeIndex (NodeID nodeID) const
+    {
+        return nodeIndices.contains (nodeID.uid) ? nodeIndices[nodeID.uid] : -1;
+    }
+
+    const NodeConnections& getConnectionsForNode (NodeID nodeID) const
+    {
+        return nodeConnections.getReference (getNodeIndex (nodeID));
+    }
+
+    void createConnectionLists()
+    {
+        auto& nodes = graph.getNodes();
+        nodeConnections.resize (nodes.size());
+
+        for (int i = 0; i < nodes.size(); ++i)
+            nodeIndices.set (nodes.getUnchecked (i)->nodeID.uid, i);
+
+        // the connections are sorted by source, so each node's inputs end up in the
+        // order that the rendering ops expect
+        for (auto&& c : graph.getConnections())
+        {
+            nodeConnections.getReference (getNodeIndex (c.source.nodeID)).outputs.add (c);
+            nodeConnections.getReference (getNodeIndex (c.destination.nodeID)).inputs.add (c);
+        }
+
+        // find every node that feeds into each node, directly or indirectly
+        Array<int> nodesToVisit;
+
+        for (auto& n : nodeConnections)
+        {
+            nodesToVisit.clearQuick();
+
+            for (auto&& c : n.inputs)
+                nodesToVisit.add (getNodeIndex (c.source.nodeID));
+
+            while (! nodesToVisit.isEmpty())
+            {
+                auto index = nodesToVisit.removeAndReturn (nodesToVisit.size() - 1);
+
+                if (! n.upstreamNodes[index])
+                {
+                    n.upstreamNodes.setBit (index);
+
+                    for (auto&& c : nodeConnections.getReference (index).inputs)
+                        nodesToVisit.add (getNodeIndex (c.source.nodeID));
+                }
+            }
+        }
+    }
+
     void createOrderedNodeList()
     {
-        for (auto* node : graph.getNodes())
+        auto& nodes = graph.getNodes();
+        Array<int> orderedIndices;
+
+        for (int i = 0; i < nodes.size(); ++i)
         {
             int j = 0;
 
-            for (; j < orderedNodes.size(); ++j)
-                if (graph.isAnInputTo (*node, *orderedNodes.getUnchecked(j)))
+            for (; j < orderedIndices.size(); ++j)
+                if (nodeConnections.getReference (orderedIndices.getUnchecked (j)).upstreamNodes[i])
                   break;
 
-            orderedNodes.insert (j, node);
+            orderedIndices.insert (j, i);
+        }
+
+        for (int i = 0; i < orderedIndices.size(); ++i)
+        {
+            auto index = orderedIndices.getUnchecked (i);
+            orderedNodes.add (nodes.getUnchecked (index));
+            nodeConnections.getReference (index).renderingIndex = i;
         }
     }
 
+    //==============================================================================
+    Step& addStep (AudioProcessorGraph::Node& node)
+    {
+        auto& processor = *node.getProcessor();
+        auto& connections = getConnectionsForNode (node.nodeID);
+
+        Step step;
+        step.node = &node;
+        step.nodeID = node.nodeID;
+        step.numIns = processor.getTotalNumInputChannels();
+        step.numOuts = processor.getTotalNumOutputChannels();
+        step.latency = processor.getLatencySamples();
+        step.acceptsMidi = processor.acceptsMidi();
+        step.producesMidi = processor.producesMidi();
+        step.inputs = connections.inputs;
+        step.outputs = connections.outputs;
+
+        plan.steps.add (std::move (step));
+        return plan.steps.getReference (plan.steps.size() - 1);
+    }
+
+    /** A step can be re-used if all the steps before it were, and nothing about its node
+        or the node's connections has changed.
+
+        The ops for a node only depend on the buffers left by the steps before it, the
+        delays of its inputs, and whether any of the buffers are needed by a node further
+        along the sequence. As the nodes before this one are all the same, any input from
+        a node that hasn't been rendered yet (i.e. a feedback loop) is treated the same way
+        as last time, and checking the outputs of each node in turn is enough to show that
+        none of the buffers are needed by a different set of later nodes.
+    */
+    bool canReuseStep (const Array<Step>& previousSteps, int index) const
+    {
+        if (index >= previousSteps.size())
+            return false;
+
+        auto& step = previousSteps.getReference (index);
+        auto& node = *orderedNodes.getUnchecked (index);
+        auto& processor = *node.getProcessor();
+        auto& connections = getConnectionsForNode (node.nodeID);
+
+        return step.nodeID == node.nodeID
+             && step.numIns == processor.getTotalNumInputChannels()
+             && step.numOuts == processor.getTotalNumOutputChannels()
+             && step.latency == processor.getLatencySamples()
+             && step.acceptsMidi == processor.acceptsMidi()
+             && step.producesMidi == processor.producesMidi()
+             && step.inputs == connections.inputs
+             && step.outputs == connections.outputs;
+    }
+
+    void reuseStep (Step& step, AudioProcessorGraph::Node& node)
+    {
+        step.node = &node;
+        delays.set (node.nodeID.uid, step.delay);
+        totalLatency = step.totalLatency;
+
+        plan.steps.add (std::move (step));
+        ++plan.numStepsReused;
+    }
+
+    void restoreBufferAssignments()
+    {
+        if (! plan.steps.isEmpty())
+        {
+            auto& lastStep = plan.steps.getReference (plan.steps.size() - 1);
+            audioBuffers = lastStep.audioBuffers;
+            midiBuffers = lastStep.midiBuffers;
+        }
+    }
+
+    //==============================================================================
     int findBufferForInputAudioChannel (AudioProcessorGraph::Node& node, const int inputChan,
                                         const int ourRenderingIndex, const int maxLatency)
     {
@@ -434,7 +1089,7 @@ struct RenderSequenceBuilder
                 return readOnlyEmptyBufferIndex;
 
             auto index = getFreeBuffer (audioBuffers);
-            sequence.addClearChannelOp (index);
+            currentStep->addClearChannelOp (index);
             return index;
         }
 
@@ -459,14 +1114,14 @@ struct RenderSequenceBuilder
                 // can't mess up this channel because it's needed later by another node,
                 // so we need to use a copy of it..
                 auto newFreeBuffer = getFreeBuffer (audioBuffers);
-                sequence.addCopyChannelOp (bufIndex, newFreeBuffer);
+                currentStep->addCopyChannelOp (bufIndex, newFreeBuffer);
                 bufIndex = newFreeBuffer;
             }
 
             auto nodeDelay = getNodeDelay (src.nodeID);
 
             if (nodeDelay < maxLatency)
-                sequence.addDelayChannelOp (bufIndex, maxLatency - nodeDelay);
+                currentStep->addDelayChannelOp (bufIndex, maxLatency - nodeDelay);
 
             return bufIndex;
         }
@@ -489,7 +1144,7 @@ struct RenderSequenceBuilder
                 auto nodeDelay = getNodeDelay (src.nodeID);
 
                 if (nodeDelay < maxLatency)
-                    sequence.addDelayChannelOp (bufIndex, maxLatency - nodeDelay);
+                    currentStep->addDelayChannelOp (bufIndex, maxLatency - nodeDelay);
 
                 break;
             }
@@ -506,15 +1161,15 @@ struct RenderSequenceBuilder
             auto srcIndex = getBufferContaining (sources.getFirst());
 
             if (srcIndex < 0)
-                sequence.addClearChannelOp (bufIndex);  // if not found, this is probably a feedback loop
+                currentStep->addClearChannelOp (bufIndex);  // if not found, this is probably a feedback loop
             else
-                sequence.addCopyChannelOp (srcIndex, bufIndex);
+                currentStep->addCopyChannelOp (srcIndex, bufIndex);
 
             reusableInputIndex = 0;
             auto nodeDelay = getNodeDelay (sources.getFirst().nodeID);
 
             if (nodeDelay < maxLatency)
-                sequence.addDelayChannelOp (bufIndex, maxLatency - nodeDelay);
+                currentStep->addDelayChannelOp (bufIndex, maxLatency - nodeDelay);
         }
 
         for (int i = 0; i < sources.size(); ++i)
@@ -532,18 +1187,18 @@ struct RenderSequenceBuilder
                     {
                         if (! isBufferNeededLater (ourRenderingIndex, inputChan, src))
                         {
-                            sequence.addDelayChannelOp (srcIndex, maxLatency - nodeDelay);
+                            currentStep->addDelayChannelOp (srcIndex, maxLatency - nodeDelay);
                         }
                         else // buffer is reused elsewhere, can't be delayed
                         {
                             auto bufferToDelay = getFreeBuffer (audioBuffers);
-                            sequence.addCopyChannelOp (srcIndex, bufferToDelay);
-                            sequence.addDelayChannelOp (bufferToDelay, maxLatency - nodeDelay);
+                            currentStep->addCopyChannelOp (srcIndex, bufferToDelay);
+                            currentStep->addDelayChannelOp (bufferToDelay, maxLatency - nodeDelay);
                             srcIndex = bufferToDelay;
                         }
                     }
 
-                    sequence.addAddChannelOp (srcIndex, bufIndex);
+                    currentStep->addAddChannelOp (srcIndex, bufIndex);
                 }
             }
         }
@@ -562,7 +1217,7 @@ struct RenderSequenceBuilder
             auto midiBufferToUse = getFreeBuffer (midiBuffers); // need to pick a buffer even if the processor doesn't use midi
 
             if (processor.acceptsMidi() || processor.producesMidi())
-                sequence.addClearMidiBufferOp (midiBufferToUse);
+                currentStep->addClearMidiBufferOp (midiBufferToUse);
 
             return midiBufferToUse;
         }
@@ -580,7 +1235,7 @@ struct RenderSequenceBuilder
                     // can't mess up this channel because it's needed later by another node, so we
                     // need to use a copy of it..
                     auto newFreeBuffer = getFreeBuffer (midiBuffers);
-                    sequence.addCopyMidiBufferOp (midiBufferToUse, newFreeBuffer);
+                    currentStep->addCopyMidiBufferOp (midiBufferToUse, newFreeBuffer);
                     midiBufferToUse = newFreeBuffer;
                 }
             }
@@ -621,9 +1276,9 @@ struct RenderSequenceBuilder
             auto srcIndex = getBufferContaining (sources.getUnchecked(0));
 
             if (srcIndex >= 0)
-                sequence.addCopyMidiBufferOp (srcIndex, midiBufferToUse);
+                currentStep->addCopyMidiBufferOp (srcIndex, midiBufferToUse);
             else
-                sequence.addClearMidiBufferOp (midiBufferToUse);
+                currentStep->addClearMidiBufferOp (midiBufferToUse);
 
             reusableInputIndex = 0;
         }
@@ -635,7 +1290,7 @@ struct RenderSequenceBuilder
                 auto srcIndex = getBufferContaining (sources.getUnchecked(i));
 
                 if (srcIndex >= 0)
-                    sequence.addAddMidiBufferOp (srcIndex, midiBufferToUse);
+                    currentStep->addAddMidiBufferOp (srcIndex, midiBufferToUse);
             }
         }
 
@@ -683,17 +1338,16 @@ struct RenderSequenceBuilder
         if (numOuts == 0)
             totalLatency = maxLatency;
 
-        sequence.addProcessOp (node, audioChannelsToUse, totalChans, midiBufferToUse);
+        currentStep->addProcessOp (audioChannelsToUse, totalChans, midiBufferToUse);
     }
 
     //==============================================================================
     Array<AudioProcessorGraph::NodeAndChannel> getSourcesForChannel (AudioProcessorGraph::Node& node, int inputChannelIndex)
     {
         Array<AudioProcessorGraph::NodeAndChannel> results;
-        AudioProcessorGraph::NodeAndChannel nc { node.nodeID, inputChannelIndex };
 
-        for (auto&& c : graph.getConnections())
-            if (c.destination == nc)
+        for (auto&& c : getConnectionsForNode (node.nodeID).inputs)
+            if (c.destination.channelIndex == inputChannelIndex)
                 results.add (c.source);
 
         return results;
@@ -735,71 +1389,199 @@ struct RenderSequenceBuilder
                               int inputChannelOfIndexToIgnore,
                               AudioProcessorGraph::NodeAndChannel output) const
     {
-        while (stepIndexToSearchFrom < orderedNodes.size())
-        {
-            auto* node = orderedNodes.getUnchecked (stepIndexToSearchFrom);
+        auto nodeIndex = getNodeIndex (output.nodeID);
 
-            if (output.isMIDI())
+        if (nodeIndex < 0)
+            return false;
+
+        for (auto&& c : nodeConnections.getReference (nodeIndex).outputs)
+        {
+            if (c.source.channelIndex == output.channelIndex)
             {
-                if (inputChannelOfIndexToIgnore != AudioProcessorGraph::midiChannelIndex
-                     && graph.isConnected ({ { output.nodeID, AudioProcessorGraph::midiChannelIndex },
-                                             { node->nodeID,  AudioProcessorGraph::midiChannelIndex } }))
+                auto destIndex = getConnectionsForNode (c.destination.nodeID).renderingIndex;
+
+                if (destIndex > stepIndexToSearchFrom
+                     || (destIndex == stepIndexToSearchFrom && c.destination.channelIndex != inputChannelOfIndexToIgnore))
                     return true;
             }
-            else
-            {
-                for (int i = 0; i < node->getProcessor()->getTotalNumInputChannels(); ++i)
-                    if (i != inputChannelOfIndexToIgnore && graph.isConnected ({ output, { node->nodeID, i } }))
-                        return true;
-            }
+        }
+
+        return false;
+    }
 
-            inputChannelOfIndexToIgnore = -1;
-            ++stepIndexToSearchFrom;
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderSequenceBuilder)
+};
+
+//==============================================================================
+AudioProcessorGraph::Connection::Connection (NodeAndChannel src, NodeAndChannel dst) noexcept
+    : source (src), destination (dst)
+{
+}
+
+bool AudioProcessorGraph::Connection::operator== (const Connection& other) const noexcept
+{
+    return source == other.source && destination == other.destination;
+}
+
+bool AudioProcessorGraph::Connection::operator!= (const Connection& c) const noexcept
+{
+    return ! operator== (c);
+}
+
+bool AudioProcessorGraph::Connection::operator< (const Connection& other) const noexcept
+{
+    if (source.nodeID != other.source.nodeID)
+        return source.nodeID < other.source.nodeID;
+
+    if (destination.nodeID != other.destination.nodeID)
+        return destination.nodeID < other.destination.nodeID;
+
+    if (source.channelIndex != other.source.channelIndex)
+        return source.channelIndex < other.source.channelIndex;
+
+    return destination.channelIndex < other.destination.channelIndex;
+}
+
+//==============================================================================
+struct AudioProcessorGraph::Node::RenderTimingData
+{
+    RenderTimingData() noexcept    { clear(); }
+
+    // Above the first few ticks, each doubling of the render time is split into 4 bins,
+    // so a bin's upper edge is never more than 25% above its lower one.
+    enum { binsPerOctave = 4, numBins = 44 * binsPerOctave };
+
+    static int getBinIndex (int64 ticks) noexcept
+    {
+        auto t = (uint64) jmax ((int64) 1, ticks);
+        int octave = 0;
+
+        while ((t >> octave) >= 2 * binsPerOctave)
+            ++octave;
+
+        return jmin ((int) numBins - 1, octave * binsPerOctave + (int) (t >> octave));
+    }
+
+    static int64 getBinUpperEdge (int bin) noexcept
+    {
+        auto octave = jmax (0, bin / binsPerOctave - 1);
+        auto base = bin - octave * binsPerOctave;
+        return (int64) (base + 1) << octave;
+    }
+
+    // Only the audio thread adds measurements, so the atomics just need to keep
+    // each value intact for any other threads that are reading them.
+    void add (int64 ticks) noexcept
+    {
+        applyPendingReset();
+
+        if (numBlocks.load (std::memory_order_relaxed) == 0 || ticks < minTicks.load (std::memory_order_relaxed))
+            minTicks.store (ticks, std::memory_order_relaxed);
+
+        if (ticks > maxTicks.load (std::memory_order_relaxed))
+            maxTicks.store (ticks, std::memory_order_relaxed);
+
+        totalTicks.fetch_add (ticks, std::memory_order_relaxed);
+        bins[getBinIndex (ticks)].fetch_add (1, std::memory_order_relaxed);
+        numBlocks.fetch_add (1, std::memory_order_release);
+    }
+
+    void addOverrun() noexcept
+    {
+        applyPendingReset();
+        numOverruns.fetch_add (1, std::memory_order_relaxed);
+    }
+
+    // Clearing the values from another thread could interleave with a measurement
+    // being added, so a reset is only requested here, and the thread that adds the
+    // measurements clears them before it adds the next one.
+    void reset() noexcept
+    {
+        resetPending.store (true, std::memory_order_release);
+    }
+
+    // The flag is only lowered once everything has been cleared, so that readers never
+    // see the old values. Another reset requested meanwhile has nothing left to clear.
+    void applyPendingReset() noexcept
+    {
+        if (resetPending.load (std::memory_order_acquire))
+        {
+            clear();
+            resetPending.store (false, std::memory_order_release);
         }
+    }
 
-        return false;
+    void clear() noexcept
+    {
+        numBlocks = 0;
+        numOverruns = 0;
+        totalTicks = 0;
+        minTicks = 0;
+        maxTicks = 0;
+
+        for (auto& b : bins)
+            b = 0;
     }
 
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderSequenceBuilder)
-};
+    RenderTimings getTimings() const noexcept
+    {
+        auto ticksToMs = [] (int64 ticks)  { return Time::highResolutionTicksToSeconds (ticks) * 1000.0; };
 
-//==============================================================================
-AudioProcessorGraph::Connection::Connection (NodeAndChannel src, NodeAndChannel dst) noexcept
-    : source (src), destination (dst)
-{
-}
+        RenderTimings timings;
 
-bool AudioProcessorGraph::Connection::operator== (const Connection& other) const noexcept
-{
-    return source == other.source && destination == other.destination;
-}
+        if (resetPending.load (std::memory_order_acquire))
+            return timings;
 
-bool AudioProcessorGraph::Connection::operator!= (const Connection& c) const noexcept
-{
-    return ! operator== (c);
-}
+        timings.numBlocks = numBlocks.load (std::memory_order_acquire);
+        timings.numOverruns = numOverruns.load (std::memory_order_relaxed);
 
-bool AudioProcessorGraph::Connection::operator< (const Connection& other) const noexcept
-{
-    if (source.nodeID != other.source.nodeID)
-        return source.nodeID < other.source.nodeID;
+        if (timings.numBlocks > 0)
+        {
+            timings.minimumMs = ticksToMs (minTicks.load (std::memory_order_relaxed));
+            timings.maximumMs = ticksToMs (maxTicks.load (std::memory_order_relaxed));
+            timings.meanMs = ticksToMs (totalTicks.load (std::memory_order_relaxed)) / (double) timings.numBlocks;
 
-    if (destination.nodeID != other.destination.nodeID)
-        return destination.nodeID < other.destination.nodeID;
+            int64 binTotals[numBins], numCounted = 0;
 
-    if (source.channelIndex != other.source.channelIndex)
-        return source.channelIndex < other.source.channelIndex;
+            for (int i = 0; i < numBins; ++i)
+                numCounted += (binTotals[i] = bins[i].load (std::memory_order_relaxed));
 
-    return destination.channelIndex < other.destination.channelIndex;
-}
+            auto target = (numCounted * 99 + 99) / 100;
+
+            int64 sum = 0;
+
+            for (int i = 0; i < numBins; ++i)
+            {
+                sum += binTotals[i];
+
+                if (sum >= target)
+                {
+                    timings.percentile99Ms = jmin (timings.maximumMs, ticksToMs (getBinUpperEdge (i)));
+                    break;
+                }
+            }
+        }
+
+        return timings;
+    }
+
+    std::atomic<int64> numBlocks, numOverruns, totalTicks, minTicks, maxTicks;
+    std::atomic<int64> bins[numBins];
+    std::atomic<bool> resetPending { false };
+
+    JUCE_DECLARE_NON_COPYABLE (RenderTimingData)
+};
 
-//==============================================================================
 AudioProcessorGraph::Node::Node (NodeID n, AudioProcessor* p) noexcept
-    : nodeID (n), processor (p)
+    : nodeID (n), processor (p), renderTimingData (new RenderTimingData())
 {
     jassert (processor != nullptr);
 }
 
+AudioProcessorGraph::Node::~Node()
+{
+}
+
 void AudioProcessorGraph::Node::prepare (double newSampleRate, int newBlockSize,
                                          AudioProcessorGraph* graph, ProcessingPrecision precision)
 {
@@ -851,6 +1633,26 @@ bool AudioProcessorGraph::Node::isBypassed() const noexcept
     return bypassed;
 }
 
+AudioProcessorGraph::Node::RenderTimings AudioProcessorGraph::Node::getRenderTimings() const noexcept
+{
+    return renderTimingData->getTimings();
+}
+
+void AudioProcessorGraph::Node::resetRenderTimings() noexcept
+{
+    renderTimingData->reset();
+}
+
+void AudioProcessorGraph::Node::addRenderTime (int64 ticks) noexcept
+{
+    renderTimingData->add (ticks);
+}
+
+void AudioProcessorGraph::Node::addRenderOverrun() noexcept
+{
+    renderTimingData->addOverrun();
+}
+
 void AudioProcessorGraph::Node::setBypassed (bool shouldBeBypassed) noexcept
 {
     if (processor != nullptr)
@@ -865,6 +1667,12 @@ void AudioProcessorGraph::Node::setBypassed (bool shouldBeBypassed) noexcept
 //==============================================================================
 struct AudioProcessorGraph::RenderSequenceFloat   : public GraphRenderSequence<float> {};
 struct AudioProcessorGraph::RenderSequenceDouble  : public GraphRenderSequence<double> {};
+struct AudioProcessorGraph::RenderingPlan         : public GraphRenderingPlan {};
+
+struct AudioProcessorGraph::RenderThreadPool  : public GraphRenderThreadPool
+{
+    using GraphRenderThreadPool::GraphRenderThreadPool;
+};
 
 //==============================================================================
 AudioProcessorGraph::AudioProcessorGraph()
@@ -877,6 +1685,32 @@ AudioProcessorGraph::~AudioProcessorGraph()
     clear();
 }
 
+//==============================================================================
+void AudioProcessorGraph::setNumParallelRenderThreads (int numThreads)
+{
+    jassert (numThreads >= 0);
+
+    if (numThreads == getNumParallelRenderThreads())
+        return;
+
+    std::unique_ptr<RenderThreadPool> newThreads (numThreads > 0 ? new RenderThreadPool (numThreads) : nullptr);
+
+    {
+        // The audio thread holds this lock for the whole of a render, and only looks up
+        // the pool once it has the lock, so once the swap is done nothing can still be
+        // using the old pool, and it's safe to delete it after the lock is released.
+        const ScopedLock sl (getCallbackLock());
+        std::swap (renderThreads, newThreads);
+    }
+
+    newThreads.reset();
+}
+
+int AudioProcessorGraph::getNumParallelRenderThreads() const noexcept
+{
+    return renderThreads != nullptr ? renderThreads->getNumThreads() : 0;
+}
+
 const String AudioProcessorGraph::getName() const
 {
     return "Audio Graph";
@@ -1200,22 +2034,25 @@ bool AudioProcessorGraph::anyNodesNeedPreparing() const noexcept
 
 void AudioProcessorGraph::buildRenderingSequence()
 {
+    auto startTicks = Time::getHighResolutionTicks();
+
     std::unique_ptr<RenderSequenceFloat>  newSequenceF (new RenderSequenceFloat());
     std::unique_ptr<RenderSequenceDouble> newSequenceD (new RenderSequenceDouble());
+    std::unique_ptr<RenderingPlan> newPlan (new RenderingPlan());
 
     {
         MessageManagerLock mml;
 
-        RenderSequenceBuilder<RenderSequenceFloat>  builderF (*this, *newSequenceF);
-        RenderSequenceBuilder<RenderSequenceDouble> builderD (*this, *newSequenceD);
-    }
+        RenderSequenceBuilder builder (*this, *newPlan, renderingPlan.get());
 
-    {
-        const ScopedLock sl (getCallbackLock());
-        newSequenceF->prepareBuffers (getBlockSize());
-        newSequenceD->prepareBuffers (getBlockSize());
+        newPlan->createOps (*newSequenceF);
+        newPlan->createOps (*newSequenceD);
     }
 
+    renderingPlan = std::move (newPlan);
+
+    auto planningEndTicks = Time::getHighResolutionTicks();
+
     if (anyNodesNeedPreparing())
     {
         {
@@ -1228,10 +2065,51 @@ void AudioProcessorGraph::buildRenderingSequence()
             node->prepare (getSampleRate(), getBlockSize(), this, getProcessingPrecision());
     }
 
+    auto preparationEndTicks = Time::getHighResolutionTicks();
+
+    {
+        const ScopedLock sl (getCallbackLock());
+
+        if (renderSequenceFloat != nullptr)   newSequenceF->takeBuffersFrom (*renderSequenceFloat);
+        if (renderSequenceDouble != nullptr)  newSequenceD->takeBuffersFrom (*renderSequenceDouble);
+
+        newSequenceF->measureRenderTimes = newSequenceD->measureRenderTimes = renderTimingEnabled;
+        newSequenceF->sampleRate = newSequenceD->sampleRate = getSampleRate();
+
+        newSequenceF->prepareBuffers (getBlockSize());
+        newSequenceD->prepareBuffers (getBlockSize());
+
+        std::swap (renderSequenceFloat, newSequenceF);
+        std::swap (renderSequenceDouble, newSequenceD);
+    }
+
+    auto endTicks = Time::getHighResolutionTicks();
+
+    auto ticksToMs = [] (int64 ticks)  { return Time::highResolutionTicksToSeconds (ticks) * 1000.0; };
+
+    lastRebuildStatistics.planningMs      = ticksToMs (planningEndTicks - startTicks);
+    lastRebuildStatistics.preparationMs   = ticksToMs (preparationEndTicks - planningEndTicks);
+    lastRebuildStatistics.bufferSwapMs    = ticksToMs (endTicks - preparationEndTicks);
+    lastRebuildStatistics.totalMs         = ticksToMs (endTicks - startTicks);
+    lastRebuildStatistics.numNodes        = nodes.size();
+    lastRebuildStatistics.numRenderingOps = renderSequenceFloat->getNumRenderingOps();
+    lastRebuildStatistics.numNodesReplanned = renderingPlan->steps.size() - renderingPlan->numStepsReused;
+    ++lastRebuildStatistics.numRebuilds;
+}
+
+AudioProcessorGraph::RebuildStatistics AudioProcessorGraph::getLastRebuildStatistics() const noexcept
+{
+    return lastRebuildStatistics;
+}
+
+void AudioProcessorGraph::setRenderTimingEnabled (bool shouldMeasureRenderTimes)
+{
     const ScopedLock sl (getCallbackLock());
 
-    std::swap (renderSequenceFloat, newSequenceF);
-    std::swap (renderSequenceDouble, newSequenceD);
+    renderTimingEnabled = shouldMeasureRenderTimes;
+
+    if (renderSequenceFloat != nullptr)   renderSequenceFloat->measureRenderTimes = shouldMeasureRenderTimes;
+    if (renderSequenceDouble != nullptr)  renderSequenceDouble->measureRenderTimes = shouldMeasureRenderTimes;
 }
 
 void AudioProcessorGraph::handleAsyncUpdate()
@@ -1297,10 +2175,13 @@ bool AudioProcessorGraph::producesMidi() const                      { return tru
 void AudioProcessorGraph::getStateInformation (juce::MemoryBlock&)  {}
 void AudioProcessorGraph::setStateInformation (const void*, int)    {}
 
-template <typename FloatType, typename SequenceType>
+// The thread pool must only be looked at while the callback lock is held, because
+// setNumParallelRenderThreads() swaps it under that lock before deleting the old one.
+template <typename FloatType, typename SequenceType, typename ThreadPoolType>
 static void processBlockForBuffer (AudioBuffer<FloatType>& buffer, MidiBuffer& midiMessages,
                                    AudioProcessorGraph& graph,
                                    std::unique_ptr<SequenceType>& renderSequence,
+                                   std::unique_ptr<ThreadPoolType>& renderThreads,
                                    Atomic<int>& isPrepared)
 {
     if (graph.isNonRealtime())
@@ -1311,7 +2192,7 @@ static void processBlockForBuffer (AudioBuffer<FloatType>& buffer, MidiBuffer& m
         const ScopedLock sl (graph.getCallbackLock());
 
         if (renderSequence != nullptr)
-            renderSequence->perform (buffer, midiMessages, graph.getPlayHead());
+            renderSequence->perform (buffer, midiMessages, graph.getPlayHead(), renderThreads.get());
     }
     else
     {
@@ -1320,7 +2201,7 @@ static void processBlockForBuffer (AudioBuffer<FloatType>& buffer, MidiBuffer& m
         if (isPrepared.get() == 1)
         {
             if (renderSequence != nullptr)
-                renderSequence->perform (buffer, midiMessages, graph.getPlayHead());
+                renderSequence->perform (buffer, midiMessages, graph.getPlayHead(), renderThreads.get());
         }
         else
         {
@@ -1335,7 +2216,7 @@ void AudioProcessorGraph::processBlock (AudioBuffer<float>& buffer, MidiBuffer&
     if (isPrepared.get() == 0 && MessageManager::getInstance()->isThisTheMessageThread())
         handleAsyncUpdate();
 
-    processBlockForBuffer<float> (buffer, midiMessages, *this, renderSequenceFloat, isPrepared);
+    processBlockForBuffer<float> (buffer, midiMessages, *this, renderSequenceFloat, renderThreads, isPrepared);
 }
 
 void AudioProcessorGraph::processBlock (AudioBuffer<double>& buffer, MidiBuffer& midiMessages)
@@ -1343,7 +2224,7 @@ void AudioProcessorGraph::processBlock (AudioBuffer<double>& buffer, MidiBuffer&
     if (isPrepared.get() == 0 && MessageManager::getInstance()->isThisTheMessageThread())
         handleAsyncUpdate();
 
-    processBlockForBuffer<double> (buffer, midiMessages, *this, renderSequenceDouble, isPrepared);
+    processBlockForBuffer<double> (buffer, midiMessages, *this, renderSequenceDouble, renderThreads, isPrepared);
 }
 
 //==============================================================================
@@ -1502,4 +2383,406 @@ void AudioProcessorGraph::AudioGraphIOProcessor::setParentGraph (AudioProcessorG
     }
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct AudioProcessorGraphRenderingTests  : public UnitTest
+{
+    AudioProcessorGraphRenderingTests()
+        : UnitTest ("AudioProcessorGraph rendering", UnitTestCategories::audio)
+    {}
+
+    // A simple recursive filter, so that the output depends on every block being
+    // rendered in the right order
+    struct FilterProcessor  : public AudioProcessor
+    {
+        FilterProcessor (float g, int latency = 0)
+            : AudioProcessor (BusesProperties().withInput  ("Input",  AudioChannelSet::stereo())
+                                               .withOutput ("Output", AudioChannelSet::stereo())),
+              gain (g)
+        {
+            setLatencySamples (latency);
+        }
+
+        const String getName() const override                             { return "Filter"; }
+        void prepareToPlay (double, int) override                         { state[0] = state[1] = 0; }
+        void releaseResources() override                                  {}
+        double getTailLengthSeconds() const override                      { return 0; }
+        bool acceptsMidi() const override                                 { return false; }
+        bool producesMidi() const override                                { return false; }
+        AudioProcessorEditor* createEditor() override                     { return nullptr; }
+        bool hasEditor() const override                                   { return false; }
+        int getNumPrograms() override                                     { return 1; }
+        int getCurrentProgram() override                                  { return 0; }
+        void setCurrentProgram (int) override                             {}
+        const String getProgramName (int) override                        { return {}; }
+        void changeProgramName (int, const String&) override              {}
+        void getStateInformation (juce::MemoryBlock&) override            {}
+        void setStateInformation (const void*, int) override              {}
+
+        void processBlock (AudioBuffer<float>& buffer, MidiBuffer&) override
+        {
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            {
+                auto* data = buffer.getWritePointer (ch);
+
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    data[i] = state[ch] = gain * data[i] + 0.5f * state[ch];
+            }
+        }
+
+        float gain, state[2];
+    };
+
+    // Has a stereo input but a mono output, so its second input channel is read-only. It
+    // adds that channel to the first one, and then scribbles over it, which is allowed.
+    struct ScribblingProcessor  : public AudioProcessor
+    {
+        ScribblingProcessor()
+            : AudioProcessor (BusesProperties().withInput  ("Input",  AudioChannelSet::stereo())
+                                               .withOutput ("Output", AudioChannelSet::mono()))
+        {}
+
+        const String getName() const override                             { return "Scribbler"; }
+        void prepareToPlay (double, int) override                         {}
+        void releaseResources() override                                  {}
+        double getTailLengthSeconds() const override                      { return 0; }
+        bool acceptsMidi() const override                                 { return false; }
+        bool producesMidi() const override                                { return false; }
+        AudioProcessorEditor* createEditor() override                     { return nullptr; }
+        bool hasEditor() const override                                   { return false; }
+        int getNumPrograms() override                                     { return 1; }
+        int getCurrentProgram() override                                  { return 0; }
+        void setCurrentProgram (int) override                             {}
+        const String getProgramName (int) override                        { return {}; }
+        void changeProgramName (int, const String&) override              {}
+        void getStateInformation (juce::MemoryBlock&) override            {}
+        void setStateInformation (const void*, int) override              {}
+
+        void processBlock (AudioBuffer<float>& buffer, MidiBuffer&) override
+        {
+            buffer.addFrom (0, 0, buffer, 1, 0, buffer.getNumSamples());
+            FloatVectorOperations::fill (buffer.getWritePointer (1), 1.0f, buffer.getNumSamples());
+        }
+    };
+
+    static void createGraph (AudioProcessorGraph& graph)
+    {
+        using IOProcessor = AudioProcessorGraph::AudioGraphIOProcessor;
+
+        graph.setPlayConfigDetails (2, 2, 44100.0, 256);
+
+        auto input  = graph.addNode (new IOProcessor (IOProcessor::audioInputNode))->nodeID;
+        auto output = graph.addNode (new IOProcessor (IOProcessor::audioOutputNode))->nodeID;
+
+        for (int chain = 0; chain < 6; ++chain)
+        {
+            auto previous = input;
+
+            for (int i = 0; i < chain % 3 + 1; ++i)
+            {
+                auto node = graph.addNode (new FilterProcessor (0.1f * (float) (chain + i + 1)))->nodeID;
+
+                for (int ch = 0; ch < 2; ++ch)
+                    graph.addConnection ({ { previous, ch }, { node, ch } });
+
+                previous = node;
+            }
+
+            for (int ch = 0; ch < 2; ++ch)
+                graph.addConnection ({ { previous, ch }, { output, ch } });
+        }
+
+        graph.prepareToPlay (44100.0, 256);
+    }
+
+    void runTest() override
+    {
+        beginTest ("Parallel rendering gives the same results as serial rendering");
+        {
+            AudioProcessorGraph serialGraph, parallelGraph;
+            createGraph (serialGraph);
+            createGraph (parallelGraph);
+            parallelGraph.setNumParallelRenderThreads (3);
+            expectEquals (parallelGraph.getNumParallelRenderThreads(), 3);
+
+            Random r (0x1234);
+            AudioBuffer<float> serialBuffer (2, 256), parallelBuffer (2, 256);
+            MidiBuffer midi;
+
+            for (int block = 0; block < 50; ++block)
+            {
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < serialBuffer.getNumSamples(); ++i)
+                        serialBuffer.setSample (ch, i, r.nextFloat() * 2.0f - 1.0f);
+
+                parallelBuffer.makeCopyOf (serialBuffer);
+
+                serialGraph.processBlock (serialBuffer, midi);
+                parallelGraph.processBlock (parallelBuffer, midi);
+                expect (serialBuffer.getMagnitude (0, 256) > 0.0f);
+
+                for (int ch = 0; ch < 2; ++ch)
+                    expect (std::equal (serialBuffer.getReadPointer (ch), serialBuffer.getReadPointer (ch) + 256,
+                                        parallelBuffer.getReadPointer (ch)));
+            }
+
+            parallelGraph.setNumParallelRenderThreads (0);
+            expectEquals (parallelGraph.getNumParallelRenderThreads(), 0);
+        }
+
+        beginTest ("Unconnected inputs are silent, even if other nodes write to theirs");
+        {
+            using IOProcessor = AudioProcessorGraph::AudioGraphIOProcessor;
+
+            for (auto numThreads : { 0, 3 })
+            {
+                AudioProcessorGraph graph;
+                graph.setPlayConfigDetails (1, 1, 44100.0, 256);
+
+                auto input  = graph.addNode (new IOProcessor (IOProcessor::audioInputNode))->nodeID;
+                auto output = graph.addNode (new IOProcessor (IOProcessor::audioOutputNode))->nodeID;
+
+                // only the first input of each node is connected
+                for (int i = 0; i < 4; ++i)
+                {
+                    auto node = graph.addNode (new ScribblingProcessor())->nodeID;
+                    graph.addConnection ({ { input, 0 }, { node, 0 } });
+                    graph.addConnection ({ { node, 0 }, { output, 0 } });
+                }
+
+                graph.prepareToPlay (44100.0, 256);
+                graph.setNumParallelRenderThreads (numThreads);
+
+                AudioBuffer<float> buffer (1, 256);
+                MidiBuffer midi;
+
+                for (int block = 0; block < 20; ++block)
+                {
+                    FloatVectorOperations::fill (buffer.getWritePointer (0), 0.25f, 256);
+                    graph.processBlock (buffer, midi);
+
+                    auto range = buffer.findMinMax (0, 0, 256);
+                    expectEquals (range.getStart(), 1.0f);
+                    expectEquals (range.getEnd(), 1.0f);
+                }
+
+                graph.setNumParallelRenderThreads (0);
+            }
+        }
+
+        beginTest ("Changing the number of render threads while rendering");
+        {
+            AudioProcessorGraph graph;
+            createGraph (graph);
+
+            struct AudioThread  : public Thread
+            {
+                AudioThread (AudioProcessorGraph& g)  : Thread ("Graph test audio thread"), graph (g) {}
+
+                void run() override
+                {
+                    AudioBuffer<float> buffer (2, 256);
+                    MidiBuffer midi;
+
+                    while (! threadShouldExit())
+                    {
+                        buffer.clear();
+                        buffer.setSample (0, 0, 1.0f);
+                        graph.processBlock (buffer, midi);
+                        ++numBlocks;
+                    }
+                }
+
+                AudioProcessorGraph& graph;
+                std::atomic<int> numBlocks { 0 };
+            };
+
+            AudioThread audioThread (graph);
+            audioThread.startThread();
+
+            for (int i = 0; i < 200; ++i)
+            {
+                graph.setNumParallelRenderThreads ((i % 4) == 3 ? 0 : (i % 4) + 1);
+                Thread::yield();
+            }
+
+            graph.setNumParallelRenderThreads (0);
+            audioThread.stopThread (10000);
+
+            expect (audioThread.numBlocks.load() > 0);
+        }
+
+        beginTest ("Rebuilding the rendering sequence updates the statistics");
+        {
+            AudioProcessorGraph graph;
+            createGraph (graph);
+
+            auto stats = graph.getLastRebuildStatistics();
+            expectEquals (stats.numNodes, graph.getNumNodes());
+            expect (stats.numRenderingOps > graph.getNumNodes());
+            expect (stats.numRebuilds > 0);
+            expect (stats.totalMs >= stats.planningMs);
+
+            graph.prepareToPlay (44100.0, 256);
+            expectEquals (graph.getLastRebuildStatistics().numRebuilds, stats.numRebuilds + 1);
+        }
+
+        beginTest ("Rebuilding after an edit gives the same sequence as building from scratch");
+        {
+            AudioProcessorGraph graph;
+            createGraph (graph);
+
+            Random r (0x4321);
+
+            for (int edit = 0; edit < 60; ++edit)
+            {
+                auto nodes = graph.getNodes();
+                auto connections = graph.getConnections();
+                auto source = nodes.getUnchecked (r.nextInt (nodes.size()));
+                auto dest   = nodes.getUnchecked (r.nextInt (nodes.size()));
+
+                switch (r.nextInt (4))
+                {
+                    case 0:
+                    {
+                        auto node = graph.addNode (new FilterProcessor (r.nextFloat(), r.nextInt (3) * 10))->nodeID;
+                        graph.addConnection ({ { source->nodeID, r.nextInt (2) }, { node, r.nextInt (2) } });
+                        graph.addConnection ({ { node, r.nextInt (2) }, { dest->nodeID, r.nextInt (2) } });
+                        break;
+                    }
+
+                    case 1:
+                        graph.addConnection ({ { source->nodeID, r.nextInt (2) }, { dest->nodeID, r.nextInt (2) } });
+                        break;
+
+                    case 2:
+                        if (! connections.empty())
+                            graph.removeConnection (connections[(size_t) r.nextInt ((int) connections.size())]);
+
+                        break;
+
+                    default:
+                        if (dynamic_cast<FilterProcessor*> (dest->getProcessor()) != nullptr)
+                            graph.removeNode (dest.get());
+
+                        break;
+                }
+
+                graph.prepareToPlay (44100.0, 256);
+                expectEquals (graph.getLastRebuildStatistics().numNodes, graph.getNumNodes());
+            }
+
+            // A graph with the same topology, built in one go
+            AudioProcessorGraph freshGraph;
+            freshGraph.setPlayConfigDetails (2, 2, 44100.0, 256);
+
+            for (auto* node : graph.getNodes())
+            {
+                using IOProcessor = AudioProcessorGraph::AudioGraphIOProcessor;
+
+                if (auto* filter = dynamic_cast<FilterProcessor*> (node->getProcessor()))
+                    freshGraph.addNode (new FilterProcessor (filter->gain, filter->getLatencySamples()), node->nodeID);
+                else if (auto* io = dynamic_cast<IOProcessor*> (node->getProcessor()))
+                    freshGraph.addNode (new IOProcessor (io->getType()), node->nodeID);
+            }
+
+            for (auto& c : graph.getConnections())
+                expect (freshGraph.addConnection (c));
+
+            freshGraph.prepareToPlay (44100.0, 256);
+
+            // Nothing has changed since the last rebuild, so the whole plan should be re-used
+            graph.prepareToPlay (44100.0, 256);
+            expectEquals (graph.getLastRebuildStatistics().numNodesReplanned, 0);
+            expectEquals (graph.getLatencySamples(), freshGraph.getLatencySamples());
+            expectEquals (graph.getLastRebuildStatistics().numRenderingOps,
+                          freshGraph.getLastRebuildStatistics().numRenderingOps);
+
+            AudioBuffer<float> buffer (2, 256), freshBuffer (2, 256);
+            MidiBuffer midi;
+
+            for (int block = 0; block < 20; ++block)
+            {
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < buffer.getNumSamples(); ++i)
+                        buffer.setSample (ch, i, r.nextFloat() * 2.0f - 1.0f);
+
+                freshBuffer.makeCopyOf (buffer);
+
+                graph.processBlock (buffer, midi);
+                freshGraph.processBlock (freshBuffer, midi);
+
+                for (int ch = 0; ch < 2; ++ch)
+                    expect (std::equal (buffer.getReadPointer (ch), buffer.getReadPointer (ch) + 256,
+                                        freshBuffer.getReadPointer (ch)));
+            }
+        }
+
+        beginTest ("Only the nodes affected by an edit are planned again");
+        {
+            AudioProcessorGraph graph;
+            createGraph (graph);
+
+            auto connections = graph.getConnections();
+            auto numNodes = graph.getNumNodes();
+            expectEquals (graph.getLastRebuildStatistics().numNodesReplanned, numNodes);
+
+            graph.removeConnection (connections.back());
+            graph.prepareToPlay (44100.0, 256);
+
+            auto numReplanned = graph.getLastRebuildStatistics().numNodesReplanned;
+            expect (numReplanned > 0 && numReplanned < numNodes);
+        }
+
+        beginTest ("Render times are measured for each node");
+        {
+            AudioProcessorGraph graph;
+            createGraph (graph);
+            graph.setRenderTimingEnabled (true);
+            expect (graph.isRenderTimingEnabled());
+
+            AudioBuffer<float> buffer (2, 256);
+            MidiBuffer midi;
+
+            for (int block = 0; block < 20; ++block)
+            {
+                buffer.clear();
+                graph.processBlock (buffer, midi);
+            }
+
+            for (auto* node : graph.getNodes())
+            {
+                auto timings = node->getRenderTimings();
+                expectEquals (timings.numBlocks, (int64) 20);
+                expect (timings.minimumMs <= timings.meanMs && timings.meanMs <= timings.maximumMs);
+                expect (timings.minimumMs <= timings.percentile99Ms && timings.percentile99Ms <= timings.maximumMs);
+
+                node->resetRenderTimings();
+                expectEquals (node->getRenderTimings().numBlocks, (int64) 0);
+            }
+
+            // the old measurements are only cleared when the next one is added
+            for (int block = 0; block < 5; ++block)
+                graph.processBlock (buffer, midi);
+
+            for (auto* node : graph.getNodes())
+            {
+                expectEquals (node->getRenderTimings().numBlocks, (int64) 5);
+                node->resetRenderTimings();
+            }
+
+            graph.setRenderTimingEnabled (false);
+            graph.processBlock (buffer, midi);
+
+            for (auto* node : graph.getNodes())
+                expectEquals (node->getRenderTimings().numBlocks, (int64) 0);
+        }
+    }
+};
+
+static AudioProcessorGraphRenderingTests audioProcessorGraphRenderingTests;
+
+#endif
+
 } // namespace juce
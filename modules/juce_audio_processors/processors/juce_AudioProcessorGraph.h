@@ -125,10 +125,51 @@ public:
         /** Tell this node to bypass processing. */
         void setBypassed (bool shouldBeBypassed) noexcept;
 
+        //==============================================================================
+        /** Statistics about the time this node's processor has spent rendering.
+            @see getRenderTimings, AudioProcessorGraph::setRenderTimingEnabled
+        */
+        struct RenderTimings
+        {
+            double minimumMs = 0;       /**< The quickest block that has been rendered. */
+            double meanMs = 0;          /**< The average time taken per block. */
+            double percentile99Ms = 0;  /**< 99% of blocks were rendered within this time (measured to within 25%). */
+            double maximumMs = 0;       /**< The slowest block that has been rendered. */
+            int64 numBlocks = 0;        /**< The number of blocks that have been measured. */
+
+            /** The number of blocks in which the graph took longer to render than the
+                duration of the audio, and this was the slowest node.
+            */
+            int64 numOverruns = 0;
+        };
+
+        /** Returns the render times that have been measured for this node.
+
+            The times are only measured while AudioProcessorGraph::setRenderTimingEnabled()
+            is turned on. This can be called from any thread, and never blocks the audio thread.
+        */
+        RenderTimings getRenderTimings() const noexcept;
+
+        /** Clears any render times that have been measured so far.
+
+            This can be called from any thread. The values are actually cleared by the
+            audio thread before it adds the next measurement, but getRenderTimings() won't
+            return any of the old ones after this has been called.
+        */
+        void resetRenderTimings() noexcept;
+
         //==============================================================================
         /** A convenient typedef for referring to a pointer to a node object. */
         using Ptr = ReferenceCountedObjectPtr<Node>;
 
+        /** Destructor. */
+        ~Node();
+
+        /** @internal */
+        void addRenderTime (int64 highResolutionTicks) noexcept;
+        /** @internal */
+        void addRenderOverrun() noexcept;
+
     private:
         //==============================================================================
         friend class AudioProcessorGraph;
@@ -145,6 +186,9 @@ public:
         Array<Connection> inputs, outputs;
         bool isPrepared = false, bypassed = false;
 
+        struct RenderTimingData;
+        std::unique_ptr<RenderTimingData> renderTimingData;
+
         Node (NodeID, AudioProcessor*) noexcept;
 
         void setParentGraph (AudioProcessorGraph*) const;
@@ -272,6 +316,64 @@ public:
     */
     bool removeIllegalConnections();
 
+    //==============================================================================
+    /** Lets the graph render independent branches on several cores.
+
+        With a non-zero number of threads, the graph works out which of its
+        rendering steps depend on each other, and a pool of real-time worker threads
+        helps the audio thread to perform the independent ones at the same time.
+        The results are exactly the same as when rendering on a single thread, and
+        no memory is allocated while rendering.
+
+        Only use this if all the processors in the graph can safely be called at the
+        same time as each other. Pass 0 to go back to rendering everything on the
+        audio thread, which is the default.
+    */
+    void setNumParallelRenderThreads (int numThreads);
+
+    /** Returns the number of worker threads used to render the graph in parallel.
+        @see setNumParallelRenderThreads
+    */
+    int getNumParallelRenderThreads() const noexcept;
+
+    //==============================================================================
+    /** Timing information about the last time the graph rebuilt its rendering sequence.
+        @see getLastRebuildStatistics
+    */
+    struct RebuildStatistics
+    {
+        double planningMs = 0;      /**< The time spent working out the rendering ops for the new topology. */
+        double preparationMs = 0;   /**< The time spent preparing any newly-added nodes. */
+        double bufferSwapMs = 0;    /**< The time spent holding the callback lock while the new sequence was swapped in. */
+        double totalMs = 0;         /**< The total time taken by the rebuild. */
+        int numNodes = 0;           /**< The number of nodes in the graph. */
+        int numRenderingOps = 0;    /**< The number of steps in the new rendering sequence. */
+        int numNodesReplanned = 0;  /**< The number of nodes whose rendering steps had to be worked out again, rather than being re-used from the previous rebuild. */
+        int numRebuilds = 0;        /**< The number of times the sequence has been rebuilt since the graph was created. */
+    };
+
+    /** Returns the timings of the last rebuild of the graph's rendering sequence.
+
+        The graph rebuilds its sequence asynchronously after nodes or connections
+        have changed, so a ChangeListener may need to wait for the next message before
+        the statistics have been updated. This should only be called on the message thread.
+    */
+    RebuildStatistics getLastRebuildStatistics() const noexcept;
+
+    //==============================================================================
+    /** Turns on measurement of the time each node takes to render.
+
+        While this is enabled, the graph times every node's processBlock() call and
+        adds it to the node's statistics, which can be read with Node::getRenderTimings().
+        It adds two clock reads per node to each block, so it's turned off by default.
+    */
+    void setRenderTimingEnabled (bool shouldMeasureRenderTimes);
+
+    /** Returns true if the graph is measuring the time each node takes to render.
+        @see setRenderTimingEnabled
+    */
+    bool isRenderTimingEnabled() const noexcept                     { return renderTimingEnabled; }
+
     //==============================================================================
     /** A special type of AudioProcessor that can live inside an AudioProcessorGraph
         in order to use the audio that comes into and out of the graph itself.
@@ -393,6 +495,15 @@ private:
     std::unique_ptr<RenderSequenceFloat> renderSequenceFloat;
     std::unique_ptr<RenderSequenceDouble> renderSequenceDouble;
 
+    struct RenderingPlan;
+    std::unique_ptr<RenderingPlan> renderingPlan;
+
+    struct RenderThreadPool;
+    std::unique_ptr<RenderThreadPool> renderThreads;
+
+    RebuildStatistics lastRebuildStatistics;
+    bool renderTimingEnabled = false;
+
     friend class AudioGraphIOProcessor;
 
     Atomic<int> isPrepared { 0 };
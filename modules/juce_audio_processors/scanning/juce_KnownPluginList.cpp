@@ -151,21 +151,20 @@ bool KnownPluginList::scanAndAddFile (const String& fileOrIdentifier,
         return false;
 
     OwnedArray<PluginDescription> found;
+    bool scanFailed = false;
 
     {
         const ScopedUnlock sl2 (scanLock);
 
         if (scanner != nullptr)
-        {
-            if (! scanner->findPluginTypesFor (format, found, fileOrIdentifier))
-                addToBlacklist (fileOrIdentifier);
-        }
+            scanFailed = ! scanner->findPluginTypesFor (format, found, fileOrIdentifier);
         else
-        {
             format.findAllTypesForFile (found, fileOrIdentifier);
-        }
     }
 
+    if (scanFailed)
+        addToBlacklist (fileOrIdentifier);
+
     for (auto* desc : found)
     {
         jassert (desc != nullptr);
@@ -0,0 +1,279 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+// Each request is the format name and the file or identifier to scan, and each reply
+// is an XML list of the types that were found.
+static const char* const scanResultsTag = "SCANNED_PLUGINS";
+
+//==============================================================================
+// The master side of the connection to one worker process.
+struct OutOfProcessPluginScanner::Worker  : public ChildProcessMaster
+{
+    ~Worker() override
+    {
+        // (this must happen before our members are deleted, in case a message is arriving)
+        killSlaveProcess();
+    }
+
+    bool scan (const MemoryBlock& request, MemoryBlock& reply, int timeoutMs)
+    {
+        {
+            const ScopedLock sl (lock);
+
+            if (connectionLost)
+                return false;
+
+            hasReply = false;
+        }
+
+        replyReceived.reset();
+
+        if (! sendMessageToSlave (request) || ! replyReceived.wait (timeoutMs))
+            return false;
+
+        const ScopedLock sl (lock);
+
+        if (! hasReply)
+            return false;
+
+        reply.swapWith (lastReply);
+        return true;
+    }
+
+    bool isConnected() const
+    {
+        const ScopedLock sl (lock);
+        return ! connectionLost;
+    }
+
+private:
+    // (these both get called on the connection's thread)
+    void handleMessageFromSlave (const MemoryBlock& message) override
+    {
+        {
+            const ScopedLock sl (lock);
+            lastReply = message;
+            hasReply = true;
+        }
+
+        replyReceived.signal();
+    }
+
+    void handleConnectionLost() override
+    {
+        {
+            const ScopedLock sl (lock);
+            connectionLost = true;
+        }
+
+        replyReceived.signal();
+    }
+
+    CriticalSection lock;
+    WaitableEvent replyReceived;
+    MemoryBlock lastReply;
+    bool hasReply = false, connectionLost = false;
+};
+
+//==============================================================================
+// The worker side, which runs in the child process.
+struct OutOfProcessPluginScanner::WorkerProcess  : public ChildProcessSlave,
+                                                   private DeletedAtShutdown
+{
+    WorkerProcess (std::function<void (AudioPluginFormatManager&)> addFormats)
+    {
+        if (addFormats != nullptr)
+            addFormats (formatManager);
+        else
+            formatManager.addDefaultFormats();
+    }
+
+    void handleMessageFromMaster (const MemoryBlock& message) override
+    {
+        // Plugins generally expect to be loaded on the message thread
+        MessageManager::callAsync ([this, message] { handleScanRequest (message); });
+    }
+
+    void handleConnectionLost() override
+    {
+        // If a plugin has hung on the message thread, it won't ever get round to quitting
+        if (isScanning.get() != 0)
+            Process::terminate();
+
+        JUCEApplicationBase::quit();
+    }
+
+    void handleScanRequest (const MemoryBlock& message)
+    {
+        MemoryInputStream input (message, false);
+        auto formatName = input.readString();
+        auto fileOrIdentifier = input.readString();
+
+        XmlElement results (scanResultsTag);
+
+        for (int i = 0; i < formatManager.getNumFormats(); ++i)
+        {
+            auto* format = formatManager.getFormat (i);
+
+            if (format->getName() == formatName)
+            {
+                OwnedArray<PluginDescription> found;
+
+                isScanning = 1;
+                format->findAllTypesForFile (found, fileOrIdentifier);
+                isScanning = 0;
+
+                for (auto* desc : found)
+                    results.addChildElement (desc->createXml());
+
+                break;
+            }
+        }
+
+        MemoryOutputStream reply;
+        reply.writeString (results.createDocument ({}, true, false));
+        sendMessageToMaster (reply.getMemoryBlock());
+    }
+
+    AudioPluginFormatManager formatManager;
+    Atomic<int> isScanning;
+};
+
+//==============================================================================
+OutOfProcessPluginScanner::OutOfProcessPluginScanner (const String& commandLineUniqueID,
+                                                      int scanTimeoutMs,
+                                                      const File& workerExecutable)
+    : commandLineID (commandLineUniqueID),
+      timeoutMs (scanTimeoutMs),
+      executable (workerExecutable != File() ? workerExecutable
+                                             : File::getSpecialLocation (File::currentExecutableFile))
+{
+}
+
+OutOfProcessPluginScanner::~OutOfProcessPluginScanner() {}
+
+std::unique_ptr<OutOfProcessPluginScanner::Worker> OutOfProcessPluginScanner::takeIdleWorker()
+{
+    {
+        const ScopedLock sl (lock);
+
+        while (! idleWorkers.isEmpty())
+        {
+            std::unique_ptr<Worker> worker (idleWorkers.removeAndReturn (idleWorkers.size() - 1));
+
+            if (worker->isConnected())
+                return worker;
+        }
+    }
+
+    std::unique_ptr<Worker> worker (new Worker());
+
+    if (worker->launchSlaveProcess (executable, commandLineID, 0, 0))
+        return worker;
+
+    return {};
+}
+
+void OutOfProcessPluginScanner::returnIdleWorker (std::unique_ptr<Worker> worker)
+{
+    const ScopedLock sl (lock);
+    idleWorkers.add (worker.release());
+}
+
+bool OutOfProcessPluginScanner::findPluginTypesFor (AudioPluginFormat& format,
+                                                    OwnedArray<PluginDescription>& result,
+                                                    const String& fileOrIdentifier)
+{
+    auto worker = takeIdleWorker();
+
+    if (worker == nullptr)
+    {
+        // Couldn't start a worker! Make sure that your app calls initialiseWorkerFromCommandLine()
+        // with the same ID when it starts up, or set onWorkerLaunchFailure to decide what happens.
+        jassert (onWorkerLaunchFailure != nullptr);
+
+        if (onWorkerLaunchFailure != nullptr && onWorkerLaunchFailure (fileOrIdentifier))
+            format.findAllTypesForFile (result, fileOrIdentifier);
+
+        // A file that couldn't be scanned isn't reported as a crash, so it won't be blacklisted
+        return true;
+    }
+
+    MemoryOutputStream request;
+    request.writeString (format.getName());
+    request.writeString (fileOrIdentifier);
+
+    MemoryBlock reply;
+
+    // If the worker crashed or hung, it gets deleted here, which shuts down its process
+    if (! worker->scan (request.getMemoryBlock(), reply, timeoutMs))
+        return false;
+
+    returnIdleWorker (std::move (worker));
+
+    MemoryInputStream replyStream (reply, false);
+
+    if (auto xml = std::unique_ptr<XmlElement> (XmlDocument::parse (replyStream.readString())))
+    {
+        if (xml->hasTagName (scanResultsTag))
+        {
+            forEachXmlChildElement (*xml, e)
+            {
+                std::unique_ptr<PluginDescription> desc (new PluginDescription());
+
+                if (desc->loadFromXml (*e))
+                    result.add (desc.release());
+            }
+        }
+    }
+
+    return true;
+}
+
+void OutOfProcessPluginScanner::scanFinished()
+{
+    const ScopedLock sl (lock);
+    idleWorkers.clear();
+}
+
+bool OutOfProcessPluginScanner::initialiseWorkerFromCommandLine (const String& commandLine,
+                                                                 const String& commandLineUniqueID,
+                                                                 std::function<void (AudioPluginFormatManager&)> addFormats)
+{
+    std::unique_ptr<WorkerProcess> worker (new WorkerProcess (std::move (addFormats)));
+
+    if (! worker->initialiseFromCommandLine (commandLine, commandLineUniqueID))
+        return false;
+
+    // (this will now be deleted by DeletedAtShutdown when the app quits)
+    worker.release();
+    return true;
+}
+
+} // namespace juce
@@ -0,0 +1,149 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A KnownPluginList::CustomScanner which loads each plugin in a separate worker
+    process, so that a plugin which crashes or hangs while it's being scanned can't
+    bring down your app.
+
+    The workers are copies of your own executable, launched with a special command
+    line using ChildProcessMaster. To make this work, your app must check its command
+    line as early as possible when it starts up, and hand it to
+    initialiseWorkerFromCommandLine(), e.g.
+
+    @code
+    void initialise (const String& commandLine) override
+    {
+        if (OutOfProcessPluginScanner::initialiseWorkerFromCommandLine (commandLine, "pluginScanner"))
+            return; // this process is a scanning worker, so don't create any windows, etc.
+
+        ...
+    }
+    @endcode
+
+    ..and then give the list a scanner which uses the same ID:
+
+    @code
+    knownPluginList.setCustomScanner (new OutOfProcessPluginScanner ("pluginScanner"));
+    @endcode
+
+    It can be called from several threads at once, in which case each thread gets its
+    own worker process, so it works well with
+    PluginDirectoryScanner::scanRemainingFilesInParallel(). The workers are re-used
+    from one file to the next, and are shut down when the scan is finished.
+
+    If a worker crashes, or takes longer than the timeout to scan a file, the file is
+    reported as having crashed, so the list will blacklist it, and the worker is
+    replaced by a new one. If a worker can't be launched at all, the file is skipped,
+    unless onWorkerLaunchFailure says otherwise.
+
+    @see KnownPluginList::setCustomScanner, PluginDirectoryScanner, ChildProcessMaster
+
+    @tags{Audio}
+*/
+class JUCE_API  OutOfProcessPluginScanner  : public KnownPluginList::CustomScanner
+{
+public:
+    //==============================================================================
+    /** Creates a scanner.
+
+        @param commandLineUniqueID  an ID which the workers will use to recognise their
+                                    command line - this must match the one that your app
+                                    passes to initialiseWorkerFromCommandLine()
+        @param scanTimeoutMs        the longest that a worker is allowed to spend on one
+                                    file before it's assumed to have hung, or -1 to wait
+                                    for as long as it takes
+        @param workerExecutable     the executable to launch, or File() to use the one
+                                    that's currently running
+    */
+    OutOfProcessPluginScanner (const String& commandLineUniqueID,
+                               int scanTimeoutMs = 60000,
+                               const File& workerExecutable = {});
+
+    /** Destructor. */
+    ~OutOfProcessPluginScanner() override;
+
+    //==============================================================================
+    /** Called when a worker process can't be launched, which usually means that your
+        app isn't passing its command line to initialiseWorkerFromCommandLine() with
+        the same ID.
+
+        It's called on the thread that's doing the scan, with the file that was about to
+        be scanned. Return true to scan the file in this process instead, at the risk of
+        a crashing plugin taking your app down with it, or false to skip it. Skipped files
+        aren't blacklisted, so they'll be tried again by the next scan.
+
+        If this isn't set, the file is skipped.
+    */
+    std::function<bool (const String& fileOrIdentifier)> onWorkerLaunchFailure;
+
+    //==============================================================================
+    /** @internal */
+    bool findPluginTypesFor (AudioPluginFormat&, OwnedArray<PluginDescription>&, const String&) override;
+    /** @internal */
+    void scanFinished() override;
+
+    //==============================================================================
+    /** Checks whether this process was launched as a scanning worker, and if so,
+        starts it running as one.
+
+        If this returns true, the worker will handle scanning requests on the message
+        thread until the process that launched it goes away, and then it'll quit the
+        app by calling JUCEApplicationBase::quit().
+
+        @param commandLine          the command line that the app was launched with
+        @param commandLineUniqueID  the ID that was passed to the OutOfProcessPluginScanner
+        @param addFormats           if this is supplied, it's called to add the formats that
+                                    the worker can scan to its AudioPluginFormatManager. If
+                                    not, the default formats are used.
+    */
+    static bool initialiseWorkerFromCommandLine (const String& commandLine,
+                                                 const String& commandLineUniqueID,
+                                                 std::function<void (AudioPluginFormatManager&)> addFormats = {});
+
+private:
+    //==============================================================================
+    struct Worker;
+    struct WorkerProcess;
+
+    const String commandLineID;
+    const int timeoutMs;
+    const File executable;
+
+    CriticalSection lock;
+    OwnedArray<Worker> idleWorkers;
+
+    std::unique_ptr<Worker> takeIdleWorker();
+    void returnIdleWorker (std::unique_ptr<Worker>);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OutOfProcessPluginScanner)
+};
+
+} // namespace juce
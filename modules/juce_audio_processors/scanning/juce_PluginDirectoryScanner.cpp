@@ -52,6 +52,7 @@ PluginDirectoryScanner::PluginDirectoryScanner (KnownPluginList& listToAddTo,
 
 PluginDirectoryScanner::~PluginDirectoryScanner()
 {
+    restoreScanOrder();
     list.scanFinished();
 }
 
@@ -69,6 +70,11 @@ void PluginDirectoryScanner::setFilesOrIdentifiersToScan (const StringArray& fil
 
     applyBlacklistingsFromDeadMansPedal (list, deadMansPedalFile);
     nextIndex.set (filesOrIdentifiersToScan.size());
+
+    typesKnownBeforeScan.clear();
+
+    for (auto* type : list)
+        typesKnownBeforeScan.add (type->createIdentifierString());
 }
 
 String PluginDirectoryScanner::getNextPluginFileThatWillBeScanned() const
@@ -78,7 +84,7 @@ String PluginDirectoryScanner::getNextPluginFileThatWillBeScanned() const
 
 void PluginDirectoryScanner::updateProgress()
 {
-    progress = (1.0f - nextIndex.get() / (float) filesOrIdentifiersToScan.size());
+    progress = (1.0f - jmax (0, nextIndex.get()) / (float) filesOrIdentifiersToScan.size());
 }
 
 bool PluginDirectoryScanner::scanNextFile (bool dontRescanIfAlreadyInList,
@@ -94,22 +100,41 @@ bool PluginDirectoryScanner::scanNextFile (bool dontRescanIfAlreadyInList,
         {
             nameOfPluginBeingScanned = format.getNameOfPluginFromIdentifier (file);
 
-            OwnedArray<PluginDescription> typesFound;
+            std::unique_ptr<ScannedFile> scanned (new ScannedFile());
+            scanned->index = index;
+
+            {
+                const ScopedLock sl (resultsLock);
+
+                // Add this plugin to the end of the dead-man's pedal list in case it crashes...
+                auto crashedPlugins = readDeadMansPedalFile (deadMansPedalFile);
+                crashedPlugins.removeString (file);
+                crashedPlugins.add (file);
+                setDeadMansPedalFile (crashedPlugins);
+
+                if (numScansInProgress.get() > 0)
+                    wasScannedConcurrently = true;
+
+                ++numScansInProgress;
+            }
 
-            // Add this plugin to the end of the dead-man's pedal list in case it crashes...
-            auto crashedPlugins = readDeadMansPedalFile (deadMansPedalFile);
-            crashedPlugins.removeString (file);
-            crashedPlugins.add (file);
-            setDeadMansPedalFile (crashedPlugins);
+            list.scanAndAddFile (file, dontRescanIfAlreadyInList, scanned->typesFound, format);
 
-            list.scanAndAddFile (file, dontRescanIfAlreadyInList, typesFound, format);
+            {
+                const ScopedLock sl (resultsLock);
+                --numScansInProgress;
 
-            // Managed to load without crashing, so remove it from the dead-man's-pedal..
-            crashedPlugins.removeString (file);
-            setDeadMansPedalFile (crashedPlugins);
+                // Managed to load without crashing, so remove it from the dead-man's-pedal..
+                // (other threads may have changed it in the meantime, so it has to be re-read)
+                auto crashedPlugins = readDeadMansPedalFile (deadMansPedalFile);
+                crashedPlugins.removeString (file);
+                setDeadMansPedalFile (crashedPlugins);
 
-            if (typesFound.size() == 0 && ! list.getBlacklistedFiles().contains (file))
-                failedFiles.add (file);
+                if (scanned->typesFound.size() == 0 && ! list.getBlacklistedFiles().contains (file))
+                    failedFiles.add (file);
+
+                scannedFiles.add (scanned.release());
+            }
         }
     }
 
@@ -123,6 +148,77 @@ bool PluginDirectoryScanner::skipNextFile()
     return --nextIndex > 0;
 }
 
+void PluginDirectoryScanner::scanRemainingFilesInParallel (bool dontRescanIfAlreadyInList, int numThreads)
+{
+    if (numThreads <= 0)
+        numThreads = SystemStats::getNumCpus();
+
+    numThreads = jlimit (1, jmax (1, nextIndex.get()), numThreads);
+
+    WaitableEvent finished;
+    Atomic<int> numThreadsRunning (numThreads);
+
+    {
+        ThreadPool pool (numThreads);
+
+        for (int i = 0; i < numThreads; ++i)
+        {
+            pool.addJob ([&]
+            {
+                String pluginBeingScanned;
+
+                while (scanNextFile (dontRescanIfAlreadyInList, pluginBeingScanned))
+                {}
+
+                if (--numThreadsRunning == 0)
+                    finished.signal();
+            });
+        }
+
+        finished.wait();
+    }
+
+    restoreScanOrder();
+}
+
+void PluginDirectoryScanner::restoreScanOrder()
+{
+    // When the files are scanned one at a time, the scanner works backwards through them,
+    // and each new type gets inserted at the start of the list. Replaying that here puts
+    // the list into the same order, whatever order the threads actually finished in.
+    if (wasScannedConcurrently)
+    {
+        std::sort (scannedFiles.begin(), scannedFiles.end(),
+                   [] (const ScannedFile* a, const ScannedFile* b) { return a->index > b->index; });
+
+        auto typesAlreadyPlaced = typesKnownBeforeScan;
+
+        for (auto* scanned : scannedFiles)
+        {
+            for (auto* type : scanned->typesFound)
+            {
+                // (addType() only moves a type to the front the first time it's seen)
+                if (! typesAlreadyPlaced.add (type->createIdentifierString()))
+                    continue;
+
+                for (int i = list.getNumTypes(); --i > 0;)
+                {
+                    if (list.getType (i)->isDuplicateOf (*type))
+                    {
+                        auto current = *list.getType (i);
+                        list.removeType (i);
+                        list.addType (current);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    scannedFiles.clear();
+    wasScannedConcurrently = false;
+}
+
 void PluginDirectoryScanner::setDeadMansPedalFile (const StringArray& newContents)
 {
     if (deadMansPedalFile.getFullPathName().isNotEmpty())
@@ -137,4 +233,138 @@ void PluginDirectoryScanner::applyBlacklistingsFromDeadMansPedal (KnownPluginLis
         list.addToBlacklist (crashedPlugin);
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct PluginDirectoryScannerTests  : public UnitTest
+{
+    PluginDirectoryScannerTests()
+        : UnitTest ("PluginDirectoryScanner", UnitTestCategories::audio)
+    {}
+
+    // Pretends that "fake:N" contains N % 3 plugins, and takes a random time to scan each one
+    struct FakeFormat  : public AudioPluginFormat
+    {
+        String getName() const override                                         { return "Fake"; }
+        bool fileMightContainThisPluginType (const String& f) override          { return f.startsWith ("fake:"); }
+        String getNameOfPluginFromIdentifier (const String& f) override         { return f; }
+        bool pluginNeedsRescanning (const PluginDescription&) override          { return false; }
+        bool doesPluginStillExist (const PluginDescription&) override           { return true; }
+        bool canScanForPlugins() const override                                 { return true; }
+        FileSearchPath getDefaultLocationsToSearch() override                   { return {}; }
+
+        StringArray searchPathsForPlugins (const FileSearchPath&, bool, bool) override
+        {
+            StringArray files;
+
+            for (int i = 0; i < 40; ++i)
+                files.add ("fake:" + String (i));
+
+            return files;
+        }
+
+        void findAllTypesForFile (OwnedArray<PluginDescription>& results, const String& file) override
+        {
+            auto index = file.fromFirstOccurrenceOf (":", false, false).getIntValue();
+            Thread::sleep (Random().nextInt (3));
+
+            for (int i = 0; i < index % 3; ++i)
+            {
+                auto* desc = results.add (new PluginDescription());
+                desc->name = "Fake " + String (index) + "." + String (i);
+                desc->pluginFormatName = getName();
+                desc->fileOrIdentifier = file;
+                desc->uid = index * 10 + i;
+            }
+        }
+
+        void createPluginInstance (const PluginDescription&, double, int, void* userData,
+                                   PluginCreationCallback callback) override
+        {
+            callback (userData, nullptr, "Can't create fake plugins");
+        }
+
+        bool requiresUnblockedMessageThreadDuringCreation (const PluginDescription&) const noexcept override
+        {
+            return false;
+        }
+    };
+
+    static StringArray getListContents (const KnownPluginList& list)
+    {
+        StringArray ids;
+
+        for (auto* type : list)
+            ids.add (type->createIdentifierString());
+
+        return ids;
+    }
+
+    void runTest() override
+    {
+        beginTest ("Parallel scanning gives the same results as a sequential scan");
+        {
+            FakeFormat format;
+
+            KnownPluginList sequentialList;
+            StringArray sequentialFailures;
+
+            {
+                PluginDirectoryScanner scanner (sequentialList, format, {}, true, {});
+                String nameOfPluginBeingScanned;
+
+                while (scanner.scanNextFile (true, nameOfPluginBeingScanned))
+                {}
+
+                expectEquals (scanner.getProgress(), 1.0f);
+                sequentialFailures = scanner.getFailedFiles();
+            }
+
+            expectEquals (sequentialList.getNumTypes(), 39);
+            expectEquals (sequentialFailures.size(), 14);
+
+            for (int numThreads = 1; numThreads <= 8; numThreads *= 2)
+            {
+                KnownPluginList parallelList;
+                PluginDirectoryScanner scanner (parallelList, format, {}, true, {});
+                scanner.scanRemainingFilesInParallel (true, numThreads);
+
+                expectEquals (scanner.getProgress(), 1.0f);
+                expect (getListContents (parallelList) == getListContents (sequentialList));
+
+                auto parallelFailures = scanner.getFailedFiles();
+                parallelFailures.sort (true);
+                sequentialFailures.sort (true);
+                expect (parallelFailures == sequentialFailures);
+            }
+        }
+
+        beginTest ("Types that were already known keep their positions");
+        {
+            FakeFormat format;
+            KnownPluginList list;
+
+            {
+                OwnedArray<PluginDescription> found;
+                list.scanAndAddFile ("fake:5", false, found, format);
+            }
+
+            auto before = getListContents (list);
+
+            PluginDirectoryScanner scanner (list, format, {}, true, {});
+            scanner.scanRemainingFilesInParallel (false, 4);
+
+            auto after = getListContents (list);
+            expectEquals (after.size(), 39);
+            expect (after[after.size() - 2] == before[0]);
+            expect (after[after.size() - 1] == before[1]);
+        }
+    }
+};
+
+static PluginDirectoryScannerTests pluginDirectoryScannerTests;
+
+#endif
+
 } // namespace juce
@@ -32,7 +32,16 @@ namespace juce
     Scans a directory for plugins, and adds them to a KnownPluginList.
 
     To use one of these, create it and call scanNextFile() repeatedly, until
-    it returns false.
+    it returns false, or call scanRemainingFilesInParallel() to scan several files
+    at once.
+
+    scanNextFile() can be called from several threads at once (which is what
+    PluginListComponent does if you give it some threads to use). The types are
+    still added to the list in the same order that a single thread would have
+    produced, although this order is only restored once all of the files have
+    been scanned.
+
+    @see OutOfProcessPluginScanner
 
     @tags{Audio}
 */
@@ -99,6 +108,28 @@ public:
     */
     bool skipNextFile();
 
+    /** Scans all the files that are left, using a number of threads to scan several
+        of them at once, and returns when they've all been done.
+
+        Each file is scanned by KnownPluginList::scanAndAddFile(), so if the list has
+        a CustomScanner, it must be able to handle calls from several threads at once.
+        OutOfProcessPluginScanner can, and it will also mean that a plugin which crashes
+        only takes down the process that was scanning it.
+
+        If you scan in-process, bear in mind that the formats must be safe to use from
+        background threads, and that if one of the plugins crashes, all the files that
+        were being scanned at the time will be added to the dead-man's-pedal file.
+
+        This blocks the calling thread until the scan is complete, so if you call it from
+        the message thread, any formats which need to use the message thread during
+        scanning will deadlock.
+
+        @param dontRescanIfAlreadyInList    see scanNextFile()
+        @param numThreads                   the number of files to scan at once. If this is
+                                            zero or less, the number of CPU cores is used
+    */
+    void scanRemainingFilesInParallel (bool dontRescanIfAlreadyInList, int numThreads = 0);
+
     /** Returns the description of the plugin that will be scanned during the next
         call to scanNextFile().
 
@@ -108,7 +139,7 @@ public:
     String getNextPluginFileThatWillBeScanned() const;
 
     /** Returns the estimated progress, between 0 and 1. */
-    float getProgress() const                                       { return progress; }
+    float getProgress() const                                       { return progress.get(); }
 
     /** This returns a list of all the filenames of things that looked like being
         a plugin file, but which failed to open for some reason.
@@ -121,17 +152,29 @@ public:
 
 private:
     //==============================================================================
+    struct ScannedFile
+    {
+        int index;
+        OwnedArray<PluginDescription> typesFound;
+    };
+
     KnownPluginList& list;
     AudioPluginFormat& format;
     StringArray filesOrIdentifiersToScan;
     File deadMansPedalFile;
     StringArray failedFiles;
-    Atomic<int> nextIndex;
-    float progress = 0;
+    Atomic<int> nextIndex, numScansInProgress;
+    Atomic<float> progress { 0.0f };
     const bool allowAsync;
 
+    CriticalSection resultsLock;
+    SortedSet<String> typesKnownBeforeScan;
+    OwnedArray<ScannedFile> scannedFiles;
+    bool wasScannedConcurrently = false;
+
     void updateProgress();
     void setDeadMansPedalFile (const StringArray& newContents);
+    void restoreScanOrder();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginDirectoryScanner)
 };
@@ -65,6 +65,72 @@ bool AudioProcessorValueTreeState::Parameter::isAutomatable() const     { return
 bool AudioProcessorValueTreeState::Parameter::isDiscrete() const        { return discrete; }
 bool AudioProcessorValueTreeState::Parameter::isBoolean() const         { return boolean; }
 
+//==============================================================================
+/*  A lock-free queue of the adapters whose values need to be written to the tree.
+
+    Any number of threads may push adapters, but only one thread at a time may pop
+    them. If the queue fills up, the pushes that didn't fit are dropped and the
+    consumer is told to check every parameter instead.
+*/
+class AudioProcessorValueTreeState::DirtyParameterQueue
+{
+public:
+    DirtyParameterQueue() noexcept
+    {
+        for (auto& slot : slots)
+            slot.store (nullptr, std::memory_order_relaxed);
+    }
+
+    void push (ParameterAdapter& adapter) noexcept
+    {
+        auto pos = writePos.load();
+
+        do
+        {
+            if (pos - readPos.load() >= capacity)
+            {
+                needsFullScan = true;
+                return;
+            }
+        }
+        while (! writePos.compare_exchange_weak (pos, pos + 1));
+
+        slots[pos & (capacity - 1)].store (&adapter, std::memory_order_release);
+    }
+
+    void requestFullScan() noexcept     { needsFullScan = true; }
+
+    /*  Calls the callback for each adapter that has been pushed, and returns false if
+        some pushes were dropped, in which case the caller must check every adapter.
+    */
+    template <typename Callback>
+    bool popAll (Callback&& callback)
+    {
+        for (auto pos = readPos.load(), end = writePos.load(); pos != end; ++pos)
+        {
+            auto* adapter = slots[pos & (capacity - 1)].exchange (nullptr, std::memory_order_acquire);
+
+            // A writer has claimed this slot but not filled it yet, so leave it for next time
+            if (adapter == nullptr)
+                break;
+
+            readPos.store (pos + 1);
+            callback (*adapter);
+        }
+
+        return ! needsFullScan.exchange (false);
+    }
+
+private:
+    static constexpr uint32 capacity = 1024;
+
+    std::atomic<ParameterAdapter*> slots[capacity];
+    std::atomic<uint32> writePos { 0 }, readPos { 0 };
+    std::atomic<bool> needsFullScan { true };
+
+    JUCE_DECLARE_NON_COPYABLE (DirtyParameterQueue)
+};
+
 //==============================================================================
 class AudioProcessorValueTreeState::ParameterAdapter   : private AudioProcessorParameter::Listener
 {
@@ -72,8 +138,9 @@ private:
     using Listener = AudioProcessorValueTreeState::Listener;
 
 public:
-    explicit ParameterAdapter (RangedAudioParameter& parameterIn)
+    explicit ParameterAdapter (RangedAudioParameter& parameterIn, DirtyParameterQueue* queue = nullptr)
         : parameter (parameterIn),
+          dirtyQueue (queue),
           // For legacy reasons, the unnormalised value should *not* be snapped on construction
           unnormalisedValue (getRange().convertFrom0to1 (parameter.getDefaultValue()))
     {
@@ -151,7 +218,9 @@ private:
         unnormalisedValue = newValue;
         listeners.call ([=](Listener& l) { l.parameterChanged (parameter.paramID, unnormalisedValue); });
         listenersNeedCalling = false;
-        needsUpdate = true;
+
+        if (! needsUpdate.exchange (true) && dirtyQueue != nullptr)
+            dirtyQueue->push (*this);
     }
 
     float denormalise (float normalised) const
@@ -173,6 +242,7 @@ private:
     }
 
     RangedAudioParameter& parameter;
+    DirtyParameterQueue* dirtyQueue;
     ListenerList<Listener> listeners;
     float unnormalisedValue{};
     std::atomic<bool> needsUpdate { true };
@@ -238,7 +308,7 @@ AudioProcessorValueTreeState::AudioProcessorValueTreeState (AudioProcessor& proc
 }
 
 AudioProcessorValueTreeState::AudioProcessorValueTreeState (AudioProcessor& p, UndoManager* um)
-    : processor (p), undoManager (um)
+    : processor (p), undoManager (um), dirtyParameters (std::make_unique<DirtyParameterQueue>())
 {
     startTimerHz (10);
     state.addListener (this);
@@ -292,7 +362,7 @@ RangedAudioParameter* AudioProcessorValueTreeState::createAndAddParameter (std::
 //==============================================================================
 void AudioProcessorValueTreeState::addParameterAdapter (RangedAudioParameter& param)
 {
-    adapterTable.emplace (param.paramID, std::make_unique<ParameterAdapter> (param));
+    adapterTable.emplace (param.paramID, std::make_unique<ParameterAdapter> (param, dirtyParameters.get()));
 }
 
 AudioProcessorValueTreeState::ParameterAdapter* AudioProcessorValueTreeState::getParameterAdapter (StringRef paramID) const
@@ -396,6 +466,7 @@ void AudioProcessorValueTreeState::updateParameterConnectionsToChildTrees()
         }
     }
 
+    dirtyParameters->requestFullScan();
     flushParameterValuesToValueTree();
 }
 
@@ -423,8 +494,16 @@ bool AudioProcessorValueTreeState::flushParameterValuesToValueTree()
 
     bool anyUpdated = false;
 
-    for (auto& p : adapterTable)
-        anyUpdated |= p.second->flushToTree (valuePropertyID, undoManager);
+    auto flush = [this, &anyUpdated] (ParameterAdapter& adapter)
+    {
+        anyUpdated |= adapter.flushToTree (valuePropertyID, undoManager);
+    };
+
+    // Normally only the parameters that have changed since the last flush need
+    // looking at, but if too many changed at once, we'll have to check them all.
+    if (! dirtyParameters->popAll (flush))
+        for (auto& p : adapterTable)
+            flush (*p.second);
 
     return anyUpdated;
 }
@@ -1029,6 +1108,34 @@ public:
             expectEquals (*proc.state.getRawParameterValue (key), value);
         }
 
+        beginTest ("Changed parameter values are flushed to the state, however many of them change");
+        {
+            for (auto numToChange : { 0, 3, 2000 })
+            {
+                TestAudioProcessor proc;
+                Array<RangedAudioParameter*> params;
+
+                for (int i = 0; i < 2000; ++i)
+                    params.add (proc.state.createAndAddParameter (std::make_unique<Parameter> ("p" + String (i), String(), String(),
+                                                                                               NormalisableRange<float>(),
+                                                                                               0.0f, nullptr, nullptr)));
+
+                proc.state.state = ValueTree { "state" };
+
+                for (int i = 0; i < numToChange; ++i)
+                    params[(i * 7) % params.size()]->setValueNotifyingHost (0.25f + (float) (i % 3) * 0.25f);
+
+                const auto valueTree = proc.state.copyState();
+                expectEquals (valueTree.getNumChildren(), params.size());
+
+                for (auto child : valueTree)
+                {
+                    const auto* param = proc.state.getParameter (child["id"].toString());
+                    expectEquals ((float) child["value"], param->convertFrom0to1 (param->getValue()));
+                }
+            }
+        }
+
         beginTest ("After adding an APVTS::Parameter, its value is the default value");
         {
             TestAudioProcessor proc;
@@ -521,6 +521,7 @@ private:
 
     //==============================================================================
     class ParameterAdapter;
+    class DirtyParameterQueue;
 
    #if JUCE_UNIT_TESTS
     friend struct ParameterAdapterTests;
@@ -545,6 +546,7 @@ private:
         bool operator() (StringRef a, StringRef b) const noexcept { return a.text.compare (b.text) < 0; }
     };
 
+    std::unique_ptr<DirtyParameterQueue> dirtyParameters;
     std::map<StringRef, std::unique_ptr<ParameterAdapter>, StringRefLessThan> adapterTable;
 
     CriticalSection valueTreeChanging;
@@ -100,6 +100,7 @@ public:
 
     ~LevelDataSource() override
     {
+        stopLoadingJobs();
         owner.cache.getTimeSliceThread().removeTimeSliceClient (this);
     }
 
@@ -120,9 +121,16 @@ public:
             sampleRate = reader->sampleRate;
 
             if (lengthInSamples <= 0 || isFullyLoaded())
+            {
                 reader.reset();
+            }
             else
+            {
+                if (owner.loadingThreadPool != nullptr)
+                    startLoadingJobs (*owner.loadingThreadPool);
+
                 owner.cache.getTimeSliceThread().addTimeSliceClient (this);
+            }
         }
     }
 
@@ -173,6 +181,11 @@ public:
             return -1;
         }
 
+        // the levels are being read by the loading jobs, so there's nothing to do but wait
+        // (if any of them failed, the whole source gets read here once they've all finished)
+        if (numRangesToLoad > 0)
+            return 200;
+
         bool justFinished = false;
 
         {
@@ -210,12 +223,19 @@ public:
     int64 hashCode = 0;
 
 private:
+    class LoadingJob;
+
     AudioThumbnail& owner;
     std::unique_ptr<InputSource> source;
     std::unique_ptr<AudioFormatReader> reader;
     CriticalSection readerLock;
     std::atomic<uint32> lastReaderUseTime { 0 };
 
+    ThreadPool* loadingPool = nullptr;
+    OwnedArray<LoadingJob> loadingJobs;
+    std::atomic<int> numRangesToLoad { 0 };
+    std::atomic<bool> loadingJobFailed { false };
+
     void createReader()
     {
         if (reader == nullptr && source != nullptr)
@@ -239,22 +259,9 @@ private:
                 auto lastThumbIndex  = sampleToThumbSample (startSample + numToDo);
                 auto numThumbSamps = lastThumbIndex - firstThumbIndex;
 
-                HeapBlock<MinMaxValue> levelData ((unsigned int) numThumbSamps * numChannels);
-                HeapBlock<MinMaxValue*> levels (numChannels);
-
-                for (int i = 0; i < (int) numChannels; ++i)
-                    levels[i] = levelData + i * numThumbSamps;
-
-                HeapBlock<Range<float>> levelsRead (numChannels);
-
-                for (int i = 0; i < numThumbSamps; ++i)
-                {
-                    reader->readMaxLevels ((firstThumbIndex + i) * owner.samplesPerThumbSample,
-                                           owner.samplesPerThumbSample, levelsRead, (int) numChannels);
-
-                    for (int j = 0; j < (int) numChannels; ++j)
-                        levels[j][i].setFloat (levelsRead[j]);
-                }
+                HeapBlock<MinMaxValue> levelData;
+                HeapBlock<MinMaxValue*> levels;
+                readLevels (*reader, firstThumbIndex, numThumbSamps, levelData, levels);
 
                 {
                     const ScopedUnlock su (readerLock);
@@ -268,6 +275,146 @@ private:
 
         return isFullyLoaded();
     }
+
+    void readLevels (AudioFormatReader& r, int firstThumbIndex, int numThumbSamps,
+                     HeapBlock<MinMaxValue>& levelData, HeapBlock<MinMaxValue*>& levels) const
+    {
+        levelData.malloc ((size_t) numThumbSamps * numChannels);
+        levels.malloc (numChannels);
+
+        for (int i = 0; i < (int) numChannels; ++i)
+            levels[i] = levelData + i * numThumbSamps;
+
+        HeapBlock<Range<float>> levelsRead (numChannels);
+
+        for (int i = 0; i < numThumbSamps; ++i)
+        {
+            r.readMaxLevels ((firstThumbIndex + i) * owner.samplesPerThumbSample,
+                             owner.samplesPerThumbSample, levelsRead, (int) numChannels);
+
+            for (int j = 0; j < (int) numChannels; ++j)
+                levels[j][i].setFloat (levelsRead[j]);
+        }
+    }
+
+    //==============================================================================
+    // Each job reads the levels for one range of the source with its own reader, or
+    // with a shared memory-mapped reader, and hands its results to the thumbnail in
+    // blocks so that the parts that have been loaded can be drawn straight away.
+    class LoadingJob  : public ThreadPoolJob
+    {
+    public:
+        LoadingJob (LevelDataSource& s, Range<int> rangeToLoad)
+            : ThreadPoolJob ("Thumbnail"), levelData (s), thumbRange (rangeToLoad)
+        {
+        }
+
+        JobStatus runJob() override
+        {
+            std::unique_ptr<AudioFormatReader> ownReader;
+            auto* r = levelData.reader.get();
+
+            if (levelData.source != nullptr)
+            {
+                if (auto* stream = levelData.source->createInputStream())
+                    ownReader.reset (levelData.owner.formatManagerToUse.createReaderFor (stream));
+
+                r = ownReader.get();
+            }
+
+            if (r == nullptr)
+            {
+                // This range couldn't be read, so once the other jobs have finished,
+                // the TimeSliceThread will go back to reading the whole source itself
+                levelData.loadingJobFailed = true;
+            }
+            else
+            {
+                HeapBlock<MinMaxValue> values;
+                HeapBlock<MinMaxValue*> levels;
+
+                for (auto start = thumbRange.getStart(); start < thumbRange.getEnd(); start += blockSize)
+                {
+                    if (shouldExit())
+                        return jobHasFinished;
+
+                    auto numThumbSamps = jmin (blockSize, thumbRange.getEnd() - start);
+                    levelData.readLevels (*r, start, numThumbSamps, values, levels);
+                    levelData.owner.setLevels (levels, start, (int) levelData.numChannels, numThumbSamps);
+                }
+            }
+
+            if (! shouldExit() && --levelData.numRangesToLoad == 0 && ! levelData.loadingJobFailed)
+                levelData.finishedLoading();
+
+            return jobHasFinished;
+        }
+
+    private:
+        static constexpr int blockSize = 256;
+
+        LevelDataSource& levelData;
+        const Range<int> thumbRange;
+
+        JUCE_DECLARE_NON_COPYABLE (LoadingJob)
+    };
+
+    void startLoadingJobs (ThreadPool& pool)
+    {
+        // Without an InputSource to create more readers from, the reader can only be
+        // shared between the jobs if it's reading from a mapped copy of the whole file
+        if (source == nullptr)
+        {
+            auto* mappedReader = dynamic_cast<MemoryMappedAudioFormatReader*> (reader.get());
+
+            if (mappedReader == nullptr || ! mappedReader->getMappedSection().contains (Range<int64> (numSamplesFinished, lengthInSamples)))
+                return;
+        }
+
+        auto firstThumbIndex = sampleToThumbSample (numSamplesFinished);
+        auto numThumbSamps = sampleToThumbSample (lengthInSamples) - firstThumbIndex;
+
+        if (numThumbSamps <= 0)
+            return;
+
+        // use a few ranges per thread so that the pool stays busy, but don't split
+        // the source into pieces that are much smaller than a single block
+        auto numRanges = jlimit (1, jmax (1, numThumbSamps / 256), pool.getNumThreads() * 4);
+
+        loadingPool = &pool;
+        numRangesToLoad = numRanges;
+        loadingJobFailed = false;
+
+        for (int i = 0; i < numRanges; ++i)
+            loadingJobs.add (new LoadingJob (*this, { firstThumbIndex + (int) ((int64) numThumbSamps * i / numRanges),
+                                                      firstThumbIndex + (int) ((int64) numThumbSamps * (i + 1) / numRanges) }));
+
+        for (auto* job : loadingJobs)
+            pool.addJob (job, false);
+    }
+
+    void stopLoadingJobs()
+    {
+        if (loadingPool != nullptr)
+        {
+            for (auto* job : loadingJobs)
+                job->signalJobShouldExit();
+
+            for (auto* job : loadingJobs)
+                loadingPool->removeJob (job, true, -1);
+        }
+    }
+
+    void finishedLoading()
+    {
+        {
+            const ScopedLock sl (readerLock);
+            numSamplesFinished = lengthInSamples;
+            lastReaderUseTime = Time::getMillisecondCounter();
+        }
+
+        owner.cache.storeThumb (owner, hashCode);
+    }
 };
 
 //==============================================================================
@@ -565,7 +712,8 @@ void AudioThumbnail::clearChannelData()
 {
     window->invalidate();
     channels.clear();
-    totalSamples = numSamplesFinished = 0;
+    totalSamples = numSamplesFinished = numSamplesLoaded = 0;
+    loadedRanges.clear();
     numChannels = 0;
     sampleRate = 0;
 
@@ -609,6 +757,9 @@ bool AudioThumbnail::loadFrom (InputStream& rawInput)
     sampleRate = input.readInt();                 // Source sample rate.
     input.skipNextBytes (16);                     // (reserved)
 
+    loadedRanges.addRange ({ 0, numSamplesFinished });
+    numSamplesLoaded = numSamplesFinished;
+
     createChannels (numThumbnailSamples);
 
     for (int i = 0; i < numThumbnailSamples; ++i)
@@ -644,7 +795,8 @@ bool AudioThumbnail::setDataSource (LevelDataSource* newSource)
 {
     JUCE_ASSERT_MESSAGE_MANAGER_IS_LOCKED
 
-    numSamplesFinished = 0;
+    numSamplesFinished = numSamplesLoaded = 0;
+    loadedRanges.clear();
     auto wasSuccessful = [&] { return sampleRate > 0 && totalSamples > 0; };
 
     if (cache.loadThumb (*this, newSource->hashCode) && isFullyLoaded())
@@ -688,6 +840,11 @@ void AudioThumbnail::setReader (AudioFormatReader* newReader, int64 hash)
         setDataSource (new LevelDataSource (*this, newReader, hash));
 }
 
+void AudioThumbnail::setLoadingThreadPool (ThreadPool* poolToUse)
+{
+    loadingThreadPool = poolToUse;
+}
+
 int64 AudioThumbnail::getHashCode() const
 {
     return source == nullptr ? 0 : source->hashCode;
@@ -738,8 +895,15 @@ void AudioThumbnail::setLevels (const MinMaxValue* const* values, int thumbIndex
     auto start = thumbIndex * (int64) samplesPerThumbSample;
     auto end   = (thumbIndex + numValues) * (int64) samplesPerThumbSample;
 
-    if (numSamplesFinished >= start && end > numSamplesFinished)
-        numSamplesFinished = end;
+    // blocks can arrive in any order when they're loaded in parallel, so keep track of all
+    // the loaded ranges, and only count the ones that join up with the start as finished
+    loadedRanges.addRange ({ start, end });
+    numSamplesLoaded = loadedRanges.size();
+
+    auto firstRange = loadedRanges.getRange (0);
+
+    if (numSamplesFinished >= firstRange.getStart() && firstRange.getEnd() > numSamplesFinished)
+        numSamplesFinished = firstRange.getEnd();
 
     totalSamples = jmax (numSamplesFinished, totalSamples.load());
     window->invalidate();
@@ -764,7 +928,7 @@ bool AudioThumbnail::isFullyLoaded() const noexcept
 
 double AudioThumbnail::getProportionComplete() const noexcept
 {
-    return jlimit (0.0, 1.0, numSamplesFinished / (double) jmax ((int64) 1, totalSamples.load()));
+    return jlimit (0.0, 1.0, jmax (numSamplesFinished, numSamplesLoaded.load()) / (double) jmax ((int64) 1, totalSamples.load()));
 }
 
 int64 AudioThumbnail::getNumSamplesFinished() const noexcept
@@ -824,4 +988,114 @@ void AudioThumbnail::drawChannels (Graphics& g, const Rectangle<int>& area, doub
     }
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AudioThumbnailTests  : public UnitTest
+{
+public:
+    AudioThumbnailTests()
+        : UnitTest ("AudioThumbnail", UnitTestCategories::audio)
+    {}
+
+    // Reads a WAV file from memory, and can be told to fail after a number of streams
+    // have been created, like a file that's been deleted while it's being loaded
+    struct MemorySource  : public InputSource
+    {
+        MemorySource (const MemoryBlock& data, int numStreams)
+            : wavData (data), numStreamsBeforeFailing (numStreams)
+        {}
+
+        InputStream* createInputStream() override
+        {
+            if (numStreamsBeforeFailing >= 0 && numStreamsCreated.load() >= numStreamsBeforeFailing)
+                return nullptr;
+
+            ++numStreamsCreated;
+            return new MemoryInputStream (wavData, false);
+        }
+
+        InputStream* createInputStreamFor (const String&) override   { return nullptr; }
+        int64 hashCode() const override                              { return (int64) wavData.getSize(); }
+
+        const MemoryBlock& wavData;
+        const int numStreamsBeforeFailing;
+        std::atomic<int> numStreamsCreated { 0 };
+    };
+
+    static MemoryBlock createWavFile (int numSamples)
+    {
+        MemoryBlock data;
+        AudioBuffer<float> buffer (2, numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            buffer.setSample (0, i, std::sin ((float) i * 0.01f) * (float) i / (float) numSamples);
+            buffer.setSample (1, i, std::cos ((float) i * 0.003f) * 0.5f);
+        }
+
+        WavAudioFormat format;
+        std::unique_ptr<AudioFormatWriter> writer (format.createWriterFor (new MemoryOutputStream (data, false),
+                                                                           44100.0, 2, 16, {}, 0));
+        writer->writeFromAudioSampleBuffer (buffer, 0, numSamples);
+
+        return data;
+    }
+
+    bool waitUntilFullyLoaded (AudioThumbnail& thumbnail)
+    {
+        for (int i = 0; i < 1000 && ! thumbnail.isFullyLoaded(); ++i)
+            Thread::sleep (10);
+
+        return thumbnail.isFullyLoaded();
+    }
+
+    MemoryBlock loadThumbnail (const MemoryBlock& wavData, ThreadPool* pool, int numStreamsBeforeFailing)
+    {
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        AudioThumbnailCache cache (4);
+
+        AudioThumbnail thumbnail (64, formatManager, cache);
+        thumbnail.setLoadingThreadPool (pool);
+
+        auto* source = new MemorySource (wavData, numStreamsBeforeFailing);
+        expect (thumbnail.setSource (source));
+        expect (waitUntilFullyLoaded (thumbnail));
+
+        if (pool != nullptr && numStreamsBeforeFailing < 0)
+            expect (source->numStreamsCreated.load() > 2);
+
+        MemoryBlock result;
+        MemoryOutputStream out (result, false);
+        thumbnail.saveTo (out);
+        out.flush();
+
+        return result;
+    }
+
+    void runTest() override
+    {
+        auto wavData = createWavFile (300000);
+        ThreadPool pool (3);
+
+        beginTest ("Loading on a ThreadPool gives the same thumbnail as loading on the TimeSliceThread");
+        {
+            auto sequential = loadThumbnail (wavData, nullptr, -1);
+            expect (sequential.getSize() > 0);
+            expect (loadThumbnail (wavData, &pool, -1) == sequential);
+        }
+
+        beginTest ("A source that can't be re-opened by the loading jobs is still fully loaded");
+        {
+            auto sequential = loadThumbnail (wavData, nullptr, -1);
+            expect (loadThumbnail (wavData, &pool, 1) == sequential);
+        }
+    }
+};
+
+static AudioThumbnailTests audioThumbnailTests;
+
+#endif
+
 } // namespace juce
@@ -191,6 +191,24 @@ public:
     /** Returns the hash code that was set by setSource() or setReader(). */
     int64 getHashCode() const override;
 
+    //==============================================================================
+    /** Makes the thumbnail read its source in parallel on a ThreadPool.
+
+        When a pool is set, the sources passed to setSource() afterwards are split into
+        ranges which are scanned by the pool's threads at the same time, each with its own
+        reader. A reader passed to setReader() can only be shared between the threads if it's
+        a MemoryMappedAudioFormatReader that has the whole file mapped; otherwise it's
+        scanned from start to finish on the cache's thread as usual.
+
+        The ranges finish in no particular order, and each block of levels is drawn as soon
+        as it's been read. getProportionComplete() counts all the loaded ranges, whereas
+        getNumSamplesFinished() only includes those that join up with the start of the source.
+
+        The pool must stay alive for as long as the thumbnail is loading a source with it.
+        Pass a nullptr to go back to scanning sources on the cache's thread.
+    */
+    void setLoadingThreadPool (ThreadPool* poolToUse);
+
 private:
     //==============================================================================
     AudioFormatManager& formatManagerToUse;
@@ -204,6 +222,9 @@ private:
     std::unique_ptr<LevelDataSource> source;
     std::unique_ptr<CachedWindow> window;
     OwnedArray<ThumbData> channels;
+    ThreadPool* loadingThreadPool = nullptr;
+    SparseSet<int64> loadedRanges;
+    std::atomic<int64> numSamplesLoaded { 0 };
 
     int32 samplesPerThumbSample = 0;
     std::atomic<int64> totalSamples { 0 };
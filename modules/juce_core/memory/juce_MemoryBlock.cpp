@@ -84,12 +84,14 @@ MemoryBlock::MemoryBlock (MemoryBlock&& other) noexcept
     : data (std::move (other.data)),
       size (other.size)
 {
+    other.size = 0;
 }
 
 MemoryBlock& MemoryBlock::operator= (MemoryBlock&& other) noexcept
 {
     data = std::move (other.data);
     size = other.size;
+    other.size = 0;
     return *this;
 }
 
@@ -407,4 +409,59 @@ bool MemoryBlock::fromBase64Encoding (StringRef s)
     }
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class MemoryBlockTests  : public UnitTest
+{
+public:
+    MemoryBlockTests()
+        : UnitTest ("MemoryBlock", UnitTestCategories::containers)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Moving a block leaves the source empty");
+        {
+            MemoryBlock source (100, true);
+            source[10] = 42;
+
+            MemoryBlock dest (std::move (source));
+            expectEquals ((int) dest.getSize(), 100);
+            expectEquals ((int) dest[10], 42);
+            expectEquals ((int) source.getSize(), 0);
+            expect (source.getData() == nullptr);
+
+            MemoryBlock other (20, true);
+            other = std::move (dest);
+            expectEquals ((int) other.getSize(), 100);
+            expectEquals ((int) dest.getSize(), 0);
+        }
+
+        beginTest ("A moved-from block can be re-used");
+        {
+            MemoryBlock source (100, true);
+            MemoryBlock dest (std::move (source));
+
+            source.append ("abc", 3);
+            expectEquals ((int) source.getSize(), 3);
+            expect (source.matches ("abc", 3));
+
+            MemoryBlock other (std::move (source));
+            source.setSize (50, true);
+            expectEquals ((int) source.getSize(), 50);
+            expectEquals ((int) source[49], 0);
+
+            source = std::move (other);
+            expect (source.matches ("abc", 3));
+            expectEquals ((int) other.getSize(), 0);
+        }
+    }
+};
+
+static MemoryBlockTests memoryBlockTests;
+
+#endif
+
 } // namespace juce
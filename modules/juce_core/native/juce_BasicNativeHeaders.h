@@ -234,6 +234,10 @@
  #include <sys/wait.h>
  #include <utime.h>
 
+ #if JUCE_INTEL && ! JUCE_NO_INLINE_ASM
+  #include <cpuid.h>
+ #endif
+
 //==============================================================================
 #elif JUCE_BSD
  #include <arpa/inet.h>
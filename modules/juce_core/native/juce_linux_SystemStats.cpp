@@ -152,6 +152,7 @@ void CPUInformation::initialise() noexcept
     hasSSE42           = flags.contains ("sse4_2");
     hasAVX             = flags.contains ("avx");
     hasAVX2            = flags.contains ("avx2");
+    hasFMA3            = StringArray::fromTokens (flags, false).contains ("fma"); // not fma4
     hasAVX512F         = flags.contains ("avx512f");
     hasAVX512BW        = flags.contains ("avx512bw");
     hasAVX512CD        = flags.contains ("avx512cd");
@@ -163,6 +164,13 @@ void CPUInformation::initialise() noexcept
     hasAVX512VL        = flags.contains ("avx512vl");
     hasAVX512VPOPCNTDQ = flags.contains ("avx512_vpopcntdq");
 
+   #if JUCE_INTEL && ! JUCE_NO_INLINE_ASM
+    // (the kernel doesn't list the osxsave flag)
+    unsigned int a = 0, b = 0, c = 0, d = 0;
+    __get_cpuid (1, &a, &b, &c, &d);
+    clearAVXFlagsUnlessEnabledByOS ((c & (1u << 27)) != 0);
+   #endif
+
     numLogicalCPUs  = getCpuInfo ("processor").getIntValue() + 1;
 
     // Assume CPUs in all sockets have the same number of cores
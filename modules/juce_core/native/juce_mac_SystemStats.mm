@@ -84,6 +84,9 @@ void CPUInformation::initialise() noexcept
     hasSSE41 = (c & (1u << 19)) != 0;
     hasSSE42 = (c & (1u << 20)) != 0;
     hasAVX   = (c & (1u << 28)) != 0;
+    hasFMA3  = (c & (1u << 12)) != 0;
+
+    auto hasOSXSAVE = (c & (1u << 27)) != 0;
 
     SystemStatsHelpers::doCPUID (a, b, c, d, 7);
     hasAVX2            = (b & (1u <<  5)) != 0;
@@ -97,6 +100,8 @@ void CPUInformation::initialise() noexcept
     hasAVX512VL        = (b & (1u << 31)) != 0;
     hasAVX512VBMI      = (c & (1u <<  1)) != 0;
     hasAVX512VPOPCNTDQ = (c & (1u << 14)) != 0;
+
+    clearAVXFlagsUnlessEnabledByOS (hasOSXSAVE);
    #endif
 
     numLogicalCPUs = (int) [[NSProcessInfo processInfo] activeProcessorCount];
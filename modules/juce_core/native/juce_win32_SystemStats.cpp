@@ -144,6 +144,7 @@ void CPUInformation::initialise() noexcept
     hasSSE2  = (info[3] & (1 << 26)) != 0;
     hasSSE3  = (info[2] & (1 <<  0)) != 0;
     hasAVX   = (info[2] & (1 << 28)) != 0;
+    hasFMA3  = (info[2] & (1 << 12)) != 0;
     hasSSSE3 = (info[2] & (1 <<  9)) != 0;
     hasSSE41 = (info[2] & (1 << 19)) != 0;
     hasSSE42 = (info[2] & (1 << 20)) != 0;
@@ -163,6 +164,9 @@ void CPUInformation::initialise() noexcept
     hasAVX512VBMI      = (info[2] & (1u <<  1)) != 0;
     hasAVX512VPOPCNTDQ = (info[2] & (1u << 14)) != 0;
 
+    callCPUID (info, 1);
+    clearAVXFlagsUnlessEnabledByOS ((info[2] & (1 << 27)) != 0);
+
     SYSTEM_INFO systemInfo;
     GetNativeSystemInfo (&systemInfo);
     numLogicalCPUs  = (int) systemInfo.dwNumberOfProcessors;
@@ -88,11 +88,39 @@ struct CPUInformation
 
     void initialise() noexcept;
 
+    // The AVX registers can only be used if the OS saves them when it switches threads, which it
+    // reports with CPUID.1:ECX.OSXSAVE and the state-component bits of the XCR0 register.
+    void clearAVXFlagsUnlessEnabledByOS (bool hasOSXSAVE) noexcept
+    {
+        auto xcr0 = hasOSXSAVE ? readXCR0() : 0;
+
+        if ((xcr0 & 0x06) != 0x06)  // SSE and AVX state
+            hasAVX = hasAVX2 = hasFMA3 = false;
+
+        if ((xcr0 & 0xe6) != 0xe6)  // ..and the AVX-512 opmask and upper ZMM state
+            hasAVX512F = hasAVX512BW = hasAVX512CD = hasAVX512DQ = hasAVX512ER = hasAVX512IFMA
+                = hasAVX512PF = hasAVX512VBMI = hasAVX512VL = hasAVX512VPOPCNTDQ = false;
+    }
+
+    static uint64 readXCR0() noexcept
+    {
+       #if JUCE_INTEL && JUCE_MSVC && ! JUCE_PROJUCER_LIVE_BUILD
+        return (uint64) _xgetbv (0);
+       #elif JUCE_INTEL && ! JUCE_NO_INLINE_ASM && (JUCE_GCC || JUCE_CLANG)
+        uint32 lo = 0, hi = 0;
+        asm volatile (".byte 0x0f, 0x01, 0xd0" : "=a" (lo), "=d" (hi) : "c" (0)); // xgetbv, for assemblers that don't know it
+        return lo | ((uint64) hi << 32);
+       #else
+        return 0;
+       #endif
+    }
+
     int numLogicalCPUs = 0, numPhysicalCPUs = 0;
 
     bool hasMMX      = false, hasSSE        = false, hasSSE2       = false, hasSSE3 = false,
          has3DNow    = false, hasSSSE3      = false, hasSSE41      = false,
          hasSSE42    = false, hasAVX        = false, hasAVX2       = false,
+         hasFMA3     = false,
          hasAVX512F  = false, hasAVX512BW   = false, hasAVX512CD   = false,
          hasAVX512DQ = false, hasAVX512ER   = false, hasAVX512IFMA = false,
          hasAVX512PF = false, hasAVX512VBMI = false, hasAVX512VL   = false,
@@ -118,6 +146,7 @@ bool SystemStats::hasSSE41() noexcept           { return getCPUInformation().has
 bool SystemStats::hasSSE42() noexcept           { return getCPUInformation().hasSSE42; }
 bool SystemStats::hasAVX() noexcept             { return getCPUInformation().hasAVX; }
 bool SystemStats::hasAVX2() noexcept            { return getCPUInformation().hasAVX2; }
+bool SystemStats::hasFMA3() noexcept            { return getCPUInformation().hasFMA3; }
 bool SystemStats::hasAVX512F() noexcept         { return getCPUInformation().hasAVX512F; }
 bool SystemStats::hasAVX512BW() noexcept        { return getCPUInformation().hasAVX512BW; }
 bool SystemStats::hasAVX512CD() noexcept        { return getCPUInformation().hasAVX512CD; }
@@ -23,26 +23,153 @@
 namespace juce
 {
 
+/*  In SchedulingMode::workStealing, each thread owns a set of queues, one per job
+    priority. A thread takes the oldest job from its own queues, and when they're
+    empty it takes the oldest job from the other threads' queues.
+
+    Every change to the state of a queued or running job (being taken from a queue,
+    finishing or being re-queued) happens while holding the lock of one of the
+    queues, so the methods that need a consistent view of all the jobs in the pool
+    simply lock all the queues at once.
+*/
+struct ThreadPool::JobQueue
+{
+    bool isEmpty() const noexcept                        { return head == jobs.size(); }
+    int size() const noexcept                            { return jobs.size() - head; }
+    ThreadPoolJob* operator[] (int index) const noexcept { return jobs.getUnchecked (head + index); }
+
+    void add (ThreadPoolJob* job)                        { jobs.add (job); }
+
+    ThreadPoolJob* removeFromFront() noexcept
+    {
+        jassert (! isEmpty());
+        auto* job = jobs.getUnchecked (head++);
+
+        if (head == jobs.size())
+        {
+            jobs.clearQuick();
+            head = 0;
+        }
+        else if (head > 32 && head * 2 > jobs.size())
+        {
+            jobs.removeRange (0, head);
+            head = 0;
+        }
+
+        return job;
+    }
+
+    int indexOf (const ThreadPoolJob* job) const noexcept
+    {
+        for (int i = head; i < jobs.size(); ++i)
+            if (jobs.getUnchecked (i) == job)
+                return i - head;
+
+        return -1;
+    }
+
+    void moveToFront (int index)
+    {
+        auto* job = jobs.removeAndReturn (head + index);
+
+        if (head > 0)
+            jobs.setUnchecked (--head, job);
+        else
+            jobs.insert (0, job);
+    }
+
+    template <typename Predicate>
+    int removeIf (Predicate&& shouldRemove)
+    {
+        auto numRemoved = 0;
+        auto destIndex = head;
+
+        for (int i = head; i < jobs.size(); ++i)
+        {
+            auto* job = jobs.getUnchecked (i);
+
+            if (shouldRemove (job))
+                ++numRemoved;
+            else
+                jobs.setUnchecked (destIndex++, job);
+        }
+
+        jobs.removeRange (destIndex, numRemoved);
+        return numRemoved;
+    }
+
+private:
+    Array<ThreadPoolJob*> jobs;
+    int head = 0;
+};
+
+//==============================================================================
 struct ThreadPool::ThreadPoolThread  : public Thread
 {
-    ThreadPoolThread (ThreadPool& p, size_t stackSize)
-       : Thread ("Pool", stackSize), pool (p)
+    ThreadPoolThread (ThreadPool& p, size_t stackSize, int threadIndex)
+       : Thread ("Pool", stackSize), pool (p), index (threadIndex)
     {
     }
 
     void run() override
     {
         while (! threadShouldExit())
+        {
             if (! pool.runNextJob (*this))
-                wait (500);
+            {
+                isIdle = true;
+
+                if (! pool.hasQueuedJobs())
+                    wait (500);
+
+                isIdle = false;
+            }
+        }
     }
 
+    // The caller must hold queueLock
+    void addToQueue (ThreadPoolJob* job)
+    {
+        auto priority = (int) job->priority;
+        queues[priority].add (job);
+        ++numQueued[priority];
+        ++pool.numQueuedJobs;
+    }
+
+    static constexpr int numPriorities = 3;
+
     std::atomic<ThreadPoolJob*> currentJob { nullptr };
     ThreadPool& pool;
+    const int index;
+
+    CriticalSection queueLock;
+    JobQueue queues[numPriorities];
+    std::atomic<int> numQueued[numPriorities] {};
+    std::atomic<bool> isIdle { false };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThreadPoolThread)
 };
 
+//==============================================================================
+struct ThreadPool::ScopedLockAllQueues
+{
+    ScopedLockAllQueues (const ThreadPool& p) noexcept  : pool (p)
+    {
+        for (auto* t : pool.threads)
+            t->queueLock.enter();
+    }
+
+    ~ScopedLockAllQueues() noexcept
+    {
+        for (int i = pool.threads.size(); --i >= 0;)
+            pool.threads.getUnchecked (i)->queueLock.exit();
+    }
+
+    const ThreadPool& pool;
+
+    JUCE_DECLARE_NON_COPYABLE (ScopedLockAllQueues)
+};
+
 //==============================================================================
 ThreadPoolJob::ThreadPoolJob (const String& name)  : jobName (name)
 {
@@ -90,7 +217,28 @@ ThreadPoolJob* ThreadPoolJob::getCurrentThreadPoolJob()
 }
 
 //==============================================================================
-ThreadPool::ThreadPool (int numThreads, size_t threadStackSize)
+namespace ThreadPoolHelpers
+{
+    struct LambdaJobWrapper  : public ThreadPoolJob
+    {
+        LambdaJobWrapper (std::function<void()> j) : ThreadPoolJob ("lambda"), job (std::move (j)) {}
+        JobStatus runJob() override      { job(); return ThreadPoolJob::jobHasFinished; }
+
+        std::function<void()> job;
+    };
+
+    struct LambdaJobWithStatusWrapper  : public ThreadPoolJob
+    {
+        LambdaJobWithStatusWrapper (std::function<ThreadPoolJob::JobStatus()> j) : ThreadPoolJob ("lambda"), job (std::move (j)) {}
+        JobStatus runJob() override      { return job(); }
+
+        std::function<ThreadPoolJob::JobStatus()> job;
+    };
+}
+
+//==============================================================================
+ThreadPool::ThreadPool (int numThreads, size_t threadStackSize, SchedulingMode mode)
+    : schedulingMode (mode)
 {
     jassert (numThreads > 0); // not much point having a pool without any threads!
 
@@ -111,7 +259,7 @@ ThreadPool::~ThreadPool()
 void ThreadPool::createThreads (int numThreads, size_t threadStackSize)
 {
     for (int i = jmax (1, numThreads); --i >= 0;)
-        threads.add (new ThreadPoolThread (*this, threadStackSize));
+        threads.add (new ThreadPoolThread (*this, threadStackSize, threads.size()));
 
     for (auto* t : threads)
         t->startThread();
@@ -126,56 +274,204 @@ void ThreadPool::stopThreads()
         t->stopThread (500);
 }
 
-void ThreadPool::addJob (ThreadPoolJob* job, bool deleteJobWhenFinished)
+void ThreadPool::prepareJob (ThreadPoolJob* job, bool deleteJobWhenFinished, ThreadPoolJob::Priority priority)
+{
+    job->pool = this;
+    job->shouldStop = false;
+    job->isActive = false;
+    job->shouldBeDeleted = deleteJobWhenFinished;
+    job->priority = priority;
+}
+
+void ThreadPool::insertIntoSharedQueue (ThreadPoolJob* job)
+{
+    // the list is kept sorted by priority, so that the threads find the most important jobs first
+    auto index = jobs.size();
+
+    while (index > 0 && jobs.getUnchecked (index - 1)->priority < job->priority)
+        --index;
+
+    jobs.insert (index, job);
+}
+
+ThreadPool::ThreadPoolThread* ThreadPool::getCurrentPoolThread() const
+{
+    if (auto* t = dynamic_cast<ThreadPoolThread*> (Thread::getCurrentThread()))
+        if (&t->pool == this)
+            return t;
+
+    return nullptr;
+}
+
+void ThreadPool::wakeIdleThreads (int maxNumThreads, int firstThreadToTry)
+{
+    auto numThreads = threads.size();
+
+    for (int i = 0; i < numThreads && maxNumThreads > 0; ++i)
+    {
+        auto* t = threads.getUnchecked ((firstThreadToTry + i) % numThreads);
+        auto wasIdle = true;
+
+        // clearing the flag here means that the next job that gets added will wake a different thread
+        if (t->isIdle.compare_exchange_strong (wasIdle, false))
+        {
+            t->notify();
+            --maxNumThreads;
+        }
+    }
+}
+
+bool ThreadPool::hasQueuedJobs() const noexcept
+{
+    return numQueuedJobs.load() > 0;
+}
+
+void ThreadPool::addJob (ThreadPoolJob* job, bool deleteJobWhenFinished, ThreadPoolJob::Priority priority)
 {
     jassert (job != nullptr);
     jassert (job->pool == nullptr);
 
     if (job->pool == nullptr)
     {
-        job->pool = this;
-        job->shouldStop = false;
-        job->isActive = false;
-        job->shouldBeDeleted = deleteJobWhenFinished;
+        prepareJob (job, deleteJobWhenFinished, priority);
 
+        if (schedulingMode == SchedulingMode::workStealing)
         {
-            const ScopedLock sl (lock);
-            jobs.add (job);
+            // a job that's added by one of our own jobs goes onto that thread's queue,
+            // as it's likely to be working on the same data
+            auto* thread = getCurrentPoolThread();
+
+            if (thread == nullptr)
+                thread = threads.getUnchecked ((int) (nextQueueIndex++ % (uint32) threads.size()));
+
+            ++numJobsInPool;
+
+            {
+                const ScopedLock sl (thread->queueLock);
+                thread->addToQueue (job);
+            }
+
+            wakeIdleThreads (1, thread->index);
         }
+        else
+        {
+            {
+                const ScopedLock sl (lock);
+                insertIntoSharedQueue (job);
+            }
 
-        for (auto* t : threads)
-            t->notify();
+            for (auto* t : threads)
+                t->notify();
+        }
     }
 }
 
-void ThreadPool::addJob (std::function<ThreadPoolJob::JobStatus()> jobToRun)
+void ThreadPool::addJob (std::function<ThreadPoolJob::JobStatus()> jobToRun, ThreadPoolJob::Priority priority)
 {
-    struct LambdaJobWrapper  : public ThreadPoolJob
+    addJob (new ThreadPoolHelpers::LambdaJobWithStatusWrapper (std::move (jobToRun)), true, priority);
+}
+
+void ThreadPool::addJob (std::function<void()> jobToRun, ThreadPoolJob::Priority priority)
+{
+    addJob (new ThreadPoolHelpers::LambdaJobWrapper (std::move (jobToRun)), true, priority);
+}
+
+void ThreadPool::addJobs (const Array<std::function<void()>>& jobsToRun, ThreadPoolJob::Priority priority)
+{
+    auto numNewJobs = jobsToRun.size();
+
+    if (numNewJobs == 0)
+        return;
+
+    Array<ThreadPoolJob*> newJobs;
+    newJobs.ensureStorageAllocated (numNewJobs);
+
+    for (auto& jobToRun : jobsToRun)
     {
-        LambdaJobWrapper (std::function<ThreadPoolJob::JobStatus()> j) : ThreadPoolJob ("lambda"), job (j) {}
-        JobStatus runJob() override      { return job(); }
+        auto* job = new ThreadPoolHelpers::LambdaJobWrapper (jobToRun);
+        prepareJob (job, true, priority);
+        newJobs.add (job);
+    }
 
-        std::function<ThreadPoolJob::JobStatus()> job;
-    };
+    auto numThreads = threads.size();
+
+    if (schedulingMode == SchedulingMode::workStealing)
+    {
+        numJobsInPool += numNewJobs;
+        int firstQueue, numQueues;
+
+        if (auto* thread = getCurrentPoolThread())
+        {
+            // jobs added by one of our own jobs all go onto that thread's queue, and
+            // the other threads will steal them from there
+            firstQueue = thread->index;
+            numQueues = 1;
+        }
+        else
+        {
+            numQueues = jmin (numThreads, numNewJobs);
+            firstQueue = (int) (nextQueueIndex.fetch_add ((uint32) numQueues) % (uint32) numThreads);
+        }
+
+        // each queue gets a contiguous run of the new jobs
+        for (int i = 0; i < numQueues; ++i)
+        {
+            auto* thread = threads.getUnchecked ((firstQueue + i) % numThreads);
+            auto start = (numNewJobs * i) / numQueues;
+            auto end = (numNewJobs * (i + 1)) / numQueues;
+
+            const ScopedLock sl (thread->queueLock);
+
+            for (int j = start; j < end; ++j)
+                thread->addToQueue (newJobs.getUnchecked (j));
+        }
+
+        wakeIdleThreads (jmin (numThreads, numNewJobs), firstQueue);
+    }
+    else
+    {
+        {
+            const ScopedLock sl (lock);
+            jobs.ensureStorageAllocated (jobs.size() + numNewJobs);
+
+            for (auto* job : newJobs)
+                insertIntoSharedQueue (job);
+        }
 
-    addJob (new LambdaJobWrapper (jobToRun), true);
+        for (auto* t : threads)
+            t->notify();
+    }
 }
 
-void ThreadPool::addJob (std::function<void()> jobToRun)
+template <typename Callback>
+void ThreadPool::visitAllJobs (Callback&& callback) const
 {
-    struct LambdaJobWrapper  : public ThreadPoolJob
-    {
-        LambdaJobWrapper (std::function<void()> j) : ThreadPoolJob ("lambda"), job (j) {}
-        JobStatus runJob() override      { job(); return ThreadPoolJob::jobHasFinished; }
+    // visits the running jobs followed by the waiting ones, stopping when the callback returns true
+    const ScopedLockAllQueues sl (*this);
 
-        std::function<void()> job;
-    };
+    for (auto* t : threads)
+        if (auto* job = t->currentJob.load())
+            if (callback (job))
+                return;
+
+    for (int priority = ThreadPoolThread::numPriorities; --priority >= 0;)
+    {
+        for (auto* t : threads)
+        {
+            auto& queue = t->queues[priority];
 
-    addJob (new LambdaJobWrapper (jobToRun), true);
+            for (int i = 0; i < queue.size(); ++i)
+                if (callback (queue[i]))
+                    return;
+        }
+    }
 }
 
 int ThreadPool::getNumJobs() const noexcept
 {
+    if (schedulingMode == SchedulingMode::workStealing)
+        return numJobsInPool.load();
+
     const ScopedLock sl (lock);
     return jobs.size();
 }
@@ -187,30 +483,99 @@ int ThreadPool::getNumThreads() const noexcept
 
 ThreadPoolJob* ThreadPool::getJob (int index) const noexcept
 {
+    if (schedulingMode == SchedulingMode::workStealing)
+    {
+        ThreadPoolJob* result = nullptr;
+
+        if (index >= 0)
+        {
+            visitAllJobs ([&] (ThreadPoolJob* job)
+            {
+                if (index-- > 0)
+                    return false;
+
+                result = job;
+                return true;
+            });
+        }
+
+        return result;
+    }
+
     const ScopedLock sl (lock);
     return jobs [index];
 }
 
 bool ThreadPool::contains (const ThreadPoolJob* job) const noexcept
 {
+    if (schedulingMode == SchedulingMode::workStealing)
+    {
+        auto found = false;
+        visitAllJobs ([&] (ThreadPoolJob* j)
+        {
+            found = (j == job);
+            return found;
+        });
+        return found;
+    }
+
     const ScopedLock sl (lock);
     return jobs.contains (const_cast<ThreadPoolJob*> (job));
 }
 
 bool ThreadPool::isJobRunning (const ThreadPoolJob* job) const noexcept
 {
+    if (schedulingMode == SchedulingMode::workStealing)
+    {
+        const ScopedLockAllQueues sl (*this);
+
+        for (auto* t : threads)
+            if (t->currentJob.load() == job)
+                return job != nullptr;
+
+        return false;
+    }
+
     const ScopedLock sl (lock);
     return jobs.contains (const_cast<ThreadPoolJob*> (job)) && job->isActive;
 }
 
 void ThreadPool::moveJobToFront (const ThreadPoolJob* job) noexcept
 {
+    if (schedulingMode == SchedulingMode::workStealing)
+    {
+        const ScopedLockAllQueues sl (*this);
+
+        for (auto* t : threads)
+        {
+            for (auto& queue : t->queues)
+            {
+                auto index = queue.indexOf (job);
+
+                if (index >= 0)
+                {
+                    queue.moveToFront (index);
+                    return;
+                }
+            }
+        }
+
+        return;
+    }
+
     const ScopedLock sl (lock);
 
     auto index = jobs.indexOf (const_cast<ThreadPoolJob*> (job));
 
     if (index > 0 && ! job->isActive)
-        jobs.move (index, 0);
+    {
+        auto newIndex = 0;
+
+        while (newIndex < index && jobs.getUnchecked (newIndex)->priority > job->priority)
+            ++newIndex;
+
+        jobs.move (index, newIndex);
+    }
 }
 
 bool ThreadPool::waitForJobToFinish (const ThreadPoolJob* job, int timeOutMs) const
@@ -236,7 +601,38 @@ bool ThreadPool::removeJob (ThreadPoolJob* job, bool interruptIfRunning, int tim
     bool dontWait = true;
     OwnedArray<ThreadPoolJob> deletionList;
 
-    if (job != nullptr)
+    if (job != nullptr && schedulingMode == SchedulingMode::workStealing)
+    {
+        const ScopedLockAllQueues sl (*this);
+        auto wasQueued = false;
+
+        for (auto* t : threads)
+        {
+            for (int priority = 0; priority < ThreadPoolThread::numPriorities && ! wasQueued; ++priority)
+            {
+                if (t->queues[priority].removeIf ([job] (ThreadPoolJob* j) { return j == job; }) > 0)
+                {
+                    --(t->numQueued[priority]);
+                    --numQueuedJobs;
+                    wasQueued = true;
+                }
+            }
+        }
+
+        if (wasQueued)
+        {
+            --numJobsInPool;
+            addToDeleteList (deletionList, job);
+        }
+        else if (isJobRunning (job))
+        {
+            if (interruptIfRunning)
+                job->signalJobShouldExit();
+
+            dontWait = false;
+        }
+    }
+    else if (job != nullptr)
     {
         const ScopedLock sl (lock);
 
@@ -265,6 +661,45 @@ bool ThreadPool::removeAllJobs (bool interruptRunningJobs, int timeOutMs,
 {
     Array<ThreadPoolJob*> jobsToWaitFor;
 
+    if (schedulingMode == SchedulingMode::workStealing)
+    {
+        OwnedArray<ThreadPoolJob> deletionList;
+
+        {
+            const ScopedLockAllQueues sl (*this);
+
+            for (auto* t : threads)
+            {
+                if (auto* job = t->currentJob.load())
+                {
+                    if (selectedJobsToRemove == nullptr || selectedJobsToRemove->isJobSuitable (job))
+                    {
+                        jobsToWaitFor.add (job);
+
+                        if (interruptRunningJobs)
+                            job->signalJobShouldExit();
+                    }
+                }
+
+                for (int priority = 0; priority < ThreadPoolThread::numPriorities; ++priority)
+                {
+                    auto numRemoved = t->queues[priority].removeIf ([&] (ThreadPoolJob* job)
+                    {
+                        if (selectedJobsToRemove != nullptr && ! selectedJobsToRemove->isJobSuitable (job))
+                            return false;
+
+                        addToDeleteList (deletionList, job);
+                        return true;
+                    });
+
+                    t->numQueued[priority] -= numRemoved;
+                    numQueuedJobs -= numRemoved;
+                    numJobsInPool -= numRemoved;
+                }
+            }
+        }
+    }
+    else
     {
         OwnedArray<ThreadPoolJob> deletionList;
 
@@ -321,6 +756,20 @@ bool ThreadPool::removeAllJobs (bool interruptRunningJobs, int timeOutMs,
 StringArray ThreadPool::getNamesOfAllJobs (bool onlyReturnActiveJobs) const
 {
     StringArray s;
+
+    if (schedulingMode == SchedulingMode::workStealing)
+    {
+        visitAllJobs ([&] (ThreadPoolJob* job)
+        {
+            if (job->isActive || ! onlyReturnActiveJobs)
+                s.add (job->getJobName());
+
+            return false;
+        });
+
+        return s;
+    }
+
     const ScopedLock sl (lock);
 
     for (auto* job : jobs)
@@ -372,8 +821,52 @@ ThreadPoolJob* ThreadPool::pickNextJobToRun()
     return nullptr;
 }
 
+ThreadPoolJob* ThreadPool::pickNextJobFromQueues (ThreadPoolThread& thread, OwnedArray<ThreadPoolJob>& deletionList)
+{
+    auto numThreads = threads.size();
+
+    for (int priority = ThreadPoolThread::numPriorities; --priority >= 0;)
+    {
+        // look in our own queue first, and then try to steal from the others
+        for (int i = 0; i < numThreads; ++i)
+        {
+            auto& owner = *threads.getUnchecked ((thread.index + i) % numThreads);
+
+            if (owner.numQueued[priority].load() == 0)
+                continue;
+
+            const ScopedLock sl (owner.queueLock);
+            auto& queue = owner.queues[priority];
+
+            while (! queue.isEmpty())
+            {
+                auto* job = queue.removeFromFront();
+                --(owner.numQueued[priority]);
+                --numQueuedJobs;
+
+                if (job->shouldStop)
+                {
+                    --numJobsInPool;
+                    addToDeleteList (deletionList, job);
+                    jobFinishedSignal.signal();
+                    continue;
+                }
+
+                job->isActive = true;
+                thread.currentJob = job;
+                return job;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
 bool ThreadPool::runNextJob (ThreadPoolThread& thread)
 {
+    if (schedulingMode == SchedulingMode::workStealing)
+        return runNextJobFromQueues (thread);
+
     if (auto* job = pickNextJobToRun())
     {
         auto result = ThreadPoolJob::jobHasFinished;
@@ -409,8 +902,9 @@ bool ThreadPool::runNextJob (ThreadPoolThread& thread)
                 }
                 else
                 {
-                    // move the job to the end of the queue if it wants another go
-                    jobs.move (jobs.indexOf (job), -1);
+                    // move the job to the end of its priority's part of the queue if it wants another go
+                    jobs.removeFirstMatchingValue (job);
+                    insertIntoSharedQueue (job);
                 }
             }
         }
@@ -421,6 +915,38 @@ bool ThreadPool::runNextJob (ThreadPoolThread& thread)
     return false;
 }
 
+bool ThreadPool::runNextJobFromQueues (ThreadPoolThread& thread)
+{
+    OwnedArray<ThreadPoolJob> deletionList;
+
+    if (auto* job = pickNextJobFromQueues (thread, deletionList))
+    {
+        auto result = job->runJob();
+
+        const ScopedLock sl (thread.queueLock);
+
+        thread.currentJob = nullptr;
+        job->isActive = false;
+
+        if (result != ThreadPoolJob::jobNeedsRunningAgain || job->shouldStop)
+        {
+            --numJobsInPool;
+            addToDeleteList (deletionList, job);
+
+            jobFinishedSignal.signal();
+        }
+        else
+        {
+            // put the job on the back of our own queue if it wants another go
+            thread.addToQueue (job);
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
 void ThreadPool::addToDeleteList (OwnedArray<ThreadPoolJob>& deletionList, ThreadPoolJob* job) const
 {
     job->shouldStop = true;
@@ -430,4 +956,148 @@ void ThreadPool::addToDeleteList (OwnedArray<ThreadPoolJob>& deletionList, Threa
         deletionList.add (job);
 }
 
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ThreadPoolTests  : public UnitTest
+{
+public:
+    ThreadPoolTests()
+        : UnitTest ("ThreadPool", UnitTestCategories::threads)
+    {}
+
+    void runTest() override
+    {
+        for (auto mode : { ThreadPool::SchedulingMode::sharedQueue, ThreadPool::SchedulingMode::workStealing })
+        {
+            auto modeName = String (mode == ThreadPool::SchedulingMode::sharedQueue ? " (shared queue)" : " (work stealing)");
+
+            beginTest ("Lambda jobs" + modeName);
+            {
+                ThreadPool pool (4, 0, mode);
+                std::atomic<int> total { 0 };
+
+                for (int i = 1; i <= 100; ++i)
+                    pool.addJob ([&total, i] { total += i; });
+
+                Array<std::function<void()>> batch;
+
+                for (int i = 1; i <= 1000; ++i)
+                    batch.add ([&total, i] { total += i; });
+
+                pool.addJobs (batch);
+
+                expect (waitForPoolToEmpty (pool));
+                expectEquals (total.load(), 5050 + 500500);
+            }
+
+            beginTest ("Priorities" + modeName);
+            {
+                ThreadPool pool (1, 0, mode);
+                WaitableEvent started, release;
+                CriticalSection orderLock;
+                Array<int> order;
+
+                pool.addJob ([&] { started.signal(); release.wait (5000); });
+                expect (started.wait (5000));
+
+                auto addJob = [&] (int id, ThreadPoolJob::Priority priority)
+                {
+                    pool.addJob ([&order, &orderLock, id] { const ScopedLock sl (orderLock); order.add (id); }, priority);
+                };
+
+                addJob (0, ThreadPoolJob::Priority::low);
+                addJob (1, ThreadPoolJob::Priority::normal);
+                addJob (2, ThreadPoolJob::Priority::high);
+                addJob (3, ThreadPoolJob::Priority::normal);
+                addJob (4, ThreadPoolJob::Priority::high);
+
+                expectEquals (pool.getNumJobs(), 6);
+                release.signal();
+
+                expect (waitForPoolToEmpty (pool));
+                expect (order == Array<int> (2, 4, 1, 3, 0));
+            }
+
+            beginTest ("Jobs that add more jobs" + modeName);
+            {
+                ThreadPool pool (3, 0, mode);
+                std::atomic<int> numRun { 0 };
+
+                for (int i = 0; i < 10; ++i)
+                {
+                    pool.addJob ([&]
+                    {
+                        Array<std::function<void()>> batch;
+
+                        for (int j = 0; j < 10; ++j)
+                            batch.add ([&numRun] { ++numRun; });
+
+                        pool.addJobs (batch);
+                        ++numRun;
+                    });
+                }
+
+                expect (waitForPoolToEmpty (pool));
+                expectEquals (numRun.load(), 110);
+            }
+
+            beginTest ("Removing jobs" + modeName);
+            {
+                ThreadPool pool (2, 0, mode);
+
+                struct RepeatingJob  : public ThreadPoolJob
+                {
+                    RepeatingJob() : ThreadPoolJob ("repeating") {}
+                    JobStatus runJob() override     { ++numRuns; Thread::sleep (1); return jobNeedsRunningAgain; }
+
+                    std::atomic<int> numRuns { 0 };
+                };
+
+                OwnedArray<RepeatingJob> repeatingJobs;
+
+                for (int i = 0; i < 6; ++i)
+                    pool.addJob (repeatingJobs.add (new RepeatingJob()), false);
+
+                expectEquals (pool.getNumJobs(), 6);
+                expect (pool.contains (repeatingJobs[5]));
+                expectEquals (pool.getNamesOfAllJobs (false).size(), 6);
+
+                Thread::sleep (20);
+
+                expect (pool.removeJob (repeatingJobs[0], true, 5000));
+                expect (! pool.contains (repeatingJobs[0]));
+                expectEquals (pool.getNumJobs(), 5);
+
+                expect (pool.removeAllJobs (true, 5000));
+                expectEquals (pool.getNumJobs(), 0);
+
+                for (auto* job : repeatingJobs)
+                    expect (! pool.contains (job));
+            }
+        }
+    }
+
+    static bool waitForPoolToEmpty (ThreadPool& pool)
+    {
+        auto start = Time::getMillisecondCounter();
+
+        while (pool.getNumJobs() > 0)
+        {
+            if (Time::getMillisecondCounter() > start + 10000)
+                return false;
+
+            Thread::sleep (1);
+        }
+
+        return true;
+    }
+};
+
+static ThreadPoolTests threadPoolTests;
+
+#endif
+
 } // namespace juce
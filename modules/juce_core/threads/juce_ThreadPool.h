@@ -123,6 +123,25 @@ public:
     /** Removes a listener added with addListener. */
     void removeListener (Thread::Listener*);
 
+    //==============================================================================
+    /** The priority classes that a job can be given when it's added to a ThreadPool.
+
+        Queued jobs with a higher priority are always started before any queued jobs
+        of a lower priority. Jobs of the same priority are started in the order in
+        which they were added.
+
+        @see ThreadPool::addJob
+    */
+    enum class Priority
+    {
+        low = 0,
+        normal,
+        high
+    };
+
+    /** Returns the priority that this job was given when it was added to a pool. */
+    Priority getPriority() const noexcept               { return priority; }
+
     //==============================================================================
     /** If the calling thread is being invoked inside a runJob() method, this will
         return the ThreadPoolJob that it belongs to.
@@ -134,6 +153,7 @@ private:
     friend class ThreadPool;
     String jobName;
     ThreadPool* pool = nullptr;
+    Priority priority = Priority::normal;
     std::atomic<bool> shouldStop { false }, isActive { false }, shouldBeDeleted { false };
     ListenerList<Thread::Listener, Array<Thread::Listener*, CriticalSection>> listeners;
 
@@ -155,6 +175,27 @@ private:
 class JUCE_API  ThreadPool
 {
 public:
+    //==============================================================================
+    /** The ways in which a pool can distribute its jobs between its threads. */
+    enum class SchedulingMode
+    {
+        /** All the jobs are kept in a single list, which the threads search for the
+            next job to run. Jobs are started strictly in the order in which they were
+            queued, which can be changed with moveJobToFront().
+        */
+        sharedQueue,
+
+        /** Each thread has its own queue of jobs, and a thread that runs out of work
+            will steal jobs from the queues of the other threads. Jobs added from inside
+            one of the pool's own jobs go onto the queue of the thread that added them.
+
+            This scales much better when there are lots of short jobs and lots of threads,
+            but jobs of the same priority are only started in the order in which they
+            were added if they end up on the same thread's queue.
+        */
+        workStealing
+    };
+
     //==============================================================================
     /** Creates a thread pool.
         Once you've created a pool, you can give it some jobs by calling addJob().
@@ -164,8 +205,10 @@ public:
         @param threadStackSize  the size of the stack of each thread. If this value
                                 is zero then the default stack size of the OS will
                                 be used.
+        @param schedulingMode   the way in which jobs are shared between the threads
     */
-    ThreadPool (int numberOfThreads, size_t threadStackSize = 0);
+    ThreadPool (int numberOfThreads, size_t threadStackSize = 0,
+                SchedulingMode schedulingMode = SchedulingMode::sharedQueue);
 
     /** Creates a thread pool with one thread per CPU core.
         Once you've created a pool, you can give it some jobs by calling addJob().
@@ -216,19 +259,34 @@ public:
         If deleteJobWhenFinished is false, the pointer will be used but not deleted, and
         the caller is responsible for making sure the object is not deleted before it has
         been removed from the pool.
+
+        The priority decides where the job is placed in the queue: it will be started
+        before any queued jobs with a lower priority.
     */
     void addJob (ThreadPoolJob* job,
-                 bool deleteJobWhenFinished);
+                 bool deleteJobWhenFinished,
+                 ThreadPoolJob::Priority priority = ThreadPoolJob::Priority::normal);
 
     /** Adds a lambda function to be called as a job.
         This will create an internal ThreadPoolJob object to encapsulate and call the lambda.
     */
-    void addJob (std::function<ThreadPoolJob::JobStatus()> job);
+    void addJob (std::function<ThreadPoolJob::JobStatus()> job,
+                 ThreadPoolJob::Priority priority = ThreadPoolJob::Priority::normal);
 
     /** Adds a lambda function to be called as a job.
         This will create an internal ThreadPoolJob object to encapsulate and call the lambda.
     */
-    void addJob (std::function<void()> job);
+    void addJob (std::function<void()> job,
+                 ThreadPoolJob::Priority priority = ThreadPoolJob::Priority::normal);
+
+    /** Adds a batch of lambda functions to be called as jobs.
+
+        This has the same effect as calling addJob() for each of the functions, but
+        the queues are only locked once for the whole batch, and the threads are only
+        woken once, so it's much cheaper when you have a lot of small jobs to run.
+    */
+    void addJobs (const Array<std::function<void()>>& jobs,
+                  ThreadPoolJob::Priority priority = ThreadPoolJob::Priority::normal);
 
     /** Tries to remove a job from the pool.
 
@@ -272,6 +330,9 @@ public:
     /** Returns the number of threads assigned to this thread pool. */
     int getNumThreads() const noexcept;
 
+    /** Returns the scheduling mode that this pool was created with. */
+    SchedulingMode getSchedulingMode() const noexcept       { return schedulingMode; }
+
     /** Returns one of the jobs in the queue.
 
         Note that this can be a very volatile list as jobs might be continuously getting shifted
@@ -300,7 +361,10 @@ public:
                              int timeOutMilliseconds) const;
 
     /** If the given job is in the queue, this will move it to the front so that it
-        is the next one to be executed.
+        is the next one of its priority to be executed.
+
+        In SchedulingMode::workStealing, this moves it to the front of the queue of the
+        thread that it's waiting for.
     */
     void moveJobToFront (const ThreadPoolJob* jobToMove) noexcept;
 
@@ -321,17 +385,32 @@ private:
     Array<ThreadPoolJob*> jobs;
 
     struct ThreadPoolThread;
+    struct JobQueue;
+    struct ScopedLockAllQueues;
     friend class ThreadPoolJob;
     OwnedArray<ThreadPoolThread> threads;
 
     CriticalSection lock;
     WaitableEvent jobFinishedSignal;
 
+    const SchedulingMode schedulingMode = SchedulingMode::sharedQueue;
+    std::atomic<int> numJobsInPool { 0 }, numQueuedJobs { 0 };
+    std::atomic<uint32> nextQueueIndex { 0 };
+
     bool runNextJob (ThreadPoolThread&);
     ThreadPoolJob* pickNextJobToRun();
     void addToDeleteList (OwnedArray<ThreadPoolJob>&, ThreadPoolJob*) const;
     void createThreads (int numThreads, size_t threadStackSize = 0);
     void stopThreads();
+    void prepareJob (ThreadPoolJob*, bool deleteJobWhenFinished, ThreadPoolJob::Priority);
+    void insertIntoSharedQueue (ThreadPoolJob*);
+    void wakeIdleThreads (int maxNumThreads, int firstThreadToTry);
+    bool hasQueuedJobs() const noexcept;
+
+    ThreadPoolThread* getCurrentPoolThread() const;
+    bool runNextJobFromQueues (ThreadPoolThread&);
+    ThreadPoolJob* pickNextJobFromQueues (ThreadPoolThread&, OwnedArray<ThreadPoolJob>&);
+    template <typename Callback> void visitAllJobs (Callback&&) const;
 
     // Note that this method has changed, and no longer has a parameter to indicate
     // whether the jobs should be deleted - see the new method for details.
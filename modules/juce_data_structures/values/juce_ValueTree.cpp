@@ -27,6 +27,91 @@
 namespace juce
 {
 
+//==============================================================================
+struct ValueTree::CompactFormat
+{
+    // The first byte of the older format is the start of the root's type name, which can
+    // never be 0xff in UTF-8, so this is enough to tell the two formats apart.
+    static constexpr uint8 magic[] = { 0xff, 'V', 'T', 'C' };
+    enum { currentVersion = 1 };
+
+    enum ValueTag
+    {
+        tagVoid, tagUndefined, tagFalse, tagTrue, tagInt, tagInt64, tagDouble, tagString, tagBinary, tagArray
+    };
+
+    // Keeps the memory-mapped data and identifier table alive for as long as any
+    // nodes still have children waiting to be decoded from it.
+    struct Source  : public ReferenceCountedObject
+    {
+        using Ptr = ReferenceCountedObjectPtr<Source>;
+
+        std::unique_ptr<MemoryMappedFile> file;
+        Array<Identifier> identifiers;
+    };
+
+    struct PendingChildren
+    {
+        Source::Ptr source;
+        const uint8* data;
+        size_t size;
+        int numChildren;
+    };
+
+    struct Reader;
+    struct Writer;
+
+    static void decodeChildren (SharedObject&, const PendingChildren&);
+
+    // Shared by all the lazily loaded trees, whose pending children are only touched under it
+    static CriticalSection& getDecodeLock()
+    {
+        static CriticalSection lock;
+        return lock;
+    }
+    static ValueTree read (const void* data, size_t size, Source::Ptr lazySource);
+    static ValueTree readPayload (const void* data, size_t size, Source::Ptr lazySource);
+};
+
+constexpr uint8 ValueTree::CompactFormat::magic[];
+
+//==============================================================================
+// The changes recorded by a ScopedNotificationBatch, which are held by the tree that
+// the batch was created on until the outermost batch for that tree finishes.
+struct ValueTree::PendingNotifications
+{
+    struct Record
+    {
+        BatchedChange change;
+        Listener* listenerToExclude;
+    };
+
+    void add (Record);
+    void addAll (PendingNotifications&);
+    void deliver();
+
+    struct PropertyKey
+    {
+        const SharedObject* object;
+        const void* name;
+
+        bool operator== (const PropertyKey& other) const noexcept   { return object == other.object && name == other.name; }
+    };
+
+    struct PropertyKeyHash
+    {
+        size_t operator() (const PropertyKey& key) const noexcept
+        {
+            return std::hash<const void*>() (key.object) * 31 + std::hash<const void*>() (key.name);
+        }
+    };
+
+    std::vector<Record> records;
+    std::unordered_map<PropertyKey, size_t, PropertyKeyHash> propertyRecords;
+    int depth = 1;
+};
+
+//==============================================================================
 class ValueTree::SharedObject  : public ReferenceCountedObject
 {
 public:
@@ -37,6 +122,8 @@ public:
     SharedObject (const SharedObject& other)
         : ReferenceCountedObject(), type (other.type), properties (other.properties)
     {
+        other.ensureChildrenDecoded();
+
         for (auto* c : other.children)
         {
             auto* child = new SharedObject (*c);
@@ -65,6 +152,74 @@ public:
         return parent == nullptr ? *this : parent->getRoot();
     }
 
+    // A tree that was loaded lazily by readFromMemoryMappedFile() only creates a node's
+    // children when something first needs them. Nothing outside this node can hold a
+    // reference to them before that, so anything that only deals with existing trees
+    // (e.g. sending listener callbacks) can safely skip this.
+    // Several threads may be reading the same tree, so whichever gets here first does the
+    // decoding under the lock, and the flag is only cleared once the children are in place.
+    void ensureChildrenDecoded() const
+    {
+        if (hasPendingChildren.load (std::memory_order_acquire))
+        {
+            const ScopedLock sl (CompactFormat::getDecodeLock());
+
+            if (pendingChildren != nullptr)
+            {
+                CompactFormat::decodeChildren (*const_cast<SharedObject*> (this), *pendingChildren);
+                pendingChildren.reset();
+                hasPendingChildren.store (false, std::memory_order_release);
+            }
+        }
+    }
+
+    // Returns true if there were children waiting to be decoded, which have now been thrown away
+    bool discardPendingChildren()
+    {
+        if (hasPendingChildren.load (std::memory_order_acquire))
+        {
+            const ScopedLock sl (CompactFormat::getDecodeLock());
+
+            if (pendingChildren != nullptr)
+            {
+                pendingChildren.reset();
+                hasPendingChildren.store (false, std::memory_order_release);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void setPendingChildren (CompactFormat::PendingChildren* pending)
+    {
+        // This is only done while the node is being created, before anything else can see it
+        pendingChildren.reset (pending);
+        hasPendingChildren.store (true, std::memory_order_release);
+    }
+
+    int getNumChildren() const noexcept
+    {
+        if (hasPendingChildren.load (std::memory_order_acquire))
+        {
+            const ScopedLock sl (CompactFormat::getDecodeLock());
+
+            if (pendingChildren != nullptr)
+                return pendingChildren->numChildren;
+        }
+
+        return children.size();
+    }
+
+    PendingNotifications* getActiveBatch() const noexcept
+    {
+        for (auto* t = this; t != nullptr; t = t->parent)
+            if (t->pendingNotifications != nullptr)
+                return t->pendingNotifications.get();
+
+        return nullptr;
+    }
+
     template <typename Function>
     void callListeners (ValueTree::Listener* listenerToExclude, Function fn) const
     {
@@ -98,24 +253,40 @@ public:
     void sendPropertyChangeMessage (const Identifier& property, ValueTree::Listener* listenerToExclude = nullptr)
     {
         ValueTree tree (*this);
+
+        if (auto* batch = getActiveBatch())
+            return batch->add ({ { BatchedChange::Type::propertyChanged, tree, {}, property, -1, -1 }, listenerToExclude });
+
         callListenersForAllParents (listenerToExclude, [&] (Listener& l) { l.valueTreePropertyChanged (tree, property); });
     }
 
     void sendChildAddedMessage (ValueTree child)
     {
         ValueTree tree (*this);
+
+        if (auto* batch = getActiveBatch())
+            return batch->add ({ { BatchedChange::Type::childAdded, tree, child, {}, -1, -1 }, nullptr });
+
         callListenersForAllParents (nullptr, [&] (Listener& l) { l.valueTreeChildAdded (tree, child); });
     }
 
     void sendChildRemovedMessage (ValueTree child, int index)
     {
         ValueTree tree (*this);
+
+        if (auto* batch = getActiveBatch())
+            return batch->add ({ { BatchedChange::Type::childRemoved, tree, child, {}, index, -1 }, nullptr });
+
         callListenersForAllParents (nullptr, [=, &tree, &child] (Listener& l) { l.valueTreeChildRemoved (tree, child, index); });
     }
 
     void sendChildOrderChangedMessage (int oldIndex, int newIndex)
     {
         ValueTree tree (*this);
+
+        if (auto* batch = getActiveBatch())
+            return batch->add ({ { BatchedChange::Type::childOrderChanged, tree, {}, {}, oldIndex, newIndex }, nullptr });
+
         callListenersForAllParents (nullptr, [=, &tree] (Listener& l) { l.valueTreeChildOrderChanged (tree, oldIndex, newIndex); });
     }
 
@@ -204,6 +375,8 @@ public:
 
     ValueTree getChildWithName (const Identifier& typeToMatch) const
     {
+        ensureChildrenDecoded();
+
         for (auto* s : children)
             if (s->type == typeToMatch)
                 return ValueTree (*s);
@@ -213,6 +386,8 @@ public:
 
     ValueTree getOrCreateChildWithName (const Identifier& typeToMatch, UndoManager* undoManager)
     {
+        ensureChildrenDecoded();
+
         for (auto* s : children)
             if (s->type == typeToMatch)
                 return ValueTree (*s);
@@ -224,6 +399,8 @@ public:
 
     ValueTree getChildWithProperty (const Identifier& propertyName, const var& propertyValue) const
     {
+        ensureChildrenDecoded();
+
         for (auto* s : children)
             if (s->properties[propertyName] == propertyValue)
                 return ValueTree (*s);
@@ -242,11 +419,14 @@ public:
 
     int indexOf (const ValueTree& child) const noexcept
     {
+        ensureChildrenDecoded();
         return children.indexOf (child.object);
     }
 
     void addChild (SharedObject* child, int index, UndoManager* undoManager)
     {
+        ensureChildrenDecoded();
+
         if (child != nullptr && child->parent != this)
         {
             if (child != this && ! isAChildOf (child))
@@ -288,6 +468,8 @@ public:
 
     void removeChild (int childIndex, UndoManager* undoManager)
     {
+        ensureChildrenDecoded();
+
         if (auto child = Ptr (children.getObjectPointer (childIndex)))
         {
             if (undoManager == nullptr)
@@ -306,12 +488,20 @@ public:
 
     void removeAllChildren (UndoManager* undoManager)
     {
+        // Any children that haven't been decoded yet can't have been seen by anyone
+        if (undoManager == nullptr && discardPendingChildren())
+            return;
+
+        ensureChildrenDecoded();
+
         while (children.size() > 0)
             removeChild (children.size() - 1, undoManager);
     }
 
     void moveChild (int currentIndex, int newIndex, UndoManager* undoManager)
     {
+        ensureChildrenDecoded();
+
         // The source index must be a valid index!
         jassert (isPositiveAndBelow (currentIndex, children.size()));
 
@@ -335,6 +525,7 @@ public:
 
     void reorderChildren (const OwnedArray<ValueTree>& newOrder, UndoManager* undoManager)
     {
+        ensureChildrenDecoded();
         jassert (newOrder.size() == children.size());
 
         for (int i = 0; i < children.size(); ++i)
@@ -352,6 +543,9 @@ public:
 
     bool isEquivalentTo (const SharedObject& other) const noexcept
     {
+        ensureChildrenDecoded();
+        other.ensureChildrenDecoded();
+
         if (type != other.type
              || properties.size() != other.properties.size()
              || children.size() != other.children.size()
@@ -367,6 +561,8 @@ public:
 
     XmlElement* createXml() const
     {
+        ensureChildrenDecoded();
+
         auto* xml = new XmlElement (type);
         properties.copyToXmlAttributes (*xml);
 
@@ -379,6 +575,8 @@ public:
 
     void writeToStream (OutputStream& output) const
     {
+        ensureChildrenDecoded();
+
         output.writeString (type.toString());
         output.writeCompressedInt (properties.size());
 
@@ -571,10 +769,140 @@ public:
     ReferenceCountedArray<SharedObject> children;
     SortedSet<ValueTree*> valueTreesWithListeners;
     SharedObject* parent = nullptr;
+    mutable std::unique_ptr<CompactFormat::PendingChildren> pendingChildren;
+    mutable std::atomic<bool> hasPendingChildren { false };
+    std::unique_ptr<PendingNotifications> pendingNotifications;
 
     JUCE_LEAK_DETECTOR (SharedObject)
 };
 
+//==============================================================================
+void ValueTree::PendingNotifications::add (Record record)
+{
+    if (record.change.type == BatchedChange::Type::propertyChanged)
+    {
+        // Only the most recent change to each property is kept, so that it comes after
+        // any structural changes that it might depend on
+        // (identifiers are pooled, so the address of the name is enough to identify it)
+        PropertyKey key { record.change.tree.object.get(), record.change.property.getCharPointer().getAddress() };
+        auto result = propertyRecords.insert ({ key, records.size() });
+
+        if (! result.second)
+        {
+            auto& previous = records[result.first->second];
+
+            if (previous.listenerToExclude != record.listenerToExclude)
+                record.listenerToExclude = nullptr;
+
+            previous.change.tree = {};
+            result.first->second = records.size();
+        }
+    }
+
+    records.push_back (std::move (record));
+}
+
+void ValueTree::PendingNotifications::addAll (PendingNotifications& other)
+{
+    for (auto& r : other.records)
+        if (r.change.tree.isValid())
+            add (std::move (r));
+}
+
+void ValueTree::PendingNotifications::deliver()
+{
+    // Each object with registered ValueTrees hears about the changes to itself and to any
+    // of the objects that are now below it
+    struct Recipient
+    {
+        SharedObject::Ptr object;
+        Array<int> recordIndexes;
+    };
+
+    std::vector<Recipient> recipients;
+    std::unordered_map<const SharedObject*, size_t> recipientIndexes;
+
+    for (int i = 0; i < (int) records.size(); ++i)
+    {
+        if (! records[(size_t) i].change.tree.isValid())
+            continue;
+
+        for (auto* t = records[(size_t) i].change.tree.object.get(); t != nullptr; t = t->parent)
+        {
+            if (t->valueTreesWithListeners.isEmpty())
+                continue;
+
+            auto result = recipientIndexes.insert ({ t, recipients.size() });
+
+            if (result.second)
+                recipients.push_back ({ t, {} });
+
+            recipients[result.first->second].recordIndexes.add (i);
+        }
+    }
+
+    for (auto& recipient : recipients)
+    {
+        Array<BatchedChange> changes;
+        changes.ensureStorageAllocated (recipient.recordIndexes.size());
+        bool anyExclusions = false;
+
+        for (auto i : recipient.recordIndexes)
+        {
+            changes.add (records[(size_t) i].change);
+            anyExclusions = anyExclusions || records[(size_t) i].listenerToExclude != nullptr;
+        }
+
+        recipient.object->callListeners (nullptr, [&] (Listener& l)
+        {
+            if (! anyExclusions)
+            {
+                l.valueTreeChangesBatched (changes);
+                return;
+            }
+
+            Array<BatchedChange> filtered;
+
+            for (auto i : recipient.recordIndexes)
+                if (records[(size_t) i].listenerToExclude != &l)
+                    filtered.add (records[(size_t) i].change);
+
+            if (! filtered.isEmpty())
+                l.valueTreeChangesBatched (filtered);
+        });
+    }
+}
+
+//==============================================================================
+ValueTree::ScopedNotificationBatch::ScopedNotificationBatch (const ValueTree& treeToBatch)
+    : tree (treeToBatch)
+{
+    if (auto* object = tree.object.get())
+    {
+        if (object->pendingNotifications != nullptr)
+            ++(object->pendingNotifications->depth);
+        else
+            object->pendingNotifications.reset (new PendingNotifications());
+    }
+}
+
+ValueTree::ScopedNotificationBatch::~ScopedNotificationBatch()
+{
+    auto* object = tree.object.get();
+
+    if (object == nullptr || --(object->pendingNotifications->depth) > 0)
+        return;
+
+    std::unique_ptr<PendingNotifications> pending (std::move (object->pendingNotifications));
+
+    // If the tree has since been added to a tree that's also being batched, the
+    // changes are passed on to that batch rather than being delivered now
+    if (auto* outerBatch = object->getActiveBatch())
+        outerBatch->addAll (*pending);
+    else
+        pending->deliver();
+}
+
 //==============================================================================
 ValueTree::ValueTree() noexcept
 {
@@ -686,8 +1014,12 @@ void ValueTree::copyPropertiesAndChildrenFrom (const ValueTree& source, UndoMana
     removeAllChildren (undoManager);
 
     if (object != nullptr && source.object != nullptr)
+    {
+        source.object->ensureChildrenDecoded();
+
         for (auto& child : source.object->children)
             object->addChild (createCopyIfNotNull (child), -1, undoManager);
+    }
 }
 
 bool ValueTree::hasType (const Identifier& typeName) const noexcept
@@ -851,21 +1183,29 @@ Value ValueTree::getPropertyAsValue (const Identifier& name, UndoManager* undoMa
 //==============================================================================
 int ValueTree::getNumChildren() const noexcept
 {
-    return object == nullptr ? 0 : object->children.size();
+    return object == nullptr ? 0 : object->getNumChildren();
 }
 
 ValueTree ValueTree::getChild (int index) const
 {
     if (object != nullptr)
+    {
+        object->ensureChildrenDecoded();
+
         if (auto* c = object->children.getObjectPointer (index))
             return ValueTree (*c);
+    }
 
     return {};
 }
 
-ValueTree::Iterator::Iterator (const ValueTree& v, bool isEnd)
-   : internal (v.object != nullptr ? (isEnd ? v.object->children.end() : v.object->children.begin()) : nullptr)
+ValueTree::Iterator::Iterator (const ValueTree& v, bool isEnd)  : internal (nullptr)
 {
+    if (v.object != nullptr)
+    {
+        v.object->ensureChildrenDecoded();
+        internal = isEnd ? v.object->children.end() : v.object->children.begin();
+    }
 }
 
 ValueTree::Iterator& ValueTree::Iterator::operator++()
@@ -932,7 +1272,7 @@ void ValueTree::removeChild (int childIndex, UndoManager* undoManager)
 void ValueTree::removeChild (const ValueTree& child, UndoManager* undoManager)
 {
     if (object != nullptr)
-        object->removeChild (object->children.indexOf (child.object), undoManager);
+        object->removeChild (object->indexOf (child), undoManager);
 }
 
 void ValueTree::removeAllChildren (UndoManager* undoManager)
@@ -951,6 +1291,7 @@ void ValueTree::moveChild (int currentIndex, int newIndex, UndoManager* undoMana
 void ValueTree::createListOfChildren (OwnedArray<ValueTree>& list) const
 {
     jassert (object != nullptr);
+    object->ensureChildrenDecoded();
 
     for (auto* o : object->children)
     {
@@ -1033,7 +1374,36 @@ void ValueTree::writeToStream (OutputStream& output) const
 
 ValueTree ValueTree::readFromStream (InputStream& input)
 {
-    auto type = input.readString();
+    auto firstByte = input.readByte();
+
+    if ((uint8) firstByte == CompactFormat::magic[0])
+    {
+        uint8 header[numElementsInArray (CompactFormat::magic) - 1];
+
+        if (input.read (header, (int) sizeof (header)) != (int) sizeof (header)
+             || memcmp (header, CompactFormat::magic + 1, sizeof (header)) != 0
+             || input.readCompressedInt() > CompactFormat::currentVersion)
+        {
+            jassertfalse;  // trying to read corrupted data, or a newer version of the format!
+            return {};
+        }
+
+        auto size = input.readInt64();
+        MemoryBlock block;
+
+        if (size <= 0 || input.readIntoMemoryBlock (block, (ssize_t) size) != (size_t) size)
+            return {};
+
+        return CompactFormat::readPayload (block.getData(), block.getSize(), nullptr);
+    }
+
+    // Otherwise this is the original format, which starts with the type name
+    MemoryOutputStream typeName;
+
+    for (auto c = firstByte; c != 0; c = input.readByte())
+        typeName.writeByte (c);
+
+    auto type = typeName.toUTF8();
 
     if (type.isEmpty())
         return {};
@@ -1077,6 +1447,10 @@ ValueTree ValueTree::readFromStream (InputStream& input)
 
 ValueTree ValueTree::readFromData (const void* data, size_t numBytes)
 {
+    // The compact format can be decoded straight from the block, without copying it
+    if (numBytes > sizeof (CompactFormat::magic) && memcmp (data, CompactFormat::magic, sizeof (CompactFormat::magic)) == 0)
+        return CompactFormat::read (data, numBytes, nullptr);
+
     MemoryInputStream in (data, numBytes, false);
     return readFromStream (in);
 }
@@ -1088,92 +1462,586 @@ ValueTree ValueTree::readFromGZIPData (const void* data, size_t numBytes)
     return readFromStream (gzipStream);
 }
 
-void ValueTree::Listener::valueTreePropertyChanged   (ValueTree&, const Identifier&) {}
-void ValueTree::Listener::valueTreeChildAdded        (ValueTree&, ValueTree&)        {}
-void ValueTree::Listener::valueTreeChildRemoved      (ValueTree&, ValueTree&, int)   {}
-void ValueTree::Listener::valueTreeChildOrderChanged (ValueTree&, int, int)          {}
-void ValueTree::Listener::valueTreeParentChanged     (ValueTree&)                    {}
-void ValueTree::Listener::valueTreeRedirected        (ValueTree&)                    {}
+ValueTree ValueTree::readFromMemoryMappedFile (const File& file, bool decodeChildrenLazily)
+{
+    CompactFormat::Source::Ptr source (new CompactFormat::Source());
+    source->file.reset (new MemoryMappedFile (file, MemoryMappedFile::readOnly));
 
+    auto* data = source->file->getData();
+    auto size = source->file->getSize();
 
-//==============================================================================
-//==============================================================================
-#if JUCE_UNIT_TESTS
+    if (data == nullptr || size == 0)
+        return {};
 
-class ValueTreeTests  : public UnitTest
-{
-public:
-    ValueTreeTests()
-        : UnitTest ("ValueTrees", UnitTestCategories::values)
-    {}
+    if (size > sizeof (CompactFormat::magic) && memcmp (data, CompactFormat::magic, sizeof (CompactFormat::magic)) == 0)
+        return CompactFormat::read (data, size, decodeChildrenLazily ? source : nullptr);
 
-    static String createRandomIdentifier (Random& r)
+    return readFromData (data, size);
+}
+
+//==============================================================================
+// The compact format is laid out as follows, with all integers stored as unsigned
+// LEB128 varints unless stated otherwise:
+//
+//   header:    magic bytes, version, payload size (int64 LE)
+//   payload:   number of identifiers, then each as a UTF-8 byte count and bytes
+//              the root node
+//   node:      type index + 1 (0 for an invalid tree), number of properties,
+//              then a name index and value for each property, number of children,
+//              and if that's non-zero, the children's size in bytes (uint32 LE)
+//              followed by the children
+//   value:     a ValueTag byte, then: ints as zigzag varints, doubles as 8 bytes LE,
+//              strings and binary data as a byte count and bytes, arrays as a count
+//              and values
+//
+struct ValueTree::CompactFormat::Writer
+{
+    void writeNode (const SharedObject* object)
     {
-        char buffer[50] = { 0 };
-        const char chars[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_-:";
+        if (object == nullptr)
+        {
+            writeVarint (0);
+            return;
+        }
 
-        for (int i = 1 + r.nextInt (numElementsInArray (buffer) - 2); --i >= 0;)
-            buffer[i] = chars[r.nextInt (sizeof (chars) - 1)];
+        object->ensureChildrenDecoded();
 
-        String result (buffer);
+        writeVarint ((uint64) getIdentifierIndex (object->type) + 1);
+        writeVarint ((uint64) object->properties.size());
 
-        if (! XmlElement::isValidXmlName (result))
-            result = createRandomIdentifier (r);
+        for (int i = 0; i < object->properties.size(); ++i)
+        {
+            writeVarint ((uint64) getIdentifierIndex (object->properties.getName (i)));
+            writeValue (*object->properties.getVarPointerAt (i));
+        }
 
-        return result;
+        writeVarint ((uint64) object->children.size());
+
+        if (object->children.size() > 0)
+        {
+            // The children's size gets filled in once they've been written
+            auto sizePosition = body.getPosition();
+            body.writeInt (0);
+
+            for (auto* child : object->children)
+                writeNode (child);
+
+            auto endPosition = body.getPosition();
+            body.setPosition (sizePosition);
+            body.writeInt ((int) (endPosition - sizePosition - 4));
+            body.setPosition (endPosition);
+        }
     }
 
-    static String createRandomWideCharString (Random& r)
+    void writeTo (OutputStream& output)
     {
-        juce_wchar buffer[50] = { 0 };
+        MemoryOutputStream table;
+        writeVarint (table, (uint64) identifiers.size());
 
-        for (int i = r.nextInt (numElementsInArray (buffer) - 1); --i >= 0;)
+        for (auto& name : identifiers)
         {
-            if (r.nextBool())
-            {
-                do
-                {
-                    buffer[i] = (juce_wchar) (1 + r.nextInt (0x10ffff - 1));
-                }
-                while (! CharPointer_UTF16::canRepresent (buffer[i]));
-            }
-            else
-                buffer[i] = (juce_wchar) (1 + r.nextInt (0x7e));
+            auto text = name.getCharPointer();
+            auto numBytes = text.sizeInBytes() - 1;
+            writeVarint (table, (uint64) numBytes);
+            table.write (text.getAddress(), numBytes);
         }
 
-        return CharPointer_UTF32 (buffer);
+        output.write (magic, sizeof (magic));
+        output.writeCompressedInt (currentVersion);
+        output.writeInt64 ((int64) (table.getDataSize() + body.getDataSize()));
+        output.write (table.getData(), table.getDataSize());
+        output.write (body.getData(), body.getDataSize());
     }
 
-    static ValueTree createRandomTree (UndoManager* undoManager, int depth, Random& r)
+private:
+    MemoryOutputStream body;
+    Array<Identifier> identifiers;
+    HashMap<const void*, int> identifierIndices;
+
+    int getIdentifierIndex (const Identifier& name)
     {
-        ValueTree v (createRandomIdentifier (r));
+        // Identifiers are pooled, so the address of the text is enough to identify them
+        auto key = static_cast<const void*> (name.getCharPointer().getAddress());
 
-        for (int i = r.nextInt (10); --i >= 0;)
+        if (identifierIndices.contains (key))
+            return identifierIndices[key];
+
+        auto index = identifiers.size();
+        identifiers.add (name);
+        identifierIndices.set (key, index);
+        return index;
+    }
+
+    static void writeVarint (OutputStream& out, uint64 value)
+    {
+        uint8 buffer[10];
+        int numBytes = 0;
+
+        for (;;)
         {
-            switch (r.nextInt (5))
+            auto byte = (uint8) (value & 0x7f);
+            value >>= 7;
+
+            if (value == 0)
             {
-                case 0: v.setProperty (createRandomIdentifier (r), createRandomWideCharString (r), undoManager); break;
-                case 1: v.setProperty (createRandomIdentifier (r), r.nextInt(), undoManager); break;
-                case 2: if (depth < 5) v.addChild (createRandomTree (undoManager, depth + 1, r), r.nextInt (v.getNumChildren() + 1), undoManager); break;
-                case 3: v.setProperty (createRandomIdentifier (r), r.nextBool(), undoManager); break;
-                case 4: v.setProperty (createRandomIdentifier (r), r.nextDouble(), undoManager); break;
-                default: break;
+                buffer[numBytes++] = byte;
+                break;
             }
+
+            buffer[numBytes++] = (uint8) (byte | 0x80);
         }
 
-        return v;
+        out.write (buffer, (size_t) numBytes);
     }
 
-    void runTest() override
+    void writeVarint (uint64 value)                 { writeVarint (body, value); }
+    void writeSignedVarint (int64 value)            { writeVarint (((uint64) value << 1) ^ (uint64) (value >> 63)); }
+    void writeTag (ValueTag tag)                    { body.writeByte ((char) tag); }
+
+    void writeBytes (const void* data, size_t numBytes)
     {
-        {
-            beginTest ("ValueTree");
+        writeVarint ((uint64) numBytes);
+        body.write (data, numBytes);
+    }
 
-            auto r = getRandom();
+    void writeValue (const var& value)
+    {
+        if (value.isVoid())             { writeTag (tagVoid); }
+        else if (value.isUndefined())   { writeTag (tagUndefined); }
+        else if (value.isBool())        { writeTag ((bool) value ? tagTrue : tagFalse); }
+        else if (value.isInt())         { writeTag (tagInt);    writeSignedVarint ((int) value); }
+        else if (value.isInt64())       { writeTag (tagInt64);  writeSignedVarint ((int64) value); }
+        else if (value.isDouble())      { writeTag (tagDouble); body.writeDouble ((double) value); }
+        else if (value.isString())
+        {
+            auto text = value.toString().toUTF8();
+            writeTag (tagString);
+            writeBytes (text.getAddress(), text.sizeInBytes() - 1);
+        }
+        else if (auto* block = value.getBinaryData())
+        {
+            writeTag (tagBinary);
+            writeBytes (block->getData(), block->getSize());
+        }
+        else if (auto* array = value.getArray())
+        {
+            writeTag (tagArray);
+            writeVarint ((uint64) array->size());
 
-            for (int i = 10; --i >= 0;)
-            {
-                MemoryOutputStream mo;
+            for (auto& item : *array)
+                writeValue (item);
+        }
+        else
+        {
+            jassertfalse;  // Can't write an object or method to a stream!
+            writeTag (tagVoid);
+        }
+    }
+};
+
+//==============================================================================
+struct ValueTree::CompactFormat::Reader
+{
+    Reader (const void* data, size_t size, Array<Identifier>& ids, Source* lazy) noexcept
+        : identifiers (ids), current (static_cast<const uint8*> (data)), end (current + size), lazySource (lazy)
+    {
+    }
+
+    bool readIdentifierTable()
+    {
+        auto num = readCount();
+        identifiers.ensureStorageAllocated (num);
+
+        for (int i = 0; i < num && ! failed; ++i)
+        {
+            auto numBytes = readCount();
+
+            if (numBytes == 0)
+                return ! (failed = true);
+
+            if (auto* text = readBytes ((size_t) numBytes))
+                identifiers.add (Identifier (String::fromUTF8 (reinterpret_cast<const char*> (text), numBytes)));
+        }
+
+        return ! failed;
+    }
+
+    SharedObject::Ptr readNode()
+    {
+        auto typeIndex = readVarint();
+
+        if (typeIndex == 0 || typeIndex > (uint64) identifiers.size())
+            return {};
+
+        SharedObject::Ptr object (new SharedObject (identifiers.getReference ((int) typeIndex - 1)));
+
+        for (auto numProperties = readCount(); --numProperties >= 0 && ! failed;)
+        {
+            auto nameIndex = readVarint();
+
+            if (nameIndex >= (uint64) identifiers.size())
+                return markFailed();
+
+            object->properties.set (identifiers.getReference ((int) nameIndex), readValue());
+        }
+
+        if (auto numChildren = readCount())
+        {
+            auto size = readUInt32();
+
+            if (auto* childData = readBytes (size))
+            {
+                PendingChildren pending { lazySource, childData, size, numChildren };
+
+                if (lazySource != nullptr)
+                    object->setPendingChildren (new PendingChildren (std::move (pending)));
+                else
+                    readChildren (*object, pending);
+            }
+        }
+
+        if (failed)
+            return {};
+
+        return object;
+    }
+
+    void readChildren (SharedObject& parent, const PendingChildren& pending)
+    {
+        Reader childReader (pending.data, pending.size, identifiers, lazySource);
+        parent.children.ensureStorageAllocated (pending.numChildren);
+
+        for (int i = 0; i < pending.numChildren; ++i)
+        {
+            auto child = childReader.readNode();
+
+            if (child == nullptr)
+            {
+                jassertfalse;  // trying to read corrupted data!
+                break;
+            }
+
+            parent.children.add (child);
+            child->parent = &parent;
+        }
+    }
+
+    Array<Identifier>& identifiers;
+    bool failed = false;
+
+private:
+    const uint8* current;
+    const uint8* const end;
+    Source* const lazySource;
+
+    std::nullptr_t markFailed() noexcept
+    {
+        failed = true;
+        return nullptr;
+    }
+
+    size_t getNumRemaining() const noexcept     { return (size_t) (end - current); }
+
+    uint64 readVarint() noexcept
+    {
+        uint64 result = 0;
+
+        for (int shift = 0; shift < 64 && current < end; shift += 7)
+        {
+            auto byte = *current++;
+            result |= (uint64) (byte & 0x7f) << shift;
+
+            if ((byte & 0x80) == 0)
+                return result;
+        }
+
+        failed = true;
+        return 0;
+    }
+
+    // Every counted item takes at least a byte, so a count can't be bigger than
+    // what's left, which stops corrupt data from triggering huge allocations.
+    int readCount() noexcept
+    {
+        auto num = readVarint();
+
+        if (num > getNumRemaining())
+        {
+            failed = true;
+            return 0;
+        }
+
+        return (int) num;
+    }
+
+    const uint8* readBytes (size_t numBytes) noexcept
+    {
+        if (numBytes > getNumRemaining())
+        {
+            failed = true;
+            return nullptr;
+        }
+
+        auto* start = current;
+        current += numBytes;
+        return start;
+    }
+
+    uint32 readUInt32() noexcept
+    {
+        auto* bytes = readBytes (4);
+        return bytes != nullptr ? ByteOrder::littleEndianInt (bytes) : 0;
+    }
+
+    int64 readSignedVarint() noexcept
+    {
+        auto value = readVarint();
+        return (int64) (value >> 1) ^ -(int64) (value & 1);
+    }
+
+    var readValue()
+    {
+        if (current >= end)
+            return markFailed(), var();
+
+        switch (*current++)
+        {
+            case tagVoid:       return {};
+            case tagUndefined:  return var::undefined();
+            case tagFalse:      return false;
+            case tagTrue:       return true;
+            case tagInt:        return (int) readSignedVarint();
+            case tagInt64:      return readSignedVarint();
+
+            case tagDouble:
+            {
+                auto* bytes = readBytes (8);
+
+                if (bytes == nullptr)
+                    return {};
+
+                auto bits = (int64) ByteOrder::littleEndianInt64 (bytes);
+                double d;
+                memcpy (&d, &bits, sizeof (d));
+                return d;
+            }
+
+            case tagString:
+            {
+                auto numBytes = readCount();
+
+                if (auto* text = readBytes ((size_t) numBytes))
+                    return String::fromUTF8 (reinterpret_cast<const char*> (text), numBytes);
+
+                return {};
+            }
+
+            case tagBinary:
+            {
+                auto numBytes = readCount();
+
+                if (auto* data = readBytes ((size_t) numBytes))
+                    return var (data, (size_t) numBytes);
+
+                return {};
+            }
+
+            case tagArray:
+            {
+                Array<var> items;
+                auto num = readCount();
+                items.ensureStorageAllocated (num);
+
+                for (int i = 0; i < num && ! failed; ++i)
+                    items.add (readValue());
+
+                return var (std::move (items));
+            }
+
+            default:
+                failed = true;
+                return {};
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Reader)
+};
+
+void ValueTree::CompactFormat::decodeChildren (SharedObject& parent, const PendingChildren& pending)
+{
+    Reader reader (pending.data, pending.size, pending.source->identifiers, pending.source.get());
+    reader.readChildren (parent, pending);
+}
+
+ValueTree ValueTree::CompactFormat::read (const void* data, size_t size, Source::Ptr lazySource)
+{
+    jassert (size > sizeof (magic) && memcmp (data, magic, sizeof (magic)) == 0);
+
+    MemoryInputStream header (data, size, false);
+    header.skipNextBytes (sizeof (magic));
+
+    if (header.readCompressedInt() > currentVersion)
+    {
+        jassertfalse;  // this was written by a newer version of the format!
+        return {};
+    }
+
+    auto payloadSize = header.readInt64();
+    auto payloadStart = (size_t) header.getPosition();
+
+    if (payloadSize <= 0 || (uint64) payloadSize > (uint64) (size - payloadStart))
+        return {};
+
+    return readPayload (static_cast<const uint8*> (data) + payloadStart, (size_t) payloadSize, lazySource);
+}
+
+ValueTree ValueTree::CompactFormat::readPayload (const void* data, size_t size, Source::Ptr lazySource)
+{
+    Array<Identifier> localIdentifiers;
+    Reader reader (data, size, lazySource != nullptr ? lazySource->identifiers : localIdentifiers, lazySource.get());
+
+    if (! reader.readIdentifierTable())
+        return {};
+
+    return ValueTree (reader.readNode());
+}
+
+void ValueTree::writeToCompactStream (OutputStream& output) const
+{
+    CompactFormat::Writer writer;
+    writer.writeNode (object.get());
+    writer.writeTo (output);
+}
+
+void ValueTree::Listener::valueTreePropertyChanged   (ValueTree&, const Identifier&) {}
+void ValueTree::Listener::valueTreeChildAdded        (ValueTree&, ValueTree&)        {}
+void ValueTree::Listener::valueTreeChildRemoved      (ValueTree&, ValueTree&, int)   {}
+void ValueTree::Listener::valueTreeChildOrderChanged (ValueTree&, int, int)          {}
+void ValueTree::Listener::valueTreeParentChanged     (ValueTree&)                    {}
+void ValueTree::Listener::valueTreeRedirected        (ValueTree&)                    {}
+
+void ValueTree::Listener::valueTreeChangesBatched (const Array<BatchedChange>& changes)
+{
+    for (auto& change : changes)
+    {
+        auto tree = change.tree;
+        auto child = change.child;
+
+        switch (change.type)
+        {
+            case BatchedChange::Type::propertyChanged:      valueTreePropertyChanged (tree, change.property); break;
+            case BatchedChange::Type::childAdded:           valueTreeChildAdded (tree, child); break;
+            case BatchedChange::Type::childRemoved:         valueTreeChildRemoved (tree, child, change.oldIndex); break;
+            case BatchedChange::Type::childOrderChanged:    valueTreeChildOrderChanged (tree, change.oldIndex, change.newIndex); break;
+            default:                                        break;
+        }
+    }
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ValueTreeTests  : public UnitTest
+{
+public:
+    ValueTreeTests()
+        : UnitTest ("ValueTrees", UnitTestCategories::values)
+    {}
+
+    static String createRandomIdentifier (Random& r)
+    {
+        char buffer[50] = { 0 };
+        const char chars[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_-:";
+
+        for (int i = 1 + r.nextInt (numElementsInArray (buffer) - 2); --i >= 0;)
+            buffer[i] = chars[r.nextInt (sizeof (chars) - 1)];
+
+        String result (buffer);
+
+        if (! XmlElement::isValidXmlName (result))
+            result = createRandomIdentifier (r);
+
+        return result;
+    }
+
+    static String createRandomWideCharString (Random& r)
+    {
+        juce_wchar buffer[50] = { 0 };
+
+        for (int i = r.nextInt (numElementsInArray (buffer) - 1); --i >= 0;)
+        {
+            if (r.nextBool())
+            {
+                do
+                {
+                    buffer[i] = (juce_wchar) (1 + r.nextInt (0x10ffff - 1));
+                }
+                while (! CharPointer_UTF16::canRepresent (buffer[i]));
+            }
+            else
+                buffer[i] = (juce_wchar) (1 + r.nextInt (0x7e));
+        }
+
+        return CharPointer_UTF32 (buffer);
+    }
+
+    static ValueTree createRandomTree (UndoManager* undoManager, int depth, Random& r)
+    {
+        ValueTree v (createRandomIdentifier (r));
+
+        for (int i = r.nextInt (10); --i >= 0;)
+        {
+            switch (r.nextInt (5))
+            {
+                case 0: v.setProperty (createRandomIdentifier (r), createRandomWideCharString (r), undoManager); break;
+                case 1: v.setProperty (createRandomIdentifier (r), r.nextInt(), undoManager); break;
+                case 2: if (depth < 5) v.addChild (createRandomTree (undoManager, depth + 1, r), r.nextInt (v.getNumChildren() + 1), undoManager); break;
+                case 3: v.setProperty (createRandomIdentifier (r), r.nextBool(), undoManager); break;
+                case 4: v.setProperty (createRandomIdentifier (r), r.nextDouble(), undoManager); break;
+                default: break;
+            }
+        }
+
+        return v;
+    }
+
+    static int countNodes (const ValueTree& v)
+    {
+        int count = 1;
+
+        for (int i = 0; i < v.getNumChildren(); ++i)
+            count += countNodes (v.getChild (i));
+
+        return count;
+    }
+
+    struct NodeCounter  : public Thread
+    {
+        NodeCounter (const ValueTree& v, WaitableEvent& e)  : Thread ("ValueTree test"), tree (v), startEvent (e) {}
+
+        void run() override
+        {
+            startEvent.wait();
+            count = countNodes (tree);
+        }
+
+        ValueTree tree;
+        WaitableEvent& startEvent;
+        int count = 0;
+    };
+
+    void runTest() override
+    {
+        {
+            beginTest ("ValueTree");
+
+            auto r = getRandom();
+
+            for (int i = 10; --i >= 0;)
+            {
+                MemoryOutputStream mo;
                 auto v1 = createRandomTree (nullptr, 0, r);
                 v1.writeToStream (mo);
 
@@ -1197,6 +2065,365 @@ public:
             }
         }
 
+        {
+            beginTest ("Compact format");
+
+            auto r = getRandom();
+
+            for (int i = 10; --i >= 0;)
+            {
+                auto v1 = createRandomTree (nullptr, 0, r);
+                v1.setProperty ("int64", (int64) r.nextInt64(), nullptr);
+                v1.setProperty ("array", Array<var> { r.nextInt(), createRandomWideCharString (r), Array<var> { -1.5, var() } }, nullptr);
+                v1.setProperty ("binary", var (&r, sizeof (r)), nullptr);
+                v1.setProperty ("undefined", var::undefined(), nullptr);
+
+                MemoryOutputStream mo;
+                v1.writeToCompactStream (mo);
+
+                MemoryInputStream mi (mo.getData(), mo.getDataSize(), false);
+                expect (v1.isEquivalentTo (ValueTree::readFromStream (mi)));
+                expect (v1.isEquivalentTo (ValueTree::readFromData (mo.getData(), mo.getDataSize())));
+
+                MemoryOutputStream zipped;
+                {
+                    GZIPCompressorOutputStream zippedOut (zipped);
+                    v1.writeToCompactStream (zippedOut);
+                }
+                expect (v1.isEquivalentTo (ValueTree::readFromGZIPData (zipped.getData(), zipped.getDataSize())));
+            }
+
+            MemoryOutputStream empty;
+            ValueTree().writeToCompactStream (empty);
+            expect (! ValueTree::readFromData (empty.getData(), empty.getDataSize()).isValid());
+        }
+
+        {
+            beginTest ("Compact format lazy decoding");
+
+            auto r = getRandom();
+            ValueTree v1 ("root");
+
+            for (int i = 0; i < 20; ++i)
+                v1.appendChild (createRandomTree (nullptr, 1, r), nullptr);
+
+            TemporaryFile tempFile;
+
+            {
+                FileOutputStream out (tempFile.getFile());
+                v1.writeToCompactStream (out);
+            }
+
+            {
+                auto v2 = ValueTree::readFromMemoryMappedFile (tempFile.getFile());
+                expectEquals (v2.getNumChildren(), v1.getNumChildren());
+                expect (v1.isEquivalentTo (v2));
+                expect (v1.getChild (7).isEquivalentTo (v2.getChild (7)));
+            }
+
+            {
+                auto v2 = ValueTree::readFromMemoryMappedFile (tempFile.getFile());
+                auto child = v2.getChild (3);
+                child.removeAllChildren (nullptr);
+                child.setProperty ("edited", true, nullptr);
+                v2.removeChild (0, nullptr);
+                expectEquals (v2.getNumChildren(), v1.getNumChildren() - 1);
+                expect (v2.getChild (2).isEquivalentTo (child));
+                expectEquals (child.getNumChildren(), 0);
+
+                int count = 0;
+
+                for (auto c : v2)
+                    count += c.isValid() ? 1 : 0;
+
+                expectEquals (count, v2.getNumChildren());
+            }
+
+            {
+                // Legacy files can be loaded the same way
+                FileOutputStream out (tempFile.getFile());
+                out.setPosition (0);
+                out.truncate();
+                v1.writeToStream (out);
+            }
+
+            expect (v1.isEquivalentTo (ValueTree::readFromMemoryMappedFile (tempFile.getFile())));
+        }
+
+        {
+            beginTest ("Compact format lazy decoding from several threads");
+
+            auto r = getRandom();
+            ValueTree v1 ("root");
+
+            for (int i = 0; i < 50; ++i)
+                v1.appendChild (createRandomTree (nullptr, 0, r), nullptr);
+
+            TemporaryFile tempFile;
+
+            {
+                FileOutputStream out (tempFile.getFile());
+                v1.writeToCompactStream (out);
+            }
+
+            const auto expectedCount = countNodes (v1);
+
+            for (int i = 0; i < 20; ++i)
+            {
+                auto v2 = ValueTree::readFromMemoryMappedFile (tempFile.getFile());
+                WaitableEvent startEvent (true);
+                OwnedArray<NodeCounter> counters;
+
+                for (int j = 0; j < 4; ++j)
+                    counters.add (new NodeCounter (v2, startEvent))->startThread();
+
+                startEvent.signal();
+
+                for (auto* c : counters)
+                {
+                    expect (c->waitForThreadToExit (10000));
+                    expectEquals (c->count, expectedCount);
+                }
+
+                expect (v1.isEquivalentTo (v2));
+            }
+        }
+
+        {
+            beginTest ("Compact format rejects bad data");
+
+            auto r = getRandom();
+            auto v1 = createRandomTree (nullptr, 0, r);
+            v1.appendChild (createRandomTree (nullptr, 1, r), nullptr);
+
+            MemoryOutputStream mo;
+            v1.writeToCompactStream (mo);
+            MemoryBlock data (mo.getData(), mo.getDataSize());
+
+            // None of these should crash or hang - any result other than an exact
+            // match is allowed, as long as it's well-formed.
+            for (size_t size = 0; size < data.getSize(); ++size)
+                ValueTree::readFromData (data.getData(), size);
+
+            for (int i = 200; --i >= 0;)
+            {
+                auto corrupt = data;
+                corrupt[(int) (sizeof (int) + (size_t) r.nextInt ((int) corrupt.getSize() - (int) sizeof (int)))] = (char) r.nextInt (256);
+                ValueTree::readFromData (corrupt.getData(), corrupt.getSize()).createCopy();
+            }
+        }
+
+        {
+            beginTest ("Batched notifications");
+
+            struct CountingListener  : public ValueTree::Listener
+            {
+                void valueTreePropertyChanged (ValueTree&, const Identifier&) override  { ++numPropertyChanges; }
+                void valueTreeChildAdded (ValueTree&, ValueTree&) override              { ++numChildrenAdded; }
+                void valueTreeChildRemoved (ValueTree&, ValueTree&, int) override       { ++numChildrenRemoved; }
+
+                void valueTreeChangesBatched (const Array<ValueTree::BatchedChange>& changes) override
+                {
+                    ++numBatches;
+                    ValueTree::Listener::valueTreeChangesBatched (changes);
+                }
+
+                int numPropertyChanges = 0, numChildrenAdded = 0, numChildrenRemoved = 0, numBatches = 0;
+            };
+
+            ValueTree root ("root"), child ("child");
+            root.appendChild (child, nullptr);
+
+            CountingListener rootListener, childListener;
+            root.addListener (&rootListener);
+            auto childRef = child;
+            childRef.addListener (&childListener);
+
+            {
+                ValueTree::ScopedNotificationBatch batch (root);
+
+                for (int i = 0; i < 100; ++i)
+                {
+                    child.setProperty ("a", i, nullptr);
+                    root.setProperty ("b", i, nullptr);
+                }
+
+                root.appendChild (ValueTree ("other"), nullptr);
+                root.removeChild (1, nullptr);
+
+                {
+                    ValueTree::ScopedNotificationBatch innerBatch (child);
+                    child.setProperty ("a", -1, nullptr);
+                    child.setProperty ("c", -1, nullptr);
+                }
+
+                expectEquals (rootListener.numPropertyChanges + rootListener.numChildrenAdded + rootListener.numBatches, 0);
+                expectEquals (childListener.numBatches, 0);
+            }
+
+            expectEquals (rootListener.numBatches, 1);
+            expectEquals (rootListener.numPropertyChanges, 3);
+            expectEquals (rootListener.numChildrenAdded, 1);
+            expectEquals (rootListener.numChildrenRemoved, 1);
+            expectEquals (childListener.numBatches, 1);
+            expectEquals (childListener.numPropertyChanges, 2);
+
+            // Undoing a transaction inside a batch should deliver it all at once
+            UndoManager undoManager;
+            undoManager.beginNewTransaction();
+
+            for (int i = 0; i < 10; ++i)
+                root.appendChild (ValueTree ("undoable"), &undoManager);
+
+            child.setProperty ("a", 1, &undoManager);
+            child.setProperty ("a", 2, &undoManager);
+
+            rootListener = {};
+
+            {
+                ValueTree::ScopedNotificationBatch batch (root);
+                undoManager.undo();
+            }
+
+            expectEquals (rootListener.numBatches, 1);
+            expectEquals (rootListener.numChildrenRemoved, 10);
+            expectEquals (rootListener.numPropertyChanges, 1);
+            expect (child["a"] == var (-1));
+            expectEquals (root.getNumChildren(), 1);
+
+            // A listener that's excluded from every change shouldn't get a callback
+            childListener = {};
+
+            {
+                ValueTree::ScopedNotificationBatch batch (root);
+                child.setPropertyExcludingListener (&childListener, "a", 5, nullptr);
+            }
+
+            expectEquals (childListener.numBatches, 0);
+
+            root.removeListener (&rootListener);
+            childRef.removeListener (&childListener);
+        }
+
+        {
+            beginTest ("Batched notifications with a ValueTreeSynchroniser");
+
+            struct Synchroniser  : public ValueTreeSynchroniser
+            {
+                Synchroniser (const ValueTree& source, ValueTree& dest)
+                    : ValueTreeSynchroniser (source), target (dest) {}
+
+                void stateChanged (const void* data, size_t size) override
+                {
+                    ++numMessages;
+                    ValueTreeSynchroniser::applyChange (target, data, size, nullptr);
+                }
+
+                ValueTree& target;
+                int numMessages = 0;
+            };
+
+            auto r = getRandom();
+            auto source = createRandomTree (nullptr, 0, r);
+            source.appendChild (ValueTree ("child"), nullptr);
+            ValueTree target;
+
+            Synchroniser sync (source, target);
+            sync.sendFullSyncCallback();
+            expect (source.isEquivalentTo (target));
+
+            sync.numMessages = 0;
+
+            {
+                ValueTree::ScopedNotificationBatch batch (source);
+
+                for (int i = 0; i < 50; ++i)
+                    source.getChild (0).setProperty ("value", i, nullptr);
+            }
+
+            expectEquals (sync.numMessages, 1);
+            expect (source.isEquivalentTo (target));
+
+            {
+                ValueTree::ScopedNotificationBatch batch (source);
+
+                for (int i = 0; i < 5; ++i)
+                    source.addChild (createRandomTree (nullptr, 2, r), 0, nullptr);
+
+                source.removeChild (2, nullptr);
+                source.getChild (0).setProperty ("value", 123, nullptr);
+            }
+
+            expect (source.isEquivalentTo (target));
+        }
+
+        {
+            beginTest ("ValueTreeSynchroniser coalescing");
+
+            struct Synchroniser  : public ValueTreeSynchroniser
+            {
+                Synchroniser (const ValueTree& source, ValueTree& dest)
+                    : ValueTreeSynchroniser (source), target (dest) {}
+
+                void stateChanged (const void* data, size_t size) override
+                {
+                    ++numMessages;
+                    expect (ValueTreeSynchroniser::applyChange (target, data, size, nullptr));
+                }
+
+                void expect (bool b)    { allApplied = allApplied && b; }
+
+                ValueTree& target;
+                int numMessages = 0;
+                bool allApplied = true;
+            };
+
+            auto r = getRandom();
+            auto source = createRandomTree (nullptr, 0, r);
+
+            for (int i = 0; i < 4; ++i)
+                source.appendChild (createRandomTree (nullptr, 1, r), nullptr);
+
+            ValueTree target;
+            Synchroniser sync (source, target);
+            sync.sendFullSyncCallback();
+            sync.setCoalescingInterval (60000);
+            sync.numMessages = 0;
+
+            for (int i = 0; i < 100; ++i)
+            {
+                source.getChild (i % 4).setProperty ("gain", i, nullptr);
+                source.getChild (i % 3).setProperty (createRandomIdentifier (r), r.nextDouble(), nullptr);
+            }
+
+            source.getChild (1).removeProperty ("gain", nullptr);
+            source.setProperty ("name", "root", nullptr);
+
+            expectEquals (sync.numMessages, 0);
+            expect (! source.isEquivalentTo (target));
+
+            // Structural changes should send the pending properties first
+            source.getChild (2).setProperty ("gain", -1, nullptr);
+            source.removeChild (0, nullptr);
+            expectEquals (sync.numMessages, 2);
+            expect (source.isEquivalentTo (target));
+
+            source.getChild (0).setProperty ("gain", 10, nullptr);
+            source.getChild (0).setProperty ("gain", 11, nullptr);
+            source.getChild (0).removeProperty ("gain", nullptr);
+            source.getChild (0).setProperty ("gain", 12, nullptr);
+            sync.flushPendingChanges();
+            sync.flushPendingChanges();
+            expectEquals (sync.numMessages, 3);
+            expect (source.isEquivalentTo (target));
+
+            sync.setCoalescingInterval (0);
+            source.setProperty ("name", "immediate", nullptr);
+            expectEquals (sync.numMessages, 4);
+            expect (source.isEquivalentTo (target));
+            expect (sync.allApplied);
+        }
+
         {
             beginTest ("Float formatting");
 
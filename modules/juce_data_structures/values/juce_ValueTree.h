@@ -451,21 +451,63 @@ public:
 
         It's much faster to load/save your tree in binary form than as XML, but
         obviously isn't human-readable.
+
+        @see writeToCompactStream
     */
     void writeToStream (OutputStream& output) const;
 
-    /** Reloads a tree from a stream that was written with writeToStream(). */
+    /** Stores this tree (and all its children) in a compact, versioned binary format.
+
+        Rather than storing the type and property names in full with every node, this
+        writes each distinct name once into a table, and refers to it by index, with
+        all the counts and sizes stored as variable-length integers. For large trees
+        made of lots of similar nodes, this is much smaller and quicker to load than
+        the format that writeToStream() uses.
+
+        The children of each node are also prefixed with their size, which lets
+        readFromMemoryMappedFile() skip over them until they're actually needed.
+
+        The data can be read back with any of the readFrom... methods, which all still
+        accept the format written by writeToStream() too.
+    */
+    void writeToCompactStream (OutputStream& output) const;
+
+    /** Reloads a tree from a stream that was written with writeToStream() or
+        writeToCompactStream().
+    */
     static ValueTree readFromStream (InputStream& input);
 
-    /** Reloads a tree from a data block that was written with writeToStream(). */
+    /** Reloads a tree from a data block that was written with writeToStream() or
+        writeToCompactStream().
+    */
     static ValueTree readFromData (const void* data, size_t numBytes);
 
-    /** Reloads a tree from a data block that was written with writeToStream() and
-        then zipped using GZIPCompressorOutputStream.
+    /** Reloads a tree from a data block that was written with writeToStream() or
+        writeToCompactStream() and then zipped using GZIPCompressorOutputStream.
     */
     static ValueTree readFromGZIPData (const void* data, size_t numBytes);
 
+    /** Reloads a tree from a file that was written with writeToStream() or
+        writeToCompactStream().
+
+        If the file is in the compact format and decodeChildrenLazily is true, only the
+        root node is decoded straight away, and the children of each node are decoded
+        from the memory-mapped file the first time that they're accessed. The file stays
+        mapped until every node that still refers to it has either been decoded or
+        deleted, so it mustn't be modified in the meantime.
+
+        A lazily loaded tree can be read from several threads at once, just like any
+        other ValueTree. The decoding is done under a lock that's shared by all the lazily
+        loaded trees, which is only taken while a node still has children waiting to be
+        decoded.
+
+        Returns an invalid tree if the file can't be read.
+    */
+    static ValueTree readFromMemoryMappedFile (const File& file, bool decodeChildrenLazily = true);
+
     //==============================================================================
+    struct BatchedChange;
+
     /** Listener class for events that happen to a ValueTree.
 
         To get events from a ValueTree, make your class implement this interface, and use
@@ -529,6 +571,24 @@ public:
             will be made.
         */
         virtual void valueTreeRedirected (ValueTree& treeWhichHasBeenChanged);
+
+        /** This method is called when a ScopedNotificationBatch finishes, with all the
+            changes that it held back which this listener would have been told about.
+
+            Each property that changed is only listed once, however many times it was set,
+            but child additions, removals and moves are all listed in the order in which
+            they happened, as each one's indexes depend on the ones before it. By the time
+            this is called, the tree is in its final state, so it may no longer match what
+            any particular change describes (e.g. a child that was added may since have been
+            removed again).
+
+            The default implementation just passes each change to the matching callback
+            above, so you only need to override this if you'd rather deal with the changes
+            all at once, e.g. to trigger a single repaint.
+
+            @see ScopedNotificationBatch
+        */
+        virtual void valueTreeChangesBatched (const Array<BatchedChange>& changes);
     };
 
     /** Adds a listener to receive callbacks when this tree is changed in some way.
@@ -562,6 +622,9 @@ public:
     */
     void sendPropertyChangeMessage (const Identifier& property);
 
+    //==============================================================================
+    class ScopedNotificationBatch;
+
     //==============================================================================
     /** This method uses a comparator object to sort the tree's children into order.
 
@@ -611,6 +674,8 @@ private:
     //==============================================================================
     JUCE_PUBLIC_IN_DLL_BUILD (class SharedObject)
     friend class SharedObject;
+    struct CompactFormat;
+    struct PendingNotifications;
 
     ReferenceCountedObjectPtr<SharedObject> object;
     ListenerList<Listener> listeners;
@@ -637,4 +702,73 @@ private:
     explicit ValueTree (SharedObject&) noexcept;
 };
 
+//==============================================================================
+/**
+    Holds back the change callbacks for a tree while a group of edits is made to it.
+
+    While one of these exists, any property changes, child additions, removals and
+    moves made to the tree or any of its sub-trees are recorded rather than being
+    sent to listeners straight away. When it's deleted, each affected listener gets a
+    single Listener::valueTreeChangesBatched() callback describing all the changes,
+    with repeated changes to the same property merged into one.
+
+    e.g.
+    @code
+    {
+        ValueTree::ScopedNotificationBatch batch (tree);
+
+        for (auto& item : itemsToPaste)
+            tree.appendChild (item, &undoManager);
+    }   // listeners are told about all the new children here
+    @endcode
+
+    Batches can be nested: a batch that's created on a tree which is already being
+    batched (or on one of its sub-trees) just adds its changes to the outer one.
+    Parent-change and redirection callbacks aren't batched.
+
+    This doesn't affect undo and redo in any way - the changes are still made (and
+    recorded by the UndoManager) immediately, it's only the callbacks that are
+    delayed. Likewise, you can wrap a call to UndoManager::undo() or redo() in a
+    batch to get a single notification for a whole transaction.
+
+    @tags{DataStructures}
+*/
+class JUCE_API  ValueTree::ScopedNotificationBatch
+{
+public:
+    /** Starts holding back the callbacks for the given tree and its sub-trees. */
+    explicit ScopedNotificationBatch (const ValueTree& treeToBatch);
+
+    /** Sends the batched callbacks, unless an outer batch is still active. */
+    ~ScopedNotificationBatch();
+
+private:
+    ValueTree tree;
+
+    JUCE_DECLARE_NON_COPYABLE (ScopedNotificationBatch)
+};
+
+//==============================================================================
+/**
+    Describes one of the changes that is passed to ValueTree::Listener::valueTreeChangesBatched().
+
+    @tags{DataStructures}
+*/
+struct JUCE_API  ValueTree::BatchedChange
+{
+    enum class Type
+    {
+        propertyChanged,    /**< A property of tree was changed (or removed). */
+        childAdded,         /**< The child was added to tree. */
+        childRemoved,       /**< The child was removed from tree, at oldIndex. */
+        childOrderChanged   /**< One of tree's children was moved from oldIndex to newIndex. */
+    };
+
+    Type type;
+    ValueTree tree;
+    ValueTree child;
+    Identifier property;
+    int oldIndex, newIndex;
+};
+
 } // namespace juce
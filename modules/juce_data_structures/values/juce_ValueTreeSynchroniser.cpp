@@ -36,7 +36,8 @@ namespace ValueTreeSynchroniserHelpers
         childAdded       = 3,
         childRemoved     = 4,
         childMoved       = 5,
-        propertyRemoved  = 6
+        propertyRemoved  = 6,
+        propertyBatch    = 7
     };
 
     static void getValueTreePath (ValueTree v, const ValueTree& topLevelTree, Array<int>& path)
@@ -58,6 +59,14 @@ namespace ValueTreeSynchroniserHelpers
         stream.writeByte ((char) type);
     }
 
+    static void writePath (MemoryOutputStream& stream, const Array<int>& path)
+    {
+        stream.writeCompressedInt (path.size());
+
+        for (int i = path.size(); --i >= 0;)
+            stream.writeCompressedInt (path.getUnchecked(i));
+    }
+
     static void writeHeader (ValueTreeSynchroniser& target, MemoryOutputStream& stream,
                              ChangeType type, ValueTree v)
     {
@@ -65,11 +74,7 @@ namespace ValueTreeSynchroniserHelpers
 
         Array<int> path;
         getValueTreePath (v, target.getRoot(), path);
-
-        stream.writeCompressedInt (path.size());
-
-        for (int i = path.size(); --i >= 0;)
-            stream.writeCompressedInt (path.getUnchecked(i));
+        writePath (stream, path);
     }
 
     static ValueTree readSubTreeLocation (MemoryInputStream& input, ValueTree v)
@@ -91,8 +96,176 @@ namespace ValueTreeSynchroniserHelpers
 
         return v;
     }
+
+    static bool applyPropertyBatch (MemoryInputStream& input, ValueTree& root, UndoManager* undoManager)
+    {
+        // Each name is sent in full the first time it appears, and after that by its index
+        Array<Identifier> names;
+
+        auto readName = [&]() -> Identifier
+        {
+            auto index = input.readCompressedInt();
+
+            if (index == names.size())
+            {
+                auto name = input.readString();
+
+                if (name.isEmpty())
+                    return {};
+
+                names.add (name);
+            }
+
+            return isPositiveAndBelow (index, names.size()) ? names.getReference (index) : Identifier();
+        };
+
+        for (int i = input.readCompressedInt(); --i >= 0;)
+        {
+            auto v = readSubTreeLocation (input, root);
+
+            for (int j = input.readCompressedInt(); --j >= 0;)
+            {
+                auto name = readName();
+                auto value = var::readFromStream (input);
+
+                if (! v.isValid() || name.isNull())
+                {
+                    jassertfalse; // Either received some corrupt data, or the trees have drifted out of sync
+                    return false;
+                }
+
+                v.setProperty (name, value, undoManager);
+            }
+
+            for (int j = input.readCompressedInt(); --j >= 0;)
+            {
+                auto name = readName();
+
+                if (! v.isValid() || name.isNull())
+                {
+                    jassertfalse; // Either received some corrupt data, or the trees have drifted out of sync
+                    return false;
+                }
+
+                v.removeProperty (name, undoManager);
+            }
+        }
+
+        return true;
+    }
 }
 
+//==============================================================================
+// The latest state of each property that has changed since the last batch was sent,
+// grouped by the path of the tree that it belongs to.
+struct ValueTreeSynchroniser::PendingChanges
+{
+    struct Node
+    {
+        Array<int> path;
+        NamedValueSet changedProperties;
+        Array<Identifier> removedProperties;
+    };
+
+    void add (const Array<int>& path, const Identifier& property, const var* newValue)
+    {
+        auto& node = getNode (path);
+
+        if (newValue != nullptr)
+        {
+            node.changedProperties.set (property, *newValue);
+            node.removedProperties.removeFirstMatchingValue (property);
+        }
+        else
+        {
+            node.changedProperties.remove (property);
+            node.removedProperties.addIfNotAlreadyThere (property);
+        }
+    }
+
+    bool isEmpty() const noexcept       { return nodes.isEmpty(); }
+
+    void clear()
+    {
+        nodes.clear();
+        nodeIndexes.clear();
+        lastNode = nullptr;
+    }
+
+    void writeTo (MemoryOutputStream& stream) const
+    {
+        ValueTreeSynchroniserHelpers::writeHeader (stream, ValueTreeSynchroniserHelpers::propertyBatch);
+        stream.writeCompressedInt (nodes.size());
+
+        Array<Identifier> names;
+
+        auto writeName = [&] (const Identifier& name)
+        {
+            auto index = names.indexOf (name);
+
+            if (index >= 0)
+            {
+                stream.writeCompressedInt (index);
+            }
+            else
+            {
+                stream.writeCompressedInt (names.size());
+                stream.writeString (name.toString());
+                names.add (name);
+            }
+        };
+
+        for (auto* node : nodes)
+        {
+            ValueTreeSynchroniserHelpers::writePath (stream, node->path);
+
+            stream.writeCompressedInt (node->changedProperties.size());
+
+            for (auto& property : node->changedProperties)
+            {
+                writeName (property.name);
+                property.value.writeToStream (stream);
+            }
+
+            stream.writeCompressedInt (node->removedProperties.size());
+
+            for (auto& name : node->removedProperties)
+                writeName (name);
+        }
+    }
+
+private:
+    OwnedArray<Node> nodes;
+    HashMap<String, int> nodeIndexes;
+    Node* lastNode = nullptr;
+
+    Node& getNode (const Array<int>& path)
+    {
+        // Changes tend to come in runs for the same tree, so it's worth checking that first
+        if (lastNode != nullptr && lastNode->path == path)
+            return *lastNode;
+
+        lastNode = findOrCreateNode (path);
+        return *lastNode;
+    }
+
+    Node* findOrCreateNode (const Array<int>& path)
+    {
+        String key;
+
+        for (auto index : path)
+            key << index << '/';
+
+        if (nodeIndexes.contains (key))
+            return nodes.getUnchecked (nodeIndexes[key]);
+
+        nodeIndexes.set (key, nodes.size());
+        auto* node = nodes.add (new Node());
+        node->path = path;
+        return node;
+    }
+};
+
 ValueTreeSynchroniser::ValueTreeSynchroniser (const ValueTree& tree)  : valueTree (tree)
 {
     valueTree.addListener (this);
@@ -105,14 +278,68 @@ ValueTreeSynchroniser::~ValueTreeSynchroniser()
 
 void ValueTreeSynchroniser::sendFullSyncCallback()
 {
+    // (this will include any property changes that were waiting to be sent)
+    if (pendingChanges != nullptr)
+        pendingChanges->clear();
+
     MemoryOutputStream m;
     writeHeader (m, ValueTreeSynchroniserHelpers::fullSync);
     valueTree.writeToStream (m);
     stateChanged (m.getData(), m.getDataSize());
 }
 
+void ValueTreeSynchroniser::setCoalescingInterval (int milliseconds)
+{
+    jassert (milliseconds >= 0);
+
+    if (milliseconds > 0)
+    {
+        if (pendingChanges == nullptr)
+            pendingChanges.reset (new PendingChanges());
+    }
+    else
+    {
+        flushPendingChanges();
+        pendingChanges.reset();
+        stopTimer();
+    }
+
+    coalescingInterval = jmax (0, milliseconds);
+}
+
+void ValueTreeSynchroniser::flushPendingChanges()
+{
+    stopTimer();
+
+    if (pendingChanges != nullptr && ! pendingChanges->isEmpty())
+    {
+        MemoryOutputStream m;
+        pendingChanges->writeTo (m);
+        pendingChanges->clear();
+        stateChanged (m.getData(), m.getDataSize());
+    }
+}
+
+void ValueTreeSynchroniser::timerCallback()
+{
+    flushPendingChanges();
+}
+
 void ValueTreeSynchroniser::valueTreePropertyChanged (ValueTree& vt, const Identifier& property)
 {
+    if (pendingChanges != nullptr)
+    {
+        Array<int> path;
+        ValueTreeSynchroniserHelpers::getValueTreePath (vt, valueTree, path);
+        pendingChanges->add (path, property, vt.getPropertyPointer (property));
+
+        // The interval starts from the first change that's held back
+        if (! isTimerRunning())
+            startTimer (coalescingInterval);
+
+        return;
+    }
+
     MemoryOutputStream m;
 
     if (auto* value = vt.getPropertyPointer (property))
@@ -132,6 +359,9 @@ void ValueTreeSynchroniser::valueTreePropertyChanged (ValueTree& vt, const Ident
 
 void ValueTreeSynchroniser::valueTreeChildAdded (ValueTree& parentTree, ValueTree& childTree)
 {
+    // The pending paths all describe the tree as it was before this change
+    flushPendingChanges();
+
     const int index = parentTree.indexOf (childTree);
     jassert (index >= 0);
 
@@ -144,6 +374,8 @@ void ValueTreeSynchroniser::valueTreeChildAdded (ValueTree& parentTree, ValueTre
 
 void ValueTreeSynchroniser::valueTreeChildRemoved (ValueTree& parentTree, ValueTree&, int oldIndex)
 {
+    flushPendingChanges();
+
     MemoryOutputStream m;
     ValueTreeSynchroniserHelpers::writeHeader (*this, m, ValueTreeSynchroniserHelpers::childRemoved, parentTree);
     m.writeCompressedInt (oldIndex);
@@ -152,6 +384,8 @@ void ValueTreeSynchroniser::valueTreeChildRemoved (ValueTree& parentTree, ValueT
 
 void ValueTreeSynchroniser::valueTreeChildOrderChanged (ValueTree& parent, int oldIndex, int newIndex)
 {
+    flushPendingChanges();
+
     MemoryOutputStream m;
     ValueTreeSynchroniserHelpers::writeHeader (*this, m, ValueTreeSynchroniserHelpers::childMoved, parent);
     m.writeCompressedInt (oldIndex);
@@ -159,6 +393,28 @@ void ValueTreeSynchroniser::valueTreeChildOrderChanged (ValueTree& parent, int o
     stateChanged (m.getData(), m.getDataSize());
 }
 
+void ValueTreeSynchroniser::valueTreeChangesBatched (const Array<ValueTree::BatchedChange>& changes)
+{
+    // Structural changes are encoded as paths and indexes, which can only be worked out from
+    // the tree's final state by now, so if there are any, the whole tree gets resent instead.
+    for (auto& change : changes)
+    {
+        if (change.type != ValueTree::BatchedChange::Type::propertyChanged)
+        {
+            sendFullSyncCallback();
+            return;
+        }
+    }
+
+    for (auto& change : changes)
+    {
+        auto tree = change.tree;
+
+        if (tree == valueTree || tree.isAChildOf (valueTree))
+            valueTreePropertyChanged (tree, change.property);
+    }
+}
+
 bool ValueTreeSynchroniser::applyChange (ValueTree& root, const void* data, size_t dataSize, UndoManager* undoManager)
 {
     MemoryInputStream input (data, dataSize, false);
@@ -171,6 +427,9 @@ bool ValueTreeSynchroniser::applyChange (ValueTree& root, const void* data, size
         return true;
     }
 
+    if (type == ValueTreeSynchroniserHelpers::propertyBatch)
+        return ValueTreeSynchroniserHelpers::applyPropertyBatch (input, root, undoManager);
+
     ValueTree v (ValueTreeSynchroniserHelpers::readSubTreeLocation (input, root));
 
     if (! v.isValid())
@@ -41,9 +41,15 @@ namespace juce
     via a network or other means) to a remote destination, where it can be
     applied to a target tree.
 
+    By default, every change is sent as soon as it happens. If the tree is being
+    changed rapidly (e.g. by automation), you can use setCoalescingInterval() to
+    make it collect property changes for a while and send only the latest value of
+    each one, all together in a single message.
+
     @tags{DataStructures}
 */
-class JUCE_API  ValueTreeSynchroniser  : private ValueTree::Listener
+class JUCE_API  ValueTreeSynchroniser  : private ValueTree::Listener,
+                                         private Timer
 {
 public:
     /** Creates a ValueTreeSynchroniser that watches the given tree.
@@ -71,6 +77,36 @@ public:
     */
     void sendFullSyncCallback();
 
+    /** Makes the synchroniser hold back property changes and send them in batches.
+
+        When this is greater than zero, changes to property values aren't sent straight
+        away. Instead, the latest value of each property that changes is kept until the
+        interval has elapsed, and then all of them are sent in a single stateChanged()
+        message. So however many times a property changes during the interval, it only
+        gets sent once.
+
+        Any pending changes are sent before a child is added, removed or moved, so the
+        receiving tree always sees the changes in an order that makes sense.
+
+        A value of zero (the default) sends every change immediately, in the same format
+        as earlier versions of this class. The batched messages can only be applied by
+        versions of applyChange() that support them.
+
+        This uses a Timer, so must be called on the message thread, and the tree should
+        only be changed on the message thread while it's enabled.
+
+        @see flushPendingChanges
+    */
+    void setCoalescingInterval (int milliseconds);
+
+    /** Returns the interval that was set with setCoalescingInterval(). */
+    int getCoalescingInterval() const noexcept      { return coalescingInterval; }
+
+    /** Immediately sends any property changes that are being held back because of
+        setCoalescingInterval().
+    */
+    void flushPendingChanges();
+
     /** Applies an encoded change to the given destination tree.
 
         When you implement a receiver for changes that were sent by the stateChanged()
@@ -85,12 +121,18 @@ public:
     const ValueTree& getRoot() noexcept       { return valueTree; }
 
 private:
+    struct PendingChanges;
+
     ValueTree valueTree;
+    std::unique_ptr<PendingChanges> pendingChanges;
+    int coalescingInterval = 0;
 
+    void timerCallback() override;
     void valueTreePropertyChanged (ValueTree&, const Identifier&) override;
     void valueTreeChildAdded (ValueTree&, ValueTree&) override;
     void valueTreeChildRemoved (ValueTree&, ValueTree&, int) override;
     void valueTreeChildOrderChanged (ValueTree&, int, int) override;
+    void valueTreeChangesBatched (const Array<ValueTree::BatchedChange>&) override;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ValueTreeSynchroniser)
 };
@@ -0,0 +1,270 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+/* Checks that a synthesiser voice which renders its whole group at once, with the
+   voices packed into the lanes of a SIMDRegister, sounds exactly like the same
+   voices rendered one at a time.
+*/
+struct SIMDSynthesiserVoiceTest  : public UnitTest
+{
+    SIMDSynthesiserVoiceTest()
+        : UnitTest ("SIMD synthesiser voices", UnitTestCategories::dsp)
+    {}
+
+    struct SineSound  : public SynthesiserSound
+    {
+        bool appliesToNote (int) override       { return true; }
+        bool appliesToChannel (int) override    { return true; }
+    };
+
+    // A sine oscillator that rotates a phasor rather than calling std::sin, so
+    // that it only needs the arithmetic a SIMDRegister can do
+    struct SineVoice  : public SynthesiserVoice
+    {
+        bool canPlaySound (SynthesiserSound*) override      { return true; }
+        void pitchWheelMoved (int) override                 {}
+        void controllerMoved (int, int) override            {}
+
+        void startNote (int note, float velocity, SynthesiserSound*, int) override
+        {
+            auto angle = MathConstants<double>::twoPi * MidiMessage::getMidiNoteInHertz (note) / getSampleRate();
+
+            cosDelta = (float) std::cos (angle);
+            sinDelta = (float) std::sin (angle);
+            re = 1.0f;
+            im = 0.0f;
+            gain = 0.1f * velocity;
+            decay = 1.0f;
+        }
+
+        void stopNote (float, bool allowTailOff) override
+        {
+            if (allowTailOff)
+            {
+                decay = tailOffDecay;
+            }
+            else
+            {
+                gain = 0.0f;
+                clearCurrentNote();
+            }
+        }
+
+        void renderNextBlock (AudioBuffer<float>& buffer, int startSample, int numSamples) override
+        {
+            if (! isVoiceActive())
+                return;
+
+            for (int i = startSample; i < startSample + numSamples; ++i)
+            {
+                auto sample = im * gain;
+
+                for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                    buffer.addSample (channel, i, sample);
+
+                auto newRe = re * cosDelta - im * sinDelta;
+                im = re * sinDelta + im * cosDelta;
+                re = newRe;
+                gain *= decay;
+
+                if (decay < 1.0f && gain <= silenceThreshold)
+                {
+                    gain = 0.0f;
+                    clearCurrentNote();
+                    break;
+                }
+            }
+        }
+
+        static constexpr float tailOffDecay = 0.999f, silenceThreshold = 0.005f;
+
+        float re = 0, im = 0, cosDelta = 1.0f, sinDelta = 0, gain = 0, decay = 1.0f;
+    };
+
+    // Renders its group in batches of as many voices as a SIMDRegister<float> has lanes
+    struct SIMDSineVoice  : public SineVoice
+    {
+        SIMDSineVoice (int& numBatches)  : batchCount (numBatches) {}
+
+        void renderNextBlockForGroup (SynthesiserVoice* const* voicesToRender, int numVoices,
+                                      AudioBuffer<float>& buffer, int startSample, int numSamples) override
+        {
+            for (int i = 0; i < numVoices; i += (int) Lanes::size())
+                renderBatch (voicesToRender + i, jmin ((int) Lanes::size(), numVoices - i), buffer, startSample, numSamples);
+        }
+
+        using Lanes = SIMDRegister<float>;
+
+        void renderBatch (SynthesiserVoice* const* voicesToRender, int numVoices,
+                          AudioBuffer<float>& buffer, int startSample, int numSamples)
+        {
+            ++batchCount;
+
+            // unused lanes keep a gain of zero, so they don't add anything to the output
+            alignas (Lanes::SIMDRegisterSize) float res[Lanes::size()] = {}, ims[Lanes::size()] = {},
+                                                    coss[Lanes::size()] = {}, sins[Lanes::size()] = {},
+                                                    gains[Lanes::size()] = {}, decays[Lanes::size()] = {};
+
+            // the synthesiser only groups together voices of the same class
+            for (int i = 0; i < numVoices; ++i)
+            {
+                auto& voice = *static_cast<SIMDSineVoice*> (voicesToRender[i]);
+
+                res[i]    = voice.re;
+                ims[i]    = voice.im;
+                coss[i]   = voice.cosDelta;
+                sins[i]   = voice.sinDelta;
+                gains[i]  = voice.gain;
+                decays[i] = voice.decay;
+            }
+
+            auto reLanes = Lanes::fromRawArray (res), imLanes = Lanes::fromRawArray (ims);
+            auto cosDeltaLanes = Lanes::fromRawArray (coss), sinDeltaLanes = Lanes::fromRawArray (sins);
+            auto gainLanes = Lanes::fromRawArray (gains), decayLanes = Lanes::fromRawArray (decays);
+
+            auto one = Lanes::expand (1.0f), threshold = Lanes::expand (silenceThreshold);
+
+            for (int i = startSample; i < startSample + numSamples; ++i)
+            {
+                auto sample = (imLanes * gainLanes).sum();
+
+                for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                    buffer.addSample (channel, i, sample);
+
+                auto newRe = reLanes * cosDeltaLanes - imLanes * sinDeltaLanes;
+                imLanes = reLanes * sinDeltaLanes + imLanes * cosDeltaLanes;
+                reLanes = newRe;
+                gainLanes *= decayLanes;
+
+                // silence the voices that have finished tailing off, which SineVoice does by stopping
+                auto finished = Lanes::lessThan (decayLanes, one) & Lanes::lessThanOrEqual (gainLanes, threshold);
+                gainLanes &= ~finished;
+            }
+
+            reLanes.copyToRawArray (res);
+            imLanes.copyToRawArray (ims);
+            gainLanes.copyToRawArray (gains);
+
+            for (int i = 0; i < numVoices; ++i)
+            {
+                auto& voice = *static_cast<SIMDSineVoice*> (voicesToRender[i]);
+
+                voice.re   = res[i];
+                voice.im   = ims[i];
+                voice.gain = gains[i];
+
+                if (gains[i] == 0.0f)
+                    voice.clearCurrentNote();
+            }
+        }
+
+        int& batchCount;
+    };
+
+    static int countActiveVoices (Synthesiser& synth)
+    {
+        int numActive = 0;
+
+        for (int i = 0; i < synth.getNumVoices(); ++i)
+            if (synth.getVoice (i)->isVoiceActive())
+                ++numActive;
+
+        return numActive;
+    }
+
+    void runTest() override
+    {
+        beginTest ("Rendering voices in SIMD lanes matches rendering them one at a time");
+        {
+            int numBatches = 0;
+            Synthesiser synth, simdSynth;
+
+            for (auto* s : { &synth, &simdSynth })
+            {
+                s->addSound (new SineSound());
+                s->setCurrentPlaybackSampleRate (48000.0);
+            }
+
+            for (int i = 0; i < 16; ++i)
+            {
+                synth.addVoice (new SineVoice());
+                simdSynth.addVoice (new SIMDSineVoice (numBatches));
+            }
+
+            simdSynth.setVoiceGroupRenderingEnabled (true);
+
+            // more notes than lanes, some of which tail off during the render
+            MidiBuffer midi;
+
+            for (int i = 0; i < 11; ++i)
+                midi.addEvent (MidiMessage::noteOn (1, 40 + i * 4, 0.5f + (float) i * 0.05f), i * 37);
+
+            for (int i = 0; i < 11; i += 3)
+                midi.addEvent (MidiMessage::noteOff (1, 40 + i * 4), 1000 + i * 150);
+
+            const int numSamples = 8192, blockSize = 256;
+            AudioBuffer<float> expected (2, numSamples), actual (2, numSamples);
+            int maxActive = 0;
+
+            for (int pos = 0; pos < numSamples; pos += blockSize)
+            {
+                MidiBuffer blockMidi;
+                blockMidi.addEvents (midi, pos, blockSize, 0);
+
+                expected.clear (pos, blockSize);
+                actual.clear (pos, blockSize);
+                synth.renderNextBlock (expected, blockMidi, pos, blockSize);
+                simdSynth.renderNextBlock (actual, blockMidi, pos, blockSize);
+
+                expectEquals (countActiveVoices (simdSynth), countActiveVoices (synth));
+                maxActive = jmax (maxActive, countActiveVoices (synth));
+            }
+
+            expect (numBatches > 0);
+            expectEquals (maxActive, 11);
+            expectEquals (countActiveVoices (synth), 7);
+
+            float maxError = 0.0f;
+
+            for (int channel = 0; channel < 2; ++channel)
+                for (int i = 0; i < numSamples; ++i)
+                    maxError = jmax (maxError, std::abs (actual.getSample (channel, i) - expected.getSample (channel, i)));
+
+            expect (expected.getMagnitude (0, numSamples) > 0.1f);
+            expectLessThan (maxError, 1.0e-4f);
+        }
+    }
+};
+
+static SIMDSynthesiserVoiceTest simdSynthesiserVoiceTest;
+
+} // namespace dsp
+} // namespace juce
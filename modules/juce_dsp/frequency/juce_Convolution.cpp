@@ -67,6 +67,8 @@ struct ConvolutionEngine
 
         double sampleRate = 0;
         size_t maximumBufferSize = 0;
+        size_t headSize = 0;
+        std::atomic<int>* numTailOverruns = nullptr;
     };
 
     //==============================================================================
@@ -81,17 +83,57 @@ struct ConvolutionEngine
 
         currentSegment = 0;
         inputDataPos = 0;
+
+        if (tail != nullptr)
+            tail->reset();
     }
 
-    /** Initalize all the states and objects to perform the convolution. */
+    /** Initalize all the states and objects to perform the convolution.
+
+        If the information has a head size set and the impulse response is long
+        enough, only its head is convolved with partitions of the host block size,
+        and the rest of it is handed to a TailStage using much larger partitions.
+    */
     void initializeConvolutionEngine (ProcessingInformation& info, int channel)
     {
-        blockSize = (size_t) nextPowerOfTwo ((int) info.maximumBufferSize);
+        auto* channelData = info.buffer->getReadPointer (channel);
+        auto impulseSize = (size_t) info.finalSize;
+
+        auto headBlockSize = (size_t) nextPowerOfTwo ((int) info.maximumBufferSize);
+        auto tailBlockSize = (size_t) nextPowerOfTwo ((int) info.headSize) / 2;
+
+        if (info.headSize > 0 && tailBlockSize >= 2 * headBlockSize && impulseSize > 2 * tailBlockSize)
+        {
+            // the tail's output is delayed by two of its blocks, so that is what the head must cover
+            auto headSize = 2 * tailBlockSize;
+
+            initializeUniformPartitions (channelData, headSize, info.maximumBufferSize);
+
+            if (tail == nullptr || tail->blockSize != tailBlockSize)
+                tail.reset (new TailStage (tailBlockSize));
+
+            tail->initialise (channelData + headSize, impulseSize - headSize, info.sampleRate, info.numTailOverruns);
+        }
+        else
+        {
+            tail.reset();
+            initializeUniformPartitions (channelData, impulseSize, info.maximumBufferSize);
+        }
+
+        reset();
+
+        isReady = true;
+    }
+
+    /** Splits an impulse response into partitions of the same size, and performs their FFTs. */
+    void initializeUniformPartitions (const float* channelData, size_t impulseSize, size_t maximumBufferSize)
+    {
+        blockSize = (size_t) nextPowerOfTwo ((int) maximumBufferSize);
 
         FFTSize = blockSize > 128 ? 2 * blockSize
                                   : 4 * blockSize;
 
-        numSegments = ((size_t) info.finalSize) / (FFTSize - blockSize) + 1u;
+        numSegments = impulseSize / (FFTSize - blockSize) + 1u;
 
         numInputSegments = (blockSize > 128 ? numSegments : 3 * numSegments);
 
@@ -122,8 +164,6 @@ struct ConvolutionEngine
 
         std::unique_ptr<FFT> FFTTempObject (new FFT (roundToInt (std::log2 (FFTSize))));
 
-        auto* channelData = info.buffer->getWritePointer (channel);
-
         for (size_t n = 0; n < numSegments; ++n)
         {
             buffersImpulseSegments.getReference (static_cast<int> (n)).clear();
@@ -134,50 +174,44 @@ struct ConvolutionEngine
                 impulseResponse[0] = 1.0f;
 
             for (size_t i = 0; i < FFTSize - blockSize; ++i)
-                if (i + n * (FFTSize - blockSize) < (size_t) info.finalSize)
+                if (i + n * (FFTSize - blockSize) < impulseSize)
                     impulseResponse[i] = channelData[i + n * (FFTSize - blockSize)];
 
             FFTTempObject->performRealOnlyForwardTransform (impulseResponse);
             prepareForConvolution (impulseResponse);
         }
-
-        reset();
-
-        isReady = true;
     }
 
-    /** Copy the states of another engine. */
-    void copyStateFromOtherEngine (const ConvolutionEngine& other)
+    /** Performs the convolution, running the tail stage alongside the head partitions if there is one. */
+    void processSamples (const float* input, float* output, size_t numSamples)
     {
-        if (FFTSize != other.FFTSize)
+        if (! isReady)
+            return;
+
+        if (tail == nullptr)
         {
-            FFTobject.reset (new FFT (roundToInt (std::log2 (other.FFTSize))));
-            FFTSize = other.FFTSize;
+            processUniformPartitions (input, output, numSamples);
+            return;
         }
 
-        currentSegment      = other.currentSegment;
-        numInputSegments    = other.numInputSegments;
-        numSegments         = other.numSegments;
-        blockSize           = other.blockSize;
-        inputDataPos        = other.inputDataPos;
+        size_t numSamplesProcessed = 0;
 
-        bufferInput         = other.bufferInput;
-        bufferTempOutput    = other.bufferTempOutput;
-        bufferOutput        = other.bufferOutput;
+        while (numSamplesProcessed < numSamples)
+        {
+            auto numSamplesToProcess = jmin (numSamples - numSamplesProcessed, tail->getNumSamplesUntilNextBlock());
 
-        buffersInputSegments    = other.buffersInputSegments;
-        buffersImpulseSegments  = other.buffersImpulseSegments;
-        bufferOverlap           = other.bufferOverlap;
+            // the tail must read its input before the head overwrites it when processing in place
+            tail->pushInput (input + numSamplesProcessed, numSamplesToProcess);
+            processUniformPartitions (input + numSamplesProcessed, output + numSamplesProcessed, numSamplesToProcess);
+            tail->addOutput (output + numSamplesProcessed, numSamplesToProcess);
 
-        isReady = true;
+            numSamplesProcessed += numSamplesToProcess;
+        }
     }
 
     /** Performs the uniform partitioned convolution using FFT. */
-    void processSamples (const float* input, float* output, size_t numSamples)
+    void processUniformPartitions (const float* input, float* output, size_t numSamples)
     {
-        if (! isReady)
-            return;
-
         // Overlap-add, zero latency convolution algorithm with uniform partitioning
         size_t numSamplesProcessed = 0;
 
@@ -312,6 +346,238 @@ struct ConvolutionEngine
         }
     }
 
+    //==============================================================================
+    /** The tail of a non-uniformly partitioned impulse response.
+
+        The tail is convolved by a second uniformly partitioned engine, with
+        partitions much larger than the host block size, so it only needs a few of
+        them however long the impulse response is. The audio thread only collects
+        one block of input at a time; the FFTs and the complex multiplications for
+        that block run on a background thread during the following block, which is
+        why the tail starts two blocks into the impulse response.
+
+        The blocks are passed to and from the background thread through two small
+        lock-free fifos, so the audio thread never waits for it. If a result isn't
+        ready by the time it is due, the tail is left out of that block and the
+        overrun is counted instead.
+    */
+    struct TailStage  : private Thread
+    {
+        TailStage (size_t blockSizeToUse)
+            : Thread ("Convolution tail"), blockSize (blockSizeToUse)
+        {
+            engine.reset (new ConvolutionEngine());
+
+            bufferInput.setSize         (1, static_cast<int> (blockSize));
+            bufferCurrentOutput.setSize (1, static_cast<int> (blockSize));
+            bufferWorkerInputs.setSize  (numSlots, static_cast<int> (blockSize));
+            bufferWorkerOutputs.setSize (numSlots, static_cast<int> (blockSize));
+        }
+
+        ~TailStage() override
+        {
+            stopThread (10000);
+        }
+
+        /** Sets up the partitions of the tail. This stops the background thread while
+            it runs, so it mustn't be called on the audio thread.
+        */
+        void initialise (const float* impulse, size_t impulseSize, double sampleRate, std::atomic<int>* overrunCounter)
+        {
+            stopThread (-1);
+
+            engine->initializeUniformPartitions (impulse, impulseSize, blockSize);
+            engine->reset();
+            engine->isReady = true;
+
+            inputFifo.reset();
+            outputFifo.reset();
+            nextBlockIndex = 0;
+            firstValidBlockIndex = 0;
+            firstBlockIndexAfterReset = 0;
+            numOverruns = overrunCounter;
+            lastResetSeenByWorker = 0;
+            nextBlockIndexForWorker = 0;
+
+            reset();
+
+            // polling several times per block leaves the worker most of a block to do its work
+            pollIntervalMs = sampleRate > 0 ? jlimit (1, 10, (int) ((double) blockSize * 1000.0 / (8.0 * sampleRate)))
+                                            : 1;
+
+            startThread (8);
+        }
+
+        /** Clears the tail's state without waiting for the background thread, which
+            clears its own state before it processes the next block.
+        */
+        void reset() noexcept
+        {
+            bufferInput.clear();
+            bufferCurrentOutput.clear();
+
+            position = 0;
+
+            firstValidBlockIndex = nextBlockIndex;
+            firstBlockIndexAfterReset = nextBlockIndex;
+        }
+
+        size_t getNumSamplesUntilNextBlock() const noexcept
+        {
+            return blockSize - position;
+        }
+
+        /** Collects input samples, which must not cross the end of the current block. */
+        void pushInput (const float* input, size_t numSamples) noexcept
+        {
+            jassert (numSamples <= getNumSamplesUntilNextBlock());
+
+            FloatVectorOperations::copy (bufferInput.getWritePointer (0) + position, input, static_cast<int> (numSamples));
+        }
+
+        /** Adds the tail's output to the given samples, and hands the block over to the worker once it is full. */
+        void addOutput (float* output, size_t numSamples) noexcept
+        {
+            jassert (numSamples <= getNumSamplesUntilNextBlock());
+
+            FloatVectorOperations::add (output, bufferCurrentOutput.getReadPointer (0) + position, static_cast<int> (numSamples));
+            position += numSamples;
+
+            if (position == blockSize)
+            {
+                position = 0;
+
+                collectOutput();
+                queueInput();
+
+                ++nextBlockIndex;
+            }
+        }
+
+        const size_t blockSize;
+
+    private:
+        //==============================================================================
+        /** Picks up the result for the previous block, throwing away any older results
+            that were too late to be used.
+        */
+        void collectOutput() noexcept
+        {
+            auto wantedBlockIndex = nextBlockIndex - 1;
+
+            for (;;)
+            {
+                int start1, size1, start2, size2;
+                outputFifo.prepareToRead (1, start1, size1, start2, size2);
+
+                if (size1 == 0)
+                    break;
+
+                auto blockIndex = outputBlockIndices[start1];
+
+                if (blockIndex == wantedBlockIndex && blockIndex >= firstValidBlockIndex)
+                {
+                    bufferCurrentOutput.copyFrom (0, 0, bufferWorkerOutputs, start1, 0, static_cast<int> (blockSize));
+                    outputFifo.finishedRead (1);
+                    return;
+                }
+
+                outputFifo.finishedRead (1);
+
+                if (blockIndex >= wantedBlockIndex)
+                    break;
+            }
+
+            bufferCurrentOutput.clear();
+
+            if (wantedBlockIndex >= firstValidBlockIndex && numOverruns != nullptr)
+                ++*numOverruns;
+        }
+
+        void queueInput() noexcept
+        {
+            int start1, size1, start2, size2;
+            inputFifo.prepareToWrite (1, start1, size1, start2, size2);
+
+            // If the worker is that far behind, this block is dropped, and the worker
+            // starts again from silence when it gets to the next one.
+            if (size1 == 0)
+                return;
+
+            bufferWorkerInputs.copyFrom (start1, 0, bufferInput, 0, 0, static_cast<int> (blockSize));
+            inputBlockIndices[start1] = nextBlockIndex;
+            inputFifo.finishedWrite (1);
+        }
+
+        //==============================================================================
+        void run() override
+        {
+            while (! threadShouldExit())
+                if (! processNextBlock())
+                    wait (pollIntervalMs);
+        }
+
+        bool processNextBlock()
+        {
+            if (inputFifo.getNumReady() == 0 || outputFifo.getFreeSpace() == 0)
+                return false;
+
+            int inStart, inSize, start2, size2;
+            inputFifo.prepareToRead (1, inStart, inSize, start2, size2);
+
+            auto blockIndex = inputBlockIndices[inStart];
+            auto resetIndex = firstBlockIndexAfterReset.load();
+
+            if (blockIndex < resetIndex)
+            {
+                inputFifo.finishedRead (1);
+                return true;
+            }
+
+            // After a reset, or if a block was dropped, the old input no longer lines up with the new
+            if (blockIndex != nextBlockIndexForWorker || resetIndex != lastResetSeenByWorker)
+                engine->reset();
+
+            lastResetSeenByWorker = resetIndex;
+            nextBlockIndexForWorker = blockIndex + 1;
+
+            int outStart, outSize;
+            outputFifo.prepareToWrite (1, outStart, outSize, start2, size2);
+
+            engine->processSamples (bufferWorkerInputs.getReadPointer (inStart),
+                                    bufferWorkerOutputs.getWritePointer (outStart),
+                                    blockSize);
+
+            outputBlockIndices[outStart] = blockIndex;
+
+            inputFifo.finishedRead (1);
+            outputFifo.finishedWrite (1);
+            return true;
+        }
+
+        //==============================================================================
+        static constexpr int numSlots = 4;
+
+        std::unique_ptr<ConvolutionEngine> engine;
+
+        AudioBuffer<float> bufferInput, bufferCurrentOutput, bufferWorkerInputs, bufferWorkerOutputs;
+        AbstractFifo inputFifo { numSlots }, outputFifo { numSlots };
+        int64 inputBlockIndices[numSlots] = {}, outputBlockIndices[numSlots] = {};
+
+        // used by the audio thread
+        size_t position = 0;
+        int64 nextBlockIndex = 0, firstValidBlockIndex = 0;
+
+        // used by the background thread
+        int64 nextBlockIndexForWorker = 0, lastResetSeenByWorker = 0;
+        int pollIntervalMs = 1;
+
+        std::atomic<int64> firstBlockIndexAfterReset { 0 };
+        std::atomic<int>* numOverruns = nullptr;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TailStage)
+    };
+
     //==============================================================================
     std::unique_ptr<FFT> FFTobject;
 
@@ -321,6 +587,8 @@ struct ConvolutionEngine
     AudioBuffer<float> bufferInput, bufferOutput, bufferTempOutput, bufferOverlap;
     Array<AudioBuffer<float>> buffersInputSegments, buffersImpulseSegments;
 
+    std::unique_ptr<TailStage> tail;
+
     bool isReady = false;
 
     //==============================================================================
@@ -353,8 +621,11 @@ struct Convolution::Pimpl  : private Thread
     using SourceType = ConvolutionEngine::ProcessingInformation::SourceType;
 
     //==============================================================================
-    Pimpl()  : Thread ("Convolution"), abstractFifo (fifoSize)
+    Pimpl (size_t headSize = 0)  : Thread ("Convolution"), abstractFifo (fifoSize)
     {
+        currentInfo.headSize = headSize;
+        currentInfo.numTailOverruns = &numTailOverruns;
+
         abstractFifo.reset();
         fifoRequestsType.resize (fifoSize);
         fifoRequestsParameter.resize (fifoSize);
@@ -762,8 +1033,10 @@ struct Convolution::Pimpl  : private Thread
             {
                 mustInterpolate = false;
 
+                // The new engines take over by swapping them with the old ones, rather than
+                // copying their state, so nothing gets allocated or started on this thread.
                 for (auto channel = 0; channel < 2; ++channel)
-                    engines[channel]->copyStateFromOtherEngine (*engines[channel + 2]);
+                    engines.swap (channel, channel + 2);
             }
         }
 
@@ -773,6 +1046,7 @@ struct Convolution::Pimpl  : private Thread
 
     //==============================================================================
     const int64 maximumTimeInSamples = 10 * 96000;
+    std::atomic<int> numTailOverruns { 0 };         // the number of blocks in which a tail stage's result came too late
 
 private:
     //==============================================================================
@@ -1062,6 +1336,14 @@ Convolution::Convolution()
     pimpl->addToFifo (Convolution::Pimpl::ChangeRequest::changeEngine, juce::var (0));
 }
 
+Convolution::Convolution (const NonUniform& requiredHeadSize)
+{
+    jassert (requiredHeadSize.headSizeInSamples >= 0);
+
+    pimpl.reset (new Pimpl ((size_t) jmax (0, requiredHeadSize.headSizeInSamples)));
+    pimpl->addToFifo (Convolution::Pimpl::ChangeRequest::changeEngine, juce::var (0));
+}
+
 Convolution::~Convolution()
 {
 }
@@ -1177,6 +1459,9 @@ void Convolution::prepare (const ProcessSpec& spec)
     pimpl->addToFifo (types, parameters, 2);
     pimpl->initProcessing (static_cast<int> (spec.maximumBlockSize));
 
+    // get the engines built now rather than on the first call to process()
+    pimpl->processFifo();
+
     for (size_t channel = 0; channel < spec.numChannels; ++channel)
     {
         volumeDry[channel].reset (spec.sampleRate, 0.05);
@@ -1191,6 +1476,11 @@ void Convolution::prepare (const ProcessSpec& spec)
     isActive = true;
 }
 
+int Convolution::getNumTailOverruns() const noexcept
+{
+    return pimpl->numTailOverruns.load();
+}
+
 void Convolution::reset() noexcept
 {
     dryBuffer.clear();
@@ -30,8 +30,13 @@ namespace dsp
 {
 
 /**
-    Performs stereo uniform-partitioned convolution of an input signal with an
-    impulse response in the frequency domain, using the juce FFT class.
+    Performs stereo partitioned convolution of an input signal with an impulse
+    response in the frequency domain, using the juce FFT class.
+
+    By default the impulse response is split into uniform partitions sized from
+    the host block size. For long impulse responses, a non-uniform mode can be
+    requested, in which only the head of the response uses these small partitions
+    and its tail is processed with larger ones on a background thread.
 
     It provides some thread-safe functions to load impulse responses as well,
     from audio files or memory on the fly without any noticeable artefacts,
@@ -54,6 +59,30 @@ public:
     /** Initialises an object for performing convolution in the frequency domain. */
     Convolution();
 
+    /** Contains the size of the head of a non-uniformly partitioned impulse response. */
+    struct NonUniform
+    {
+        /** The number of samples at the start of the impulse response which are
+            convolved with partitions of the host block size.
+
+            The rest of the impulse response is convolved with partitions of half
+            this size (rounded up to a power of two) on a background thread, at a
+            much lower cost per sample. The audio thread never waits for that
+            thread: if it falls behind, the tail is left out of the late blocks,
+            which getNumTailOverruns() counts. If the head is not at least four
+            times as long as the maximum block size, or the impulse response is
+            shorter than the head, the uniform algorithm is used instead.
+        */
+        int headSizeInSamples = 0;
+    };
+
+    /** Initialises an object for performing non-uniformly partitioned convolution
+        in the frequency domain. The latency is the same as in the uniform mode.
+
+        @see NonUniform
+    */
+    explicit Convolution (const NonUniform& requiredHeadSize);
+
     /** Destructor. */
     ~Convolution();
 
@@ -67,6 +96,16 @@ public:
     /** Resets the processing pipeline, ready to start a new stream of data. */
     void reset() noexcept;
 
+    /** Returns the number of blocks so far in which the background thread convolving
+        the tail of a non-uniformly partitioned impulse response didn't deliver its
+        result in time, so that the tail was missing from the output.
+
+        This can be called from any thread.
+
+        @see NonUniform
+    */
+    int getNumTailOverruns() const noexcept;
+
     /** Performs the filter operation on the given set of samples, with optional
         stereo processing.
     */
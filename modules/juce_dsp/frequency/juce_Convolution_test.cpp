@@ -0,0 +1,159 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+struct ConvolutionTest  : public UnitTest
+{
+    ConvolutionTest()
+        : UnitTest ("Convolution", UnitTestCategories::dsp)
+    {}
+
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 256;
+
+    static AudioBuffer<float> createImpulseResponse (Random& random, int numSamples)
+    {
+        AudioBuffer<float> ir (1, numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+            ir.setSample (0, i, (random.nextFloat() * 2.0f - 1.0f) * 0.05f * std::exp ((float) -i / 2000.0f));
+
+        return ir;
+    }
+
+    static void loadImpulseResponse (Convolution& convolution, AudioBuffer<float>& ir)
+    {
+        convolution.copyAndLoadImpulseResponseFromBuffer (ir, sampleRate, false, false, false, 0);
+    }
+
+    // Processes silence until any new impulse response has been loaded and faded in
+    static void waitForImpulseResponse (Convolution& convolution)
+    {
+        AudioBuffer<float> buffer (1, blockSize);
+
+        for (int i = 0; i < 200; ++i)
+        {
+            buffer.clear();
+            AudioBlock<float> block (buffer);
+            convolution.process (ProcessContextReplacing<float> (block));
+            Thread::sleep (1);
+        }
+
+        convolution.reset();
+    }
+
+    // Processes the input at roughly the pace of a real audio device, which is what
+    // gives the tail stages' background threads time to keep up
+    static AudioBuffer<float> process (Convolution& convolution, const AudioBuffer<float>& input)
+    {
+        AudioBuffer<float> output (input);
+
+        for (int pos = 0; pos < output.getNumSamples(); pos += blockSize)
+        {
+            auto block = AudioBlock<float> (output).getSubBlock ((size_t) pos, (size_t) jmin (blockSize, output.getNumSamples() - pos));
+            convolution.process (ProcessContextReplacing<float> (block));
+            Thread::sleep (roundToInt (1000.0 * blockSize / sampleRate));
+        }
+
+        return output;
+    }
+
+    void expectSameOutput (Convolution& reference, Convolution& convolution, const AudioBuffer<float>& input)
+    {
+        auto numOverruns = convolution.getNumTailOverruns();
+
+        auto expected = process (reference, input);
+        auto actual = process (convolution, input);
+
+        expectEquals (convolution.getNumTailOverruns(), numOverruns);
+
+        float maxError = 0.0f, maxLevel = 0.0f;
+
+        for (int i = 0; i < input.getNumSamples(); ++i)
+        {
+            maxError = jmax (maxError, std::abs (expected.getSample (0, i) - actual.getSample (0, i)));
+            maxLevel = jmax (maxLevel, std::abs (expected.getSample (0, i)));
+        }
+
+        expect (maxLevel > 0.01f);
+        expectLessThan (maxError, 1.0e-4f);
+    }
+
+    void runTest() override
+    {
+        auto random = getRandom();
+        const ProcessSpec spec { sampleRate, (uint32) blockSize, 1 };
+
+        AudioBuffer<float> input (1, 16384);
+
+        for (int i = 0; i < input.getNumSamples(); ++i)
+            input.setSample (0, i, random.nextFloat() * 2.0f - 1.0f);
+
+        beginTest ("Non-uniform partitioning matches the uniform algorithm");
+        {
+            auto ir = createImpulseResponse (random, 12000);
+
+            Convolution uniform, nonUniform (Convolution::NonUniform { 2048 });
+
+            for (auto* convolution : { &uniform, &nonUniform })
+            {
+                loadImpulseResponse (*convolution, ir);
+                convolution->prepare (spec);
+                convolution->reset();
+            }
+
+            expectSameOutput (uniform, nonUniform, input);
+
+            beginTest ("Non-uniform partitioning after loading a new impulse response");
+
+            auto newIR = createImpulseResponse (random, 9000);
+
+            for (auto* convolution : { &uniform, &nonUniform })
+            {
+                loadImpulseResponse (*convolution, newIR);
+                waitForImpulseResponse (*convolution);
+            }
+
+            Convolution reference;
+            loadImpulseResponse (reference, newIR);
+            reference.prepare (spec);
+            reference.reset();
+
+            expectSameOutput (reference, nonUniform, input);
+            reference.reset();
+            expectSameOutput (reference, uniform, input);
+        }
+    }
+};
+
+static ConvolutionTest convolutionUnitTest;
+
+} // namespace dsp
+} // namespace juce
@@ -193,6 +193,45 @@ struct FFTUnitTest  : public UnitTest
         }
     };
 
+    struct EngineConsistencyTest
+    {
+        static void run (FFTUnitTest& u)
+        {
+            Random random (378272);
+
+            // larger sizes than the other tests, checking the SIMD engine against the fallback
+            for (int order = 0; order <= 16; ++order)
+            {
+                auto n = (size_t) (1 << order);
+
+                std::unique_ptr<FFT::Instance> fallback (FFTFallback::create (order));
+                std::unique_ptr<FFT::Instance> simd (SIMDFFT::create (order));
+
+                HeapBlock<Complex<float>> input (n), expected (n), output (n);
+                fillRandom (random, input.getData(), n);
+
+                for (auto inverse : { false, true })
+                {
+                    fallback->perform (input.getData(), expected.getData(), inverse);
+                    simd->perform (input.getData(), output.getData(), inverse);
+                    u.expect (checkArrayIsSimilar (expected.getData(), output.getData(), n));
+                }
+
+                HeapBlock<float> realExpected (n << 1, true), realOutput (n << 1, true);
+                fillRandom (random, realExpected.getData(), n);
+                memcpy (realOutput.getData(), realExpected.getData(), n * sizeof (float));
+
+                fallback->performRealOnlyForwardTransform (realExpected.getData(), false);
+                simd->performRealOnlyForwardTransform (realOutput.getData(), false);
+                u.expect (checkArrayIsSimilar (realExpected.getData(), realOutput.getData(), n << 1));
+
+                fallback->performRealOnlyInverseTransform (realExpected.getData());
+                simd->performRealOnlyInverseTransform (realOutput.getData());
+                u.expect (checkArrayIsSimilar (realExpected.getData(), realOutput.getData(), n));
+            }
+        }
+    };
+
     template <class TheTest>
     void runTestForAllTypes (const char* unitTestName)
     {
@@ -206,6 +245,7 @@ struct FFTUnitTest  : public UnitTest
         runTestForAllTypes<RealTest> ("Real input numbers Test");
         runTestForAllTypes<FrequencyOnlyTest> ("Frequency only Test");
         runTestForAllTypes<ComplexTest> ("Complex input numbers Test");
+        runTestForAllTypes<EngineConsistencyTest> ("Engine consistency Test");
     }
 };
 
@@ -87,9 +87,11 @@
 
  #if JUCE_USE_SIMD
   #include "containers/juce_SIMDRegister_test.cpp"
+  #include "containers/juce_SIMDSynthesiserVoice_test.cpp"
  #endif
 
  #include "frequency/juce_FFT_test.cpp"
+ #include "frequency/juce_Convolution_test.cpp"
  #include "processors/juce_FIRFilter_test.cpp"
 #endif
 
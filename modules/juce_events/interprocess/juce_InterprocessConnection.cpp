@@ -70,10 +70,104 @@ class InterprocessConnection::SafeAction : public SafeActionImpl
     using SafeActionImpl::SafeActionImpl;
 };
 
+//==============================================================================
+/*  Keeps the blocks that incoming messages have been read into, so that they can be
+    re-used for later messages.
+
+    A MemoryBlock's allocation always matches its size, so a single block can't keep any
+    spare capacity. Instead, a few blocks of recently-seen sizes are kept, and a message
+    gets the smallest one that it fits in. Blocks that have been posted to the message
+    thread come back here once they've been delivered.
+*/
+class ReceiveBufferPoolImpl
+{
+public:
+    ReceiveBufferPoolImpl() = default;
+
+    MemoryBlock acquire (size_t size)
+    {
+        MemoryBlock block;
+
+        {
+            const SpinLock::ScopedLockType sl (lock);
+            auto index = findBlockFor (size);
+
+            if (index >= 0)
+            {
+                block = std::move (blocks.getReference (index));
+                blocks.remove (index);
+            }
+        }
+
+        // Shrinking a block can usually be done in place, but growing one would copy its old contents
+        if (block.getSize() < size)
+            block.reset();
+
+        block.setSize (size);
+        return block;
+    }
+
+    void release (MemoryBlock&& block)
+    {
+        if (block.getSize() == 0)
+            return;
+
+        const SpinLock::ScopedLockType sl (lock);
+
+        // (if the pool's full, the block is left for the caller to free, outside the lock)
+        if (blocks.size() < maxBlocks)
+            blocks.add (std::move (block));
+    }
+
+private:
+    enum { maxBlocks = 4 };
+
+    SpinLock lock;
+    Array<MemoryBlock> blocks;
+
+    // Until the pool is full, a message that doesn't match any of the blocks gets a new one,
+    // so that the others are kept for the sizes they already have. After that, it takes the
+    // smallest block that's big enough, or failing that, the biggest one.
+    int findBlockFor (size_t size) const
+    {
+        int best = -1;
+
+        for (int i = 0; i < blocks.size(); ++i)
+        {
+            auto blockSize = blocks.getReference (i).getSize();
+
+            if (blockSize == size)
+                return i;
+
+            if (best < 0)
+            {
+                best = i;
+                continue;
+            }
+
+            auto bestSize = blocks.getReference (best).getSize();
+
+            if (bestSize >= size ? (blockSize >= size && blockSize < bestSize)
+                                 : blockSize > bestSize)
+                best = i;
+        }
+
+        return blocks.size() < maxBlocks ? -1 : best;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ReceiveBufferPoolImpl)
+};
+
+class InterprocessConnection::ReceiveBufferPool : public ReceiveBufferPoolImpl
+{
+    using ReceiveBufferPoolImpl::ReceiveBufferPoolImpl;
+};
+
 //==============================================================================
 InterprocessConnection::InterprocessConnection (bool callbacksOnMessageThread, uint32 magicMessageHeaderNumber)
     : useMessageThread (callbacksOnMessageThread),
       magicMessageHeader (magicMessageHeaderNumber),
+      receiveBufferPool (std::make_shared<ReceiveBufferPool>()),
       safeAction (std::make_shared<SafeAction> (*this))
 {
     thread.reset (new ConnectionThread (*this));
@@ -145,10 +239,22 @@ bool InterprocessConnection::createPipe (const String& pipeName, int timeoutMs,
     return false;
 }
 
+void InterprocessConnection::setReactor (InterprocessConnectionReactor* reactorToUse) noexcept
+{
+    // This must be set before the connection is opened!
+    jassert (! isConnected());
+
+    reactor = reactorToUse;
+}
+
 void InterprocessConnection::disconnect (int timeoutMs, Notify notify)
 {
     thread->signalThreadShouldExit();
 
+    // (this waits for the reactor to finish any callbacks that it's making)
+    if (reactor != nullptr)
+        reactor->removeConnection (*this);
+
     {
         const ScopedReadLock sl (pipeAndSocketLock);
         if (socket != nullptr)  socket->close();
@@ -158,6 +264,12 @@ void InterprocessConnection::disconnect (int timeoutMs, Notify notify)
     thread->stopThread (timeoutMs);
     deletePipeAndSocket();
 
+    {
+        const ScopedLock sl (writeLock);
+        queueUnsentData = false;
+        unsentStart = unsentEnd = 0;
+    }
+
     if (notify == Notify::yes)
         connectionLostInt();
 
@@ -198,29 +310,268 @@ String InterprocessConnection::getConnectedHostName() const
 
 //==============================================================================
 bool InterprocessConnection::sendMessage (const MemoryBlock& message)
+{
+    return sendMessages (&message, 1);
+}
+
+bool InterprocessConnection::sendMessages (const MemoryBlock* messages, int numMessages)
 {
     jassert(magicMessageHeader); // SMODE: ensure magicMessageHeader is set at construction to send first sendMessage or sendMessage after first received packet for dlrd/Smode-Issues#5487)
-    uint32 messageHeader[2] = { ByteOrder::swapIfBigEndian (magicMessageHeader),
-                                ByteOrder::swapIfBigEndian ((uint32) message.getSize()) };
 
-    MemoryBlock messageData (sizeof (messageHeader) + message.getSize());
-    messageData.copyFrom (messageHeader, 0, sizeof (messageHeader));
-    messageData.copyFrom (message.getData(), sizeof (messageHeader), message.getSize());
+    if (numMessages <= 0)
+        return true;
+
+    // (this stops the messages from different threads being interleaved)
+    const ScopedLock sl (writeLock);
+    return writeMessages (messages, numMessages);
+}
+
+size_t InterprocessConnection::getNumBytesWaitingToBeSent() const
+{
+    const ScopedLock sl (writeLock);
+    return unsentEnd - unsentStart;
+}
+
+void InterprocessConnection::notifyMessagesToWrite()
+{
+    if (reactor != nullptr)
+        reactor->notifyMessagesToWrite (*this);
 
-    return writeData (messageData.getData(), (int) messageData.getSize()) == (int) messageData.getSize();
+    thread->notify();
 }
 
-int InterprocessConnection::writeData (void* data, int dataSize)
+bool InterprocessConnection::writeMessages (const MemoryBlock* messages, int numMessages)
 {
     const ScopedReadLock sl (pipeAndSocketLock);
 
+   #if ! JUCE_WINDOWS
     if (socket != nullptr)
-        return socket->write (data, dataSize);
+        return writeToSocket (messages, numMessages);
+   #endif
+
+    if (socket == nullptr && pipe == nullptr)
+        return false;
+
+    // Without a gather-write, the messages are concatenated into a buffer that's kept
+    // between calls, so at least it doesn't need to be allocated each time
+    size_t totalSize = 0;
+
+    for (int i = 0; i < numMessages; ++i)
+        totalSize += sizeof (uint32) * 2 + messages[i].getSize();
+
+    sendBuffer.ensureSize (totalSize);
+    auto* dest = static_cast<char*> (sendBuffer.getData());
+
+    for (int i = 0; i < numMessages; ++i)
+    {
+        uint32 messageHeader[2] = { ByteOrder::swapIfBigEndian (magicMessageHeader),
+                                    ByteOrder::swapIfBigEndian ((uint32) messages[i].getSize()) };
+
+        memcpy (dest, messageHeader, sizeof (messageHeader));
+        memcpy (dest + sizeof (messageHeader), messages[i].getData(), messages[i].getSize());
+        dest += sizeof (messageHeader) + messages[i].getSize();
+    }
+
+    auto* data = static_cast<const char*> (sendBuffer.getData());
+    auto numBytes = (int) totalSize;
 
     if (pipe != nullptr)
-        return pipe->write (data, dataSize, pipeReceiveMessageTimeout);
+        return pipe->write (data, numBytes, pipeReceiveMessageTimeout) == numBytes;
+
+    while (numBytes > 0)
+    {
+        auto numWritten = socket->write (data, numBytes);
+
+        if (numWritten <= 0)
+            return false;
+
+        data += numWritten;
+        numBytes -= numWritten;
+    }
+
+    return true;
+}
+
+bool InterprocessConnection::writeToSocket (const MemoryBlock* messages, int numMessages)
+{
+   #if JUCE_WINDOWS
+    ignoreUnused (messages, numMessages);
+    jassertfalse;
+    return false;
+   #else
+    #ifdef MSG_NOSIGNAL
+     const int flags = MSG_NOSIGNAL;
+    #else
+     const int flags = 0;
+    #endif
+
+    // A connection that's serviced by a reactor mustn't block its thread, so whatever the
+    // socket can't take straight away gets queued, and is sent when it becomes writable.
+    // Anything new has to wait behind what's already queued.
+    const bool queueIfFull = queueUnsentData;
+
+    if (queueIfFull)
+    {
+        if (! flushUnsentData())
+            return false;
+
+        if (unsentEnd > unsentStart)
+        {
+            for (int i = 0; i < numMessages; ++i)
+                appendUnsentMessage (messages[i]);
+
+            return true;
+        }
+    }
+
+    // Each message becomes two iovecs, for its header and its data
+    enum { maxMessagesPerCall = 256 };
+    uint32 headers[maxMessagesPerCall][2];
+    iovec buffers[maxMessagesPerCall * 2];
+
+    auto handle = socket->getRawSocketHandle();
+
+    while (numMessages > 0)
+    {
+        auto numThisTime = jmin (numMessages, (int) maxMessagesPerCall);
+        int numBuffers = 0;
+
+        for (int i = 0; i < numThisTime; ++i)
+        {
+            headers[i][0] = ByteOrder::swapIfBigEndian (magicMessageHeader);
+            headers[i][1] = ByteOrder::swapIfBigEndian ((uint32) messages[i].getSize());
+
+            buffers[numBuffers++] = { headers[i], sizeof (headers[i]) };
+
+            if (messages[i].getSize() > 0)
+                buffers[numBuffers++] = { messages[i].getData(), messages[i].getSize() };
+        }
+
+        auto* buffer = buffers;
+
+        while (numBuffers > 0)
+        {
+            msghdr message {};
+            message.msg_iov = buffer;
+            message.msg_iovlen = (decltype (message.msg_iovlen)) numBuffers;
+
+            auto numWritten = ::sendmsg (handle, &message, queueIfFull ? (flags | MSG_DONTWAIT) : flags);
+
+            if (numWritten < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                {
+                    if (queueIfFull)
+                    {
+                        for (int i = 0; i < numBuffers; ++i)
+                            appendUnsentData (buffer[i].iov_base, buffer[i].iov_len);
+
+                        for (int i = numThisTime; i < numMessages; ++i)
+                            appendUnsentMessage (messages[i]);
+
+                        return true;
+                    }
+
+                    pollfd pfd { handle, POLLOUT, 0 };
+
+                    if (::poll (&pfd, 1, -1) >= 0)
+                        continue;
+                }
+
+                return false;
+            }
+
+            // Skip past whatever was written, which may have ended part-way through a buffer
+            while (numBuffers > 0 && (size_t) numWritten >= buffer->iov_len)
+            {
+                numWritten -= (decltype (numWritten)) buffer->iov_len;
+                ++buffer;
+                --numBuffers;
+            }
+
+            if (numBuffers > 0)
+            {
+                buffer->iov_base = addBytesToPointer (buffer->iov_base, numWritten);
+                buffer->iov_len -= (size_t) numWritten;
+            }
+        }
+
+        messages += numThisTime;
+        numMessages -= numThisTime;
+    }
+
+    return true;
+   #endif
+}
+
+// These are all called with the write lock held
+void InterprocessConnection::appendUnsentData (const void* data, size_t numBytes)
+{
+    if (unsentStart > 0)
+    {
+        memmove (unsentData.getData(), addBytesToPointer (unsentData.getData(), unsentStart), unsentEnd - unsentStart);
+        unsentEnd -= unsentStart;
+        unsentStart = 0;
+    }
+
+    if (unsentData.getSize() < unsentEnd + numBytes)
+        unsentData.setSize (jmax (unsentEnd + numBytes, unsentData.getSize() * 2));
+
+    memcpy (addBytesToPointer (unsentData.getData(), unsentEnd), data, numBytes);
+    unsentEnd += numBytes;
+}
+
+void InterprocessConnection::appendUnsentMessage (const MemoryBlock& message)
+{
+    uint32 messageHeader[2] = { ByteOrder::swapIfBigEndian (magicMessageHeader),
+                                ByteOrder::swapIfBigEndian ((uint32) message.getSize()) };
+
+    appendUnsentData (messageHeader, sizeof (messageHeader));
+    appendUnsentData (message.getData(), message.getSize());
+}
+
+bool InterprocessConnection::flushUnsentData()
+{
+   #if JUCE_WINDOWS
+    return true;
+   #else
+    #ifdef MSG_NOSIGNAL
+     const int flags = MSG_NOSIGNAL | MSG_DONTWAIT;
+    #else
+     const int flags = MSG_DONTWAIT;
+    #endif
+
+    while (unsentEnd > unsentStart)
+    {
+        auto numWritten = ::send (socket->getRawSocketHandle(), addBytesToPointer (unsentData.getData(), unsentStart),
+                                  unsentEnd - unsentStart, flags);
+
+        if (numWritten < 0)
+        {
+            if (errno == EINTR)
+                continue;
 
-    return 0;
+            // (if it's full, the rest will be sent when the reactor sees it become writable)
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+
+        unsentStart += (size_t) numWritten;
+    }
+
+    unsentStart = unsentEnd = 0;
+    return true;
+   #endif
+}
+
+bool InterprocessConnection::sendUnsentData()
+{
+    const ScopedLock sl (writeLock);
+    const ScopedReadLock rl (pipeAndSocketLock);
+
+    return socket != nullptr && flushUnsentData();
 }
 
 //==============================================================================
@@ -229,6 +580,18 @@ void InterprocessConnection::initialise()
     safeAction->setSafe (true);
     threadIsRunning = true;
     connectionMadeInt();
+
+    if (reactor != nullptr && socket != nullptr)
+    {
+        // (this is set first, because the reactor may start making callbacks straight away)
+        queueUnsentData = true;
+
+        if (reactor->addConnection (*this))
+            return;
+
+        queueUnsentData = false;
+    }
+
     thread->startThread();
 }
 
@@ -296,12 +659,17 @@ void InterprocessConnection::connectionLostInt()
     }
 }
 
-struct DataDeliveryMessage  : public Message
+struct InterprocessConnection::DataDeliveryMessage  : public Message
 {
-    DataDeliveryMessage (std::shared_ptr<SafeActionImpl> ipc, const MemoryBlock& d)
-        : safeAction (ipc), data (d)
+    DataDeliveryMessage (std::shared_ptr<SafeActionImpl> ipc, std::shared_ptr<ReceiveBufferPool> p, MemoryBlock&& d)
+        : safeAction (ipc), pool (p), data (std::move (d))
     {}
 
+    ~DataDeliveryMessage() override
+    {
+        pool->release (std::move (data));
+    }
+
     void messageCallback() override
     {
         safeAction->ifSafe ([this] (InterprocessConnection& owner)
@@ -311,17 +679,31 @@ struct DataDeliveryMessage  : public Message
     }
 
     std::shared_ptr<SafeActionImpl> safeAction;
+    std::shared_ptr<ReceiveBufferPool> pool;
     MemoryBlock data;
 };
 
-void InterprocessConnection::deliverDataInt (const MemoryBlock& data)
+MemoryBlock& InterprocessConnection::prepareReceiveBuffer (size_t messageSize)
+{
+    if (receiveBuffer.getSize() != messageSize)
+    {
+        receiveBufferPool->release (std::move (receiveBuffer));
+        receiveBuffer = receiveBufferPool->acquire (messageSize);
+    }
+
+    return receiveBuffer;
+}
+
+void InterprocessConnection::deliverReceiveBuffer()
 {
     jassert (callbackConnectionState);
 
+    // When the message is posted, it takes the buffer with it, so it won't be copied. The
+    // buffer goes back into the pool once the message has been delivered.
     if (useMessageThread)
-        (new DataDeliveryMessage (safeAction, data))->post();
+        (new DataDeliveryMessage (safeAction, receiveBufferPool, std::move (receiveBuffer)))->post();
     else
-        messageReceived (data);
+        messageReceived (receiveBuffer);
 }
 
 //==============================================================================
@@ -353,31 +735,34 @@ bool InterprocessConnection::readNextMessage()
     {
         auto bytesInMessage = (int) ByteOrder::swapIfBigEndian (messageHeader[1]);
 
-        if (bytesInMessage > 0)
-        {
-            MemoryBlock messageData ((size_t) bytesInMessage, true);
-            int bytesRead = 0;
+        if (bytesInMessage <= 0)
+            return true;
 
-            while (bytesInMessage > 0)
-            {
-                if (thread->threadShouldExit())
-                    return false;
+        auto& messageData = prepareReceiveBuffer ((size_t) bytesInMessage);
+        int bytesRead = 0;
 
-                auto numThisTime = jmin (bytesInMessage, 65536);
-                auto bytesIn = readData (addBytesToPointer (messageData.getData(), bytesRead), numThisTime);
+        while (bytesRead < bytesInMessage)
+        {
+            if (thread->threadShouldExit())
+                return false;
 
-                if (bytesIn <= 0)
-                    break;
+            auto numThisTime = jmin (bytesInMessage - bytesRead, 65536);
+            auto bytesIn = readData (addBytesToPointer (messageData.getData(), bytesRead), numThisTime);
 
-                bytesRead += bytesIn;
-                bytesInMessage -= bytesIn;
-            }
+            if (bytesIn <= 0)
+                break;
 
-            if (bytesRead >= 0)
-                deliverDataInt (messageData);
+            bytesRead += bytesIn;
         }
 
-        return true;
+        if (bytesRead == bytesInMessage)
+        {
+            deliverReceiveBuffer();
+            return true;
+        }
+
+        // The connection failed part-way through the message
+        bytes = -1;
     }
 
     if (bytes < 0)
@@ -456,6 +841,9 @@ void InterprocessConnection::runThread()
                 connectionLostInt();
                 break;
             }
+
+            // (pipe reads block until data arrives or the timeout expires)
+            somethingToRead = true;
         }
         else
         {
@@ -469,4 +857,281 @@ void InterprocessConnection::runThread()
     threadIsRunning = false;
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class InterprocessConnectionTests  : public UnitTest
+{
+public:
+    InterprocessConnectionTests()
+        : UnitTest ("InterprocessConnection", UnitTestCategories::networking)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("sendMessages() delivers a batch intact and in order");
+        {
+            Server server (false);
+            Connection client (false);
+
+            if (connect (server, client))
+            {
+                // (more than the number of messages that are written in each system call)
+                Array<MemoryBlock> messages;
+
+                for (int i = 0; i < 600; ++i)
+                    messages.add (createMessage (i, getRandom().nextInt (i % 50 == 0 ? 100000 : 2000)));
+
+                expect (client.sendMessages (messages));
+                expect (waitUntil ([&] { return server.getConnection()->numReceived == 600; }));
+                expectEquals (server.getConnection()->numErrors.load(), 0);
+
+                expect (client.sendMessages (nullptr, 0));
+                expect (client.sendMessage (createMessage (600, 10)));
+                expect (waitUntil ([&] { return server.getConnection()->numReceived == 601; }));
+                expectEquals (server.getConnection()->numErrors.load(), 0);
+            }
+        }
+
+       #if ! JUCE_WINDOWS
+        beginTest ("Writes that are cut short are resumed");
+        {
+            Server server (false);
+            Connection client (false);
+
+            if (connect (server, client))
+            {
+                // With a send timeout, sendmsg() returns as soon as the socket's buffer is full,
+                // having written only part of what it was given, so while the receiver is
+                // stalled, the batch has to be written in many pieces.
+                timeval timeout { 0, 1000 };
+                expect (::setsockopt (client.getSocket()->getRawSocketHandle(), SOL_SOCKET, SO_SNDTIMEO,
+                                      &timeout, sizeof (timeout)) == 0);
+
+                server.getConnection()->delayMs = 5;
+
+                Array<MemoryBlock> messages;
+
+                for (int i = 0; i < 40; ++i)
+                    messages.add (createMessage (i, 100000 + getRandom().nextInt (1000)));
+
+                expect (client.sendMessages (messages));
+
+                for (int i = 40; i < 60; ++i)
+                    expect (client.sendMessage (createMessage (i, 100000)));
+
+                expect (waitUntil ([&] { return server.getConnection()->numReceived == 60; }));
+                expectEquals (server.getConnection()->numErrors.load(), 0);
+            }
+        }
+       #endif
+
+       #if JUCE_MODAL_LOOPS_PERMITTED
+        if (MessageManager::getInstance()->isThisTheMessageThread())
+        {
+            beginTest ("Messages can be delivered on the message thread");
+
+            Server server (true);
+            Connection client (false);
+
+            if (connect (server, client))
+            {
+                for (int i = 0; i < 100; ++i)
+                    expect (client.sendMessage (createMessage (i, getRandom().nextInt (i % 10 == 0 ? 100000 : 500))));
+
+                expect (waitUntil ([&] { return server.getConnection()->numReceived == 100; }));
+                expectEquals (server.getConnection()->numErrors.load(), 0);
+            }
+        }
+       #endif
+
+        beginTest ("Receive buffers are re-used");
+        {
+            ReceiveBufferPoolImpl pool;
+
+            auto a = pool.acquire (300);
+            auto b = pool.acquire (5000);
+            auto* dataA = a.getData();
+            auto* dataB = b.getData();
+
+            // Blocks of the sizes that are in the pool come back out unchanged
+            for (int i = 0; i < 5; ++i)
+            {
+                pool.release (std::move (a));
+                pool.release (std::move (b));
+                expectEquals ((int) a.getSize(), 0);
+
+                a = pool.acquire (300);
+                b = pool.acquire (5000);
+                expect (a.getData() == dataA);
+                expect (b.getData() == dataB);
+            }
+
+            // Until the pool is full, a new size gets a new block, and the others are kept
+            pool.release (std::move (a));
+            pool.release (std::move (b));
+
+            auto c = pool.acquire (1000);
+            expectEquals ((int) c.getSize(), 1000);
+            expect (c.getData() != dataA && c.getData() != dataB);
+            pool.release (std::move (c));
+
+            a = pool.acquire (300);
+            expect (a.getData() == dataA);
+            pool.release (std::move (a));
+
+            // Once it's full, a new size is given the smallest block it fits in
+            MemoryBlock big (20000);
+            auto* dataBig = big.getData();
+            pool.release (std::move (big));
+
+            auto d = pool.acquire (4000);
+            expectEquals ((int) d.getSize(), 4000);
+
+            big = pool.acquire (20000);
+            expect (big.getData() == dataBig);
+
+            pool.release (std::move (d));
+            pool.release (std::move (big));
+
+            // ..and a block that's released when it's full is freed
+            MemoryBlock e (100);
+            pool.release (std::move (e));
+            expectEquals ((int) e.getSize(), 100);
+
+            auto f = pool.acquire (100000);
+            expectEquals ((int) f.getSize(), 100000);
+        }
+    }
+
+private:
+    //==============================================================================
+    // Each message starts with its index, and the rest of it is filled with a pattern
+    // that depends on the index, so that the receiver can check it arrived intact.
+    static MemoryBlock createMessage (int index, int extraSize)
+    {
+        MemoryBlock m (sizeof (int) + (size_t) extraSize);
+        auto* data = static_cast<uint8*> (m.getData());
+        memcpy (data, &index, sizeof (int));
+
+        for (int i = 0; i < extraSize; ++i)
+            data[sizeof (int) + (size_t) i] = (uint8) (index + i);
+
+        return m;
+    }
+
+    static bool isValidMessage (const MemoryBlock& m, int expectedIndex)
+    {
+        if (m.getSize() < sizeof (int))
+            return false;
+
+        auto* data = static_cast<const uint8*> (m.getData());
+        int index;
+        memcpy (&index, data, sizeof (int));
+
+        if (index != expectedIndex)
+            return false;
+
+        for (size_t i = sizeof (int); i < m.getSize(); ++i)
+            if (data[i] != (uint8) (index + (int) (i - sizeof (int))))
+                return false;
+
+        return true;
+    }
+
+    //==============================================================================
+    struct Connection  : public InterprocessConnection
+    {
+        explicit Connection (bool callbacksOnMessageThread)
+            : InterprocessConnection (callbacksOnMessageThread) {}
+
+        ~Connection() override   { disconnect(); }
+
+        void connectionMade() override  {}
+        void connectionLost() override  {}
+
+        void messageReceived (const MemoryBlock& message) override
+        {
+            if (numReceived < 10 && delayMs > 0)
+                Thread::sleep (delayMs);
+
+            if (! isValidMessage (message, numReceived))
+                ++numErrors;
+
+            ++numReceived;
+        }
+
+        std::atomic<int> numReceived { 0 }, numErrors { 0 }, delayMs { 0 };
+    };
+
+    struct Server  : public InterprocessConnectionServer
+    {
+        explicit Server (bool callbacksOnMessageThread)
+            : useMessageThread (callbacksOnMessageThread) {}
+
+        ~Server() override   { stop(); }
+
+        InterprocessConnection* createConnectionObject() override
+        {
+            auto* c = new Connection (useMessageThread);
+            connection.reset (c);
+            return c;
+        }
+
+        Connection* getConnection() const   { return connection.get(); }
+
+        const bool useMessageThread;
+        std::unique_ptr<Connection> connection;
+    };
+
+    //==============================================================================
+    template <typename Predicate>
+    static bool waitUntil (Predicate&& predicate)
+    {
+        auto timeout = Time::getMillisecondCounter() + 10000;
+
+        while (! predicate())
+        {
+            if (Time::getMillisecondCounter() > timeout)
+                return false;
+
+           #if JUCE_MODAL_LOOPS_PERMITTED
+            if (MessageManager::getInstance()->isThisTheMessageThread())
+            {
+                MessageManager::getInstance()->runDispatchLoopUntil (1);
+                continue;
+            }
+           #endif
+
+            Thread::sleep (1);
+        }
+
+        return true;
+    }
+
+    bool connect (Server& server, Connection& client)
+    {
+        if (! server.beginWaitingForSocket (0, "127.0.0.1"))
+        {
+            expect (false, "couldn't open a listening socket");
+            return false;
+        }
+
+        if (! client.connectToSocket ("127.0.0.1", server.getBoundPort(), 2000))
+        {
+            expect (false, "couldn't connect");
+            return false;
+        }
+
+        auto connected = waitUntil ([&] { return server.getConnection() != nullptr; });
+        expect (connected);
+        return connected;
+    }
+};
+
+static InterprocessConnectionTests interprocessConnectionTests;
+
+#endif
+
 } // namespace juce
@@ -24,6 +24,7 @@ namespace juce
 {
 
 class InterprocessConnectionServer;
+class InterprocessConnectionReactor;
 class MemoryBlock;
 
 
@@ -120,6 +121,21 @@ public:
     */
     bool createPipe (const String& pipeName, int pipeReceiveMessageTimeoutMs, bool mustNotExist = false);
 
+    /** Makes this connection use a shared InterprocessConnectionReactor instead of
+        starting its own thread.
+
+        This must be called before the connection is opened, and the reactor must
+        outlive the connection. It only affects socket connections, and if the reactor
+        isn't available on this platform, the connection will use its own thread as usual.
+
+        @see InterprocessConnectionReactor, InterprocessConnectionServer::setReactor
+    */
+    void setReactor (InterprocessConnectionReactor* reactorToUse) noexcept;
+
+    /** Returns the reactor that was set with setReactor(), if there is one. */
+    InterprocessConnectionReactor* getReactor() const noexcept  { return reactor; }
+
+    //==============================================================================
     /** Whether the disconnect call should trigger callbacks. */
     enum class Notify { no, yes };
 
@@ -154,10 +170,44 @@ public:
         it succeeds, the connection object at the other end will receive the message by
         a callback to its messageReceived() method.
 
-        @see messageReceived
+        The header and the message data are sent with a single gather-write, so the
+        message isn't copied. This can safely be called from several threads at once.
+
+        If the connection is serviced by an InterprocessConnectionReactor, this never
+        blocks. Whatever the socket can't take straight away is copied into a queue, and
+        the reactor sends it when the socket becomes writable again, so a true result
+        only means that the message has been sent or queued.
+
+        @see messageReceived, sendMessages, getNumBytesWaitingToBeSent
     */
     bool sendMessage (const MemoryBlock& message);
 
+    /** Sends a batch of messages to the other end of this connection.
+
+        This has the same effect as calling sendMessage() for each of them, but lets many
+        small messages go out in a single system call. No other thread's messages can
+        be interleaved with the batch.
+
+        @returns true if all the messages were sent
+        @see sendMessage
+    */
+    bool sendMessages (const MemoryBlock* messages, int numMessages);
+
+    /** Sends a batch of messages to the other end of this connection.
+        @see sendMessage
+    */
+    bool sendMessages (const Array<MemoryBlock>& messages)      { return sendMessages (messages.begin(), messages.size()); }
+
+    /** Returns the number of bytes that have been queued by sendMessage() but not sent yet.
+
+        This will only be non-zero for a connection that's serviced by an
+        InterprocessConnectionReactor, when the other end isn't reading as fast as you're
+        sending. You can use it to stop sending until the queue has drained.
+
+        @see sendMessage
+    */
+    size_t getNumBytesWaitingToBeSent() const;
+
     //==============================================================================
     /** Called when the connection is first connected.
 
@@ -184,6 +234,10 @@ public:
         this will be called on the message thread; otherwise it will be called on a server
         thread.
 
+        The connection re-uses the blocks that it reads messages into, to avoid allocating
+        a new one for each message, so the block is only valid for the duration of this
+        callback. If you need to keep the message, copy it.
+
         @see sendMessage
     */
     virtual void messageReceived (const MemoryBlock& message) = 0;
@@ -192,6 +246,16 @@ public:
     virtual bool hasMessagesToWrite() const { return false; }
     virtual bool sendMessagesToWrite() { return true; }
 
+    /** Call this when hasMessagesToWrite() has become true, so that sendMessagesToWrite()
+        gets called as soon as possible.
+
+        A connection that's serviced by an InterprocessConnectionReactor must call this.
+        By default, the reactor doesn't poll hasMessagesToWrite() at all, so without it,
+        the messages will wait until the socket next becomes writable, which may never
+        happen.
+    */
+    void notifyMessagesToWrite();
+
     // SMODE: lazy magicMessageHeader support (set at first received packet if null)
     uint32 getMagicMessageHeader() const
       {return magicMessageHeader;}
@@ -206,14 +270,29 @@ private:
     /* SMODE non const anymore du to lazy first received packet when null*/ uint32 magicMessageHeader;
     int pipeReceiveMessageTimeout = -1;
 
+    CriticalSection writeLock;
+    MemoryBlock receiveBuffer, sendBuffer, unsentData;
+    size_t unsentStart = 0, unsentEnd = 0;
+    std::atomic<bool> queueUnsentData { false };
+
+    class ReceiveBufferPool;
+    struct DataDeliveryMessage;
+    std::shared_ptr<ReceiveBufferPool> receiveBufferPool;
+
+    InterprocessConnectionReactor* reactor = nullptr;
+    struct ReactorRegistration;
+    std::shared_ptr<ReactorRegistration> reactorRegistration;
+
     friend class InterprocessConnectionServer;
+    friend class InterprocessConnectionReactor;
     void initialise();
     void initialiseWithSocket (std::unique_ptr<StreamingSocket>);
     void initialiseWithPipe (std::unique_ptr<NamedPipe>);
     void deletePipeAndSocket();
     void connectionMadeInt();
     void connectionLostInt();
-    void deliverDataInt (const MemoryBlock&);
+    MemoryBlock& prepareReceiveBuffer (size_t);
+    void deliverReceiveBuffer();
     bool readNextMessage();
     int readData (void*, int);
     bool writeNextMessage(); // SMODE
@@ -226,7 +305,12 @@ private:
     std::shared_ptr<SafeAction> safeAction;
 
     void runThread();
-    int writeData (void*, int);
+    bool writeMessages (const MemoryBlock*, int);
+    bool writeToSocket (const MemoryBlock*, int);
+    void appendUnsentData (const void*, size_t);
+    void appendUnsentMessage (const MemoryBlock&);
+    bool flushUnsentData();
+    bool sendUnsentData();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (InterprocessConnection)
 };
@@ -0,0 +1,964 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+#if JUCE_LINUX
+
+//==============================================================================
+// The reactor's record of a connection, and how much of the incoming message has arrived.
+// The message itself is assembled in the connection's receive buffer.
+struct InterprocessConnection::ReactorRegistration
+{
+    ReactorRegistration (InterprocessConnection& c, InterprocessConnectionReactor::IOThread& t, int fd)
+        : owner (c), thread (t), socketHandle (fd)
+    {}
+
+    InterprocessConnection& owner;
+    InterprocessConnectionReactor::IOThread& thread;
+    const int socketHandle;
+    std::atomic<bool> removed { false }, writeRequested { false };
+
+    uint32 header[2];
+    int headerBytes = 0, messageBytes = 0, messageSize = 0;
+    bool isReadingMessage = false;
+};
+
+//==============================================================================
+/*  Each thread has its own epoll set, and owns the connections that were assigned to it,
+    so a connection's callbacks are only ever made from one thread. The sockets are
+    registered edge-triggered, so the thread only wakes when new data arrives or when a
+    full send buffer drains, and it then reads everything that's available in one go.
+
+    Registrations are shared_ptrs which are kept alive until the end of the batch of events
+    that's being handled, because a registration can be removed by one of the callbacks
+    in the batch, or by another thread, while the batch still has events for it.
+*/
+struct InterprocessConnectionReactor::IOThread  : public Thread
+{
+    using Registration = InterprocessConnection::ReactorRegistration;
+
+    IOThread (InterprocessConnectionReactor& r, int index)
+        : Thread ("JUCE IPC reactor " + String (index)), reactor (r)
+    {
+        epollHandle = ::epoll_create1 (EPOLL_CLOEXEC);
+        wakeHandle = ::eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+        jassert (epollHandle >= 0 && wakeHandle >= 0);
+
+        epoll_event e {};
+        e.events = EPOLLIN;
+        e.data.ptr = nullptr;
+        ::epoll_ctl (epollHandle, EPOLL_CTL_ADD, wakeHandle, &e);
+
+        startThread();
+    }
+
+    ~IOThread() override
+    {
+        signalThreadShouldExit();
+        wake();
+        stopThread (4000);
+
+        ::close (wakeHandle);
+        ::close (epollHandle);
+    }
+
+    void wake() noexcept
+    {
+        const uint64 one = 1;
+        auto bytesWritten = ::write (wakeHandle, &one, sizeof (one));
+        ignoreUnused (bytesWritten);
+    }
+
+    //==============================================================================
+    // These are all called with the reactor's lock held
+    bool attach (const std::shared_ptr<Registration>& reg)
+    {
+        epoll_event e {};
+        e.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        e.data.ptr = reg.get();
+
+        if (::epoll_ctl (epollHandle, EPOLL_CTL_ADD, reg->socketHandle, &e) != 0)
+            return false;
+
+        active.push_back (reg);
+        return true;
+    }
+
+    bool detach (Registration& reg)
+    {
+        if (reg.removed.exchange (true))
+            return false;
+
+        ::epoll_ctl (epollHandle, EPOLL_CTL_DEL, reg.socketHandle, nullptr);
+
+        for (auto i = active.begin(); i != active.end(); ++i)
+        {
+            if (i->get() == &reg)
+            {
+                garbage.push_back (std::move (*i));
+                active.erase (i);
+                break;
+            }
+        }
+
+        reg.owner.threadIsRunning = false;
+        wake();
+        return true;
+    }
+
+    //==============================================================================
+    void requestWrite (const std::shared_ptr<Registration>& reg)
+    {
+        if (reg->writeRequested.exchange (true))
+            return;
+
+        bool needsWaking;
+
+        {
+            const ScopedLock sl (pendingWritesLock);
+            needsWaking = pendingWrites.empty();
+            pendingWrites.push_back (reg);
+        }
+
+        if (needsWaking)
+            wake();
+    }
+
+    void run() override
+    {
+        constexpr int maxEvents = 64;
+        epoll_event events[maxEvents];
+        auto nextPollTime = Time::getMillisecondCounter();
+
+        while (! threadShouldExit())
+        {
+            auto timeoutMs = -1;
+
+            if (reactor.writePollInterval >= 0)
+                timeoutMs = jmax (0, (int) (nextPollTime - Time::getMillisecondCounter()));
+
+            auto numEvents = ::epoll_wait (epollHandle, events, maxEvents, timeoutMs);
+
+            if (numEvents < 0 && errno != EINTR)
+                break;
+
+            const ScopedLock sl (dispatchLock);
+
+            for (int i = 0; i < numEvents; ++i)
+            {
+                if (auto* reg = static_cast<Registration*> (events[i].data.ptr))
+                    handleEvents (*reg, events[i].events);
+                else
+                    clearWakeSignal();
+            }
+
+            handlePendingWrites();
+
+            if (reactor.writePollInterval >= 0 && Time::getMillisecondCounter() >= nextPollTime)
+            {
+                pollForMessagesToWrite();
+                nextPollTime = Time::getMillisecondCounter() + (uint32) reactor.writePollInterval;
+            }
+
+            const ScopedLock rl (reactor.lock);
+            garbage.clear();
+        }
+    }
+
+    //==============================================================================
+    InterprocessConnectionReactor& reactor;
+    int epollHandle = -1, wakeHandle = -1;
+
+    // (these are protected by the reactor's lock)
+    std::vector<std::shared_ptr<Registration>> active, garbage;
+
+    // This is held while any callbacks are being made, so that a connection can wait for
+    // them to finish before it gets disconnected
+    CriticalSection dispatchLock;
+
+private:
+    CriticalSection pendingWritesLock;
+    std::vector<std::shared_ptr<Registration>> pendingWrites, writesToHandle;
+    HeapBlock<char> readBuffer { (size_t) readBufferSize };
+
+    enum { readBufferSize = 65536 };
+
+    void clearWakeSignal() noexcept
+    {
+        uint64 value;
+        auto bytesRead = ::read (wakeHandle, &value, sizeof (value));
+        ignoreUnused (bytesRead);
+    }
+
+    void handleEvents (Registration& reg, uint32 flags)
+    {
+        // The connection may have been removed while handling an earlier event in this batch
+        if (reg.removed)
+            return;
+
+        if ((flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0
+             && ! readAvailableData (reg, (flags & (EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0))
+            return handleConnectionLost (reg);
+
+        if ((flags & EPOLLOUT) != 0 && ! reg.removed)
+        {
+            if (! reg.owner.sendUnsentData())
+                return handleConnectionLost (reg);
+
+            writeMessages (reg);
+        }
+    }
+
+    void handleConnectionLost (Registration& reg)
+    {
+        {
+            const ScopedLock sl (reactor.lock);
+
+            // If this fails, the connection has been disconnected by its owner
+            if (! detach (reg))
+                return;
+        }
+
+        reg.owner.deletePipeAndSocket();
+        reg.owner.connectionLostInt();
+    }
+
+    void writeMessages (Registration& reg)
+    {
+        reg.writeRequested = false;
+
+        if (reg.owner.hasMessagesToWrite() && ! reg.owner.sendMessagesToWrite())
+            handleConnectionLost (reg);
+    }
+
+    void handlePendingWrites()
+    {
+        {
+            const ScopedLock sl (pendingWritesLock);
+            std::swap (writesToHandle, pendingWrites);
+        }
+
+        for (auto& reg : writesToHandle)
+            if (! reg->removed)
+                writeMessages (*reg);
+
+        writesToHandle.clear();
+    }
+
+    void pollForMessagesToWrite()
+    {
+        for (size_t i = 0;; ++i)
+        {
+            std::shared_ptr<Registration> reg;
+
+            {
+                const ScopedLock sl (reactor.lock);
+
+                if (i >= active.size())
+                    break;
+
+                reg = active[i];
+            }
+
+            if (! reg->removed)
+                writeMessages (*reg);
+        }
+    }
+
+    //==============================================================================
+    // Reads until the socket's empty, as required for edge-triggering. Returns false if
+    // the connection has been closed or has sent something that isn't a valid message.
+    // If the other end has hung up, there won't be another event once the last of its
+    // data has been read, so in that case this keeps going until it gets the end of
+    // the stream or an error.
+    bool readAvailableData (Registration& reg, bool peerHasHungUp)
+    {
+        for (;;)
+        {
+            // A large message that's partly arrived is read straight into place
+            auto readIntoMessage = reg.isReadingMessage
+                                     && reg.messageSize - reg.messageBytes >= (int) readBufferSize;
+
+            auto* dest = readIntoMessage ? addBytesToPointer (reg.owner.receiveBuffer.getData(), reg.messageBytes)
+                                         : readBuffer.get();
+            auto numWanted = readIntoMessage ? reg.messageSize - reg.messageBytes
+                                             : (int) readBufferSize;
+
+            auto numRead = (int) ::recv (reg.socketHandle, dest, (size_t) numWanted, MSG_DONTWAIT);
+
+            if (numRead < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                return ! peerHasHungUp && (errno == EAGAIN || errno == EWOULDBLOCK);
+            }
+
+            if (numRead == 0)
+                return false;
+
+            if (readIntoMessage)
+            {
+                reg.messageBytes += numRead;
+
+                if (reg.messageBytes == reg.messageSize)
+                    deliverMessage (reg);
+            }
+            else if (! processData (reg, readBuffer, numRead))
+            {
+                return false;
+            }
+
+            if (reg.removed)
+                return true;
+
+            // A short read means the socket's been drained, and more data will trigger a new event
+            if (numRead < numWanted && ! peerHasHungUp)
+                return true;
+        }
+    }
+
+    bool processData (Registration& reg, const char* data, int numBytes)
+    {
+        while (numBytes > 0)
+        {
+            if (! reg.isReadingMessage)
+            {
+                auto numToCopy = jmin (numBytes, (int) sizeof (reg.header) - reg.headerBytes);
+                memcpy (addBytesToPointer (reg.header, reg.headerBytes), data, (size_t) numToCopy);
+                reg.headerBytes += numToCopy;
+                data += numToCopy;
+                numBytes -= numToCopy;
+
+                if (reg.headerBytes < (int) sizeof (reg.header))
+                    return true;
+
+                reg.headerBytes = 0;
+
+                auto magic = ByteOrder::swapIfBigEndian (reg.header[0]);
+
+                // SMODE lazy magicMessageHeader, as in readNextMessage()
+                if (reg.owner.magicMessageHeader == 0)
+                    reg.owner.magicMessageHeader = magic;
+
+                if (magic != reg.owner.magicMessageHeader)
+                    return false;
+
+                auto messageSize = (int) ByteOrder::swapIfBigEndian (reg.header[1]);
+
+                if (messageSize <= 0)
+                    continue;
+
+                reg.owner.prepareReceiveBuffer ((size_t) messageSize);
+                reg.messageSize = messageSize;
+                reg.messageBytes = 0;
+                reg.isReadingMessage = true;
+            }
+
+            auto numToCopy = jmin (numBytes, reg.messageSize - reg.messageBytes);
+            reg.owner.receiveBuffer.copyFrom (data, reg.messageBytes, (size_t) numToCopy);
+            reg.messageBytes += numToCopy;
+            data += numToCopy;
+            numBytes -= numToCopy;
+
+            if (reg.messageBytes == reg.messageSize)
+            {
+                deliverMessage (reg);
+
+                if (reg.removed)
+                    return true;
+            }
+        }
+
+        return true;
+    }
+
+    void deliverMessage (Registration& reg)
+    {
+        reg.messageBytes = 0;
+        reg.messageSize = 0;
+        reg.isReadingMessage = false;
+
+        reg.owner.deliverReceiveBuffer();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (IOThread)
+};
+
+//==============================================================================
+InterprocessConnectionReactor::InterprocessConnectionReactor (int numThreads, int writePollIntervalMs)
+    : writePollInterval (writePollIntervalMs)
+{
+    for (int i = 0; i < jmax (1, numThreads); ++i)
+        threads.add (new IOThread (*this, i));
+}
+
+InterprocessConnectionReactor::~InterprocessConnectionReactor()
+{
+    // All the connections must be disconnected before the reactor is deleted!
+    jassert (getNumConnections() == 0);
+
+    threads.clear();
+}
+
+bool InterprocessConnectionReactor::isAvailable() noexcept     { return true; }
+
+int InterprocessConnectionReactor::getNumConnections() const noexcept
+{
+    const ScopedLock sl (lock);
+    size_t total = 0;
+
+    for (auto* t : threads)
+        total += t->active.size();
+
+    return (int) total;
+}
+
+bool InterprocessConnectionReactor::addConnection (InterprocessConnection& connection)
+{
+    jassert (connection.socket != nullptr);
+
+    const ScopedLock sl (lock);
+
+    auto* thread = threads.getFirst();
+
+    for (auto* t : threads)
+        if (t->active.size() < thread->active.size())
+            thread = t;
+
+    auto reg = std::make_shared<InterprocessConnection::ReactorRegistration> (connection, *thread,
+                                                                              connection.socket->getRawSocketHandle());
+
+    if (! thread->attach (reg))
+        return false;
+
+    connection.reactorRegistration = std::move (reg);
+    return true;
+}
+
+void InterprocessConnectionReactor::removeConnection (InterprocessConnection& connection)
+{
+    std::shared_ptr<InterprocessConnection::ReactorRegistration> reg;
+
+    {
+        const ScopedLock sl (lock);
+        reg = std::move (connection.reactorRegistration);
+
+        if (reg == nullptr)
+            return;
+
+        reg->thread.detach (*reg);
+    }
+
+    // Wait for any callbacks that are in progress (this won't block if it's called from a
+    // callback, because the lock is re-entrant)
+    const ScopedLock dl (reg->thread.dispatchLock);
+}
+
+void InterprocessConnectionReactor::notifyMessagesToWrite (InterprocessConnection& connection)
+{
+    std::shared_ptr<InterprocessConnection::ReactorRegistration> reg;
+
+    {
+        const ScopedLock sl (lock);
+        reg = connection.reactorRegistration;
+    }
+
+    if (reg != nullptr && ! reg->removed)
+        reg->thread.requestWrite (reg);
+}
+
+#else
+
+//==============================================================================
+struct InterprocessConnectionReactor::IOThread {};
+
+InterprocessConnectionReactor::InterprocessConnectionReactor (int, int writePollIntervalMs)
+    : writePollInterval (writePollIntervalMs)
+{
+}
+
+InterprocessConnectionReactor::~InterprocessConnectionReactor() {}
+
+bool InterprocessConnectionReactor::isAvailable() noexcept                                  { return false; }
+int InterprocessConnectionReactor::getNumConnections() const noexcept                       { return 0; }
+bool InterprocessConnectionReactor::addConnection (InterprocessConnection&)                 { return false; }
+void InterprocessConnectionReactor::removeConnection (InterprocessConnection&)              {}
+void InterprocessConnectionReactor::notifyMessagesToWrite (InterprocessConnection&)         {}
+
+#endif
+
+int InterprocessConnectionReactor::getNumThreads() const noexcept   { return threads.size(); }
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class InterprocessConnectionReactorTests  : public UnitTest
+{
+public:
+    InterprocessConnectionReactorTests()
+        : UnitTest ("InterprocessConnectionReactor", UnitTestCategories::networking)
+    {}
+
+    void runTest() override
+    {
+        if (! InterprocessConnectionReactor::isAvailable())
+            logMessage ("The reactor isn't available on this platform, so the connections will use their own threads");
+
+        // The server's connections and the clients use different reactors, so that each side's
+        // connections can be counted.
+        InterprocessConnectionReactor serverReactor (2), clientReactor (2);
+
+        beginTest ("Messages are delivered to several connections");
+        {
+            Server server (serverReactor);
+            OwnedArray<Connection> clients;
+
+            if (connect (server, clientReactor, clients, 8, Connection::Mode::count))
+            {
+                for (auto* c : clients)
+                {
+                    Array<MemoryBlock> messages;
+
+                    for (int i = 0; i < 50; ++i)
+                        messages.add (createMessage (i, getRandom().nextInt (i % 10 == 0 ? 200000 : 100)));
+
+                    expect (c->sendMessages (messages));
+                }
+
+                expect (waitUntil ([&] { return allReceived (clients, 50); }));
+
+                for (auto* c : clients)
+                    expectEquals (c->numErrors.load(), 0);
+            }
+
+            disconnectAll (server, clients);
+        }
+
+        beginTest ("notifyMessagesToWrite() wakes up a reactor that isn't polling");
+        {
+            Server server (serverReactor);
+            OwnedArray<Connection> clients;
+
+            if (connect (server, clientReactor, clients, 4, Connection::Mode::count))
+            {
+                for (int i = 0; i < 20; ++i)
+                    for (auto* c : clients)
+                        c->queueMessage (createMessage (i, 1000));
+
+                expect (waitUntil ([&] { return allReceived (clients, 20); }));
+
+                for (auto* c : clients)
+                    expectEquals (c->numErrors.load(), 0);
+            }
+
+            disconnectAll (server, clients);
+        }
+
+        beginTest ("Connections can be disconnected while messages are flowing");
+        {
+            Server server (serverReactor);
+            OwnedArray<Connection> clients;
+
+            if (connect (server, clientReactor, clients, 8, Connection::Mode::pingPong))
+            {
+                for (auto* c : clients)
+                    for (int i = 0; i < 4; ++i)
+                        c->sendMessage (createMessage (i, 100));
+
+                expect (waitUntil ([&] { return allReceived (clients, 100); }));
+
+                // Half the clients disconnect, and the server drops one of the others
+                for (int i = 0; i < 4; ++i)
+                    clients[i]->disconnect();
+
+                expect (waitUntil ([&] { return server.getNumLost() == 4; }));
+
+                for (int i = 0; i < server.getNumConnections(); ++i)
+                {
+                    if (! server.getConnection (i)->lost)
+                    {
+                        server.getConnection (i)->disconnect();
+                        break;
+                    }
+                }
+
+                expect (waitUntil ([&] { return server.getNumLost() == 5; }));
+
+                if (InterprocessConnectionReactor::isAvailable())
+                    expect (waitUntil ([&] { return serverReactor.getNumConnections() <= 3
+                                                      && clientReactor.getNumConnections() <= 3; }));
+
+                // The remaining connections should be unaffected
+                Array<int> counts;
+
+                for (int i = 4; i < clients.size(); ++i)
+                    counts.add (clients[i]->numReceived);
+
+                expect (waitUntil ([&]
+                {
+                    int numStillRunning = 0;
+
+                    for (int i = 4; i < clients.size(); ++i)
+                        if (clients[i]->numReceived > counts[i - 4] + 100)
+                            ++numStillRunning;
+
+                    return numStillRunning >= 3;
+                }));
+            }
+
+            disconnectAll (server, clients);
+        }
+
+        beginTest ("A connection that only receives sees the other end disconnect");
+        {
+            // The server is still busy with the first message when the second one arrives
+            // along with the end of the stream
+            Server server (serverReactor, Connection::Mode::count, 200);
+            Connection client (Connection::Mode::count);
+
+            if (connect (server, client))
+            {
+                expect (client.sendMessage (createMessage (0, 100)));
+                expect (waitUntil ([&] { return server.getNumConnections() == 1 && server.getConnection (0)->isBusy; }));
+                expect (client.sendMessage (createMessage (1, 100)));
+                client.disconnect();
+
+                expect (waitUntil ([&] { return server.getNumLost() == 1; }));
+                expectEquals (server.getConnection (0)->numReceived.load(), 2);
+                expectEquals (server.getConnection (0)->numErrors.load(), 0);
+
+                if (InterprocessConnectionReactor::isAvailable())
+                    expect (waitUntil ([&] { return serverReactor.getNumConnections() == 0; }));
+            }
+        }
+
+        beginTest ("A peer that stops reading doesn't hold up the others");
+        {
+            // Every connection here shares the same reactor thread
+            InterprocessConnectionReactor reactor (1);
+            Server server (reactor, Connection::Mode::reply);
+
+            if (server.beginWaitingForSocket (0, "127.0.0.1"))
+            {
+                // This one asks for a big reply, but never reads it
+                StreamingSocket stalled;
+                expect (stalled.connect ("127.0.0.1", server.getBoundPort(), 2000));
+
+                auto request = createMessage (0, 100);
+                uint32 header[] = { ByteOrder::swapIfBigEndian ((uint32) 0xf2b49e2c),
+                                    ByteOrder::swapIfBigEndian ((uint32) request.getSize()) };
+
+                expect (stalled.write (header, (int) sizeof (header)) == (int) sizeof (header));
+                expect (stalled.write (request.getData(), (int) request.getSize()) == (int) request.getSize());
+
+                expect (waitUntil ([&] { return server.getNumConnections() == 1
+                                                  && server.getConnection (0)->getNumBytesWaitingToBeSent() > 0; }));
+
+                Connection client (Connection::Mode::count);
+                client.setReactor (&reactor);
+
+                if (client.connectToSocket ("127.0.0.1", server.getBoundPort(), 2000))
+                {
+                    expect (client.sendMessage (createMessage (0, 100)));
+                    expect (waitUntil ([&] { return client.numReceived == 1; }, 4000));
+                    expectEquals (client.numErrors.load(), 0);
+
+                    // Disconnecting the stalled one mustn't wait for its queue to drain
+                    auto startTime = Time::getMillisecondCounter();
+                    server.getConnection (0)->disconnect();
+                    expect (Time::getMillisecondCounter() - startTime < 1000);
+                    expectEquals ((int) server.getConnection (0)->getNumBytesWaitingToBeSent(), 0);
+
+                    client.disconnect();
+                }
+                else
+                {
+                    expect (false, "couldn't connect");
+                }
+
+                server.stop();
+                server.connections.clear();
+            }
+            else
+            {
+                expect (false, "couldn't open a listening socket");
+            }
+
+            if (InterprocessConnectionReactor::isAvailable())
+                expectEquals (reactor.getNumConnections(), 0);
+        }
+
+        if (InterprocessConnectionReactor::isAvailable())
+        {
+            expectEquals (serverReactor.getNumConnections(), 0);
+            expectEquals (clientReactor.getNumConnections(), 0);
+        }
+    }
+
+private:
+    //==============================================================================
+    // Each message starts with its index, and the rest of it is filled with a pattern
+    // that depends on the index, so that the receiver can check it arrived intact.
+    static MemoryBlock createMessage (int index, int extraSize)
+    {
+        MemoryBlock m (sizeof (int) + (size_t) extraSize);
+        auto* data = static_cast<uint8*> (m.getData());
+        memcpy (data, &index, sizeof (int));
+
+        for (int i = 0; i < extraSize; ++i)
+            data[sizeof (int) + (size_t) i] = (uint8) (index + i);
+
+        return m;
+    }
+
+    static bool isValidMessage (const MemoryBlock& m, int expectedIndex)
+    {
+        if (m.getSize() < sizeof (int))
+            return false;
+
+        auto* data = static_cast<const uint8*> (m.getData());
+        int index;
+        memcpy (&index, data, sizeof (int));
+
+        if (index != expectedIndex)
+            return false;
+
+        for (size_t i = sizeof (int); i < m.getSize(); ++i)
+            if (data[i] != (uint8) (index + (int) (i - sizeof (int))))
+                return false;
+
+        return true;
+    }
+
+    //==============================================================================
+    struct Connection  : public InterprocessConnection
+    {
+        // The server's connections echo everything, or answer each message with a much
+        // bigger one. The clients either count the messages they get, or keep sending
+        // them back so that the traffic never stops.
+        enum class Mode { echo, reply, count, pingPong };
+
+        explicit Connection (Mode m, int delay = 0)
+            : InterprocessConnection (false), mode (m), delayMs (delay) {}
+
+        ~Connection() override  { disconnect(); }
+
+        void connectionMade() override  {}
+        void connectionLost() override  { lost = true; }
+
+        void messageReceived (const MemoryBlock& message) override
+        {
+            if (mode == Mode::echo)
+            {
+                sendMessage (message);
+                return;
+            }
+
+            if (mode == Mode::reply)
+            {
+                sendMessage (createMessage (0, 16 * 1024 * 1024));
+                return;
+            }
+
+            if (delayMs > 0)
+            {
+                isBusy = true;
+                Thread::sleep (delayMs);
+                isBusy = false;
+            }
+
+            // With several messages in flight, a ping-pong connection's indexes cycle
+            // through the ones it started with.
+            auto expectedIndex = mode == Mode::count ? numReceived.load() : numReceived % 4;
+
+            if (! isValidMessage (message, expectedIndex))
+                ++numErrors;
+
+            ++numReceived;
+
+            if (mode == Mode::pingPong)
+                sendMessage (message);
+        }
+
+        bool hasMessagesToWrite() const override
+        {
+            const ScopedLock sl (queueLock);
+            return ! queue.isEmpty();
+        }
+
+        bool sendMessagesToWrite() override
+        {
+            Array<MemoryBlock> messages;
+
+            {
+                const ScopedLock sl (queueLock);
+                messages.swapWith (queue);
+            }
+
+            return sendMessages (messages);
+        }
+
+        void queueMessage (const MemoryBlock& message)
+        {
+            {
+                const ScopedLock sl (queueLock);
+                queue.add (message);
+            }
+
+            notifyMessagesToWrite();
+        }
+
+        const Mode mode;
+        const int delayMs;
+        std::atomic<int> numReceived { 0 }, numErrors { 0 };
+        std::atomic<bool> lost { false }, isBusy { false };
+
+        CriticalSection queueLock;
+        Array<MemoryBlock> queue;
+    };
+
+    struct Server  : public InterprocessConnectionServer
+    {
+        explicit Server (InterprocessConnectionReactor& r,
+                         Connection::Mode m = Connection::Mode::echo, int delay = 0)
+            : mode (m), delayMs (delay)
+        {
+            setReactor (&r);
+        }
+
+        ~Server() override  { stop(); }
+
+        InterprocessConnection* createConnectionObject() override
+        {
+            return connections.add (new Connection (mode, delayMs));
+        }
+
+        int getNumConnections() const           { return connections.size(); }
+        Connection* getConnection (int index)   { return connections[index]; }
+
+        int getNumLost() const
+        {
+            const ScopedLock sl (connections.getLock());
+            int num = 0;
+
+            for (auto* c : connections)
+                num += c->lost ? 1 : 0;
+
+            return num;
+        }
+
+        const Connection::Mode mode;
+        const int delayMs;
+        OwnedArray<Connection, CriticalSection> connections;
+    };
+
+    //==============================================================================
+    template <typename Predicate>
+    static bool waitUntil (Predicate&& predicate, int timeoutMs = 10000)
+    {
+        auto timeout = Time::getMillisecondCounter() + (uint32) timeoutMs;
+
+        while (! predicate())
+        {
+            if (Time::getMillisecondCounter() > timeout)
+                return false;
+
+            Thread::sleep (1);
+        }
+
+        return true;
+    }
+
+    static bool allReceived (const OwnedArray<Connection>& clients, int numMessages)
+    {
+        for (auto* c : clients)
+            if (c->numReceived < numMessages)
+                return false;
+
+        return true;
+    }
+
+    bool connect (Server& server, InterprocessConnectionReactor& reactor,
+                  OwnedArray<Connection>& clients, int numClients, Connection::Mode mode)
+    {
+        if (! server.beginWaitingForSocket (0, "127.0.0.1"))
+        {
+            expect (false, "couldn't open a listening socket");
+            return false;
+        }
+
+        for (int i = 0; i < numClients; ++i)
+        {
+            auto* c = clients.add (new Connection (mode));
+            c->setReactor (&reactor);
+
+            if (! c->connectToSocket ("127.0.0.1", server.getBoundPort(), 2000))
+            {
+                expect (false, "couldn't connect");
+                return false;
+            }
+        }
+
+        auto allConnected = waitUntil ([&] { return server.getNumConnections() == numClients; });
+        expect (allConnected);
+
+        if (InterprocessConnectionReactor::isAvailable())
+            expectEquals (reactor.getNumConnections(), numClients);
+
+        return allConnected;
+    }
+
+    // Connects a client that runs its own thread
+    bool connect (Server& server, Connection& client)
+    {
+        if (! server.beginWaitingForSocket (0, "127.0.0.1"))
+        {
+            expect (false, "couldn't open a listening socket");
+            return false;
+        }
+
+        if (! client.connectToSocket ("127.0.0.1", server.getBoundPort(), 2000))
+        {
+            expect (false, "couldn't connect");
+            return false;
+        }
+
+        return true;
+    }
+
+    static void disconnectAll (Server& server, OwnedArray<Connection>& clients)
+    {
+        server.stop();
+        clients.clear();
+        server.connections.clear();
+    }
+};
+
+static InterprocessConnectionReactorTests interprocessConnectionReactorTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,109 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A small set of I/O threads that can service many socket-based
+    InterprocessConnections, instead of each connection running its own thread.
+
+    Normally, each InterprocessConnection starts a thread which polls its socket.
+    If you give a group of connections a reactor with InterprocessConnection::setReactor()
+    or InterprocessConnectionServer::setReactor(), they'll be serviced by the reactor's
+    threads instead, which sleep until one of the sockets actually has something to do.
+    This saves a thread per connection, and means that incoming messages are picked up
+    as soon as they arrive rather than on the next poll.
+
+    Each connection is assigned to one of the reactor's threads when it connects, and
+    all its callbacks will be made on that thread (unless the connection was created to
+    use the message thread). Because a thread may be shared by many connections, your
+    callbacks should return quickly, and shouldn't block waiting for other connections.
+
+    Writes to a connection that's serviced by a reactor never block, so one peer that
+    stops reading can't hold up the others. Whatever its socket can't take is queued,
+    and sent when the socket becomes writable again.
+
+    The reactor uses epoll, so it's only available on Linux. On other platforms,
+    isAvailable() returns false and the connections will just run their own threads
+    as usual. Pipe-based connections always use their own threads.
+
+    The reactor must outlive all the connections that are using it.
+
+    @see InterprocessConnection, InterprocessConnectionServer
+
+    @tags{Events}
+*/
+class JUCE_API  InterprocessConnectionReactor
+{
+public:
+    //==============================================================================
+    /** Creates a reactor and starts its threads.
+
+        @param numThreads           the number of I/O threads to share the connections
+                                    between
+        @param writePollIntervalMs  if this is 0 or more, the threads also wake up at this
+                                    interval to check whether any connections have
+                                    messages to write, using
+                                    InterprocessConnection::hasMessagesToWrite(). By default
+                                    they don't poll, and only wake up when there's something
+                                    to do, so connections that use hasMessagesToWrite() must
+                                    call InterprocessConnection::notifyMessagesToWrite()
+                                    whenever they queue messages. Polling is only there for
+                                    code that can't do that
+    */
+    InterprocessConnectionReactor (int numThreads = 1, int writePollIntervalMs = -1);
+
+    /** Destructor.
+        All the connections that were using this reactor must have been disconnected
+        before it is deleted.
+    */
+    ~InterprocessConnectionReactor();
+
+    //==============================================================================
+    /** Returns true if the reactor is supported on this platform. */
+    static bool isAvailable() noexcept;
+
+    /** Returns the number of I/O threads. */
+    int getNumThreads() const noexcept;
+
+    /** Returns the number of connections that the reactor is currently servicing. */
+    int getNumConnections() const noexcept;
+
+private:
+    //==============================================================================
+    friend class InterprocessConnection;
+
+    struct IOThread;
+    OwnedArray<IOThread> threads;
+    const int writePollInterval;
+    CriticalSection lock;
+
+    bool addConnection (InterprocessConnection&);
+    void removeConnection (InterprocessConnection&);
+    void notifyMessagesToWrite (InterprocessConnection&);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (InterprocessConnectionReactor)
+};
+
+} // namespace juce
@@ -72,8 +72,15 @@ void InterprocessConnectionServer::run()
         std::unique_ptr<StreamingSocket> clientSocket (socket->waitForNextConnection());
 
         if (clientSocket != nullptr)
+        {
             if (auto* newConnection = createConnectionObject())
+            {
+                if (newConnection->getReactor() == nullptr)
+                    newConnection->setReactor (reactor);
+
                 newConnection->initialiseWithSocket (std::move (clientSocket));
+            }
+        }
     }
 }
 
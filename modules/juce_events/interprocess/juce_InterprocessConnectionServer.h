@@ -82,6 +82,16 @@ public:
     */
     int getBoundPort() const noexcept;
 
+    /** Makes the connections that this server creates use a shared reactor, rather
+        than each running its own thread.
+
+        This only applies to connections which don't already have a reactor set, and
+        the reactor must outlive all of them.
+
+        @see InterprocessConnectionReactor, InterprocessConnection::setReactor
+    */
+    void setReactor (InterprocessConnectionReactor* reactorToUse) noexcept  { reactor = reactorToUse; }
+
 protected:
     /** Creates a suitable connection object for a client process that wants to
         connect to this one.
@@ -97,6 +107,7 @@ protected:
 private:
     //==============================================================================
     std::unique_ptr<StreamingSocket> socket;
+    InterprocessConnectionReactor* reactor = nullptr;
 
     void run() override;
 
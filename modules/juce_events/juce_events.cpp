@@ -51,6 +51,13 @@
 
 #elif JUCE_LINUX
  #include <unistd.h>
+ #include <sys/epoll.h>
+ #include <sys/eventfd.h>
+#endif
+
+#if ! JUCE_WINDOWS
+ #include <poll.h>
+ #include <sys/uio.h>
 #endif
 
 //==============================================================================
@@ -65,6 +72,7 @@
 #include "timers/juce_Timer.cpp"
 #include "interprocess/juce_InterprocessConnection.cpp"
 #include "interprocess/juce_InterprocessConnectionServer.cpp"
+#include "interprocess/juce_InterprocessConnectionReactor.cpp"
 #include "interprocess/juce_ConnectedChildProcess.cpp"
 #include "interprocess/juce_NetworkServiceDiscovery.cpp"
 
@@ -86,6 +86,7 @@
 #include "timers/juce_MultiTimer.h"
 #include "interprocess/juce_InterprocessConnection.h"
 #include "interprocess/juce_InterprocessConnectionServer.h"
+#include "interprocess/juce_InterprocessConnectionReactor.h"
 #include "interprocess/juce_ConnectedChildProcess.h"
 #include "interprocess/juce_NetworkServiceDiscovery.h"
 
@@ -21,6 +21,7 @@
 */
 
 #include <poll.h>
+#include <sys/eventfd.h>
 
 enum FdType
 {
@@ -33,17 +34,22 @@ namespace juce
 {
 
 //==============================================================================
+/*  Messages can be posted from any thread without taking a lock: each post pushes
+    its message onto a lock-free list, and only the post that finds the list empty
+    signals the eventfd that wakes the message thread. The message thread then takes
+    everything that has arrived in one go, and dispatches it in order.
+*/
 class InternalMessageQueue
 {
 public:
     InternalMessageQueue()
     {
-        auto ret = ::socketpair (AF_LOCAL, SOCK_STREAM, 0, fd);
-        ignoreUnused (ret); jassert (ret == 0);
+        eventFd = ::eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+        jassert (eventFd >= 0);
 
-        auto internalQueueCb = [this] (int _fd)
+        auto internalQueueCb = [this] (int)
         {
-            if (const MessageManager::MessageBase::Ptr msg = this->popNextMessage (_fd))
+            if (const MessageManager::MessageBase::Ptr msg = this->popNextMessage())
             {
                 JUCE_TRY
                 {
@@ -55,15 +61,17 @@ public:
             return false;
         };
 
-        pfds[INTERNAL_QUEUE_FD].fd = getReadHandle();
+        pfds[INTERNAL_QUEUE_FD].fd = eventFd;
         pfds[INTERNAL_QUEUE_FD].events = POLLIN;
         readCallback[INTERNAL_QUEUE_FD].reset (new LinuxEventLoop::CallbackFunction<decltype(internalQueueCb)> (internalQueueCb));
     }
 
     ~InternalMessageQueue()
     {
-        close (getReadHandle());
-        close (getWriteHandle());
+        close (eventFd);
+
+        deleteNodes (incoming.exchange (nullptr));
+        deleteNodes (pending);
 
         clearSingletonInstance();
     }
@@ -71,18 +79,15 @@ public:
     //==============================================================================
     void postMessage (MessageManager::MessageBase* const msg) noexcept
     {
-        ScopedLock sl (lock);
-        queue.add (msg);
+        auto* node = new MessageNode { msg, incoming.load (std::memory_order_relaxed) };
 
-        const int maxBytesInSocketQueue = 128;
+        while (! incoming.compare_exchange_weak (node->next, node, std::memory_order_release, std::memory_order_relaxed))
+        {}
 
-        if (bytesInSocket < maxBytesInSocketQueue)
+        if (node->next == nullptr)
         {
-            bytesInSocket++;
-
-            ScopedUnlock ul (lock);
-            const unsigned char x = 0xff;
-            ssize_t bytesWritten = write (getWriteHandle(), &x, 1);
+            const uint64 one = 1;
+            ssize_t bytesWritten = write (eventFd, &one, sizeof (one));
             ignoreUnused (bytesWritten);
         }
     }
@@ -135,33 +140,64 @@ public:
     JUCE_DECLARE_SINGLETON_SINGLETHREADED_MINIMAL (InternalMessageQueue)
 
 private:
+    struct MessageNode
+    {
+        MessageManager::MessageBase::Ptr message;
+        MessageNode* next;
+    };
+
     CriticalSection lock;
-    ReferenceCountedArray <MessageManager::MessageBase> queue;
-    int fd[2];
-    pollfd pfds[FD_COUNT];
+    std::atomic<MessageNode*> incoming { nullptr };  // newest first, pushed by any thread
+    MessageNode* pending = nullptr;                  // oldest first, only used by the message thread
+    int eventFd = -1;
+    pollfd pfds[FD_COUNT] = {};
     std::unique_ptr<LinuxEventLoop::CallbackFunctionBase> readCallback[FD_COUNT];
     int fdCount = 1;
     int loopCount = 0;
-    int bytesInSocket = 0;
-
-    int getWriteHandle() const noexcept     { return fd[0]; }
-    int getReadHandle() const noexcept      { return fd[1]; }
 
-    MessageManager::MessageBase::Ptr popNextMessage (int _fd) noexcept
+    static void deleteNodes (MessageNode* node) noexcept
     {
-        const ScopedLock sl (lock);
+        while (node != nullptr)
+        {
+            auto* next = node->next;
+            delete node;
+            node = next;
+        }
+    }
 
-        if (bytesInSocket > 0)
+    MessageManager::MessageBase::Ptr popNextMessage() noexcept
+    {
+        if (pending == nullptr)
         {
-            --bytesInSocket;
+            auto& pfd = pfds[INTERNAL_QUEUE_FD];
+
+            if ((pfd.revents & POLLIN) == 0 && incoming.load (std::memory_order_relaxed) == nullptr)
+                return nullptr;
 
-            const ScopedUnlock ul (lock);
-            unsigned char x;
-            ssize_t numBytes = read (_fd, &x, 1);
+            pfd.revents = 0;
+
+            // The eventfd must be reset before taking the messages, so that anything
+            // posted after that point is guaranteed to signal it again.
+            uint64 counter;
+            ssize_t numBytes = read (eventFd, &counter, sizeof (counter));
             ignoreUnused (numBytes);
+
+            // Take the whole batch at once, flipping it back into the order it was posted in
+            for (auto* node = incoming.exchange (nullptr, std::memory_order_acquire); node != nullptr;)
+            {
+                auto* next = node->next;
+                node->next = pending;
+                pending = node;
+                node = next;
+            }
+
+            if (pending == nullptr)
+                return nullptr;
         }
 
-        return queue.removeAndReturn (0);
+        std::unique_ptr<MessageNode> node (pending);
+        pending = node->next;
+        return std::move (node->message);
     }
 };
 
@@ -261,5 +297,151 @@ void LinuxEventLoop::removeWindowSystemFd() noexcept
         queue->removeWindowSystemFd();
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class LinuxMessageQueueTests  : public UnitTest
+{
+public:
+    LinuxMessageQueueTests()
+        : UnitTest ("Linux message queue", UnitTestCategories::threads)
+    {}
+
+    // Only touched by the thread that's dispatching the messages, apart from numReceived
+    struct Receiver
+    {
+        Receiver (int numProducers)  { lastNumbers.insertMultiple (0, -1, numProducers); }
+
+        void receive (int producer, int number)
+        {
+            if (lastNumbers.getReference (producer) + 1 != number)
+                ++numOutOfOrder;
+
+            lastNumbers.set (producer, number);
+            ++numReceived;
+        }
+
+        Array<int> lastNumbers;
+        int numOutOfOrder = 0;
+        std::atomic<int> numReceived { 0 };
+    };
+
+    struct Producer  : public Thread
+    {
+        Producer (std::function<void (int)> postFn, std::atomic<int>& received, int num, bool waitForEachMessage)
+            : Thread ("Message producer"), post (std::move (postFn)), numReceived (received),
+              numMessages (num), waitForEach (waitForEachMessage)
+        {}
+
+        void run() override
+        {
+            Random r;
+
+            for (int i = 0; i < numMessages && ! threadShouldExit(); ++i)
+            {
+                auto numReceivedBefore = numReceived.load();
+                post (i);
+
+                if (waitForEach)
+                {
+                    // wait until the queue's been emptied, so that the next post has to wake it up again
+                    while (numReceived.load() == numReceivedBefore && ! threadShouldExit())
+                        Thread::yield();
+                }
+                else if (r.nextInt (64) == 0)
+                {
+                    Thread::sleep (r.nextInt (2));
+                }
+            }
+        }
+
+        std::function<void (int)> post;
+        std::atomic<int>& numReceived;
+        const int numMessages;
+        const bool waitForEach;
+    };
+
+    struct TestMessage  : public MessageManager::MessageBase
+    {
+        TestMessage (Receiver& r, int p, int n)  : receiver (r), producer (p), number (n) {}
+
+        void messageCallback() override    { receiver.receive (producer, number); }
+
+        Receiver& receiver;
+        const int producer, number;
+    };
+
+    void runTest() override
+    {
+        beginTest ("Messages from several threads all arrive, in the order each thread posted them");
+        runProducers (6, 20000, false);
+
+        beginTest ("Posting to an empty queue always wakes up the message thread");
+        runProducers (3, 2000, true);
+
+       #if JUCE_MODAL_LOOPS_PERMITTED
+        if (MessageManager::getInstance()->isThisTheMessageThread())
+        {
+            beginTest ("callAsync from several threads");
+
+            const int numProducers = 4, numMessages = 10000;
+            Receiver receiver (numProducers);
+            OwnedArray<Producer> producers;
+
+            for (int i = 0; i < numProducers; ++i)
+                producers.add (new Producer ([&receiver, i] (int n) { MessageManager::callAsync ([&receiver, i, n] { receiver.receive (i, n); }); },
+                                             receiver.numReceived, numMessages, false));
+
+            for (auto* p : producers)
+                p->startThread();
+
+            auto timeout = Time::getMillisecondCounter() + 30000;
+
+            while (receiver.numReceived.load() < numProducers * numMessages && Time::getMillisecondCounter() < timeout)
+                MessageManager::getInstance()->runDispatchLoopUntil (5);
+
+            for (auto* p : producers)
+                p->stopThread (5000);
+
+            expectEquals (receiver.numReceived.load(), numProducers * numMessages);
+            expectEquals (receiver.numOutOfOrder, 0);
+        }
+       #endif
+    }
+
+    // Dispatches from a queue of its own, on this thread, while the producers post to it
+    void runProducers (int numProducers, int numMessages, bool waitForEachMessage)
+    {
+        InternalMessageQueue queue;
+        Receiver receiver (numProducers);
+        OwnedArray<Producer> producers;
+
+        for (int i = 0; i < numProducers; ++i)
+            producers.add (new Producer ([&queue, &receiver, i] (int n) { queue.postMessage (new TestMessage (receiver, i, n)); },
+                                         receiver.numReceived, numMessages, waitForEachMessage));
+
+        for (auto* p : producers)
+            p->startThread();
+
+        // A lost wake-up would leave the queue waiting for the whole timeout
+        int numTimeouts = 0;
+
+        while (receiver.numReceived.load() < numProducers * numMessages && numTimeouts < 3)
+            if (! queue.dispatchNextEvent())
+                if (! queue.sleepUntilEvent (5000))
+                    ++numTimeouts;
+
+        for (auto* p : producers)
+            p->stopThread (5000);
+
+        expectEquals (numTimeouts, 0);
+        expectEquals (receiver.numReceived.load(), numProducers * numMessages);
+        expectEquals (receiver.numOutOfOrder, 0);
+    }
+};
+
+static LinuxMessageQueueTests linuxMessageQueueTests;
+
+#endif
 
 } // namespace juce
@@ -23,6 +23,16 @@
 namespace juce
 {
 
+/*  The timers are kept in a hierarchical timing wheel, so starting, stopping and
+    restarting a timer are all constant-time, and the cost of a tick doesn't depend
+    on how many timers are running.
+
+    Level 0 of the wheel has a slot for each of the next 64 milliseconds, level 1 a
+    slot for each of the following 64 blocks of 64ms, and so on. As time moves past
+    the end of each block, the next slot up is cascaded down into the finer levels,
+    and the timers in each level-0 slot are moved to a list of due timers when its
+    millisecond arrives, to be called back in a batch on the message thread.
+*/
 class Timer::TimerThread  : private Thread,
                             private DeletedAtShutdown,
                             private AsyncUpdater
@@ -32,7 +42,6 @@ public:
 
     TimerThread()  : Thread ("JUCE Timer")
     {
-        timers.reserve (32);
         triggerAsyncUpdate();
     }
 
@@ -49,17 +58,11 @@ public:
 
     void run() override
     {
-        auto lastTime = Time::getMillisecondCounter();
         ReferenceCountedObjectPtr<CallTimersMessage> messageToSend (new CallTimersMessage());
 
         while (! threadShouldExit())
         {
-            auto now = Time::getMillisecondCounter();
-            auto elapsed = (int) (now >= lastTime ? (now - lastTime)
-                                                  : (std::numeric_limits<uint32>::max() - (lastTime - now)));
-            lastTime = now;
-
-            auto timeUntilFirstTimer = getTimeUntilFirstTimer (elapsed);
+            auto timeUntilFirstTimer = getTimeUntilFirstTimer();
 
             if (timeUntilFirstTimer <= 0)
             {
@@ -95,16 +98,11 @@ public:
 
         const LockType::ScopedLockType sl (lock);
 
-        while (! timers.empty())
-        {
-            auto& first = timers.front();
+        wheel.advanceTo (Time::getMillisecondCounter());
 
-            if (first.countdownMs > 0)
-                break;
-
-            auto* timer = first.timer;
-            first.countdownMs = timer->timerPeriodMs;
-            shuffleTimerBackInQueue (0);
+        while (auto* timer = wheel.getFirstDueTimer())
+        {
+            wheel.reschedule (timer);
             notify();
 
             const LockType::ScopedUnlockType ul (lock);
@@ -156,148 +154,238 @@ public:
             instance->resetTimerCounter (tim);
     }
 
-    static TimerThread* instance;
-    static LockType lock;
-
-private:
-    struct TimerCountdown
+    //==============================================================================
+    // The wheel itself doesn't know about the thread or the clock, so that the tests
+    // can drive it with whatever times they like.
+    class Wheel
     {
-        Timer* timer;
-        int countdownMs;
-    };
-
-    std::vector<TimerCountdown> timers;
+    public:
+        explicit Wheel (uint32 now) noexcept  : nextTick (now) {}
 
-    WaitableEvent callbackArrived;
+        void schedule (Timer* t, uint32 now) noexcept
+        {
+            advanceTo (now);
+            insert (t, getCurrentTime() + (uint32) t->timerPeriodMs);
+        }
 
-    struct CallTimersMessage  : public MessageManager::MessageBase
-    {
-        CallTimersMessage() {}
+        void remove (Timer* t) noexcept
+        {
+            removeFromList (t);
+        }
 
-        void messageCallback() override
+        // Moves a timer that's about to be called back to the slot for its next callback
+        void reschedule (Timer* t) noexcept
         {
-            if (instance != nullptr)
-                instance->callTimers();
+            removeFromList (t);
+            insert (t, getCurrentTime() + (uint32) t->timerPeriodMs);
         }
-    };
 
-    //==============================================================================
-    void addTimer (Timer* t)
-    {
-        // Trying to add a timer that's already here - shouldn't get to this point,
-        // so if you get this assertion, let me know!
-        jassert (std::find_if (timers.begin(), timers.end(),
-                               [t](TimerCountdown i) { return i.timer == t; }) == timers.end());
+        Timer* getFirstDueTimer() const noexcept    { return lists[dueList].head; }
 
-        auto pos = timers.size();
+        void advanceTo (uint32 now) noexcept
+        {
+            while ((int32) (now - nextTick) >= 0)
+            {
+                auto slot = (int) (nextTick & (numSlots - 1));
 
-        timers.push_back ({ t, t->timerPeriodMs });
-        t->positionInQueue = pos;
-        shuffleTimerForwardInQueue (pos);
-        notify();
-    }
+                if (slot == 0)
+                    for (int level = 1; level < numLevels && cascade (level) == 0; ++level)
+                    {}
 
-    void removeTimer (Timer* t)
-    {
-        auto pos = t->positionInQueue;
-        auto lastIndex = timers.size() - 1;
+                while (auto* t = lists[slot].head)
+                {
+                    removeFromList (t);
+                    appendToList (t, dueList);
+                }
+
+                ++nextTick;
+
+                // If nothing's going to happen until the end of a block, skip straight to it
+                if (numTimersInLevel[0] == 0)
+                {
+                    int level = 1;
 
-        jassert (pos <= lastIndex);
-        jassert (timers[pos].timer == t);
+                    while (level < numLevels && numTimersInLevel[level] == 0)
+                        ++level;
 
-        for (auto i = pos; i < lastIndex; ++i)
+                    if (level == numLevels)
+                    {
+                        nextTick = now + 1;
+                        break;
+                    }
+
+                    auto blockSize = (uint32) 1 << (slotBits * level);
+                    auto nextBlock = (nextTick + blockSize - 1) & ~(blockSize - 1);
+
+                    nextTick = (int32) (nextBlock - (now + 1)) > 0 ? now + 1 : nextBlock;
+                }
+            }
+        }
+
+        int getTimeUntilFirstTimer (uint32 now) noexcept
         {
-            timers[i] = timers[i + 1];
-            timers[i].timer->positionInQueue = i;
+            advanceTo (now);
+
+            if (lists[dueList].head != nullptr)
+                return 0;
+
+            if (std::all_of (std::begin (numTimersInLevel), std::end (numTimersInLevel), [] (int n) { return n == 0; }))
+                return 1000;
+
+            // The slots for the next block haven't been cascaded down yet, so anything in
+            // them could be due as soon as the clock moves on
+            if ((nextTick & (numSlots - 1)) == 0)
+                return 1;
+
+            // Anything in the higher levels can't be due before the end of the current block
+            for (auto tick = nextTick;; ++tick)
+                if (lists[tick & (numSlots - 1)].head != nullptr || (tick & (numSlots - 1)) == numSlots - 1)
+                    return (int) (tick - getCurrentTime());
         }
 
-        timers.pop_back();
-    }
+    private:
+        struct TimerList
+        {
+            Timer* head = nullptr;
+            Timer* tail = nullptr;
+        };
 
-    void resetTimerCounter (Timer* t) noexcept
-    {
-        auto pos = t->positionInQueue;
+        static constexpr int slotBits = 6;
+        static constexpr int numSlots = 1 << slotBits;
+        static constexpr int numLevels = 6; // enough levels to cover any 32-bit delay
+        static constexpr int dueList = numLevels * numSlots;
 
-        jassert (pos < timers.size());
-        jassert (timers[pos].timer == t);
+        TimerList lists[dueList + 1];
+        int numTimersInLevel[numLevels] = {};
+        uint32 nextTick; // the first millisecond that hasn't been processed yet
 
-        auto lastCountdown = timers[pos].countdownMs;
-        auto newCountdown = t->timerPeriodMs;
+        uint32 getCurrentTime() const noexcept      { return nextTick - 1; }
 
-        if (newCountdown != lastCountdown)
+        void appendToList (Timer* t, int index) noexcept
         {
-            timers[pos].countdownMs = newCountdown;
+            auto& list = lists[index];
+
+            t->listIndex = index;
+            t->previousInList = list.tail;
+            t->nextInList = nullptr;
 
-            if (newCountdown > lastCountdown)
-                shuffleTimerBackInQueue (pos);
+            if (list.tail != nullptr)
+                list.tail->nextInList = t;
             else
-                shuffleTimerForwardInQueue (pos);
+                list.head = t;
 
-            notify();
-        }
-    }
+            list.tail = t;
 
-    void shuffleTimerBackInQueue (size_t pos)
-    {
-        auto numTimers = timers.size();
+            if (index < dueList)
+                ++numTimersInLevel[index / numSlots];
+        }
 
-        if (pos < numTimers - 1)
+        void removeFromList (Timer* t) noexcept
         {
-            auto t = timers[pos];
+            auto& list = lists[t->listIndex];
 
-            for (;;)
-            {
-                auto next = pos + 1;
+            if (t->previousInList != nullptr)
+                t->previousInList->nextInList = t->nextInList;
+            else
+                list.head = t->nextInList;
 
-                if (next == numTimers || timers[next].countdownMs >= t.countdownMs)
-                    break;
+            if (t->nextInList != nullptr)
+                t->nextInList->previousInList = t->previousInList;
+            else
+                list.tail = t->previousInList;
 
-                timers[pos] = timers[next];
-                timers[pos].timer->positionInQueue = pos;
+            if (t->listIndex < dueList)
+                --numTimersInLevel[t->listIndex / numSlots];
 
-                ++pos;
-            }
+            t->listIndex = -1;
+            t->previousInList = nullptr;
+            t->nextInList = nullptr;
+        }
 
-            timers[pos] = t;
-            t.timer->positionInQueue = pos;
+        void insert (Timer* t, uint32 due) noexcept
+        {
+            if ((int32) (due - nextTick) < 0)
+                due = nextTick;
+
+            t->dueTime = due;
+
+            auto delta = due - nextTick;
+            int level = 0;
+
+            while (level < numLevels - 1 && delta >= (uint32) 1 << (slotBits * (level + 1)))
+                ++level;
+
+            appendToList (t, level * numSlots + (int) ((due >> (slotBits * level)) & (numSlots - 1)));
         }
-    }
 
-    void shuffleTimerForwardInQueue (size_t pos)
-    {
-        if (pos > 0)
+        // Re-inserts the timers from a slot into the finer levels, returning the slot's index.
+        int cascade (int level)
         {
-            auto t = timers[pos];
+            auto slot = (int) ((nextTick >> (slotBits * level)) & (numSlots - 1));
+            auto& list = lists[level * numSlots + slot];
 
-            while (pos > 0)
+            while (auto* t = list.head)
             {
-                auto& prev = timers[(size_t) pos - 1];
+                removeFromList (t);
+                insert (t, t->dueTime);
+            }
 
-                if (prev.countdownMs <= t.countdownMs)
-                    break;
+            return slot;
+        }
 
-                timers[pos] = prev;
-                timers[pos].timer->positionInQueue = pos;
+        JUCE_DECLARE_NON_COPYABLE (Wheel)
+    };
 
-                --pos;
-            }
+    static TimerThread* instance;
+    static LockType lock;
 
-            timers[pos] = t;
-            t.timer->positionInQueue = pos;
+private:
+    WaitableEvent callbackArrived;
+    Wheel wheel { Time::getMillisecondCounter() };
+
+    struct CallTimersMessage  : public MessageManager::MessageBase
+    {
+        CallTimersMessage() {}
+
+        void messageCallback() override
+        {
+            if (instance != nullptr)
+                instance->callTimers();
         }
+    };
+
+    //==============================================================================
+    void addTimer (Timer* t)
+    {
+        // Trying to add a timer that's already here - shouldn't get to this point,
+        // so if you get this assertion, let me know!
+        jassert (t->listIndex < 0);
+
+        wheel.schedule (t, Time::getMillisecondCounter());
+        notify();
     }
 
-    int getTimeUntilFirstTimer (int numMillisecsElapsed)
+    void removeTimer (Timer* t)
     {
-        const LockType::ScopedLockType sl (lock);
+        jassert (t->listIndex >= 0);
+
+        wheel.remove (t);
+    }
+
+    void resetTimerCounter (Timer* t) noexcept
+    {
+        jassert (t->listIndex >= 0);
 
-        if (timers.empty())
-            return 1000;
+        wheel.remove (t);
+        wheel.schedule (t, Time::getMillisecondCounter());
+        notify();
+    }
 
-        for (auto& t : timers)
-            t.countdownMs -= numMillisecsElapsed;
+    int getTimeUntilFirstTimer()
+    {
+        const LockType::ScopedLockType sl (lock);
 
-        return timers.front().countdownMs;
+        return wheel.getTimeUntilFirstTimer (Time::getMillisecondCounter());
     }
 
     void handleAsyncUpdate() override
@@ -386,4 +474,265 @@ void JUCE_CALLTYPE Timer::callAfterDelay (int milliseconds, std::function<void()
     new LambdaInvoker (milliseconds, f);
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct TimerTests  : public UnitTest
+{
+    TimerTests()
+        : UnitTest ("Timer", UnitTestCategories::time)
+    {}
+
+    using Wheel = Timer::TimerThread::Wheel;
+
+    // A timer that's only ever added to a test's own wheel, never to the real timer thread
+    struct WheelTimer  : public Timer
+    {
+        WheelTimer (Wheel& w)  : wheel (w) {}
+        ~WheelTimer() override  { stop(); }
+
+        void start (int period, uint32 now)
+        {
+            stop();
+            timerPeriodMs = period;
+            wheel.schedule (this, now);
+            expectedTime = now + (uint32) period;
+        }
+
+        void stop()
+        {
+            if (listIndex >= 0)
+                wheel.remove (this);
+
+            timerPeriodMs = 0;
+        }
+
+        bool isRunning() const noexcept     { return timerPeriodMs > 0; }
+        void timerCallback() override       {}
+
+        Wheel& wheel;
+        uint32 expectedTime = 0;
+        int numCallbacks = 0;
+    };
+
+    // Does the same as TimerThread::callTimers(), but with a made-up clock
+    template <typename Callback>
+    static void callDueTimers (Wheel& wheel, uint32 now, Callback&& callback)
+    {
+        wheel.advanceTo (now);
+
+        while (auto* t = wheel.getFirstDueTimer())
+        {
+            wheel.reschedule (t);
+            callback (*static_cast<WheelTimer*> (t));
+        }
+    }
+
+    void runTest() override
+    {
+        Random r (0x5678);
+
+        beginTest ("Timers are due exactly when their period has elapsed, across the boundaries between levels");
+        {
+            for (auto start : { 0u, 1u, 63u, 64u, 4095u, 4096u, 262143u, 262144u, 0x7fffffffu, 0xffffffc0u, 0xfffffffeu })
+            {
+                for (auto period : { 1, 2, 63, 64, 65, 127, 128, 4095, 4096, 4097, 262143, 262144, 262145,
+                                     16777215, 16777216, 16777217, 1 << 30, 0x7fffffff })
+                {
+                    auto due = start + (uint32) period;
+
+                    {
+                        Wheel wheel (start);
+                        WheelTimer timer (wheel);
+                        timer.start (period, start);
+
+                        wheel.advanceTo (due - 1);
+                        expect (wheel.getFirstDueTimer() == nullptr);
+                        wheel.advanceTo (due);
+                        expect (wheel.getFirstDueTimer() == &timer);
+                    }
+
+                    // the same again, but moving the clock along in uneven steps
+                    {
+                        Wheel wheel (start);
+                        WheelTimer timer (wheel);
+                        timer.start (period, start);
+
+                        for (auto now = start; now != due - 1;)
+                        {
+                            now += jmin ((uint32) r.nextInt (period / 7 + 1) + 1, due - 1 - now);
+                            wheel.advanceTo (now);
+                            expect (wheel.getFirstDueTimer() == nullptr);
+                        }
+
+                        wheel.advanceTo (due);
+                        expect (wheel.getFirstDueTimer() == &timer);
+                    }
+
+                    // the timer thread must never sleep past a timer's due time
+                    if (period <= 262145)
+                    {
+                        Wheel wheel (start);
+                        WheelTimer timer (wheel);
+                        timer.start (period, start);
+
+                        auto now = start;
+
+                        while (now != due)
+                        {
+                            auto wait = wheel.getTimeUntilFirstTimer (now);
+                            expect (wait > 0 && (uint32) wait <= due - now);
+
+                            if (wait <= 0 || (uint32) wait > due - now)
+                                break;
+
+                            now += (uint32) wait;
+                        }
+
+                        expectEquals (wheel.getTimeUntilFirstTimer (now), 0);
+                    }
+                }
+            }
+        }
+
+        beginTest ("Timers can be started and stopped from inside a callback");
+        {
+            uint32 now = 0xffffff00;
+            Wheel wheel (now);
+            WheelTimer stopsItself (wheel), stopsAnother (wheel), stopped (wheel), keptWaiting (wheel), startedLater (wheel);
+
+            stopsItself.start (10, now);
+            stopsAnother.start (7, now);
+            stopped.start (7, now);     // due at the same time as stopsAnother, but after it in the list
+            keptWaiting.start (20, now);
+
+            for (int i = 0; i < 200; ++i)
+            {
+                callDueTimers (wheel, ++now, [&] (WheelTimer& t)
+                {
+                    ++t.numCallbacks;
+
+                    if (&t == &stopsItself)
+                    {
+                        if (t.numCallbacks == 1)
+                            startedLater.start (15, now);
+
+                        if (t.numCallbacks == 3)
+                            t.stop();
+                    }
+                    else if (&t == &stopsAnother)
+                    {
+                        stopped.stop();
+                        keptWaiting.start (20, now);
+                    }
+                });
+            }
+
+            expectEquals (stopsItself.numCallbacks, 3);
+            expectEquals (stopsAnother.numCallbacks, 200 / 7);
+            expectEquals (stopped.numCallbacks, 0);
+            expectEquals (keptWaiting.numCallbacks, 0);
+            expectEquals (startedLater.numCallbacks, (200 - 10) / 15);
+        }
+
+        beginTest ("Changing a timer's interval");
+        {
+            uint32 now = 4000;
+            Wheel wheel (now);
+            WheelTimer changesItself (wheel), changedByOther (wheel);
+            Array<uint32> times;
+
+            changesItself.start (10, now);
+            changedByOther.start (1000, now);
+
+            for (int i = 0; i < 100; ++i)
+            {
+                callDueTimers (wheel, ++now, [&] (WheelTimer& t)
+                {
+                    if (&t == &changesItself)
+                    {
+                        times.add (now - 4000);
+
+                        if (times.size() == 3)
+                            t.start (25, now);
+
+                        if (times.size() == 4)
+                            changedByOther.start (3, now);
+                    }
+                    else
+                    {
+                        ++t.numCallbacks;
+                    }
+                });
+            }
+
+            expect (times == Array<uint32> (10, 20, 30, 55, 80));
+            expectEquals (changedByOther.numCallbacks, (100 - 55) / 3);
+        }
+
+        beginTest ("Ten thousand timers being started, stopped and changed at random");
+        {
+            uint32 now = 0xffff8000;    // so that the clock wraps around while the test is running
+            Wheel wheel (now);
+            OwnedArray<WheelTimer> timers;
+
+            auto randomPeriod = [&r] { return (int) std::pow (10.0, 1.2 + r.nextDouble() * 4.1); };
+
+            for (int i = 0; i < 10000; ++i)
+                timers.add (new WheelTimer (wheel))->start (randomPeriod(), now);
+
+            int numLate = 0, numEarly = 0, numStoppedCalled = 0, numCallbacks = 0;
+
+            for (auto end = now + 60000; (int32) (end - now) > 0;)
+            {
+                auto previous = now;
+                now += (uint32) r.nextInt (50) + 1;
+
+                callDueTimers (wheel, now, [&] (WheelTimer& t)
+                {
+                    ++numCallbacks;
+
+                    if (! t.isRunning())                                    ++numStoppedCalled;
+                    else if ((int32) (now - t.expectedTime) < 0)            ++numEarly;
+                    else if ((int32) (previous - t.expectedTime) >= 0)      ++numLate;
+
+                    t.expectedTime = now + (uint32) t.timerPeriodMs;
+
+                    switch (r.nextInt (100))
+                    {
+                        case 0:  t.stop(); break;
+                        case 1:  timers.getUnchecked (r.nextInt (timers.size()))->stop(); break;
+                        case 2:  timers.getUnchecked (r.nextInt (timers.size()))->start (randomPeriod(), now); break;
+                        case 3:  t.start (randomPeriod(), now); break;
+                        default: break;
+                    }
+                });
+
+                // any timer that should have been called by now must have been
+                for (auto* t : timers)
+                    if (t->isRunning() && (int32) (now - t->expectedTime) >= 0)
+                        ++numLate;
+
+                // and keep a few of the stopped ones going
+                for (int i = 0; i < 5; ++i)
+                {
+                    auto* t = timers.getUnchecked (r.nextInt (timers.size()));
+
+                    if (! t->isRunning())
+                        t->start (randomPeriod(), now);
+                }
+            }
+
+            expect (numCallbacks > 100000);
+            expectEquals (numLate, 0);
+            expectEquals (numEarly, 0);
+            expectEquals (numStoppedCalled, 0);
+        }
+    }
+};
+
+static TimerTests timerTests;
+
+#endif
+
 } // namespace juce
@@ -128,7 +128,11 @@ public:
 private:
     class TimerThread;
     friend class TimerThread;
-    size_t positionInQueue = (size_t) -1;
+    friend struct TimerTests;
+    Timer* previousInList = nullptr;
+    Timer* nextInList = nullptr;
+    int listIndex = -1;
+    uint32 dueTime = 0;
     int timerPeriodMs = 0;
 
     Timer& operator= (const Timer&) = delete;
@@ -0,0 +1,539 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+class LowLevelGraphicsTiledSoftwareRenderer::TileContext  : public RenderingHelpers::StackBasedLowLevelGraphicsContext<RenderingHelpers::SoftwareRendererSavedState>
+{
+public:
+    TileContext (const Image& image, Point<int> origin, const RectangleList<int>& clip)
+        : RenderingHelpers::StackBasedLowLevelGraphicsContext<RenderingHelpers::SoftwareRendererSavedState>
+            (new RenderingHelpers::SoftwareRendererSavedState (image, clip, origin))
+    {
+    }
+
+    RenderingHelpers::SoftwareRendererSavedState& getState() const noexcept    { return *stack; }
+
+    /** Tracks the state changes made by beginning a transparency layer, without
+        actually allocating an image for it.
+    */
+    void beginTransparencyLayerWithoutImage()
+    {
+        stack.save();
+
+        auto& state = *stack;
+
+        if (state.clip != nullptr)
+        {
+            auto layerBounds = state.clip->getClipBounds();
+
+            state.transform.moveOriginInDeviceSpace (-layerBounds.getPosition());
+            state.cloneClipIfMultiplyReferenced();
+            state.clip->translate (-layerBounds.getPosition());
+        }
+    }
+
+    void endTransparencyLayerWithoutImage()
+    {
+        stack.restore();
+    }
+};
+
+//==============================================================================
+struct LowLevelGraphicsTiledSoftwareRenderer::Frame
+{
+    Frame (const Image& im, Point<int> o, const RectangleList<int>& clip)
+        : image (im), origin (o), initialClip (clip)
+    {
+    }
+
+    void renderTiles()
+    {
+        for (;;)
+        {
+            auto index = nextTile++;
+
+            if (index >= tiles.size())
+                break;
+
+            renderTile (tiles.getReference (index));
+
+            if (++numTilesFinished == tiles.size())
+                finished.signal();
+        }
+    }
+
+    void renderTile (Rectangle<int> area)
+    {
+        RectangleList<int> tileClip (initialClip);
+        tileClip.clipTo (area);
+
+        if (! tileClip.isEmpty())
+        {
+            TileContext context (image, origin, tileClip);
+
+            for (auto& op : operations)
+                op (context);
+        }
+    }
+
+    Image image;
+    Point<int> origin;
+    RectangleList<int> initialClip;
+    std::vector<Operation> operations;
+    Array<Rectangle<int>> tiles;
+    std::atomic<int> nextTile { 0 }, numTilesFinished { 0 };
+    WaitableEvent finished;
+
+    JUCE_DECLARE_NON_COPYABLE (Frame)
+};
+
+//==============================================================================
+LowLevelGraphicsTiledSoftwareRenderer::LowLevelGraphicsTiledSoftwareRenderer (const Image& image, ThreadPool& poolToUse)
+    : LowLevelGraphicsTiledSoftwareRenderer (image, {}, image.getBounds(), poolToUse)
+{
+}
+
+LowLevelGraphicsTiledSoftwareRenderer::LowLevelGraphicsTiledSoftwareRenderer (const Image& image, Point<int> origin,
+                                                                              const RectangleList<int>& initialClip,
+                                                                              ThreadPool& poolToUse)
+    : pool (poolToUse),
+      frame (std::make_shared<Frame> (image, origin, initialClip)),
+      shadowContext (new TileContext (image, origin, initialClip))
+{
+}
+
+LowLevelGraphicsTiledSoftwareRenderer::~LowLevelGraphicsTiledSoftwareRenderer()
+{
+    renderFrame();
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::addOperation (Operation op)
+{
+    frame->operations.push_back (std::move (op));
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::renderFrame()
+{
+    if (frame->operations.empty())
+        return;
+
+    auto area = frame->initialClip.getBounds();
+    const int minTileHeight = 64;
+    auto numTiles = jlimit (1, (pool.getNumThreads() + 1) * 2, area.getHeight() / minTileHeight);
+
+    for (int i = 0; i < numTiles; ++i)
+    {
+        auto y1 = area.getY() + (area.getHeight() * i) / numTiles;
+        auto y2 = area.getY() + (area.getHeight() * (i + 1)) / numTiles;
+        frame->tiles.add (area.withTop (y1).withBottom (y2));
+    }
+
+    if (numTiles > 1)
+    {
+        // The jobs keep the frame alive, so any that only get started after we've
+        // finished will just find that there's nothing left to do.
+        auto f = frame;
+        Array<std::function<void()>> jobs;
+
+        for (int i = jmin (pool.getNumThreads(), numTiles - 1); --i >= 0;)
+            jobs.add ([f] { f->renderTiles(); });
+
+        pool.addJobs (jobs);
+    }
+
+    frame->renderTiles();
+
+    while (frame->numTilesFinished.load() < numTiles)
+        frame->finished.wait();
+}
+
+//==============================================================================
+bool LowLevelGraphicsTiledSoftwareRenderer::isVectorDevice() const                   { return false; }
+float LowLevelGraphicsTiledSoftwareRenderer::getPhysicalPixelScaleFactor()           { return shadowContext->getPhysicalPixelScaleFactor(); }
+Rectangle<int> LowLevelGraphicsTiledSoftwareRenderer::getClipBounds() const          { return shadowContext->getClipBounds(); }
+bool LowLevelGraphicsTiledSoftwareRenderer::isClipEmpty() const                      { return shadowContext->isClipEmpty(); }
+bool LowLevelGraphicsTiledSoftwareRenderer::clipRegionIntersects (const Rectangle<int>& r)  { return shadowContext->clipRegionIntersects (r); }
+const Font& LowLevelGraphicsTiledSoftwareRenderer::getFont()                         { return shadowContext->getFont(); }
+
+void LowLevelGraphicsTiledSoftwareRenderer::setOrigin (Point<int> o)
+{
+    shadowContext->setOrigin (o);
+    addOperation ([o] (TileContext& c) { c.setOrigin (o); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::addTransform (const AffineTransform& t)
+{
+    shadowContext->addTransform (t);
+    addOperation ([t] (TileContext& c) { c.addTransform (t); });
+}
+
+bool LowLevelGraphicsTiledSoftwareRenderer::clipToRectangle (const Rectangle<int>& r)
+{
+    addOperation ([r] (TileContext& c) { c.clipToRectangle (r); });
+    return shadowContext->clipToRectangle (r);
+}
+
+bool LowLevelGraphicsTiledSoftwareRenderer::clipToRectangleList (const RectangleList<int>& r)
+{
+    addOperation ([r] (TileContext& c) { c.clipToRectangleList (r); });
+    return shadowContext->clipToRectangleList (r);
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::excludeClipRectangle (const Rectangle<int>& r)
+{
+    shadowContext->excludeClipRectangle (r);
+    addOperation ([r] (TileContext& c) { c.excludeClipRectangle (r); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::clipToPath (const Path& path, const AffineTransform& t)
+{
+    shadowContext->clipToPath (path, t);
+    addOperation ([path, t] (TileContext& c) { c.clipToPath (path, t); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::clipToImageAlpha (const Image& im, const AffineTransform& t)
+{
+    shadowContext->clipToImageAlpha (im, t);
+    addOperation ([im, t] (TileContext& c) { c.clipToImageAlpha (im, t); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::saveState()
+{
+    shadowContext->saveState();
+    addOperation ([] (TileContext& c) { c.saveState(); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::restoreState()
+{
+    shadowContext->restoreState();
+    addOperation ([] (TileContext& c) { c.restoreState(); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::beginTransparencyLayer (float opacity)
+{
+    // Each tile's layer only covers the part of the layer's clip that falls in that
+    // tile, so no tile needs an image for the whole layer.
+    shadowContext->beginTransparencyLayerWithoutImage();
+    addOperation ([opacity] (TileContext& c) { c.beginTransparencyLayer (opacity); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::endTransparencyLayer()
+{
+    shadowContext->endTransparencyLayerWithoutImage();
+    addOperation ([] (TileContext& c) { c.endTransparencyLayer(); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setFill (const FillType& fillType)
+{
+    shadowContext->setFill (fillType);
+    addOperation ([fillType] (TileContext& c) { c.setFill (fillType); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setOpacity (float opacity)
+{
+    shadowContext->setOpacity (opacity);
+    addOperation ([opacity] (TileContext& c) { c.setOpacity (opacity); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setInterpolationQuality (Graphics::ResamplingQuality quality)
+{
+    shadowContext->setInterpolationQuality (quality);
+    addOperation ([quality] (TileContext& c) { c.setInterpolationQuality (quality); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::fillRect (const Rectangle<int>& r, bool replaceExistingContents)
+{
+    addOperation ([r, replaceExistingContents] (TileContext& c) { c.fillRect (r, replaceExistingContents); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::fillRect (const Rectangle<float>& r)
+{
+    addOperation ([r] (TileContext& c) { c.fillRect (r); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::fillRectList (const RectangleList<float>& list)
+{
+    addOperation ([list] (TileContext& c) { c.fillRectList (list); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::fillPath (const Path& path, const AffineTransform& t)
+{
+    addOperation ([path, t] (TileContext& c) { c.fillPath (path, t); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::drawImage (const Image& im, const AffineTransform& t)
+{
+    addOperation ([im, t] (TileContext& c) { c.drawImage (im, t); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::drawLine (const Line<float>& line)
+{
+    addOperation ([line] (TileContext& c) { c.drawLine (line); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setFont (const Font& newFont)
+{
+    shadowContext->setFont (newFont);
+    addOperation ([newFont] (TileContext& c) { c.setFont (newFont); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::drawGlyph (int glyphNumber, const AffineTransform& t)
+{
+    // Typefaces aren't thread-safe, so the glyph's outline is looked up here rather
+    // than by the tiles.
+    if (! shadowContext->isClipEmpty())
+    {
+        auto glyph = shadowContext->getState().prepareGlyph (glyphNumber, t);
+        addOperation ([glyph] (TileContext& c) { c.getState().drawPreparedGlyph (glyph); });
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class LowLevelGraphicsTiledSoftwareRendererTests  : public UnitTest
+{
+public:
+    LowLevelGraphicsTiledSoftwareRendererTests()
+        : UnitTest ("LowLevelGraphicsTiledSoftwareRenderer", UnitTestCategories::gui)
+    {}
+
+    static void drawScene (Graphics& g, int w, int h)
+    {
+        Random r (0x1234);
+
+        g.fillAll (Colours::darkgrey);
+
+        ColourGradient gradient (Colours::red, 0, 0, Colours::blue, (float) w, (float) h, false);
+        gradient.addColour (0.5, Colours::yellow.withAlpha (0.5f));
+        g.setGradientFill (gradient);
+        g.fillRect (w / 10, h / 10, w / 2, h / 3);
+
+        for (int i = 0; i < 40; ++i)
+        {
+            Path star;
+            star.addStar ({ r.nextFloat() * (float) w, r.nextFloat() * (float) h }, 5 + r.nextInt (6),
+                          5.0f + r.nextFloat() * 20.0f, 20.0f + r.nextFloat() * 80.0f, r.nextFloat());
+
+            g.setColour (Colour (r.nextInt()).withAlpha (0.6f));
+            g.fillPath (star, AffineTransform::rotation (r.nextFloat() * 0.2f, (float) w * 0.5f, (float) h * 0.5f));
+            g.setColour (Colours::white);
+            g.strokePath (star, PathStrokeType (2.5f));
+        }
+
+        Image image (Image::ARGB, 100, 60, true);
+
+        {
+            Graphics ig (image);
+            ig.setGradientFill (ColourGradient (Colours::green, 0, 0, Colours::transparentBlack, 100, 60, true));
+            ig.fillEllipse (0, 0, 100, 60);
+        }
+
+        for (int i = 0; i < 10; ++i)
+        {
+            g.setOpacity (0.8f);
+            g.drawImageTransformed (image, AffineTransform::rotation (r.nextFloat() * 6.0f)
+                                                           .scaled (0.5f + r.nextFloat() * 3.0f)
+                                                           .translated (r.nextFloat() * (float) w, r.nextFloat() * (float) h));
+        }
+
+        for (int i = 0; i < 20; ++i)
+        {
+            g.setColour (Colour (r.nextInt()).withAlpha (1.0f));
+            g.setFont (8.0f + r.nextFloat() * 30.0f);
+            g.drawText ("The quick brown fox jumps over the lazy dog", r.nextInt (w), r.nextInt (h), 800, 40, Justification::left);
+        }
+
+        {
+            Graphics::ScopedSaveState state (g);
+            g.addTransform (AffineTransform::rotation (0.3f, (float) w * 0.5f, (float) h * 0.5f));
+            g.setFont (Font (40.0f, Font::bold));
+            g.setColour (Colours::orange);
+            g.drawText ("Rotated text", w / 4, h / 2, w, 60, Justification::left);
+        }
+
+        {
+            Graphics::ScopedSaveState state (g);
+
+            Path clip;
+            clip.addEllipse ((float) w * 0.3f, (float) h * 0.2f, (float) w * 0.4f, (float) h * 0.6f);
+            g.reduceClipRegion (clip);
+
+            g.beginTransparencyLayer (0.5f);
+            g.setTiledImageFill (image, 13, 7, 1.0f);
+            g.fillRect (0, 0, w, h);
+            g.setColour (Colours::cyan);
+
+            for (int i = 0; i < 20; ++i)
+                g.drawLine (r.nextFloat() * (float) w, r.nextFloat() * (float) h,
+                            r.nextFloat() * (float) w, r.nextFloat() * (float) h, 7.0f);
+
+            g.endTransparencyLayer();
+        }
+
+        g.excludeClipRegion ({ w / 2, h / 2, 50, 50 });
+
+        RectangleList<float> rectangles;
+
+        for (int i = 0; i < 40; ++i)
+            rectangles.addWithoutMerging ({ r.nextFloat() * (float) w, r.nextFloat() * (float) h, 30.5f, 20.25f });
+
+        g.setColour (Colours::pink.withAlpha (0.7f));
+        g.fillRectList (rectangles);
+    }
+
+    // Nested layers, drawn through a rotation inside a path clip
+    static void drawLayers (Graphics& g, int w, int h)
+    {
+        Random r (0x4321);
+
+        g.fillAll (Colours::white);
+        g.addTransform (AffineTransform::rotation (-0.4f, (float) w * 0.5f, (float) h * 0.5f));
+
+        Path clip;
+        clip.addEllipse ((float) w * 0.1f, (float) h * 0.1f, (float) w * 0.8f, (float) h * 0.8f);
+        g.reduceClipRegion (clip);
+
+        g.beginTransparencyLayer (0.7f);
+        g.setGradientFill (ColourGradient (Colours::magenta, (float) w * 0.3f, 0, Colours::lime, (float) w * 0.7f, (float) h, false));
+        g.fillEllipse ((float) w * 0.2f, (float) h * 0.25f, (float) w * 0.6f, (float) h * 0.5f);
+
+        {
+            Graphics::ScopedSaveState state (g);
+            g.reduceClipRegion (w / 4, h / 3, w / 2, h / 2);
+            g.beginTransparencyLayer (0.6f);
+            g.setColour (Colours::black);
+
+            for (int i = 0; i < 20; ++i)
+                g.drawLine (r.nextFloat() * (float) w, r.nextFloat() * (float) h,
+                            r.nextFloat() * (float) w, r.nextFloat() * (float) h, 3.3f);
+
+            g.endTransparencyLayer();
+        }
+
+        g.endTransparencyLayer();
+    }
+
+    static int countDifferentRows (const Image& a, const Image& b)
+    {
+        const Image::BitmapData dataA (a, Image::BitmapData::readOnly);
+        const Image::BitmapData dataB (b, Image::BitmapData::readOnly);
+        int numDifferent = 0;
+
+        for (int y = 0; y < a.getHeight(); ++y)
+            if (memcmp (dataA.getLinePointer (y), dataB.getLinePointer (y), (size_t) (a.getWidth() * dataA.pixelStride)) != 0)
+                ++numDifferent;
+
+        return numDifferent;
+    }
+
+    static int getLargestDifference (const Image& a, const Image& b)
+    {
+        int largest = 0;
+
+        for (int y = 0; y < a.getHeight(); ++y)
+        {
+            for (int x = 0; x < a.getWidth(); ++x)
+            {
+                auto ca = a.getPixelAt (x, y), cb = b.getPixelAt (x, y);
+
+                largest = jmax (largest, std::abs (ca.getRed()   - cb.getRed()),
+                                         std::abs (ca.getGreen() - cb.getGreen()),
+                                         std::abs (ca.getBlue()  - cb.getBlue()));
+            }
+        }
+
+        return largest;
+    }
+
+    template <typename DrawFn>
+    static void render (Image& expected, Image& actual, Point<int> origin, const RectangleList<int>& clip,
+                        ThreadPool& pool, DrawFn&& draw)
+    {
+        {
+            LowLevelGraphicsSoftwareRenderer context (expected, origin, clip);
+            Graphics g (context);
+            draw (g, expected.getWidth(), expected.getHeight());
+        }
+
+        {
+            LowLevelGraphicsTiledSoftwareRenderer context (actual, origin, clip, pool);
+            Graphics g (context);
+            draw (g, actual.getWidth(), actual.getHeight());
+        }
+    }
+
+    void runTest() override
+    {
+        const int w = 640, h = 480;
+        ThreadPool pool (3);
+
+        for (auto format : { Image::ARGB, Image::RGB })
+        {
+            for (int variant = 0; variant < 3; ++variant)
+            {
+                beginTest ("Renders the same image as the software renderer, "
+                             + String (format == Image::ARGB ? "ARGB" : "RGB")
+                             + String (variant == 0 ? "" : (variant == 1 ? ", complex clip" : ", complex clip and offset origin")));
+
+                auto origin = variant == 2 ? Point<int> (-37, -11) : Point<int>();
+                RectangleList<int> clip (Rectangle<int> (w, h));
+
+                if (variant > 0)
+                {
+                    clip.subtract (Rectangle<int> (100, 60, 150, 200));
+                    clip.subtract (Rectangle<int> (0, 250, w, 17));
+                }
+
+                Image expected (format, w, h, true), actual (format, w, h, true);
+                render (expected, actual, origin, clip, pool, drawScene);
+
+                expect (countDifferentRows (expected, Image (format, w, h, true)) > h / 2);
+                expectEquals (countDifferentRows (expected, actual), 0);
+            }
+        }
+
+        beginTest ("Transformed transparency layers match the software renderer to within rounding");
+        {
+            // Each band's layer starts at a different place, which can change how the
+            // transformed coordinates get rounded.
+            Image expected (Image::RGB, w, h, true), actual (Image::RGB, w, h, true);
+            render (expected, actual, {}, RectangleList<int> (Rectangle<int> (w, h)), pool, drawLayers);
+
+            expect (countDifferentRows (expected, Image (Image::RGB, w, h, true)) > h / 2);
+            expectLessOrEqual (getLargestDifference (expected, actual), 1);
+        }
+    }
+};
+
+static LowLevelGraphicsTiledSoftwareRendererTests lowLevelGraphicsTiledSoftwareRendererTests;
+
+#endif
+
+} // namespace juce
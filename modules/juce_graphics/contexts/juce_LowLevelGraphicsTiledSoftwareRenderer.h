@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A software renderer that records the drawing operations for a frame and then
+    rasterises them in parallel.
+
+    Whilst the context is alive, drawing calls are only recorded, and the clip queries
+    that the Graphics class makes are answered straight away, exactly as a
+    LowLevelGraphicsSoftwareRenderer would answer them. When the context is deleted,
+    the target area is split into horizontal bands and each band replays the recorded
+    operations with its clip restricted to that band, using the given ThreadPool as
+    well as the thread that is deleting the context. The result is pixel-for-pixel
+    identical to rendering with a LowLevelGraphicsSoftwareRenderer, except inside
+    transparency layers that are drawn through a rotation or scale, where the odd
+    edge pixel may be out by one level. That's because each band only allocates the
+    part of a layer that falls inside it, so its layer image starts in a different
+    place, and the transformed coordinates can round differently.
+
+    Because nothing is drawn until the context is deleted, any images that are used
+    as sources must not be modified until then. The pool should have a few threads
+    to spare, as the deleting thread blocks until all the bands have been rendered.
+
+    To use it for a window, you can return one from your LookAndFeel:
+    @code
+    std::unique_ptr<LowLevelGraphicsContext> createGraphicsContext (const Image& imageToRenderOn,
+                                                                    const Point<int>& origin,
+                                                                    const RectangleList<int>& initialClip) override
+    {
+        return std::make_unique<LowLevelGraphicsTiledSoftwareRenderer> (imageToRenderOn, origin,
+                                                                        initialClip, renderingPool);
+    }
+    @endcode
+
+    @see LowLevelGraphicsSoftwareRenderer
+
+    @tags{Graphics}
+*/
+class JUCE_API  LowLevelGraphicsTiledSoftwareRenderer    : public LowLevelGraphicsContext
+{
+public:
+    //==============================================================================
+    /** Creates a context to render into an image. */
+    LowLevelGraphicsTiledSoftwareRenderer (const Image& imageToRenderOnto, ThreadPool& poolToUse);
+
+    /** Creates a context to render into a clipped subsection of an image. */
+    LowLevelGraphicsTiledSoftwareRenderer (const Image& imageToRenderOnto, Point<int> origin,
+                                           const RectangleList<int>& initialClip, ThreadPool& poolToUse);
+
+    /** Destructor.
+        This is where the recorded operations actually get rendered.
+    */
+    ~LowLevelGraphicsTiledSoftwareRenderer() override;
+
+    //==============================================================================
+    bool isVectorDevice() const override;
+    void setOrigin (Point<int>) override;
+    void addTransform (const AffineTransform&) override;
+    float getPhysicalPixelScaleFactor() override;
+
+    bool clipToRectangle (const Rectangle<int>&) override;
+    bool clipToRectangleList (const RectangleList<int>&) override;
+    void excludeClipRectangle (const Rectangle<int>&) override;
+    void clipToPath (const Path&, const AffineTransform&) override;
+    void clipToImageAlpha (const Image&, const AffineTransform&) override;
+    bool clipRegionIntersects (const Rectangle<int>&) override;
+    Rectangle<int> getClipBounds() const override;
+    bool isClipEmpty() const override;
+
+    void saveState() override;
+    void restoreState() override;
+    void beginTransparencyLayer (float opacity) override;
+    void endTransparencyLayer() override;
+
+    void setFill (const FillType&) override;
+    void setOpacity (float) override;
+    void setInterpolationQuality (Graphics::ResamplingQuality) override;
+
+    void fillRect (const Rectangle<int>&, bool replaceExistingContents) override;
+    void fillRect (const Rectangle<float>&) override;
+    void fillRectList (const RectangleList<float>&) override;
+    void fillPath (const Path&, const AffineTransform&) override;
+    void drawImage (const Image&, const AffineTransform&) override;
+    void drawLine (const Line<float>&) override;
+
+    void setFont (const Font&) override;
+    const Font& getFont() override;
+    void drawGlyph (int glyphNumber, const AffineTransform&) override;
+
+private:
+    //==============================================================================
+    class TileContext;
+    struct Frame;
+    using Operation = std::function<void (TileContext&)>;
+
+    ThreadPool& pool;
+    std::shared_ptr<Frame> frame;
+    std::unique_ptr<TileContext> shadowContext;
+
+    void addOperation (Operation);
+    void renderFrame();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LowLevelGraphicsTiledSoftwareRenderer)
+};
+
+} // namespace juce
@@ -179,11 +179,22 @@ public:
 
     void drawGlyph (RenderTargetType& target, const Font& font, const int glyphNumber, Point<float> pos)
     {
-        if (auto glyph = findOrCreateGlyph (font, glyphNumber))
-        {
-            glyph->lastAccessCount = ++accessCounter;
+        if (auto glyph = getGlyphForDrawing (font, glyphNumber))
             glyph->draw (target, pos);
-        }
+    }
+
+    /** Finds or creates a glyph and marks it as recently used.
+        A glyph won't be recycled while the caller is still holding a reference to it,
+        so the result can safely be drawn later on another thread.
+    */
+    ReferenceCountedObjectPtr<CachedGlyphType> getGlyphForDrawing (const Font& font, const int glyphNumber)
+    {
+        auto glyph = findOrCreateGlyph (font, glyphNumber);
+
+        if (glyph != nullptr)
+            glyph->lastAccessCount = ++accessCounter;
+
+        return glyph;
     }
 
     ReferenceCountedObjectPtr<CachedGlyphType> findOrCreateGlyph (const Font& font, int glyphNumber)
@@ -2564,49 +2575,76 @@ public:
     }
 
     //==============================================================================
-    void drawGlyph (int glyphNumber, const AffineTransform& trans)
+    /** A glyph whose outline has already been looked up, ready to be drawn without
+        needing to touch the typeface again.
+    */
+    struct PreparedGlyph
+    {
+        ReferenceCountedObjectPtr<CachedGlyphEdgeTable<SoftwareRendererSavedState>> cachedGlyph;
+        Point<float> position;
+        std::shared_ptr<const EdgeTable> edgeTable;
+    };
+
+    PreparedGlyph prepareGlyph (int glyphNumber, const AffineTransform& trans) const
     {
-        if (clip != nullptr)
+        PreparedGlyph prepared;
+
+        if (trans.isOnlyTranslation() && ! transform.isRotated)
         {
-            if (trans.isOnlyTranslation() && ! transform.isRotated)
-            {
-                auto& cache = GlyphCacheType::getInstance();
-                Point<float> pos (trans.getTranslationX(), trans.getTranslationY());
+            auto& cache = GlyphCacheType::getInstance();
+            Point<float> pos (trans.getTranslationX(), trans.getTranslationY());
 
-                if (transform.isOnlyTranslated)
-                {
-                    cache.drawGlyph (*this, font, glyphNumber, pos + transform.offset.toFloat());
-                }
-                else
-                {
-                    pos = transform.transformed (pos);
+            if (transform.isOnlyTranslated)
+            {
+                prepared.cachedGlyph = cache.getGlyphForDrawing (font, glyphNumber);
+                prepared.position = pos + transform.offset.toFloat();
+            }
+            else
+            {
+                pos = transform.transformed (pos);
 
-                    Font f (font);
-                    f.setHeight (font.getHeight() * transform.complexTransform.mat11);
+                Font f (font);
+                f.setHeight (font.getHeight() * transform.complexTransform.mat11);
 
-                    auto xScale = transform.complexTransform.mat00 / transform.complexTransform.mat11;
+                auto xScale = transform.complexTransform.mat00 / transform.complexTransform.mat11;
 
-                    if (std::abs (xScale - 1.0f) > 0.01f)
-                        f.setHorizontalScale (xScale);
+                if (std::abs (xScale - 1.0f) > 0.01f)
+                    f.setHorizontalScale (xScale);
 
-                    cache.drawGlyph (*this, f, glyphNumber, pos);
-                }
+                prepared.cachedGlyph = cache.getGlyphForDrawing (f, glyphNumber);
+                prepared.position = pos;
             }
-            else
-            {
-                auto fontHeight = font.getHeight();
+        }
+        else
+        {
+            auto fontHeight = font.getHeight();
 
-                auto t = transform.getTransformWith (AffineTransform::scale (fontHeight * font.getHorizontalScale(), fontHeight)
-                                                                     .followedBy (trans));
+            auto t = transform.getTransformWith (AffineTransform::scale (fontHeight * font.getHorizontalScale(), fontHeight)
+                                                                 .followedBy (trans));
 
-                std::unique_ptr<EdgeTable> et (font.getTypeface()->getEdgeTableForGlyph (glyphNumber, t, fontHeight));
+            prepared.edgeTable.reset (font.getTypeface()->getEdgeTableForGlyph (glyphNumber, t, fontHeight));
+        }
 
-                if (et != nullptr)
-                    fillShape (*new EdgeTableRegionType (*et), false);
-            }
+        return prepared;
+    }
+
+    void drawPreparedGlyph (const PreparedGlyph& prepared)
+    {
+        if (clip != nullptr)
+        {
+            if (prepared.cachedGlyph != nullptr)
+                prepared.cachedGlyph->draw (*this, prepared.position);
+            else if (prepared.edgeTable != nullptr)
+                fillShape (*new EdgeTableRegionType (*prepared.edgeTable), false);
         }
     }
 
+    void drawGlyph (int glyphNumber, const AffineTransform& trans)
+    {
+        if (clip != nullptr)
+            drawPreparedGlyph (prepareGlyph (glyphNumber, trans));
+    }
+
     Rectangle<int> getMaximumBounds() const     { return image.getBounds(); }
 
     //==============================================================================
@@ -2707,6 +2745,12 @@ public:
         currentState.reset (currentState->beginTransparencyLayer (opacity));
     }
 
+    void beginTransparencyLayer (float opacity, Rectangle<int> layerBounds)
+    {
+        save();
+        currentState.reset (currentState->beginTransparencyLayer (opacity, layerBounds));
+    }
+
     void endTransparencyLayer()
     {
         std::unique_ptr<StateObjectType> finishedTransparencyLayer (currentState.release());
@@ -315,6 +315,240 @@ namespace
 
 }  // namespace
 
+//==============================================================================
+/*  A pattern for one part of an OSC address, which is parsed once up-front so that it
+    can be matched against lots of strings without parsing it again each time.
+
+    It follows exactly the same rules (and quirks) as OSCPatternMatcherImpl. Because OSC
+    address characters are always printable ASCII, the pattern and targets are treated
+    as plain bytes.
+*/
+class CompiledOSCPattern
+{
+public:
+    CompiledOSCPattern (const char* pattern, const char* patternEnd)
+    {
+        while (pattern < patternEnd && ! failed)
+        {
+            auto c = *pattern++;
+
+            switch (c)
+            {
+                case '?':   tokens.add (Token (Token::anyChar)); break;
+                case '*':   tokens.add (Token (Token::anyOrNoChars)); break;
+                case '{':   pattern = parseStringSet (pattern, patternEnd); break;
+                case '[':   pattern = parseCharSet (pattern, patternEnd); break;
+                default:    addLiteralChar (c); break;
+            }
+        }
+    }
+
+    /** Returns true if the pattern contains no wildcards, so only matches itself. */
+    static bool isLiteral (const char* pattern, const char* patternEnd) noexcept
+    {
+        for (; pattern < patternEnd; ++pattern)
+            if (CharPointer_ASCII ("*?{}[]").indexOf ((juce_wchar) (uint8) *pattern) >= 0)
+                return false;
+
+        return true;
+    }
+
+    bool matches (const char* target, const char* targetEnd) const noexcept
+    {
+        return ! failed && match (0, target, targetEnd);
+    }
+
+private:
+    //==============================================================================
+    struct Token
+    {
+        enum Type { literal, anyChar, anyOrNoChars, stringSet, charSet };
+
+        Token (Type t) noexcept  : type (t) {}
+
+        Type type;
+        int start = 0, end = 0;              // literal: a range of text; stringSet: a range of setStrings
+        uint64 setBits[2] = { 0, 0 };        // charSet
+        bool isEmptySet = true, isNegated = false;
+
+        bool containsChar (char c) const noexcept
+        {
+            auto index = (uint8) c;
+            return index < 128 && (setBits[index >> 6] & (((uint64) 1) << (index & 63))) != 0;
+        }
+
+        void addChar (juce_wchar c) noexcept
+        {
+            isEmptySet = false;
+
+            if (c >= 0 && c < 128)
+                setBits[c >> 6] |= ((uint64) 1) << (c & 63);
+        }
+    };
+
+    Array<Token> tokens;
+    MemoryBlock text;
+    Array<Range<int>> setStrings;
+    bool failed = false;
+
+    //==============================================================================
+    void addLiteralChar (char c)
+    {
+        if (tokens.isEmpty() || tokens.getReference (tokens.size() - 1).type != Token::literal)
+        {
+            Token t (Token::literal);
+            t.start = t.end = (int) text.getSize();
+            tokens.add (t);
+        }
+
+        text.append (&c, 1);
+        tokens.getReference (tokens.size() - 1).end = (int) text.getSize();
+    }
+
+    const char* parseStringSet (const char* pattern, const char* patternEnd)
+    {
+        Token t (Token::stringSet);
+        t.start = setStrings.size();
+        auto elementStart = (int) text.getSize();
+
+        while (pattern < patternEnd)
+        {
+            auto c = *pattern++;
+
+            if (c == '}' || c == ',')
+            {
+                setStrings.add ({ elementStart, (int) text.getSize() });
+                elementStart = (int) text.getSize();
+
+                if (c == '}')
+                {
+                    t.end = setStrings.size();
+                    tokens.add (t);
+                    return pattern;
+                }
+            }
+            else
+            {
+                text.append (&c, 1);
+            }
+        }
+
+        failed = true;
+        return pattern;
+    }
+
+    const char* parseCharSet (const char* pattern, const char* patternEnd)
+    {
+        Token t (Token::charSet);
+        juce_wchar lastChar = 0;
+
+        while (pattern < patternEnd)
+        {
+            auto c = *pattern++;
+
+            if (c == ']')
+            {
+                tokens.add (t);
+                return pattern;
+            }
+
+            if (c == '-')
+            {
+                // (as in OSCPatternMatcherImpl, the character after the '-' is left to be
+                // added to the set again by the next iteration)
+                auto rangeEnd = (juce_wchar) (pattern < patternEnd ? *pattern : 0);
+
+                if (rangeEnd == ']')
+                {
+                    t.addChar ('-');
+                    lastChar = '-';
+                    continue;
+                }
+
+                if (rangeEnd == ',' || rangeEnd == '{' || rangeEnd == '}' || t.isEmptySet)
+                    break;
+
+                while (rangeEnd > lastChar)
+                    t.addChar (++lastChar);
+
+                continue;
+            }
+
+            if (c == '!' && t.isEmptySet && ! t.isNegated)
+            {
+                t.isNegated = true;
+                continue;
+            }
+
+            t.addChar (c);
+            lastChar = c;
+        }
+
+        failed = true;
+        return pattern;
+    }
+
+    //==============================================================================
+    bool match (int tokenIndex, const char* target, const char* targetEnd) const noexcept
+    {
+        if (tokenIndex == tokens.size())
+            return target == targetEnd;
+
+        auto& t = tokens.getReference (tokenIndex);
+        auto* textData = static_cast<const char*> (text.getData());
+
+        switch (t.type)
+        {
+            case Token::literal:
+            {
+                auto length = t.end - t.start;
+
+                return targetEnd - target >= length
+                        && memcmp (target, textData + t.start, (size_t) length) == 0
+                        && match (tokenIndex + 1, target + length, targetEnd);
+            }
+
+            case Token::anyChar:
+                return target != targetEnd && match (tokenIndex + 1, target + 1, targetEnd);
+
+            case Token::anyOrNoChars:
+                for (;; ++target)
+                {
+                    if (target == targetEnd)
+                        return tokenIndex + 1 == tokens.size();
+
+                    if (match (tokenIndex + 1, target, targetEnd))
+                        return true;
+                }
+
+            case Token::stringSet:
+                for (int i = t.start; i < t.end; ++i)
+                {
+                    auto range = setStrings.getReference (i);
+
+                    if (targetEnd - target >= range.getLength()
+                         && memcmp (target, textData + range.getStart(), (size_t) range.getLength()) == 0
+                         && match (tokenIndex + 1, target + range.getLength(), targetEnd))
+                        return true;
+                }
+
+                return false;
+
+            case Token::charSet:
+                if (t.isEmptySet)
+                    return match (tokenIndex + 1, target, targetEnd);
+
+                return target != targetEnd
+                        && t.containsChar (*target) != t.isNegated
+                        && match (tokenIndex + 1, target + 1, targetEnd);
+
+            default:
+                jassertfalse;
+                return false;
+        }
+    }
+};
+
 //==============================================================================
 OSCAddress::OSCAddress (const String& address)
     : oscSymbols (OSCAddressTokeniser<OSCAddress>::tokenise (address)),
@@ -782,6 +1016,33 @@ public:
         {
             expect (matchOscPattern ("*ea*ll[y-z0-9X-Zvwx]??m[o-q]l[e]x{fat,mat,pat}te{}r*?", "reallycomplexpattern"));
         }
+
+        beginTest ("compiled patterns match the same strings");
+        {
+            auto random = getRandom();
+
+            auto createRandomString = [&] (const char* chars, int maxLength)
+            {
+                String s;
+
+                for (int i = random.nextInt (maxLength + 1); --i >= 0;)
+                    s += (juce_wchar) chars[random.nextInt ((int) strlen (chars))];
+
+                return s;
+            };
+
+            for (int i = 0; i < 20000; ++i)
+            {
+                auto pattern = createRandomString ("ab-!,?*[]{}", 8);
+                auto target = createRandomString ("ab-!c", 6);
+
+                CompiledOSCPattern compiled (pattern.toRawUTF8(), pattern.toRawUTF8() + pattern.getNumBytesAsUTF8());
+
+                expectEquals ((int) compiled.matches (target.toRawUTF8(), target.toRawUTF8() + target.getNumBytesAsUTF8()),
+                              (int) matchOscPattern (pattern, target),
+                              pattern + " " + target);
+            }
+        }
     }
 };
 
@@ -0,0 +1,383 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace
+{
+    //==============================================================================
+    // These follow the same rules as OSCInputStream, so that a packet which can't be
+    // read into an OSCMessage or OSCBundle never gets a valid view either.
+    struct OSCViewHelpers
+    {
+        static size_t getPaddedSize (size_t size) noexcept
+        {
+            return (size + 3) & ~(size_t) 3;
+        }
+
+        static const char* skipPaddingZeros (const char* p, const char* end, size_t bytesRead) noexcept
+        {
+            for (auto numZeros = ~(bytesRead - 1) & 3; numZeros > 0; --numZeros)
+                if (p == end || *p++ != 0)
+                    return nullptr;
+
+            return p;
+        }
+
+        static const char* skipString (const char* p, const char* end) noexcept
+        {
+            auto* start = p;
+
+            while (p < end && *p != 0)
+                ++p;
+
+            if (p == end)
+                return nullptr;
+
+            ++p;
+            return skipPaddingZeros (p, end, (size_t) (p - start));
+        }
+
+        static const char* skipArgument (OSCType type, const char* p, const char* end) noexcept
+        {
+            switch (type)
+            {
+                case OSCTypes::int32:
+                case OSCTypes::float32:
+                case OSCTypes::colour:
+                    return end - p >= 4 ? p + 4 : nullptr;
+
+                case OSCTypes::string:
+                    return skipString (p, end);
+
+                case OSCTypes::blob:
+                {
+                    if (end - p < 4)
+                        return nullptr;
+
+                    auto size = (int32) ByteOrder::bigEndianInt (p);
+                    p += 4;
+
+                    if (size < 0 || size > end - p)
+                        return nullptr;
+
+                    return skipPaddingZeros (p + size, end, (size_t) size);
+                }
+
+                default:
+                    return nullptr;
+            }
+        }
+
+        // (for data that's already been checked)
+        static const char* nextArgument (OSCType type, const char* p) noexcept
+        {
+            switch (type)
+            {
+                case OSCTypes::string:  return p + getPaddedSize (strlen (p) + 1);
+                case OSCTypes::blob:    return p + 4 + getPaddedSize (ByteOrder::bigEndianInt (p));
+                default:                return p + 4;
+            }
+        }
+
+        static bool isValidAddressPattern (const char* p) noexcept
+        {
+            if (*p != '/')
+                return false;
+
+            for (; *p != 0; ++p)
+                if (*p < ' ' || *p > '~' || *p == ' ' || *p == '#')
+                    return false;
+
+            return true;
+        }
+
+        static bool isValidBundle (const char* p, const char* end) noexcept
+        {
+            if (end - p < 16 || memcmp (p, "#bundle", 8) != 0)
+                return false;
+
+            for (p += 16; p < end;)
+            {
+                if (end - p < 4)
+                    return false;
+
+                auto size = (int32) ByteOrder::bigEndianInt (p);
+                p += 4;
+
+                if (size < 4 || size > end - p)
+                    return false;
+
+                if (*p == '/' ? ! OSCMessageView (p, (size_t) size).isValid()
+                              : (*p != '#' || ! isValidBundle (p, p + size)))
+                    return false;
+
+                p += size;
+            }
+
+            return true;
+        }
+
+        static String createString (const char* s)
+        {
+            // (this matches the way OSCInputStream reads strings)
+            return String::createStringFromData (s, (int) strlen (s) + 1);
+        }
+    };
+}
+
+//==============================================================================
+OSCArgumentView::OSCArgumentView (OSCType t, const char* d) noexcept  : type (t), data (d) {}
+
+int32 OSCArgumentView::getInt32() const noexcept
+{
+    if (isInt32())
+        return (int32) ByteOrder::bigEndianInt (data);
+
+    jassertfalse; // you must check the type of an argument before attempting to get its value!
+    return 0;
+}
+
+float OSCArgumentView::getFloat32() const noexcept
+{
+    if (isFloat32())
+    {
+        union { uint32 asInt; float asFloat; } n;
+        n.asInt = ByteOrder::bigEndianInt (data);
+        return n.asFloat;
+    }
+
+    jassertfalse; // you must check the type of an argument before attempting to get its value!
+    return 0.0f;
+}
+
+StringRef OSCArgumentView::getString() const noexcept
+{
+    if (isString())
+        return StringRef (data);
+
+    jassertfalse; // you must check the type of an argument before attempting to get its value!
+    return StringRef();
+}
+
+const void* OSCArgumentView::getBlobData() const noexcept
+{
+    // you must check the type of an argument before attempting to get its value!
+    jassert (isBlob());
+
+    return isBlob() ? data + 4 : nullptr;
+}
+
+size_t OSCArgumentView::getBlobSize() const noexcept
+{
+    // you must check the type of an argument before attempting to get its value!
+    jassert (isBlob());
+
+    return isBlob() ? (size_t) ByteOrder::bigEndianInt (data) : 0;
+}
+
+OSCColour OSCArgumentView::getColour() const noexcept
+{
+    if (isColour())
+        return OSCColour::fromInt32 (ByteOrder::bigEndianInt (data));
+
+    jassertfalse; // you must check the type of an argument before attempting to get its value!
+    return { 0, 0, 0, 0 };
+}
+
+OSCArgument OSCArgumentView::toArgument() const
+{
+    switch (type)
+    {
+        case OSCTypes::int32:       return OSCArgument (getInt32());
+        case OSCTypes::float32:     return OSCArgument (getFloat32());
+        case OSCTypes::string:      return OSCArgument (OSCViewHelpers::createString (data));
+        case OSCTypes::blob:        return OSCArgument (MemoryBlock (getBlobData(), getBlobSize()));
+        case OSCTypes::colour:      return OSCArgument (getColour());
+
+        default:
+            jassertfalse;
+            throw OSCInternalError ("OSC argument view: internal error while copying argument");
+    }
+}
+
+//==============================================================================
+OSCMessageView::OSCMessageView (const void* sourceData, size_t sourceDataSize) noexcept
+{
+    auto* start = static_cast<const char*> (sourceData);
+    auto* end = start + sourceDataSize;
+
+    if (start == nullptr || sourceDataSize < 4)
+        return;
+
+    auto* p = OSCViewHelpers::skipString (start, end);
+
+    if (p == nullptr || ! OSCViewHelpers::isValidAddressPattern (start) || p == end || *p != ',')
+        return;
+
+    auto* tags = ++p;
+
+    for (;; ++p)
+    {
+        if (p == end)
+            return;
+
+        if (*p == 0)
+            break;
+
+        if (! OSCTypes::isSupportedType (*p))
+            return;
+    }
+
+    auto numTags = (int) (p - tags);
+    p = OSCViewHelpers::skipPaddingZeros (p + 1, end, (size_t) numTags + 2);
+
+    if (p == nullptr)
+        return;
+
+    auto* firstArgument = p;
+
+    for (int i = 0; i < numTags; ++i)
+        if ((p = OSCViewHelpers::skipArgument (tags[i], p, end)) == nullptr)
+            return;
+
+    if (p != end)
+        return;
+
+    data = start;
+    dataSize = sourceDataSize;
+    typeTags = tags;
+    arguments = firstArgument;
+    numArguments = numTags;
+}
+
+StringRef OSCMessageView::getAddressPattern() const noexcept
+{
+    return data != nullptr ? StringRef (data) : StringRef();
+}
+
+OSCArgumentView OSCMessageView::operator[] (int i) const noexcept
+{
+    jassert (isPositiveAndBelow (i, numArguments));
+
+    auto it = begin();
+
+    while (--i >= 0)
+        ++it;
+
+    return *it;
+}
+
+OSCMessageView::Iterator::Iterator (const char* t, const char* a) noexcept  : typeTag (t), argumentData (a) {}
+
+OSCArgumentView OSCMessageView::Iterator::operator*() const noexcept
+{
+    return OSCArgumentView (*typeTag, argumentData);
+}
+
+OSCMessageView::Iterator& OSCMessageView::Iterator::operator++() noexcept
+{
+    argumentData = OSCViewHelpers::nextArgument (*typeTag++, argumentData);
+    return *this;
+}
+
+OSCMessageView::Iterator OSCMessageView::begin() const noexcept   { return Iterator (typeTags, arguments); }
+OSCMessageView::Iterator OSCMessageView::end() const noexcept     { return Iterator (typeTags + numArguments, nullptr); }
+
+OSCMessage OSCMessageView::toMessage() const
+{
+    if (! isValid())
+        throw OSCFormatError ("OSC message view: can't copy an invalid message");
+
+    OSCMessage message (OSCAddressPattern (OSCViewHelpers::createString (data)));
+
+    for (auto arg : *this)
+        message.addArgument (arg.toArgument());
+
+    return message;
+}
+
+//==============================================================================
+OSCBundleView::OSCBundleView (const void* sourceData, size_t sourceDataSize) noexcept
+{
+    auto* start = static_cast<const char*> (sourceData);
+
+    if (start != nullptr && OSCViewHelpers::isValidBundle (start, start + sourceDataSize))
+    {
+        data = start;
+        dataSize = sourceDataSize;
+    }
+}
+
+OSCTimeTag OSCBundleView::getTimeTag() const noexcept
+{
+    return data != nullptr ? OSCTimeTag ((uint64) ByteOrder::bigEndianInt64 (data + 8)) : OSCTimeTag();
+}
+
+OSCMessageView OSCBundleView::Element::getMessage() const noexcept
+{
+    return isMessage() ? OSCMessageView (data, dataSize) : OSCMessageView();
+}
+
+OSCBundleView OSCBundleView::Element::getBundle() const noexcept
+{
+    return isBundle() ? OSCBundleView (data, dataSize) : OSCBundleView();
+}
+
+OSCBundleView::Element OSCBundleView::Iterator::operator*() const noexcept
+{
+    return Element (position + 4, ByteOrder::bigEndianInt (position));
+}
+
+OSCBundleView::Iterator& OSCBundleView::Iterator::operator++() noexcept
+{
+    position += 4 + ByteOrder::bigEndianInt (position);
+    return *this;
+}
+
+OSCBundleView::Iterator OSCBundleView::begin() const noexcept   { return Iterator (data != nullptr ? data + 16 : nullptr); }
+OSCBundleView::Iterator OSCBundleView::end() const noexcept     { return Iterator (data != nullptr ? data + dataSize : nullptr); }
+
+OSCBundle OSCBundleView::toBundle() const
+{
+    if (! isValid())
+        throw OSCFormatError ("OSC bundle view: can't copy an invalid bundle");
+
+    OSCBundle bundle (getTimeTag());
+
+    for (auto element : *this)
+    {
+        if (element.isMessage())
+            bundle.addElement (OSCBundle::Element (element.getMessage().toMessage()));
+        else
+            bundle.addElement (OSCBundle::Element (element.getBundle().toBundle()));
+    }
+
+    return bundle;
+}
+
+} // namespace juce
@@ -0,0 +1,319 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A read-only view of one argument of an OSCMessageView.
+
+    This refers directly to the argument's data inside the packet that the
+    message was received in, so it's only valid for as long as that data is.
+
+    @see OSCMessageView, OSCArgument
+
+    @tags{OSC}
+*/
+class JUCE_API  OSCArgumentView
+{
+public:
+    //==============================================================================
+    /** Returns the type of the argument as an OSCType.
+        OSCType is a char, so you can also directly compare it to ',', 'i', 'f', 's', 'b' etc.
+    */
+    OSCType getType() const noexcept        { return type; }
+
+    /** Returns true if the argument is an int32. */
+    bool isInt32() const noexcept           { return type == OSCTypes::int32; }
+
+    /** Returns true if the argument is a float32. */
+    bool isFloat32() const noexcept         { return type == OSCTypes::float32; }
+
+    /** Returns true if the argument is a string. */
+    bool isString() const noexcept          { return type == OSCTypes::string; }
+
+    /** Returns true if the argument is a blob. */
+    bool isBlob() const noexcept            { return type == OSCTypes::blob; }
+
+    /** Returns true if the argument is a colour. */
+    bool isColour() const noexcept          { return type == OSCTypes::colour; }
+
+    //==============================================================================
+    /** Returns the value of the argument as an int32.
+        If the argument is not of type int32, the behaviour is undefined.
+    */
+    int32 getInt32() const noexcept;
+
+    /** Returns the value of the argument as a float32.
+        If the argument is not of type float32, the behaviour is undefined.
+    */
+    float getFloat32() const noexcept;
+
+    /** Returns the value of the argument as a null-terminated string, pointing
+        straight into the packet data.
+        If the argument is not of type string, the behaviour is undefined.
+    */
+    StringRef getString() const noexcept;
+
+    /** Returns a pointer to the data of a blob argument.
+        If the argument is not of type blob, the behaviour is undefined.
+    */
+    const void* getBlobData() const noexcept;
+
+    /** Returns the size in bytes of a blob argument.
+        If the argument is not of type blob, the behaviour is undefined.
+    */
+    size_t getBlobSize() const noexcept;
+
+    /** Returns the value of the argument as an OSCColour.
+        If the argument is not of type colour, the behaviour is undefined.
+    */
+    OSCColour getColour() const noexcept;
+
+    //==============================================================================
+    /** Creates an OSCArgument holding a copy of this argument's value. */
+    OSCArgument toArgument() const;
+
+private:
+    //==============================================================================
+    friend class OSCMessageView;
+    OSCArgumentView (OSCType, const char* data) noexcept;
+
+    OSCType type;
+    const char* data;
+};
+
+//==============================================================================
+/**
+    A read-only view of an OSC message, which reads the address pattern and arguments
+    directly from the encoded data that it was received in.
+
+    Unlike an OSCMessage, creating one of these doesn't copy or allocate anything,
+    so it's suitable for handling messages on a realtime thread - see
+    OSCReceiver::ViewListener. It's only valid for as long as the data that it refers to,
+    so if you need to keep the message, use toMessage() to make a copy of it.
+
+    Getting the arguments in order with begin() and end() is quicker than using
+    operator[], which has to skip over all the arguments before the one you ask for.
+
+    @see OSCMessage, OSCBundleView, OSCReceiver::ViewListener
+
+    @tags{OSC}
+*/
+class JUCE_API  OSCMessageView
+{
+public:
+    //==============================================================================
+    /** Creates an invalid, empty view. */
+    OSCMessageView() noexcept = default;
+
+    /** Creates a view of an encoded OSC message.
+        The data is checked when the view is created, and if it isn't a correctly-formed
+        message, isValid() will return false and the view will be empty.
+    */
+    OSCMessageView (const void* data, size_t dataSize) noexcept;
+
+    /** Returns true if the data was a correctly-formed OSC message. */
+    bool isValid() const noexcept                   { return data != nullptr; }
+
+    //==============================================================================
+    /** Returns the message's address pattern, as a null-terminated string that points
+        straight into the packet data.
+    */
+    StringRef getAddressPattern() const noexcept;
+
+    /** Returns the number of arguments in the message. */
+    int size() const noexcept                       { return numArguments; }
+
+    /** Returns true if the message has no arguments. */
+    bool isEmpty() const noexcept                   { return numArguments == 0; }
+
+    /** Returns the argument at index i.
+        This has to skip over the arguments before it, so if you want to look at all of
+        them, iterate over the view with begin() and end() instead. The index isn't
+        checked, and the behaviour is undefined if it's out of range.
+    */
+    OSCArgumentView operator[] (int i) const noexcept;
+
+    //==============================================================================
+    /** Iterates over the arguments of an OSCMessageView. */
+    class JUCE_API  Iterator
+    {
+    public:
+        OSCArgumentView operator*() const noexcept;
+        Iterator& operator++() noexcept;
+        bool operator== (const Iterator& other) const noexcept    { return typeTag == other.typeTag; }
+        bool operator!= (const Iterator& other) const noexcept    { return typeTag != other.typeTag; }
+
+    private:
+        friend class OSCMessageView;
+        Iterator (const char* typeTag, const char* argumentData) noexcept;
+
+        const char* typeTag;
+        const char* argumentData;
+    };
+
+    /** Returns an iterator to the first argument. */
+    Iterator begin() const noexcept;
+
+    /** Returns an iterator to the position after the last argument. */
+    Iterator end() const noexcept;
+
+    //==============================================================================
+    /** Returns the encoded data that the view refers to. */
+    const void* getData() const noexcept            { return data; }
+
+    /** Returns the size of the encoded data that the view refers to. */
+    size_t getDataSize() const noexcept             { return dataSize; }
+
+    /** Creates an OSCMessage holding a copy of this message.
+        If the view isn't valid, this will throw an OSCFormatError.
+    */
+    OSCMessage toMessage() const;
+
+private:
+    //==============================================================================
+    const char* data = nullptr;
+    size_t dataSize = 0;
+    const char* typeTags = nullptr;
+    const char* arguments = nullptr;
+    int numArguments = 0;
+};
+
+//==============================================================================
+/**
+    A read-only view of an OSC bundle, which reads its time tag and elements directly
+    from the encoded data that it was received in.
+
+    Like OSCMessageView, creating one of these doesn't copy or allocate anything,
+    and it's only valid for as long as the data that it refers to.
+
+    @see OSCBundle, OSCMessageView, OSCReceiver::ViewListener
+
+    @tags{OSC}
+*/
+class JUCE_API  OSCBundleView
+{
+public:
+    //==============================================================================
+    /** Creates an invalid, empty view. */
+    OSCBundleView() noexcept = default;
+
+    /** Creates a view of an encoded OSC bundle.
+        The data, including any messages and bundles inside it, is checked when the view
+        is created, and if it isn't a correctly-formed bundle, isValid() will return false
+        and the view will be empty.
+    */
+    OSCBundleView (const void* data, size_t dataSize) noexcept;
+
+    /** Returns true if the data was a correctly-formed OSC bundle. */
+    bool isValid() const noexcept                   { return data != nullptr; }
+
+    /** Returns the bundle's OSC time tag. */
+    OSCTimeTag getTimeTag() const noexcept;
+
+    //==============================================================================
+    /** An element of an OSCBundleView, which is a view of either a message or another bundle. */
+    class JUCE_API  Element
+    {
+    public:
+        /** Returns true if the element is a message. */
+        bool isMessage() const noexcept             { return *data == '/'; }
+
+        /** Returns true if the element is a bundle. */
+        bool isBundle() const noexcept              { return *data == '#'; }
+
+        /** Returns a view of the message, or an invalid view if the element is a bundle. */
+        OSCMessageView getMessage() const noexcept;
+
+        /** Returns a view of the bundle, or an invalid view if the element is a message. */
+        OSCBundleView getBundle() const noexcept;
+
+    private:
+        friend class OSCBundleView;
+        Element (const char* elementData, size_t elementSize) noexcept  : data (elementData), dataSize (elementSize) {}
+
+        const char* data;
+        size_t dataSize;
+    };
+
+    /** Iterates over the elements of an OSCBundleView. */
+    class JUCE_API  Iterator
+    {
+    public:
+        Element operator*() const noexcept;
+        Iterator& operator++() noexcept;
+        bool operator== (const Iterator& other) const noexcept    { return position == other.position; }
+        bool operator!= (const Iterator& other) const noexcept    { return position != other.position; }
+
+    private:
+        friend class OSCBundleView;
+        Iterator (const char* p) noexcept  : position (p) {}
+
+        const char* position;
+    };
+
+    /** Returns an iterator to the first element. */
+    Iterator begin() const noexcept;
+
+    /** Returns an iterator to the position after the last element. */
+    Iterator end() const noexcept;
+
+    /** Calls a function for each message in the bundle, including the ones in any
+        bundles that it contains. The function should take a const OSCMessageView&.
+    */
+    template <typename Callback>
+    void forEachMessage (Callback&& callback) const
+    {
+        for (auto element : *this)
+        {
+            if (element.isMessage())
+                callback (element.getMessage());
+            else
+                element.getBundle().forEachMessage (callback);
+        }
+    }
+
+    //==============================================================================
+    /** Returns the encoded data that the view refers to. */
+    const void* getData() const noexcept            { return data; }
+
+    /** Returns the size of the encoded data that the view refers to. */
+    size_t getDataSize() const noexcept             { return dataSize; }
+
+    /** Creates an OSCBundle holding a copy of this bundle and everything in it.
+        If the view isn't valid, this will throw an OSCFormatError.
+    */
+    OSCBundle toBundle() const;
+
+private:
+    //==============================================================================
+    const char* data = nullptr;
+    size_t dataSize = 0;
+};
+
+} // namespace juce
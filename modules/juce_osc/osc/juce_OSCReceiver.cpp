@@ -327,6 +327,250 @@ namespace
 
 } // namespace
 
+//==============================================================================
+/*  An index of listeners by OSC address, so that an incoming address pattern can be
+    dispatched without testing it against every registered address.
+
+    It's a trie of address parts. The literal parts of a pattern are looked up by their
+    hash, and only the parts that contain wildcards get compiled and matched against the
+    children at that level. So dispatching a message costs roughly the depth of its
+    address, rather than the number of listeners.
+*/
+template <typename ListenerType>
+class OSCAddressIndex
+{
+public:
+    OSCAddressIndex() = default;
+
+    void add (const OSCAddress& address, ListenerType* listener)
+    {
+        auto addressString = address.toString();
+        auto* node = &root;
+
+        forEachAddressPart (addressString, [&] (const char* start, const char* end)
+        {
+            auto* child = findChild (*node, start, end);
+            node = child != nullptr ? child : addChild (*node, start, end);
+        });
+
+        node->entries.add ({ addressString, listener });
+    }
+
+    void remove (const OSCAddress& address, ListenerType* listener)
+    {
+        auto addressString = address.toString();
+        Array<Node*> path;
+        path.add (&root);
+
+        forEachAddressPart (addressString, [&] (const char* start, const char* end)
+        {
+            if (auto* node = path.getLast())
+                path.add (findChild (*node, start, end));
+        });
+
+        auto* node = path.getLast();
+
+        if (node == nullptr)
+            return;
+
+        for (int i = 0; i < node->entries.size(); ++i)
+        {
+            auto& entry = node->entries.getReference (i);
+
+            if (entry.listener == listener && entry.address == addressString)
+            {
+                node->entries.remove (i);
+                break;
+            }
+        }
+
+        // get rid of any nodes that aren't needed any more
+        for (int i = path.size(); --i > 0;)
+        {
+            if (! path[i]->entries.isEmpty() || ! path[i]->children.isEmpty())
+                break;
+
+            removeChild (*path[i - 1], path[i]);
+        }
+    }
+
+    /** Calls the callback with each listener whose address matches the pattern. */
+    template <typename Callback>
+    void callMatchingListeners (const OSCAddressPattern& pattern, Callback&& callback) const
+    {
+        auto patternString = pattern.toString();
+
+        if (! pattern.containsWildcards())
+        {
+            const Node* node = &root;
+
+            forEachAddressPart (patternString, [&] (const char* start, const char* end)
+            {
+                if (node != nullptr)
+                    node = findChild (*node, start, end);
+            });
+
+            if (node != nullptr)
+                for (auto& entry : node->entries)
+                    if (entry.address == patternString) // (same as OSCAddressPattern::matches for a literal)
+                        callback (entry.listener);
+
+            return;
+        }
+
+        Array<std::pair<const char*, const char*>> parts;
+        OwnedArray<CompiledOSCPattern> compiledParts;
+
+        forEachAddressPart (patternString, [&] (const char* start, const char* end)
+        {
+            parts.add ({ start, end });
+            compiledParts.add (CompiledOSCPattern::isLiteral (start, end) ? nullptr
+                                                                           : new CompiledOSCPattern (start, end));
+        });
+
+        callMatchingListeners (root, parts, compiledParts, 0, callback);
+    }
+
+private:
+    //==============================================================================
+    struct Entry
+    {
+        String address;
+        ListenerType* listener;
+    };
+
+    struct Node
+    {
+        String name;
+        int nameLength = 0;
+        Node* parent = nullptr;
+        Node* nextWithSameKey = nullptr;
+        OwnedArray<Node> children;
+        Array<Entry> entries;
+
+        bool hasName (const char* start, const char* end) const noexcept
+        {
+            return nameLength == (int) (end - start)
+                    && memcmp (name.toRawUTF8(), start, (size_t) nameLength) == 0;
+        }
+    };
+
+    Node root;
+    HashMap<uint64, Node*> childrenByKey;
+
+    //==============================================================================
+    template <typename Callback>
+    static void forEachAddressPart (const String& address, Callback&& callback)
+    {
+        auto* p = address.toRawUTF8();
+
+        for (;;)
+        {
+            while (*p == '/')
+                ++p;
+
+            if (*p == 0)
+                break;
+
+            auto* start = p;
+
+            while (*p != '/' && *p != 0)
+                ++p;
+
+            callback (start, p);
+        }
+    }
+
+    static uint64 getKey (const Node& parent, const char* start, const char* end) noexcept
+    {
+        // FNV-1a, starting from the parent's address so that each node gets its own keys
+        auto hash = (uint64) 14695981039346656037ULL ^ (uint64) (pointer_sized_uint) &parent;
+
+        for (; start < end; ++start)
+            hash = (hash ^ (uint8) *start) * (uint64) 1099511628211ULL;
+
+        return hash;
+    }
+
+    Node* findChild (const Node& parent, const char* start, const char* end) const noexcept
+    {
+        for (auto* node = childrenByKey[getKey (parent, start, end)]; node != nullptr; node = node->nextWithSameKey)
+            if (node->parent == &parent && node->hasName (start, end))
+                return node;
+
+        return nullptr;
+    }
+
+    Node* addChild (Node& parent, const char* start, const char* end)
+    {
+        auto* node = parent.children.add (new Node());
+        node->name = String::fromUTF8 (start, (int) (end - start));
+        node->nameLength = (int) (end - start);
+        node->parent = &parent;
+
+        auto& firstWithSameKey = childrenByKey.getReference (getKey (parent, start, end));
+        node->nextWithSameKey = firstWithSameKey;
+        firstWithSameKey = node;
+        return node;
+    }
+
+    void removeChild (Node& parent, Node* child)
+    {
+        auto* name = child->name.toRawUTF8();
+        auto key = getKey (parent, name, name + child->nameLength);
+        auto& firstWithSameKey = childrenByKey.getReference (key);
+
+        for (auto** n = &firstWithSameKey; *n != nullptr; n = &((*n)->nextWithSameKey))
+        {
+            if (*n == child)
+            {
+                *n = child->nextWithSameKey;
+                break;
+            }
+        }
+
+        if (firstWithSameKey == nullptr)
+            childrenByKey.remove (key);
+
+        parent.children.removeObject (child);
+    }
+
+    template <typename Callback>
+    void callMatchingListeners (const Node& node,
+                                const Array<std::pair<const char*, const char*>>& parts,
+                                const OwnedArray<CompiledOSCPattern>& compiledParts,
+                                int depth, Callback& callback) const
+    {
+        if (depth == parts.size())
+        {
+            for (auto& entry : node.entries)
+                callback (entry.listener);
+
+            return;
+        }
+
+        if (auto* compiled = compiledParts.getUnchecked (depth))
+        {
+            for (auto* child : node.children)
+            {
+                auto* name = child->name.toRawUTF8();
+
+                if (compiled->matches (name, name + child->nameLength))
+                    callMatchingListeners (*child, parts, compiledParts, depth + 1, callback);
+            }
+        }
+        else
+        {
+            auto& part = parts.getReference (depth);
+
+            if (auto* child = findChild (node, part.first, part.second))
+                callMatchingListeners (*child, parts, compiledParts, depth + 1, callback);
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (OSCAddressIndex)
+};
+
 
 //==============================================================================
 struct OSCReceiver::Pimpl   : private Thread,
@@ -373,7 +617,10 @@ struct OSCReceiver::Pimpl   : private Thread,
             signalThreadShouldExit();
 
             if (socket.willDeleteObject())
+            {
+                const ScopedLock sl (socketLock);
                 socket->shutdown();
+            }
 
             waitForThreadToExit (10000);
             socket.reset();
@@ -393,15 +640,20 @@ struct OSCReceiver::Pimpl   : private Thread,
         realtimeListeners.add (listenerToAdd);
     }
 
+    void addListener (OSCReceiver::ViewListener* listenerToAdd)
+    {
+        viewListeners.add (listenerToAdd);
+    }
+
     void addListener (ListenerWithOSCAddress<MessageLoopCallback>* listenerToAdd,
                       OSCAddress addressToMatch)
     {
-        addListenerWithAddress (listenerToAdd, addressToMatch, listenersWithAddress);
+        addListenerWithAddress (listenerToAdd, addressToMatch, listenersWithAddress, listenersByAddress);
     }
 
     void addListener (ListenerWithOSCAddress<RealtimeCallback>* listenerToAdd, OSCAddress addressToMatch)
     {
-        addListenerWithAddress (listenerToAdd, addressToMatch, realtimeListenersWithAddress);
+        addListenerWithAddress (listenerToAdd, addressToMatch, realtimeListenersWithAddress, realtimeListenersByAddress);
     }
 
     void removeListener (OSCReceiver::Listener<MessageLoopCallback>* listenerToRemove)
@@ -414,51 +666,67 @@ struct OSCReceiver::Pimpl   : private Thread,
         realtimeListeners.remove (listenerToRemove);
     }
 
+    void removeListener (OSCReceiver::ViewListener* listenerToRemove)
+    {
+        viewListeners.remove (listenerToRemove);
+    }
+
     void removeListener (ListenerWithOSCAddress<MessageLoopCallback>* listenerToRemove)
     {
-        removeListenerWithAddress (listenerToRemove, listenersWithAddress);
+        removeListenerWithAddress (listenerToRemove, listenersWithAddress, listenersByAddress);
     }
 
     void removeListener (ListenerWithOSCAddress<RealtimeCallback>* listenerToRemove)
     {
-        removeListenerWithAddress (listenerToRemove, realtimeListenersWithAddress);
+        removeListenerWithAddress (listenerToRemove, realtimeListenersWithAddress, realtimeListenersByAddress);
     }
 
     //==============================================================================
-    struct CallbackMessage   : public Message
-    {
-        CallbackMessage (OSCBundle::Element oscElement)  : content (oscElement) {}
-
-        // the payload of the message. Can be either an OSCMessage or an OSCBundle.
-        OSCBundle::Element content;
-    };
+    // Posted to the message thread whenever the queue of pending elements goes from
+    // empty to non-empty, so that a whole burst of packets only needs one message.
+    struct CallbackMessage   : public Message {};
 
     //==============================================================================
-    void handleBuffer (const char* data, size_t dataSize)
+    // Parses a packet, calls the realtime listeners, and adds the content to the
+    // given list if the message thread's listeners will need to see it.
+    void handleBuffer (const char* data, size_t dataSize, Array<OSCBundle::Element>& elementsForMessageThread)
     {
-        OSCInputStream inStream (data, dataSize);
+        bool isFormatError = false;
+
+        // the view listeners come first, as they don't need anything to be copied
+        if (viewListeners.size() > 0)
+            isFormatError = ! callViewListeners (data, dataSize);
 
-        try
+        // ..and if they're the only listeners, we can skip creating the OSCMessage or OSCBundle
+        if (viewListeners.size() == 0
+             || realtimeListeners.size() > 0 || realtimeListenersWithAddress.size() > 0
+             || listeners.size() > 0 || listenersWithAddress.size() > 0)
         {
-            auto content = inStream.readElementWithKnownSize (dataSize);
+            OSCInputStream inStream (data, dataSize);
 
-            // realtime listeners should receive the OSC content first - and immediately
-            // on this thread:
-            callRealtimeListeners (content);
+            try
+            {
+                auto content = inStream.readElementWithKnownSize (dataSize);
 
-            if (content.isMessage())
-                callRealtimeListenersWithAddress (content.getMessage());
+                // realtime listeners should receive the OSC content first - and immediately
+                // on this thread:
+                callRealtimeListeners (content);
 
-            // now post the message that will trigger the handleMessage callback
-            // dealing with the non-realtime listeners.
-            if (listeners.size() > 0 || listenersWithAddress.size() > 0)
-                postMessage (new CallbackMessage (content));
-        }
-        catch (const OSCFormatError&)
-        {
-            if (formatErrorHandler != nullptr)
-                formatErrorHandler (data, (int) dataSize);
+                if (content.isMessage())
+                    callRealtimeListenersWithAddress (content.getMessage());
+
+                // now queue the content for the non-realtime listeners
+                if (listeners.size() > 0 || listenersWithAddress.size() > 0)
+                    elementsForMessageThread.add (content);
+            }
+            catch (const OSCFormatError&)
+            {
+                isFormatError = true;
+            }
         }
+
+        if (isFormatError && formatErrorHandler != nullptr)
+            formatErrorHandler (data, (int) dataSize);
     }
 
     //==============================================================================
@@ -467,56 +735,184 @@ struct OSCReceiver::Pimpl   : private Thread,
         formatErrorHandler = handler;
     }
 
+    void setIdleCallbackInterval (int milliseconds) noexcept
+    {
+        idleCallbackInterval = milliseconds;
+    }
+
 private:
     //==============================================================================
+    enum
+    {
+        maxPacketSize = 65535,
+        maxPacketsPerRead = 32,
+
+        // the longest we'll block in one go, so that we notice when we're asked to stop,
+        // even if it's someone else's socket and it doesn't get shut down
+        maxWaitMs = 100
+    };
+
     void run() override
     {
-        int bufferSize = 65535;
-        HeapBlock<char> oscBuffer (bufferSize);
+        HeapBlock<char> packetBuffers ((size_t) maxPacketsPerRead * maxPacketSize);
+        int packetSizes[maxPacketsPerRead];
+        auto lastActivityTime = Time::getMillisecondCounter();
 
         while (! threadShouldExit())
         {
             jassert (socket != nullptr);
-            auto ready = socket->waitUntilReady (true, /* SMODE 100 */ 0);
+
+            const int idleInterval = idleCallbackInterval;
+            int timeoutMs = maxWaitMs;
+
+            if (idleInterval >= 0)
+                timeoutMs = jlimit (0, (int) maxWaitMs,
+                                    (int) (lastActivityTime + (uint32) idleInterval - Time::getMillisecondCounter()));
+
+            auto ready = socket->waitUntilReady (true, timeoutMs);
 
             if (ready < 0 || threadShouldExit())
                 return;
 
             if (ready == 0)
-            { 
-              realtimeListeners.call([&](OSCReceiver::Listener<OSCReceiver::RealtimeCallback>& l) { l.oscThreadIdle(); }); // SMODE call idle callback 
-              continue;
+            {
+                if (idleInterval >= 0)
+                {
+                    auto now = Time::getMillisecondCounter();
+
+                    if (now - lastActivityTime >= (uint32) idleInterval)
+                    {
+                        lastActivityTime = now;
+                        realtimeListeners.call ([&] (OSCReceiver::Listener<OSCReceiver::RealtimeCallback>& l) { l.oscThreadIdle(); }); // SMODE call idle callback
+                    }
+                }
+
+                continue;
+            }
+
+            auto numPackets = readPackets (packetBuffers, packetSizes);
+
+            if (numPackets < 0)
+                return;
+
+            for (int i = 0; i < numPackets; ++i)
+                if (packetSizes[i] >= 4)
+                    handleBuffer (packetBuffers.getData() + (size_t) i * maxPacketSize, (size_t) packetSizes[i], pendingOnThisThread);
+
+            deliverPendingElements();
+            lastActivityTime = Time::getMillisecondCounter();
+        }
+    }
+
+    // Reads as many of the datagrams that are waiting on the socket as will fit into the
+    // buffers, and returns the number that were read, or -1 if the socket has been closed.
+    int readPackets (char* buffers, int* sizes)
+    {
+       #if JUCE_LINUX
+        mmsghdr headers[maxPacketsPerRead];
+        iovec iovecs[maxPacketsPerRead];
+        zeromem (headers, sizeof (headers));
+
+        for (int i = 0; i < maxPacketsPerRead; ++i)
+        {
+            iovecs[i].iov_base = buffers + (size_t) i * maxPacketSize;
+            iovecs[i].iov_len = (size_t) maxPacketSize;
+            headers[i].msg_hdr.msg_iov = iovecs + i;
+            headers[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int numRead = 0;
+
+        {
+            // (this stops our own socket from being closed while we're using its handle)
+            const ScopedLock sl (socketLock);
+            auto handle = socket->getRawSocketHandle();
+
+            if (handle < 0)
+                return -1;
+
+            do
+            {
+                numRead = ::recvmmsg (handle, headers, (unsigned int) maxPacketsPerRead, MSG_DONTWAIT, nullptr);
             }
+            while (numRead < 0 && errno == EINTR);
+        }
+
+        if (numRead < 0)
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
 
-            auto bytesRead = (size_t) socket->read (oscBuffer.getData(), bufferSize, false);
+        for (int i = 0; i < numRead; ++i)
+            sizes[i] = (headers[i].msg_hdr.msg_flags & MSG_TRUNC) != 0 ? 0 : (int) headers[i].msg_len;
 
-            if (bytesRead >= 4)
-                handleBuffer (oscBuffer.getData(), bytesRead);
+        return numRead;
+       #else
+        int numRead = 0;
+
+        while (numRead < maxPacketsPerRead)
+        {
+            auto bytesRead = socket->read (buffers + (size_t) numRead * maxPacketSize, maxPacketSize, false);
+
+            if (bytesRead <= 0)
+                break;
+
+            sizes[numRead++] = bytesRead;
+        }
+
+        return numRead;
+       #endif
+    }
+
+    // Hands everything that's been queued up by this thread over to the message thread.
+    void deliverPendingElements()
+    {
+        if (pendingOnThisThread.isEmpty())
+            return;
+
+        bool needsPosting;
+
+        {
+            const SpinLock::ScopedLockType sl (pendingLock);
+            needsPosting = pendingForMessageThread.isEmpty();
+
+            if (needsPosting)
+                pendingForMessageThread.swapWith (pendingOnThisThread);
+            else
+                pendingForMessageThread.addArray (pendingOnThisThread);
         }
+
+        pendingOnThisThread.clearQuick();
+
+        if (needsPosting)
+            postMessage (new CallbackMessage());
     }
 
     //==============================================================================
     template <typename ListenerType>
     void addListenerWithAddress (ListenerType* listenerToAdd,
                                  OSCAddress address,
-                                 Array<std::pair<OSCAddress, ListenerType*>>& array)
+                                 Array<std::pair<OSCAddress, ListenerType*>>& array,
+                                 OSCAddressIndex<ListenerType>& index)
     {
         for (auto& i : array)
             if (address == i.first && listenerToAdd == i.second)
                 return;
 
         array.add (std::make_pair (address, listenerToAdd));
+        index.add (address, listenerToAdd);
     }
 
     //==============================================================================
     template <typename ListenerType>
     void removeListenerWithAddress (ListenerType* listenerToRemove,
-                                    Array<std::pair<OSCAddress, ListenerType*>>& array)
+                                    Array<std::pair<OSCAddress, ListenerType*>>& array,
+                                    OSCAddressIndex<ListenerType>& index)
     {
         for (int i = 0; i < array.size(); ++i)
         {
             if (listenerToRemove == array.getReference (i).second)
             {
+                index.remove (array.getReference (i).first, listenerToRemove);
+
                 // aarrgh... can't simply call array.remove (i) because this
                 // requires a default c'tor to be present for OSCAddress...
                 // luckily, we don't care about methods preserving element order:
@@ -530,14 +926,22 @@ private:
     //==============================================================================
     void handleMessage (const Message& msg) override
     {
-        if (auto* callbackMessage = dynamic_cast<const CallbackMessage*> (&msg))
+        if (dynamic_cast<const CallbackMessage*> (&msg) != nullptr)
         {
-            auto& content = callbackMessage->content;
+            {
+                const SpinLock::ScopedLockType sl (pendingLock);
+                elementsBeingDelivered.swapWith (pendingForMessageThread);
+            }
 
-            callListeners (content);
+            for (auto& content : elementsBeingDelivered)
+            {
+                callListeners (content);
 
-            if (content.isMessage())
-                callListenersWithAddress (content.getMessage());
+                if (content.isMessage())
+                    callListenersWithAddress (content.getMessage());
+            }
+
+            elementsBeingDelivered.clearQuick();
         }
     }
 
@@ -558,6 +962,36 @@ private:
         }
     }
 
+    bool callViewListeners (const char* data, size_t dataSize)
+    {
+        if (dataSize == 0)
+            return false;
+
+        if (*data == '/')
+        {
+            OSCMessageView message (data, dataSize);
+
+            if (! message.isValid())
+                return false;
+
+            viewListeners.call ([&] (OSCReceiver::ViewListener& l) { l.oscMessageReceived (message); });
+            return true;
+        }
+
+        if (*data == '#')
+        {
+            OSCBundleView bundle (data, dataSize);
+
+            if (! bundle.isValid())
+                return false;
+
+            viewListeners.call ([&] (OSCReceiver::ViewListener& l) { l.oscBundleReceived (bundle); });
+            return true;
+        }
+
+        return false;
+    }
+
     void callRealtimeListeners (const OSCBundle::Element& content)
     {
         using OSCListener = OSCReceiver::Listener<OSCReceiver::RealtimeCallback>;
@@ -577,29 +1011,40 @@ private:
     //==============================================================================
     void callListenersWithAddress (const OSCMessage& message)
     {
-        for (auto& entry : listenersWithAddress)
-            if (auto* listener = entry.second)
-                if (message.getAddressPattern().matches (entry.first))
-                    listener->oscMessageReceived (message);
+        listenersByAddress.callMatchingListeners (message.getAddressPattern(), [&] (ListenerWithOSCAddress<MessageLoopCallback>* listener)
+        {
+            if (listener != nullptr)
+                listener->oscMessageReceived (message);
+        });
     }
 
     void callRealtimeListenersWithAddress (const OSCMessage& message)
     {
-        for (auto& entry : realtimeListenersWithAddress)
-            if (auto* listener = entry.second)
-                if (message.getAddressPattern().matches (entry.first))
-                    listener->oscMessageReceived (message);
+        realtimeListenersByAddress.callMatchingListeners (message.getAddressPattern(), [&] (ListenerWithOSCAddress<RealtimeCallback>* listener)
+        {
+            if (listener != nullptr)
+                listener->oscMessageReceived (message);
+        });
     }
 
     //==============================================================================
     ListenerList<OSCReceiver::Listener<OSCReceiver::MessageLoopCallback>> listeners;
     ListenerList<OSCReceiver::Listener<OSCReceiver::RealtimeCallback>>    realtimeListeners;
+    ListenerList<OSCReceiver::ViewListener>                               viewListeners;
 
     Array<std::pair<OSCAddress, OSCReceiver::ListenerWithOSCAddress<OSCReceiver::MessageLoopCallback>*>> listenersWithAddress;
     Array<std::pair<OSCAddress, OSCReceiver::ListenerWithOSCAddress<OSCReceiver::RealtimeCallback>*>>    realtimeListenersWithAddress;
 
+    OSCAddressIndex<OSCReceiver::ListenerWithOSCAddress<OSCReceiver::MessageLoopCallback>> listenersByAddress;
+    OSCAddressIndex<OSCReceiver::ListenerWithOSCAddress<OSCReceiver::RealtimeCallback>>    realtimeListenersByAddress;
+
     OptionalScopedPointer<DatagramSocket> socket;
+    CriticalSection socketLock;
     OSCReceiver::FormatErrorHandler formatErrorHandler { nullptr };
+    std::atomic<int> idleCallbackInterval { 0 };
+
+    Array<OSCBundle::Element> pendingOnThisThread, pendingForMessageThread, elementsBeingDelivered;
+    SpinLock pendingLock;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Pimpl)
 };
@@ -653,6 +1098,11 @@ void OSCReceiver::addListener (ListenerWithOSCAddress<RealtimeCallback>* listene
     pimpl->addListener (listenerToAdd, addressToMatch);
 }
 
+void OSCReceiver::addListener (ViewListener* listenerToAdd)
+{
+    pimpl->addListener (listenerToAdd);
+}
+
 void OSCReceiver::removeListener (Listener<MessageLoopCallback>* listenerToRemove)
 {
     pimpl->removeListener (listenerToRemove);
@@ -673,11 +1123,21 @@ void OSCReceiver::removeListener (ListenerWithOSCAddress<RealtimeCallback>* list
     pimpl->removeListener (listenerToRemove);
 }
 
+void OSCReceiver::removeListener (ViewListener* listenerToRemove)
+{
+    pimpl->removeListener (listenerToRemove);
+}
+
 void OSCReceiver::registerFormatErrorHandler (FormatErrorHandler handler)
 {
     pimpl->registerFormatErrorHandler (handler);
 }
 
+void OSCReceiver::setIdleCallbackInterval (int milliseconds) noexcept
+{
+    pimpl->setIdleCallbackInterval (milliseconds);
+}
+
 
 //==============================================================================
 //==============================================================================
@@ -1208,6 +1668,245 @@ public:
 
 static OSCInputStreamTests OSCInputStreamUnitTests;
 
+//==============================================================================
+class OSCReceiverTests  : public UnitTest
+{
+public:
+    OSCReceiverTests()
+        : UnitTest ("OSCReceiver class", UnitTestCategories::osc)
+    {}
+
+    struct RealtimeCounter  : public OSCReceiver::Listener<OSCReceiver::RealtimeCallback>
+    {
+        void oscMessageReceived (const OSCMessage& message) override
+        {
+            if (message.size() == 1 && message[0].isInt32())
+            {
+                sum += message[0].getInt32();
+                ++numMessages;
+            }
+        }
+
+        void oscThreadIdle() override   { ++numIdleCallbacks; }
+
+        std::atomic<int> numMessages { 0 }, numIdleCallbacks { 0 };
+        std::atomic<int64> sum { 0 };
+    };
+
+    struct ViewCounter  : public OSCReceiver::ViewListener
+    {
+        void oscMessageReceived (const OSCMessageView& message) override
+        {
+            if (message.size() == 1 && message[0].isInt32())
+            {
+                sum += message[0].getInt32();
+                ++numMessages;
+            }
+        }
+
+        std::atomic<int> numMessages { 0 };
+        std::atomic<int64> sum { 0 };
+    };
+
+    static bool waitUntil (std::function<bool()> condition)
+    {
+        for (int i = 0; i < 2000; ++i)
+        {
+            if (condition())
+                return true;
+
+            Thread::sleep (1);
+        }
+
+        return condition();
+    }
+
+    void runTest()
+    {
+        beginTest ("receiving bursts of packets");
+        {
+            DatagramSocket socket;
+            expect (socket.bindToPort (0));
+
+            RealtimeCounter counter;
+            OSCReceiver receiver;
+            receiver.setIdleCallbackInterval (-1);
+            receiver.addListener (&counter);
+            expect (receiver.connectToSocket (socket));
+
+            OSCSender sender;
+            expect (sender.connect ("127.0.0.1", socket.getBoundPort()));
+
+            const int numBursts = 20, burstSize = 32;
+            int64 expectedSum = 0;
+
+            for (int burst = 0; burst < numBursts; ++burst)
+            {
+                for (int i = 0; i < burstSize; ++i)
+                {
+                    auto value = (int32) (burst * burstSize + i);
+                    expect (sender.send (OSCMessage ("/test/burst", value)));
+                    expectedSum += value;
+                }
+
+                expect (waitUntil ([&] { return counter.numMessages == (burst + 1) * burstSize; }));
+            }
+
+            expectEquals (counter.numMessages.load(), numBursts * burstSize);
+            expectEquals (counter.sum.load(), expectedSum);
+            expectEquals (counter.numIdleCallbacks.load(), 0);
+
+            expect (receiver.disconnect());
+        }
+
+        beginTest ("idle callbacks");
+        {
+            DatagramSocket socket;
+            expect (socket.bindToPort (0));
+
+            RealtimeCounter counter;
+            OSCReceiver receiver;
+            receiver.setIdleCallbackInterval (10);
+            receiver.addListener (&counter);
+            expect (receiver.connectToSocket (socket));
+
+            expect (waitUntil ([&] { return counter.numIdleCallbacks >= 3; }));
+
+            receiver.setIdleCallbackInterval (-1);
+            Thread::sleep (50);
+            auto numIdleCallbacks = counter.numIdleCallbacks.load();
+            Thread::sleep (150);
+            expectEquals (counter.numIdleCallbacks.load(), numIdleCallbacks);
+
+            expect (receiver.disconnect());
+        }
+
+        beginTest ("view listeners");
+        {
+            DatagramSocket socket;
+            expect (socket.bindToPort (0));
+
+            ViewCounter viewCounter;
+            RealtimeCounter realtimeCounter;
+            std::atomic<int> numFormatErrors { 0 };
+
+            OSCReceiver receiver;
+            receiver.setIdleCallbackInterval (-1);
+            receiver.addListener (&viewCounter);
+            receiver.registerFormatErrorHandler ([&] (const char*, int) { ++numFormatErrors; });
+            expect (receiver.connectToSocket (socket));
+
+            OSCSender sender;
+            expect (sender.connect ("127.0.0.1", socket.getBoundPort()));
+
+            OSCBundle bundle;
+            bundle.addElement (OSCMessage ("/test/view", (int32) 2));
+            bundle.addElement (OSCMessage ("/test/view", 0.5f));
+            bundle.addElement (OSCBundle::Element (OSCBundle()));
+            bundle.addElement (OSCMessage ("/test/view", (int32) 3));
+
+            expect (sender.send (OSCMessage ("/test/view", (int32) 1)));
+            expect (sender.send (bundle));
+            expect (waitUntil ([&] { return viewCounter.numMessages == 3; }));
+            expectEquals (viewCounter.sum.load(), (int64) 6);
+
+            const char malformed[] = "/test/view\0\0,i\0";
+            expect (socket.write ("127.0.0.1", socket.getBoundPort(), malformed, (int) sizeof (malformed) - 1) > 0);
+            expect (waitUntil ([&] { return numFormatErrors == 1; }));
+
+            receiver.addListener (&realtimeCounter);
+            expect (sender.send (OSCMessage ("/test/view", (int32) 4)));
+            expect (waitUntil ([&] { return viewCounter.numMessages == 4 && realtimeCounter.numMessages == 1; }));
+            expectEquals (realtimeCounter.sum.load(), (int64) 4);
+
+            expect (socket.write ("127.0.0.1", socket.getBoundPort(), malformed, (int) sizeof (malformed) - 1) > 0);
+            expect (waitUntil ([&] { return numFormatErrors == 2; }));
+
+            receiver.removeListener (&viewCounter);
+            expect (sender.send (OSCMessage ("/test/view", (int32) 5)));
+            expect (waitUntil ([&] { return realtimeCounter.numMessages == 2; }));
+            expectEquals (viewCounter.numMessages.load(), 4);
+
+            expect (receiver.disconnect());
+        }
+
+        beginTest ("dispatching by address");
+        {
+            struct DummyListener {};
+            OwnedArray<DummyListener> dummyListeners;
+            Array<std::pair<OSCAddress, DummyListener*>> registered;
+            OSCAddressIndex<DummyListener> index;
+
+            auto addListener = [&] (const char* address)
+            {
+                auto* listener = dummyListeners.add (new DummyListener());
+                registered.add ({ OSCAddress (address), listener });
+                index.add (OSCAddress (address), listener);
+            };
+
+            for (int i = 0; i < 20; ++i)
+            {
+                addListener (("/mixer/channel" + String (i) + "/fader").toRawUTF8());
+                addListener (("/mixer/channel" + String (i) + "/mute").toRawUTF8());
+            }
+
+            addListener ("/mixer");
+            addListener ("/mixer/master/fader");
+            addListener ("/mixer/master/fader");
+            addListener ("/mixer//master/fader/");
+            addListener ("/transport/play");
+
+            auto checkMatches = [&] (const char* pattern)
+            {
+                OSCAddressPattern p (pattern);
+                Array<DummyListener*> expected, actual;
+
+                for (auto& r : registered)
+                    if (p.matches (r.first))
+                        expected.add (r.second);
+
+                index.callMatchingListeners (p, [&] (DummyListener* l) { actual.add (l); });
+
+                expected.sort();
+                actual.sort();
+                expect (expected == actual, pattern);
+                return actual.size();
+            };
+
+            expectEquals (checkMatches ("/mixer/channel3/fader"), 1);
+            expectEquals (checkMatches ("/mixer/channel3/pan"), 0);
+            expectEquals (checkMatches ("/mixer/channel3"), 0);
+            expectEquals (checkMatches ("/mixer"), 1);
+            expectEquals (checkMatches ("/mixer/master/fader"), 2);
+            expectEquals (checkMatches ("/mixer/channel*/fader"), 20);
+            expectEquals (checkMatches ("/mixer/channel1?/{fader,mute}"), 20);
+            expectEquals (checkMatches ("/mixer/channel[0-4]/*"), 10);
+            expectEquals (checkMatches ("/mixer/channel[!0-4]/mute"), 5);
+            expectEquals (checkMatches ("/*/*/fader"), 23);
+            expectEquals (checkMatches ("/*"), 1);
+            expectEquals (checkMatches ("/*/play"), 1);
+            expectEquals (checkMatches ("/mixer/channel{1,2/fader"), 0);
+
+            for (int i = registered.size(); --i >= 0;)
+            {
+                if (i % 3 == 0)
+                {
+                    index.remove (registered.getReference (i).first, registered.getReference (i).second);
+                    registered.remove (i);
+                }
+            }
+
+            checkMatches ("/mixer/channel*/fader");
+            checkMatches ("/mixer/channel1?/{fader,mute}");
+            checkMatches ("/*/*/fader");
+            checkMatches ("/mixer/master/fader");
+            checkMatches ("/mixer");
+        }
+    }
+};
+
+static OSCReceiverTests OSCReceiverUnitTests;
+
 #endif
 
 } // namespace juce
@@ -124,7 +124,7 @@ public:
         virtual void oscBundleReceived (const OSCBundle& /*bundle*/) {}
 
 
-        virtual void oscThreadIdle() {} // SMODE callback when receiver thread is idle
+        virtual void oscThreadIdle() {} // SMODE callback when receiver thread is idle, see OSCReceiver::setIdleCallbackInterval()
     };
 
     //==============================================================================
@@ -161,6 +161,42 @@ public:
         virtual void oscMessageReceived (const OSCMessage& message) = 0;
     };
 
+    //==============================================================================
+    /** A class for receiving OSC data from an OSCReceiver without any copying or
+        allocation.
+
+        These listeners are always called on the network thread, like a
+        Listener<RealtimeCallback>, but they're given an OSCMessageView or OSCBundleView
+        which reads directly from the receiver's buffer, rather than an OSCMessage or
+        OSCBundle. The views are only valid until the callback returns.
+
+        If a receiver only has ViewListeners, it doesn't create any OSCMessage or
+        OSCBundle objects at all, so receiving and handling a packet won't touch the heap.
+
+        @see OSCReceiver::addListener, OSCMessageView, OSCBundleView
+    */
+    class JUCE_API  ViewListener
+    {
+    public:
+        /** Destructor. */
+        virtual ~ViewListener() = default;
+
+        /** Called when the OSCReceiver receives a new OSC message.
+            You must implement this function.
+        */
+        virtual void oscMessageReceived (const OSCMessageView& message) = 0;
+
+        /** Called when the OSCReceiver receives a new OSC bundle.
+            The default implementation calls oscMessageReceived() for each message in the
+            bundle (and any bundles inside it), so you only need to override this if you're
+            interested in the bundle's time tag or structure.
+        */
+        virtual void oscBundleReceived (const OSCBundleView& bundle)
+        {
+            bundle.forEachMessage ([this] (const OSCMessageView& m) { oscMessageReceived (m); });
+        }
+    };
+
     //==============================================================================
     /** Adds a listener that listens to OSC messages and bundles.
         This listener will be called on the application's message loop.
@@ -187,6 +223,13 @@ public:
     void addListener (ListenerWithOSCAddress<RealtimeCallback>* listenerToAdd,
                       OSCAddress addressToMatch);
 
+    /** Adds a listener that receives views of the OSC messages and bundles, without
+        copying or allocating anything.
+        This listener will be called in real-time directly on the network thread
+        that receives OSC data.
+    */
+    void addListener (ViewListener* listenerToAdd);
+
     /** Removes a previously-registered listener. */
     void removeListener (Listener<MessageLoopCallback>* listenerToRemove);
 
@@ -199,6 +242,9 @@ public:
     /** Removes a previously-registered listener. */
     void removeListener (ListenerWithOSCAddress<RealtimeCallback>* listenerToRemove);
 
+    /** Removes a previously-registered listener. */
+    void removeListener (ViewListener* listenerToRemove);
+
     //==============================================================================
     /** An error handler function for OSC format errors that can be called by the
         OSCReceiver.
@@ -216,6 +262,26 @@ public:
     */
     void registerFormatErrorHandler (FormatErrorHandler handler);
 
+    //==============================================================================
+    /** Sets how often the receiver thread calls Listener<RealtimeCallback>::oscThreadIdle()
+        while there's no incoming data.
+
+        If the interval is 0 (the default), the thread polls its socket continuously, and
+        calls oscThreadIdle() every time it finds nothing to read. This gives the lowest
+        latency for idle work, but keeps a CPU core busy.
+
+        If it's greater than 0, the thread sleeps until a packet arrives, and calls
+        oscThreadIdle() once this many milliseconds have passed without one, and then
+        again after every further interval.
+
+        If it's less than 0, the thread just sleeps until a packet arrives and never calls
+        oscThreadIdle().
+
+        This can be called at any time, and takes effect the next time the thread waits
+        for data.
+    */
+    void setIdleCallbackInterval (int milliseconds) noexcept;
+
 private:
     //==============================================================================
     struct Pimpl;
@@ -27,186 +27,192 @@
 namespace juce
 {
 
-namespace
+//==============================================================================
+/** Writes OSC data to an internal memory buffer, which grows as required.
+
+    The data that was written into the stream can then be accessed later as
+    a contiguous block of memory.
+
+    This class implements the Open Sound Control 1.0 Specification for
+    the format in which the OSC data will be written into the buffer.
+*/
+struct OSCOutputStream
 {
-    //==============================================================================
-    /** Writes OSC data to an internal memory buffer, which grows as required.
+    OSCOutputStream() noexcept {}
 
-        The data that was written into the stream can then be accessed later as
-        a contiguous block of memory.
+    /** Creates a stream whose buffer starts off with the given size. */
+    explicit OSCOutputStream (size_t initialSize)  : output (initialSize) {}
 
-        This class implements the Open Sound Control 1.0 Specification for
-        the format in which the OSC data will be written into the buffer.
-    */
-    struct OSCOutputStream
-    {
-        OSCOutputStream() noexcept {}
+    /** Returns a pointer to the data that has been written to the stream. */
+    const void* getData() const noexcept    { return output.getData(); }
 
-        /** Returns a pointer to the data that has been written to the stream. */
-        const void* getData() const noexcept    { return output.getData(); }
+    /** Returns the number of bytes of data that have been written to the stream. */
+    size_t getDataSize() const noexcept     { return output.getDataSize(); }
 
-        /** Returns the number of bytes of data that have been written to the stream. */
-        size_t getDataSize() const noexcept     { return output.getDataSize(); }
+    /** Empties the stream so that it can be re-used, without freeing its buffer. */
+    void reset() noexcept                   { output.reset(); }
 
-        //==============================================================================
-        bool writeInt32 (int32 value)
-        {
-            return output.writeIntBigEndian (value);
-        }
+    //==============================================================================
+    bool writeInt32 (int32 value)
+    {
+        return output.writeIntBigEndian (value);
+    }
 
-        bool writeUint64 (uint64 value)
-        {
-            return output.writeInt64BigEndian (int64 (value));
-        }
+    bool writeUint64 (uint64 value)
+    {
+        return output.writeInt64BigEndian (int64 (value));
+    }
 
-        bool writeFloat32 (float value)
-        {
-            return output.writeFloatBigEndian (value);
-        }
+    bool writeFloat32 (float value)
+    {
+        return output.writeFloatBigEndian (value);
+    }
 
-        bool writeString (const String& value)
-        {
-            if (! output.writeString (value))
-                return false;
+    bool writeString (const String& value)
+    {
+        if (! output.writeString (value))
+            return false;
 
-            const size_t numPaddingZeros = ~value.getNumBytesAsUTF8() & 3;
+        const size_t numPaddingZeros = ~value.getNumBytesAsUTF8() & 3;
 
-            return output.writeRepeatedByte ('\0', numPaddingZeros);
-        }
+        return output.writeRepeatedByte ('\0', numPaddingZeros);
+    }
 
-        bool writeBlob (const MemoryBlock& blob)
-        {
-            if (! (output.writeIntBigEndian ((int) blob.getSize())
-                    && output.write (blob.getData(), blob.getSize())))
-                return false;
+    bool writeBlob (const MemoryBlock& blob)
+    {
+        if (! (output.writeIntBigEndian ((int) blob.getSize())
+                && output.write (blob.getData(), blob.getSize())))
+            return false;
 
-            const size_t numPaddingZeros = ~(blob.getSize() - 1) & 3;
+        const size_t numPaddingZeros = ~(blob.getSize() - 1) & 3;
 
-            return output.writeRepeatedByte (0, numPaddingZeros);
-        }
+        return output.writeRepeatedByte (0, numPaddingZeros);
+    }
 
-        bool writeColour (OSCColour colour)
-        {
-            return output.writeIntBigEndian ((int32) colour.toInt32());
-        }
+    bool writeColour (OSCColour colour)
+    {
+        return output.writeIntBigEndian ((int32) colour.toInt32());
+    }
 
-        bool writeTimeTag (OSCTimeTag timeTag)
-        {
-            return output.writeInt64BigEndian (int64 (timeTag.getRawTimeTag()));
-        }
+    bool writeTimeTag (OSCTimeTag timeTag)
+    {
+        return output.writeInt64BigEndian (int64 (timeTag.getRawTimeTag()));
+    }
 
-        bool writeAddress (const OSCAddress& address)
-        {
-            return writeString (address.toString());
-        }
+    bool writeAddress (const OSCAddress& address)
+    {
+        return writeString (address.toString());
+    }
 
-        bool writeAddressPattern (const OSCAddressPattern& ap)
-        {
-            return writeString (ap.toString());
-        }
+    bool writeAddressPattern (const OSCAddressPattern& ap)
+    {
+        return writeString (ap.toString());
+    }
 
-        bool writeTypeTagString (const OSCTypeList& typeList)
-        {
-            output.writeByte (',');
+    bool writeTypeTagString (const OSCTypeList& typeList)
+    {
+        output.writeByte (',');
 
-            if (typeList.size() > 0)
-                output.write (typeList.begin(), (size_t) typeList.size());
+        if (typeList.size() > 0)
+            output.write (typeList.begin(), (size_t) typeList.size());
 
-            output.writeByte ('\0');
+        output.writeByte ('\0');
 
-            size_t bytesWritten = (size_t) typeList.size() + 1;
-            size_t numPaddingZeros = ~bytesWritten & 0x03;
+        size_t bytesWritten = (size_t) typeList.size() + 1;
+        size_t numPaddingZeros = ~bytesWritten & 0x03;
 
-            return output.writeRepeatedByte ('\0', numPaddingZeros);
-        }
+        return output.writeRepeatedByte ('\0', numPaddingZeros);
+    }
 
-        bool writeArgument (const OSCArgument& arg)
+    bool writeArgument (const OSCArgument& arg)
+    {
+        switch (arg.getType())
         {
-            switch (arg.getType())
-            {
-                case OSCTypes::int32:       return writeInt32 (arg.getInt32());
-                case OSCTypes::float32:     return writeFloat32 (arg.getFloat32());
-                case OSCTypes::string:      return writeString (arg.getString());
-                case OSCTypes::blob:        return writeBlob (arg.getBlob());
-                case OSCTypes::colour:      return writeColour (arg.getColour());
-
-                default:
-                    // In this very unlikely case you supplied an invalid OSCType!
-                    jassertfalse;
-                    return false;
-            }
-        }
+            case OSCTypes::int32:       return writeInt32 (arg.getInt32());
+            case OSCTypes::float32:     return writeFloat32 (arg.getFloat32());
+            case OSCTypes::string:      return writeString (arg.getString());
+            case OSCTypes::blob:        return writeBlob (arg.getBlob());
+            case OSCTypes::colour:      return writeColour (arg.getColour());
 
-        //==============================================================================
-        bool writeMessage (const OSCMessage& msg)
-        {
-            if (! writeAddressPattern (msg.getAddressPattern()))
+            default:
+                // In this very unlikely case you supplied an invalid OSCType!
+                jassertfalse;
                 return false;
+        }
+    }
 
-            OSCTypeList typeList;
+    //==============================================================================
+    bool writeMessage (const OSCMessage& msg)
+    {
+        if (! writeAddressPattern (msg.getAddressPattern()))
+            return false;
 
-            for (auto& arg : msg)
-                typeList.add (arg.getType());
+        // (this writes the same thing as writeTypeTagString, but without needing an OSCTypeList)
+        if (! output.writeByte (','))
+            return false;
 
-            if (! writeTypeTagString (typeList))
+        for (auto& arg : msg)
+            if (! output.writeByte (arg.getType()))
                 return false;
 
-            for (auto& arg : msg)
-                if (! writeArgument (arg))
-                    return false;
-
-            return true;
-        }
-
-        bool writeBundle (const OSCBundle& bundle)
-        {
-            if (! writeString ("#bundle"))
-                return false;
+        if (! (output.writeByte ('\0')
+                && output.writeRepeatedByte ('\0', ~((size_t) msg.size() + 1) & 0x03)))
+            return false;
 
-            if (! writeTimeTag (bundle.getTimeTag()))
+        for (auto& arg : msg)
+            if (! writeArgument (arg))
                 return false;
 
-            for (auto& element : bundle)
-                if (! writeBundleElement (element))
-                    return false;
+        return true;
+    }
 
-            return true;
-        }
+    bool writeBundle (const OSCBundle& bundle)
+    {
+        if (! writeString ("#bundle"))
+            return false;
 
-        //==============================================================================
-        bool writeBundleElement (const OSCBundle::Element& element)
-        {
-            const int64 startPos = output.getPosition();
+        if (! writeTimeTag (bundle.getTimeTag()))
+            return false;
 
-            if (! writeInt32 (0))   // writing dummy value for element size
+        for (auto& element : bundle)
+            if (! writeBundleElement (element))
                 return false;
 
-            if (element.isBundle())
-            {
-                if (! writeBundle (element.getBundle()))
-                    return false;
-            }
-            else
-            {
-                if (! writeMessage (element.getMessage()))
-                    return false;
-            }
+        return true;
+    }
+
+    //==============================================================================
+    bool writeBundleElement (const OSCBundle::Element& element)
+    {
+        const int64 startPos = output.getPosition();
 
-            const int64 endPos = output.getPosition();
-            const int64 elementSize = endPos - (startPos + 4);
+        if (! writeInt32 (0))   // writing dummy value for element size
+            return false;
 
-            return output.setPosition (startPos)
-                     && writeInt32 ((int32) elementSize)
-                     && output.setPosition (endPos);
+        if (element.isBundle())
+        {
+            if (! writeBundle (element.getBundle()))
+                return false;
+        }
+        else
+        {
+            if (! writeMessage (element.getMessage()))
+                return false;
         }
 
-    private:
-        MemoryOutputStream output;
+        const int64 endPos = output.getPosition();
+        const int64 elementSize = endPos - (startPos + 4);
 
-        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OSCOutputStream)
-    };
+        return output.setPosition (startPos)
+                 && writeInt32 ((int32) elementSize)
+                 && output.setPosition (endPos);
+    }
 
-} // namespace
+private:
+    MemoryOutputStream output;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OSCOutputStream)
+};
 
 
 //==============================================================================
@@ -252,18 +258,20 @@ struct OSCSender::Pimpl
     //==============================================================================
     bool send (const OSCMessage& message, const String& hostName, int portNumber)
     {
-        OSCOutputStream outStream;
+        const ScopedLock sl (packetStreamLock);
+        packetStream.reset();
 
-        return outStream.writeMessage (message)
-            && sendOutputStream (outStream, hostName, portNumber);
+        return packetStream.writeMessage (message)
+            && sendOutputStream (packetStream, hostName, portNumber);
     }
 
     bool send (const OSCBundle& bundle, const String& hostName, int portNumber)
     {
-        OSCOutputStream outStream;
+        const ScopedLock sl (packetStreamLock);
+        packetStream.reset();
 
-        return outStream.writeBundle (bundle)
-            && sendOutputStream (outStream, hostName, portNumber);
+        return packetStream.writeBundle (bundle)
+            && sendOutputStream (packetStream, hostName, portNumber);
     }
 
     bool send (const OSCMessage& message)   { return send (message, targetHostName, targetPortNumber); }
@@ -294,6 +302,11 @@ private:
     String targetHostName;
     int targetPortNumber = 0;
 
+    // Every packet is encoded into this same buffer, which is big enough for any UDP
+    // datagram, so sending never needs to allocate.
+    OSCOutputStream packetStream { 65536 };
+    CriticalSection packetStreamLock;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Pimpl)
 };
 
@@ -867,6 +880,121 @@ public:
                 expectEquals (msg[0].getInt32(), 42);
             }
         }
+
+        beginTest ("Re-using an output stream");
+        {
+            OSCMessage message1 ("/test/four_args", 42, 0.5f, String ("foo"), String ("bar"));
+            OSCMessage message2 ("/test/one_arg", 42);
+
+            OSCOutputStream reused (1024), output1, output2;
+            output1.writeMessage (message1);
+            output2.writeMessage (message2);
+
+            expect (reused.writeMessage (message1));
+            expect (reused.getDataSize() == output1.getDataSize());
+            expect (std::memcmp (reused.getData(), output1.getData(), output1.getDataSize()) == 0);
+
+            reused.reset();
+            expect (reused.writeMessage (message2));
+            expect (reused.getDataSize() == output2.getDataSize());
+            expect (std::memcmp (reused.getData(), output2.getData(), output2.getDataSize()) == 0);
+        }
+
+        beginTest ("Message and bundle views");
+        {
+            const uint8 blobData[] = { 1, 2, 3, 4, 5 };
+            OSCMessage outMessage ("/test/all_types", 42, 0.5f, String ("foo"),
+                                   MemoryBlock (blobData, sizeof (blobData)),
+                                   OSCColour { 1, 2, 3, 4 });
+
+            OSCBundle outBundleNested (OSCTimeTag (1234));
+            outBundleNested.addElement (OSCMessage ("/test/empty"));
+
+            OSCBundle outBundle (OSCTimeTag (5678));
+            outBundle.addElement (outMessage);
+            outBundle.addElement (outBundleNested);
+
+            OSCOutputStream output;
+            output.writeBundle (outBundle);
+
+            OSCBundleView bundle (output.getData(), output.getDataSize());
+            expect (bundle.isValid());
+            expect (bundle.getTimeTag().getRawTimeTag() == 5678);
+
+            Array<String> addresses;
+            bundle.forEachMessage ([&] (const OSCMessageView& m) { addresses.add (m.getAddressPattern().text); });
+            expect (addresses == Array<String> ("/test/all_types", "/test/empty"));
+
+            auto element = *bundle.begin();
+            expect (element.isMessage());
+
+            auto message = element.getMessage();
+            expect (message.isValid());
+            expectEquals (message.size(), 5);
+            expectEquals (message[0].getInt32(), 42);
+            expectEquals (message[1].getFloat32(), 0.5f);
+            expect (String (message[2].getString()) == "foo");
+            expectEquals ((int) message[3].getBlobSize(), (int) sizeof (blobData));
+            expect (std::memcmp (message[3].getBlobData(), blobData, sizeof (blobData)) == 0);
+            expect (message[4].getColour().toInt32() == (OSCColour { 1, 2, 3, 4 }).toInt32());
+
+            int numArgs = 0;
+
+            for (auto arg : message)
+                expect (arg.getType() == message[numArgs++].getType());
+
+            expectEquals (numArgs, 5);
+
+            // copying the views should give back the same packet
+            OSCOutputStream copied;
+            copied.writeBundle (bundle.toBundle());
+            expect (copied.getDataSize() == output.getDataSize());
+            expect (std::memcmp (copied.getData(), output.getData(), output.getDataSize()) == 0);
+        }
+
+        beginTest ("Views only accept data that can be read");
+        {
+            OSCBundle outBundleNested;
+            outBundleNested.addElement (OSCMessage ("/test/one_arg", String ("foo")));
+
+            OSCBundle outBundle;
+            outBundle.addElement (OSCMessage ("/test/four_args", 42, 0.5f, String ("abc"), MemoryBlock (3, true)));
+            outBundle.addElement (outBundleNested);
+
+            OSCOutputStream output;
+            output.writeBundle (outBundle);
+
+            auto random = getRandom();
+
+            for (int i = 0; i < 5000; ++i)
+            {
+                MemoryBlock packet (output.getData(), output.getDataSize());
+
+                for (int j = random.nextInt (4); --j >= 0;)
+                    packet[random.nextInt ((int) packet.getSize())] = (char) random.nextInt (256);
+
+                if (random.nextBool())
+                    packet.setSize ((size_t) random.nextInt ((int) packet.getSize()) + 1);
+
+                OSCBundleView bundle (packet.getData(), packet.getSize());
+
+                if (bundle.isValid())
+                {
+                    OSCInputStream input (packet.getData(), packet.getSize());
+
+                    try
+                    {
+                        auto content = input.readElementWithKnownSize (packet.getSize());
+                        expect (content.isBundle());
+                        expectEquals (bundle.toBundle().size(), content.getBundle().size());
+                    }
+                    catch (const OSCFormatError&)
+                    {
+                        expect (false, "A view accepted a packet which can't be read");
+                    }
+                }
+            }
+        }
     }
 };
 
@@ -34,6 +34,17 @@ namespace juce
     An OSCSender object can connect to a network port. It then can send OSC
     messages and bundles to a specified host over an UDP socket.
 
+    Each packet is encoded into a buffer that belongs to the sender and is re-used
+    for every send, so sending an OSCMessage or OSCBundle doesn't allocate anything.
+    If you want to avoid allocating, create your OSCMessage objects up-front and just
+    change the values of their arguments before sending them, rather than using the
+    send() methods that create a new OSCMessage each time.
+
+    Sending isn't lock-free, though. The buffer is protected by a lock, so a send()
+    will block while another thread is sending through the same sender, and writing
+    to the socket is a system call that may block too. If you send from a realtime
+    thread, give that thread a sender of its own.
+
     @tags{OSC}
 */
 class JUCE_API  OSCSender